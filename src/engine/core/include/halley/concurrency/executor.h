@@ -36,7 +36,7 @@ namespace Halley
 		std::mutex mutex;
 		std::condition_variable condition;
 
-		std::atomic<int> attachedCount;
+		std::atomic<int> attachedCount = 0;
 		std::atomic<bool> hasTasks;
 		std::atomic<bool> aborted;
 
@@ -50,6 +50,8 @@ namespace Halley
 
 		static Executors& get();
 		static void setInstance(Executors& e);
+		static bool hasInstance() { return instance != nullptr; }
+		static void clearInstance() { instance = nullptr; }
 
 		static ExecutionQueue& getCPU() { return instance->cpu; }
 		static ExecutionQueue& getCPUAux() { return instance->cpuAux; }
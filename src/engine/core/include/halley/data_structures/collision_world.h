@@ -0,0 +1,89 @@
+#pragma once
+
+#include "dynamic_aabb_tree.h"
+#include "halley/maths/circle.h"
+#include "halley/maths/polygon.h"
+#include "halley/maths/ray.h"
+
+namespace Halley {
+	// Shape for narrowphase tests. Polygons must be convex.
+	class CollisionShape {
+	public:
+		enum class Type {
+			Circle,
+			Polygon
+		};
+
+		CollisionShape(Circle circle);
+		CollisionShape(Polygon polygon);
+
+		[[nodiscard]] Type getType() const { return type; }
+		[[nodiscard]] const Circle& getCircle() const;
+		[[nodiscard]] const Polygon& getPolygon() const;
+
+		[[nodiscard]] Rect4f getAABB() const;
+		[[nodiscard]] bool overlaps(const CollisionShape& other) const;
+		[[nodiscard]] std::optional<Ray::RayCastResult> rayCast(const Ray& ray) const;
+
+	private:
+		Type type;
+		Circle circle;
+		Polygon polygon;
+	};
+
+	// Broadphase (DynamicAABBTree) plus narrowphase (CollisionShape) for gameplay collision.
+	// Elements are identified by the handle returned by add(), and can carry arbitrary user data (e.g. an EntityId).
+	class CollisionWorld {
+	public:
+		using Handle = DynamicAABBTree::Handle;
+		using Pair = DynamicAABBTree::Pair;
+
+		struct RayCastHit {
+			Handle handle;
+			Ray::RayCastResult result;
+		};
+
+		explicit CollisionWorld(float margin = 4.0f);
+
+		Handle add(CollisionShape shape, uint64_t userData = 0);
+		void remove(Handle handle);
+
+		// Displacement is how much the shape moved since last update, used to predict its movement in the broadphase
+		void setShape(Handle handle, CollisionShape shape, Vector2f displacement = Vector2f());
+
+		[[nodiscard]] const CollisionShape& getShape(Handle handle) const;
+		[[nodiscard]] uint64_t getUserData(Handle handle) const;
+		[[nodiscard]] size_t size() const { return tree.size(); }
+		[[nodiscard]] const DynamicAABBTree& getTree() const { return tree; }
+
+		// Finds all pairs of shapes that overlap. Each pair is reported once, with first < second
+		void getCollisions(Vector<Pair>& result) const;
+
+		// Returns the closest shape hit by the ray (whose direction must be normalised)
+		[[nodiscard]] std::optional<RayCastHit> rayCast(const Ray& ray, float maxDistance) const;
+
+		// Visits every shape that overlaps the given shape. The visitor returns false to stop the query.
+		template <typename F>
+		void query(const CollisionShape& shape, F visitor) const
+		{
+			tree.query(shape.getAABB(), [&] (Handle handle) -> bool
+			{
+				if (shape.overlaps(entries[handle]->shape)) {
+					return visitor(handle);
+				}
+				return true;
+			});
+		}
+
+	private:
+		struct Entry {
+			CollisionShape shape;
+			uint64_t userData;
+		};
+
+		DynamicAABBTree tree;
+		Vector<std::optional<Entry>> entries; // Indexed by handle
+
+		const Entry& getEntry(Handle handle) const;
+	};
+}
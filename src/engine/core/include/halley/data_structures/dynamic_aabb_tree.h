@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <gsl/gsl>
+#include "vector.h"
+#include "halley/maths/rect.h"
+#include "halley/maths/ray.h"
+
+namespace Halley {
+	// Dynamic bounding volume hierarchy, for broadphase collision of moving objects.
+	// Elements are stored with "fat" bounds (grown by a margin, and extended along their movement), so that small movements don't require updating the tree.
+	// The tree is kept balanced with rotations on insertion and removal.
+	class DynamicAABBTree {
+	public:
+		using Handle = int32_t;
+		constexpr static Handle InvalidHandle = -1;
+
+		using Pair = std::pair<Handle, Handle>;
+
+		explicit DynamicAABBTree(float margin = 4.0f, float displacementMultiplier = 2.0f);
+
+		Handle insert(Rect4f bounds);
+		void remove(Handle handle);
+
+		// Returns true if the element had to be reinserted in the tree (i.e. it moved outside its fat bounds)
+		bool move(Handle handle, Rect4f bounds, Vector2f displacement = Vector2f());
+
+		void clear();
+
+		[[nodiscard]] Rect4f getFatBounds(Handle handle) const;
+		[[nodiscard]] size_t size() const { return nElements; }
+		[[nodiscard]] bool empty() const { return nElements == 0; }
+		[[nodiscard]] int getHeight() const;
+
+		// Finds all pairs of elements whose fat bounds overlap. Each pair is reported once, with first < second.
+		void getOverlappingPairs(Vector<Pair>& result) const;
+
+		// Finds overlapping pairs involving elements inserted or moved (i.e. reinserted) since the last call, then clears that list.
+		// Together with the pairs reported previously, this gives all overlapping pairs, without having to go through elements that didn't move.
+		void getNewOverlappingPairs(Vector<Pair>& result);
+
+		// Visits every element whose fat bounds overlap rect. The visitor returns false to stop the query.
+		template <typename F>
+		void query(Rect4f rect, F visitor) const
+		{
+			if (root == InvalidHandle) {
+				return;
+			}
+
+			std::array<Handle, StackSize> stack;
+			size_t stackSize = 0;
+			stack[stackSize++] = root;
+
+			while (stackSize > 0) {
+				const auto nodeIdx = stack[--stackSize];
+				const auto& node = nodes[nodeIdx];
+
+				if (node.bounds.overlaps(rect)) {
+					if (node.isLeaf()) {
+						if (!visitor(nodeIdx)) {
+							return;
+						}
+					} else {
+						Expects(stackSize + 2 <= StackSize);
+						stack[stackSize++] = node.child0;
+						stack[stackSize++] = node.child1;
+					}
+				}
+			}
+		}
+
+		// Visits every element whose fat bounds are hit by the ray before maxDistance. The ray direction is assumed to be normalised.
+		// The visitor is called as float(Handle handle, float maxDistance) and returns the new maxDistance (e.g. distance to the narrowphase hit), or 0 to stop.
+		template <typename F>
+		void rayCast(const Ray& ray, float maxDistance, F visitor) const
+		{
+			if (root == InvalidHandle) {
+				return;
+			}
+
+			const auto invDir = Vector2f(1.0f / ray.dir.x, 1.0f / ray.dir.y);
+
+			std::array<Handle, StackSize> stack;
+			size_t stackSize = 0;
+			stack[stackSize++] = root;
+
+			while (stackSize > 0 && maxDistance > 0) {
+				const auto nodeIdx = stack[--stackSize];
+				const auto& node = nodes[nodeIdx];
+
+				if (rayHitsBounds(ray.p, invDir, node.bounds, maxDistance)) {
+					if (node.isLeaf()) {
+						maxDistance = visitor(nodeIdx, maxDistance);
+					} else {
+						Expects(stackSize + 2 <= StackSize);
+						stack[stackSize++] = node.child0;
+						stack[stackSize++] = node.child1;
+					}
+				}
+			}
+		}
+
+	private:
+		constexpr static size_t StackSize = 256;
+
+		struct Node {
+			Rect4f bounds;
+			Handle parent = InvalidHandle; // Doubles as the free list link when the node isn't in use
+			Handle child0 = InvalidHandle;
+			Handle child1 = InvalidHandle;
+			int height = 0; // Leaves are 0, free nodes are -1
+			bool moved = false;
+
+			bool isLeaf() const { return child0 == InvalidHandle; }
+		};
+
+		float margin;
+		float displacementMultiplier;
+
+		Vector<Node> nodes;
+		Handle root = InvalidHandle;
+		Handle freeList = InvalidHandle;
+		size_t nElements = 0;
+		Vector<Handle> moved;
+
+		Handle allocateNode();
+		void freeNode(Handle idx);
+
+		void insertLeaf(Handle leaf);
+		void removeLeaf(Handle leaf);
+		Handle balance(Handle idx);
+		void refit(Handle idx);
+
+		static float getPerimeter(const Rect4f& rect);
+		static bool rayHitsBounds(Vector2f origin, Vector2f invDir, const Rect4f& bounds, float maxDistance);
+	};
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <gsl/gsl>
+#include "vector.h"
+#include "halley/maths/rect.h"
+#include "halley/maths/simd.h"
+
+namespace Halley {
+	// Bounding volume hierarchy over a fixed set of rectangles, built once and then queried.
+	// Each node holds the bounds of up to four children in SoA layout, so a query tests all of them in one SIMD pass.
+	class StaticBVH {
+	public:
+		using Index = uint32_t;
+
+		StaticBVH() = default;
+		explicit StaticBVH(gsl::span<const Rect4f> bounds);
+
+		void build(gsl::span<const Rect4f> bounds);
+		void clear();
+
+		[[nodiscard]] bool empty() const { return nodes.empty(); }
+		[[nodiscard]] size_t getNumNodes() const { return nodes.size(); }
+
+		// Visits the index of every element whose bounds are within maxDist of point, closest branches first.
+		// The visitor is called as float(Index idx, float maxDist) and returns the new maxDist, allowing the search to narrow as it goes.
+		// Elements are never culled if their bounds are at exactly maxDist, so callers can break ties themselves.
+		template <typename F>
+		void visitNearest(Vector2f point, float maxDist, F visitor) const
+		{
+			if (nodes.empty()) {
+				return;
+			}
+
+			float maxDist2 = maxDist * maxDist;
+			const auto px = SIMDVec4::loadSingleValue(point.x);
+			const auto py = SIMDVec4::loadSingleValue(point.y);
+			const auto zero = SIMDVec4::loadZero();
+
+			std::array<std::pair<int32_t, float>, StackSize> stack;
+			size_t stackSize = 0;
+			stack[stackSize++] = { 0, 0.0f };
+
+			while (stackSize > 0) {
+				const auto [nodeIdx, nodeDist2] = stack[--stackSize];
+				if (nodeDist2 > maxDist2) {
+					continue;
+				}
+
+				const auto& node = nodes[nodeIdx];
+				const auto dx = (SIMDVec4::loadAligned(node.minX.data()) - px).max(px - SIMDVec4::loadAligned(node.maxX.data())).max(zero);
+				const auto dy = (SIMDVec4::loadAligned(node.minY.data()) - py).max(py - SIMDVec4::loadAligned(node.maxY.data())).max(zero);
+				alignas(16) std::array<float, Width> dist2;
+				(dx * dx + dy * dy).storeAligned(dist2.data());
+
+				// Leaves are visited right away, branches are pushed farthest first so the closest one is popped next
+				std::array<std::pair<int32_t, float>, Width> branches;
+				size_t nBranches = 0;
+				for (size_t i = 0; i < Width; ++i) {
+					if (dist2[i] <= maxDist2) {
+						const auto child = node.child[i];
+						if (child == EmptySlot) {
+							continue;
+						}
+						if (child < 0) {
+							maxDist = visitor(static_cast<Index>(-(child + 1)), maxDist);
+							maxDist2 = maxDist * maxDist;
+						} else {
+							branches[nBranches++] = { child, dist2[i] };
+						}
+					}
+				}
+				std::sort(branches.begin(), branches.begin() + nBranches, [] (const auto& a, const auto& b) { return a.second > b.second; });
+				for (size_t i = 0; i < nBranches; ++i) {
+					Expects(stackSize < StackSize);
+					stack[stackSize++] = branches[i];
+				}
+			}
+		}
+
+		// Same as visitNearest, but for up to four points at once, walking the tree a single time for all of them.
+		// Each SIMD lane holds one point, so every child box is tested against all points in one pass.
+		// The visitor is called as float(size_t query, Index idx, float maxDist) and returns the new maxDist for that query.
+		// Elements are visited in a different order than visitNearest, but never culled while they're within maxDist of their query.
+		template <typename F>
+		void visitNearestPacket(gsl::span<const Vector2f> points, gsl::span<float> maxDists, F visitor) const
+		{
+			Expects(points.size() <= Width);
+			Expects(points.size() == maxDists.size());
+			if (nodes.empty() || points.empty()) {
+				return;
+			}
+
+			// Unused lanes get a negative range, so nothing ever passes for them
+			alignas(16) std::array<float, Width> xs = {};
+			alignas(16) std::array<float, Width> ys = {};
+			alignas(16) std::array<float, Width> laneMaxDist2;
+			laneMaxDist2.fill(-1.0f);
+			for (size_t i = 0; i < points.size(); ++i) {
+				xs[i] = points[i].x;
+				ys[i] = points[i].y;
+				laneMaxDist2[i] = maxDists[i] * maxDists[i];
+			}
+			const auto px = SIMDVec4::loadAligned(xs.data());
+			const auto py = SIMDVec4::loadAligned(ys.data());
+			const auto zero = SIMDVec4::loadZero();
+			auto maxDist2 = SIMDVec4::loadAligned(laneMaxDist2.data());
+
+			struct alignas(16) Entry {
+				std::array<float, Width> dist2;
+				int32_t node;
+			};
+			std::array<Entry, StackSize> stack;
+			size_t stackSize = 0;
+			stack[stackSize].dist2.fill(0.0f);
+			stack[stackSize++].node = 0;
+
+			while (stackSize > 0) {
+				const auto& top = stack[--stackSize];
+				if (SIMDVec4::loadAligned(top.dist2.data()).lessOrEqual(maxDist2).getMask() == 0) {
+					continue;
+				}
+
+				// Note that top gets overwritten by the branches pushed below
+				const auto& node = nodes[top.node];
+				std::array<std::pair<int32_t, float>, Width> branches;
+				std::array<std::array<float, Width>, Width> branchDist2;
+				size_t nBranches = 0;
+
+				for (size_t i = 0; i < Width; ++i) {
+					const auto dx = (SIMDVec4::loadSingleValue(node.minX[i]) - px).max(px - SIMDVec4::loadSingleValue(node.maxX[i])).max(zero);
+					const auto dy = (SIMDVec4::loadSingleValue(node.minY[i]) - py).max(py - SIMDVec4::loadSingleValue(node.maxY[i])).max(zero);
+					const auto dist2 = dx * dx + dy * dy;
+					const int mask = dist2.lessOrEqual(maxDist2).getMask();
+					if (mask == 0) {
+						continue;
+					}
+
+					const auto child = node.child[i];
+					if (child == EmptySlot) {
+						continue;
+					}
+					if (child < 0) {
+						for (size_t lane = 0; lane < points.size(); ++lane) {
+							if (mask & (1 << lane)) {
+								maxDists[lane] = visitor(lane, static_cast<Index>(-(child + 1)), maxDists[lane]);
+								laneMaxDist2[lane] = maxDists[lane] * maxDists[lane];
+							}
+						}
+						maxDist2 = SIMDVec4::loadAligned(laneMaxDist2.data());
+					} else {
+						alignas(16) std::array<float, Width> d;
+						dist2.storeAligned(d.data());
+						branchDist2[nBranches] = d;
+						branches[nBranches++] = { child, *std::min_element(d.begin(), d.begin() + points.size()) };
+					}
+				}
+
+				// Closest branch (to any of the points) is popped next
+				std::array<size_t, Width> order = { 0, 1, 2, 3 };
+				std::sort(order.begin(), order.begin() + nBranches, [&] (size_t a, size_t b) { return branches[a].second > branches[b].second; });
+				for (size_t i = 0; i < nBranches; ++i) {
+					Expects(stackSize < StackSize);
+					auto& entry = stack[stackSize++];
+					entry.node = branches[order[i]].first;
+					entry.dist2 = branchDist2[order[i]];
+				}
+			}
+		}
+
+		// Visits the index of every element whose bounds overlap rect (touching edges count as overlapping).
+		template <typename F>
+		void visitOverlapping(Rect4f rect, F visitor) const
+		{
+			if (nodes.empty()) {
+				return;
+			}
+
+			const auto left = SIMDVec4::loadSingleValue(rect.getLeft());
+			const auto right = SIMDVec4::loadSingleValue(rect.getRight());
+			const auto top = SIMDVec4::loadSingleValue(rect.getTop());
+			const auto bottom = SIMDVec4::loadSingleValue(rect.getBottom());
+
+			std::array<int32_t, StackSize> stack;
+			size_t stackSize = 0;
+			stack[stackSize++] = 0;
+
+			while (stackSize > 0) {
+				const auto& node = nodes[stack[--stackSize]];
+				const auto overlapX = SIMDVec4::loadAligned(node.minX.data()).lessOrEqual(right) & left.lessOrEqual(SIMDVec4::loadAligned(node.maxX.data()));
+				const auto overlapY = SIMDVec4::loadAligned(node.minY.data()).lessOrEqual(bottom) & top.lessOrEqual(SIMDVec4::loadAligned(node.maxY.data()));
+				const int mask = (overlapX & overlapY).getMask();
+
+				for (size_t i = 0; i < Width; ++i) {
+					if (mask & (1 << i)) {
+						const auto child = node.child[i];
+						if (child == EmptySlot) {
+							continue;
+						}
+						if (child < 0) {
+							visitor(static_cast<Index>(-(child + 1)));
+						} else {
+							Expects(stackSize < StackSize);
+							stack[stackSize++] = child;
+						}
+					}
+				}
+			}
+		}
+
+	private:
+		constexpr static size_t Width = 4;
+		constexpr static size_t StackSize = 256;
+		constexpr static int32_t EmptySlot = std::numeric_limits<int32_t>::min();
+
+		// Each child is either a node (child >= 0), an element (child < 0, element index is -(child + 1)) or unused (EmptySlot)
+		// Unused slots also get inverted infinite bounds, but those still pass tests against infinite distances or rects, so they're skipped explicitly
+		struct alignas(16) Node {
+			std::array<float, Width> minX;
+			std::array<float, Width> minY;
+			std::array<float, Width> maxX;
+			std::array<float, Width> maxY;
+			std::array<int32_t, Width> child;
+		};
+
+		struct BuildEntry {
+			Rect4f bounds;
+			Vector2f centre;
+			Index idx;
+		};
+
+		Vector<Node> nodes;
+
+		int32_t buildNode(gsl::span<BuildEntry> entries);
+		static Rect4f getBounds(gsl::span<const BuildEntry> entries);
+	};
+}
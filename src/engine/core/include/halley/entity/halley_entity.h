@@ -37,9 +37,12 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "halley/diagnostics/performance_stats.h"
 #include "halley/diagnostics/world_stats.h"
 
+#include "halley/scripting/script_data_program.h"
+#include "halley/scripting/script_data_value.h"
 #include "halley/scripting/script_environment.h"
 #include "halley/scripting/script_graph.h"
 #include "halley/scripting/script_node_type.h"
+#include "halley/scripting/script_parallel_updater.h"
 #include "halley/scripting/script_renderer.h"
 #include "halley/scripting/script_state.h"
 #include "halley/scripting/script_state_set.h"
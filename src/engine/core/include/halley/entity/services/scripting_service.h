@@ -12,6 +12,11 @@ namespace Halley {
 
 		ScriptEnvironment& getEnvironment() const;
 
+		// When enabled, ScriptSystem updates scripts that don't require the main thread on worker threads, see ScriptEnvironment::makeWorker
+		// Scripts updated that way should only modify their own entity
+		void setParallelUpdate(bool enabled);
+		bool isParallelUpdate() const;
+
 		ConfigNode evaluateExpression(const String& expression, bool useResultCache = false) const;
 		ConfigNode evaluateExpression(const LuaExpression& expression, bool useResultCache = false) const;
 		void clearResultCache();
@@ -38,6 +43,7 @@ namespace Halley {
 		HashMap<String, ConfigNode> globals;
 		String initialModule;
 		Resources& resources;
+		bool parallelUpdate = false;
 
 	    mutable HashMap<String, ConfigNode> resultCache;
 	};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "halley/api/halley_api.h"
+#include "halley/maths/vector2.h"
+#include <functional>
+#include <memory>
+#include <string_view>
+
+namespace Halley {
+	class Camera;
+	class MaterialDefinition;
+	class Painter;
+	class RenderContext;
+	class Resources;
+	class ScreenRenderTarget;
+	class Texture;
+
+	// Renders frames through the regular Painter path on the dummy video backend, without a window or a GPU
+	// Material definitions are generated with the layouts of the standard Halley materials, and any texture name resolves to a blank texture, so no imported assets are needed
+	class HeadlessRenderer {
+	public:
+		explicit HeadlessRenderer(Vector2i screenSize = Vector2i(1280, 720));
+		~HeadlessRenderer();
+
+		const HalleyAPI& getAPI() const;
+		Resources& getResources() const;
+		Painter& getPainter() const;
+		Camera& getCamera() const;
+
+		void render(const std::function<void(RenderContext&)>& f);
+
+	private:
+		std::shared_ptr<SystemAPIInternal> system;
+		std::shared_ptr<VideoAPIInternal> video;
+		HalleyAPI api{};
+		std::unique_ptr<Resources> resources;
+		std::unique_ptr<Painter> painter;
+		std::unique_ptr<ScreenRenderTarget> screenTarget;
+		std::unique_ptr<Camera> camera;
+
+		std::shared_ptr<MaterialDefinition> makeMaterialDefinition(std::string_view name) const;
+		std::shared_ptr<Texture> makeTexture(std::string_view name) const;
+	};
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include "halley/text/halleystring.h"
 #include "halley/graphics/texture.h"
@@ -45,7 +46,7 @@ namespace Halley
 	public:
 		MaterialDataBlock();
 		MaterialDataBlock(MaterialDataBlockType type, size_t size, int bindPoint, std::string_view name, const MaterialDefinition& def);
-		MaterialDataBlock(const MaterialDataBlock& other) = default;
+		MaterialDataBlock(const MaterialDataBlock& other);
 		MaterialDataBlock(MaterialDataBlock&& other) noexcept;
 
 		int getBindPoint() const { return bindPoint; }
@@ -53,8 +54,8 @@ namespace Halley
 		MaterialDataBlockType getType() const { return dataBlockType; }
 		uint64_t getHash() const;
 
-		MaterialDataBlock& operator=(const MaterialDataBlock& other) = default;
-		MaterialDataBlock& operator=(MaterialDataBlock&& other) = default;
+		MaterialDataBlock& operator=(const MaterialDataBlock& other);
+		MaterialDataBlock& operator=(MaterialDataBlock&& other) noexcept;
 
 		bool operator==(const MaterialDataBlock& other) const;
 		bool operator!=(const MaterialDataBlock& other) const;
@@ -62,7 +63,7 @@ namespace Halley
 	private:
 		Bytes data;
 		MaterialDataBlockType dataBlockType = MaterialDataBlockType::Local;
-		mutable bool needToUpdateHash = true;
+		mutable std::atomic<bool> needToUpdateHash = true;
 		int16_t bindPoint = 0;
 		mutable uint64_t hash = 0;
 
@@ -81,9 +82,6 @@ namespace Halley
 		explicit Material(std::shared_ptr<const MaterialDefinition> materialDefinition, bool forceLocalBlocks = false); // forceLocalBlocks is for engine use only
 		~Material();
 
-		void bind(int pass, Painter& painter) const;
-		static void resetBindCache();
-
 		bool operator==(const Material& material) const;
 		bool operator!=(const Material& material) const;
 
@@ -137,19 +135,24 @@ namespace Halley
 
 		uint64_t getPartialHash() const; // Not including textures
 		uint64_t getFullHash() const; // Including textures
+		uint64_t getStateHash() const; // Everything but uniform data, i.e. what binding a pass depends on
+		uint64_t getSortKey() const; // Orders by shader, then textures, then uniform data, so sorted draws switch the costliest state least
+		// Hashes are computed lazily, but it's safe for several threads to read them at once (e.g. while recording PainterCommandLists)
 
 		const String& getTexUnitAssetId(int texUnit) const;
 
 	private:
 		std::shared_ptr<const MaterialDefinition> materialDefinition;
 		
-		mutable bool needToUpdateHash = true;
+		mutable std::atomic<bool> needToUpdateHash = true;
 		bool forceLocalBlocks = false;
 		bool depthStencilEnabled = true;
 		std::optional<uint8_t> stencilReferenceOverride;
 		std::bitset<8> passEnabled;
 		mutable uint64_t fullHashValue = 0;
 		mutable uint64_t partialHashValue = 0;
+		mutable uint64_t stateHashValue = 0;
+		mutable uint64_t sortKeyValue = 0;
 		
 		Vector<MaterialDataBlock, std::allocator<MaterialDataBlock>, 2 * sizeof(MaterialDataBlock)> dataBlocks;
 		Vector<std::shared_ptr<const Texture>, std::allocator<std::shared_ptr<const Texture>>, 4 * sizeof(std::shared_ptr<const Texture>)> textures;
@@ -162,6 +165,7 @@ namespace Halley
 
 		bool setUniform(int blockNumber, size_t offset, ShaderParameterType type, const void* data);
 		bool isUniformEqualTo(int blockNumber, size_t offset, ShaderParameterType type, const void* data) const;
+		void updateHashes() const;
 		void computeHashes() const;
 
 		const std::shared_ptr<const Texture>& getFallbackTexture() const;
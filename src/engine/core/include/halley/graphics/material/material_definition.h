@@ -255,6 +255,7 @@ namespace Halley
 		size_t getVertexSize() const;
 		size_t getVertexStride() const;
 		size_t getVertexPosOffset() const;
+		bool hasVertexPos() const;
 
 		void setAttributes(Vector<MaterialAttribute> attributes);
 		const Vector<MaterialAttribute>& getAttributes() const { return attributes; }
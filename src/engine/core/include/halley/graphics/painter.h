@@ -4,6 +4,7 @@
 #include "halley/maths/colour.h"
 #include "graphics_enums.h"
 #include <condition_variable>
+#include <functional>
 #include <halley/maths/vector4.h>
 
 
@@ -29,13 +30,15 @@ namespace Halley
 	class MaterialDefinition;
 	class Camera;
 	class RenderContext;
+	class StreamingBuffer;
 	class Core;
 
 	class Painter
 	{
 		friend class RenderContext;
 		friend class Core;
-		friend class Material;
+		friend class HeadlessRenderer;
+		friend class PainterCommandList;
 		friend class RenderSnapshot;
 
 		struct PainterVertexData
@@ -84,8 +87,14 @@ namespace Halley
 
 		// Draw sprites takes a single vertex per sprite, duplicates the data across multiple vertices, and draws
 		// vertPosOffset is the offset, in bytes, from the start of each vertex's data, to a Vector2f which will be filled with the vertex's position in 0-1 space.
+		// If the backend supports instancing, each sprite's data is instead uploaded once, and the corners come from a static unit quad
 		void drawSprites(const std::shared_ptr<const Material>& material, size_t numSprites, const void* vertexData);
 
+		// Same, but writeSprites fills in the sprites' data straight into the painter's buffers, instead of the painter copying it
+		// It's called as writeSprites(start, end, dst, spriteStride), with sprite i (from start) at dst + (i - start) * spriteStride, and may be called more than once
+		using SpriteWriter = std::function<void(size_t start, size_t end, char* dst, size_t spriteStride)>;
+		void drawSprites(const std::shared_ptr<const Material>& material, size_t numSprites, const SpriteWriter& writeSprites);
+
 		// Draw one sliced sprite. Slices -> x = left, y = top, z = right, w = bottom, in [0..1] space relative to the texture
 		void drawSlicedSprite(const std::shared_ptr<const Material>& material, Vector2f scale, Vector4f slices, const void* vertexData);
 
@@ -118,9 +127,23 @@ namespace Halley
 		size_t getNumVertices() const { return nVertices; }
 		size_t getNumTriangles() const { return nTriangles; }
 
+		size_t getNumBytesUploaded() const { return nBytesUploaded; }
+
 		size_t getPrevDrawCalls() const { return prevDrawCalls; }
 		size_t getPrevVertices() const { return prevVertices; }
 		size_t getPrevTriangles() const { return prevTriangles; }
+		size_t getPrevBytesUploaded() const { return prevBytesUploaded; }
+
+		// Bytes written straight into the backend's streaming buffers, out of the total uploaded
+		size_t getNumBytesStreamed() const { return nBytesStreamed; }
+		size_t getPrevBytesStreamed() const { return prevBytesStreamed; }
+
+		// Material passes and uniform data that weren't sent to the backend, as they matched what was already bound
+		size_t getNumBindsAvoided() const { return nBindsAvoided; }
+		size_t getPrevBindsAvoided() const { return prevBindsAvoided; }
+
+		void setInstancingEnabled(bool enabled);
+		bool isInstancingEnabled() const;
 
 		void setLogging(bool logging);
 
@@ -136,6 +159,22 @@ namespace Halley
 		virtual void setVertices(const MaterialDefinition& material, size_t numVertices, const void* vertexData, size_t numIndices, const IndexType* indices, bool standardQuadsOnly) = 0;
 		virtual void drawTriangles(size_t numIndices) = 0;
 
+		// Instanced quads: the material's vertPos attribute reads from a static unit quad, and every other attribute advances once per instance
+		virtual bool supportsInstancing() const { return false; }
+		virtual void setInstances(const MaterialDefinition& material, size_t numInstances, const void* instanceData) {}
+		virtual void drawInstancedQuads(size_t numInstances) {}
+
+		// Streaming: if the backend returns memory here, draw data is written straight into it, as a ring of streamRegions per-frame regions
+		// Draws from that memory then come through setStreamed* instead of setVertices/setInstances, with offsets into it
+		// Regions are fenced when their frame ends, and waited on before being written again; backends without persistent mapping can just upload each range
+		constexpr static size_t streamRegions = 3;
+		virtual gsl::span<char> getVertexStreamMemory() { return {}; }
+		virtual gsl::span<char> getIndexStreamMemory() { return {}; }
+		virtual void setStreamedVertices(const MaterialDefinition& material, size_t numVertices, size_t vertexOffset, size_t numIndices, size_t indexOffset, bool standardQuadsOnly) {}
+		virtual void setStreamedInstances(const MaterialDefinition& material, size_t numInstances, size_t offset) {}
+		virtual void waitForStreamRegion(size_t region) {}
+		virtual void fenceStreamRegion(size_t region) {}
+
 		virtual void doClear(std::optional<Colour> colour, std::optional<float> depth = 1.0f, std::optional<uint8_t> stencil = 0) = 0;
 
 		virtual void setMaterialPass(const Material& material, int pass) = 0;
@@ -172,6 +211,14 @@ namespace Halley
 			std::shared_ptr<MaterialConstantBuffer> buffer;
 			int age = 0;
 		};
+
+		// What was last sent to the backend, reset whenever something else (clip, target, projection...) might have changed its state
+		struct BindCache {
+			const MaterialDefinition* definition = nullptr;
+			int pass = -1;
+			uint64_t stateHash = 0;
+			std::optional<uint64_t> dataHash;
+		};
 		
 		Resources& resources;
 		VideoAPI& video;
@@ -184,9 +231,13 @@ namespace Halley
 		size_t verticesPending = 0;
 		size_t bytesPending = 0;
 		size_t indicesPending = 0;
+		size_t instancesPending = 0;
 		bool allIndicesAreQuads = true;
+		bool pendingInStream = false;
 		Vector<char> vertexBuffer;
 		Vector<IndexType> indexBuffer;
+		std::unique_ptr<StreamingBuffer> vertexStream;
+		std::unique_ptr<StreamingBuffer> indexStream;
 		std::shared_ptr<const Material> materialPending;
 		std::shared_ptr<const Material> solidLineMaterial;
 		std::shared_ptr<const Material> solidPolygonMaterial;
@@ -199,7 +250,14 @@ namespace Halley
 		size_t prevDrawCalls = 0;
 		size_t prevVertices = 0;
 		size_t prevTriangles = 0;
+		size_t nBytesUploaded = 0;
+		size_t prevBytesUploaded = 0;
+		size_t nBytesStreamed = 0;
+		size_t prevBytesStreamed = 0;
+		size_t nBindsAvoided = 0;
+		size_t prevBindsAvoided = 0;
 		bool logging = true;
+		bool instancingEnabled = true;
 
 		Vector<IndexType> stdQuadIndexCache;
 		std::optional<Rect4i> curClip;
@@ -209,9 +267,11 @@ namespace Halley
 		Vector<String> pendingDebugGroupStack;
 
 		HashMap<uint64_t, ConstantBufferEntry> constantBuffers;
+		BindCache bindCache;
 
 		RenderSnapshot* recordingSnapshot = nullptr;
 		bool recordingPerformance = false;
+		bool deferred = false; // Commands only go to recordingSnapshot, see PainterCommandList
 		uint64_t frameStart, frameEnd;
 		std::chrono::steady_clock::time_point frameStartCPUTime;
 
@@ -226,11 +286,21 @@ namespace Halley
 		void resetPending();
 		void startDrawCall(const std::shared_ptr<const Material>& material);
 		void flushPending();
-		void executeDrawPrimitives(const Material& material, size_t numVertices, gsl::span<const char> vertexData, gsl::span<const IndexType> indices, PrimitiveType primitiveType, bool allIndicesAreQuads);
+		void executeDrawPrimitives(const std::shared_ptr<const Material>& material, size_t numVertices, gsl::span<const char> vertexData, gsl::span<const IndexType> indices, PrimitiveType primitiveType, bool allIndicesAreQuads);
+		void executeDrawInstancedQuads(const std::shared_ptr<const Material>& material, size_t numInstances, gsl::span<const char> instanceData);
 
+		void makeSpaceForPending(size_t numBytes, size_t numIndices);
 		void makeSpaceForPendingVertices(size_t numBytes);
 		void makeSpaceForPendingIndices(size_t numIndices);
+		char* getPendingVertices();
+		IndexType* getPendingIndices();
 		PainterVertexData addDrawData(const std::shared_ptr<const Material>& material, size_t numVertices, size_t numIndices, bool standardQuadsOnly);
+		char* addInstanceData(const std::shared_ptr<const Material>& material, size_t numInstances);
+		bool canDrawInstanced(const MaterialDefinition& material) const;
+
+		void bindMaterialPass(const Material& material, int pass);
+		void bindMaterialData(const Material& material);
+		void resetBindCache();
 
 		IndexType* getStandardQuadIndices(size_t numQuads);
 		void generateQuadIndicesOffset(IndexType firstVertex, IndexType lineStride, IndexType* target);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "render_snapshot.h"
+#include <functional>
+#include <memory>
+
+namespace Halley {
+	class Painter;
+	class RenderContext;
+
+	// Records drawing away from the render thread, to be replayed on it later, e.g. so each camera of a split-screen can build its draw data in parallel
+	// Commands are stored in the same format as RenderSnapshot, and all the batching and vertex generation happens while recording
+	// Recording only writes to the list itself, so any number of lists can be recorded at once, as long as each list stays on one thread at a time
+	// Whatever is drawn is shared between threads, so don't modify materials (or anything else being drawn) while lists are recording
+	class PainterCommandList {
+	public:
+		// The list is meant to be replayed on painter, which is used here for its resources and to check what it supports
+		explicit PainterCommandList(Painter& painter);
+		~PainterCommandList();
+
+		PainterCommandList(const PainterCommandList& other) = delete;
+		PainterCommandList& operator=(const PainterCommandList& other) = delete;
+
+		// Replaces the contents of the list with everything drawn by f, which gets a context like the one given, but recording here
+		void record(const RenderContext& context, const std::function<void(RenderContext&)>& f);
+
+		// Must be called on the render thread, usually with lists replayed in a fixed order each frame
+		void replay(Painter& painter) const;
+
+		void clear();
+		size_t getNumCommands() const;
+		bool isEmpty() const;
+
+	private:
+		Painter& target;
+		std::unique_ptr<Painter> painter;
+		RenderSnapshot commands;
+	};
+}
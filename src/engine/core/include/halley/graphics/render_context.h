@@ -10,6 +10,8 @@ namespace Halley
 	class RenderContext
 	{
 		friend class Core;
+		friend class HeadlessRenderer;
+		friend class PainterCommandList;
 		friend class RenderSnapshot;
 
 	public:
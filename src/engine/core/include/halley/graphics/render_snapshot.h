@@ -80,11 +80,13 @@ namespace Halley {
         void end();
 
         void bind(RenderContext& context);
-        void unbind(RenderContext& context);
+        void bind(const Camera& camera, RenderTarget& renderTarget);
+        void unbind();
 
         void setClip(Rect4i rect, bool enable);
     	void clear(std::optional<Colour4f> colour, std::optional<float> depth, std::optional<uint8_t> stencil);
-	    void draw(const Material& material, size_t numVertices, gsl::span<const char> vertexData, gsl::span<const IndexType> indices, PrimitiveType primitive, bool allIndicesAreQuads);
+	    void draw(std::shared_ptr<const Material> material, size_t numVertices, gsl::span<const char> vertexData, gsl::span<const IndexType> indices, PrimitiveType primitive, bool allIndicesAreQuads);
+	    void drawInstancedQuads(std::shared_ptr<const Material> material, size_t numInstances, gsl::span<const char> instanceData);
 
         void finish();
 
@@ -93,6 +95,10 @@ namespace Halley {
 
         PlaybackResult playback(Painter& painter, std::optional<size_t> maxCommands, TargetBufferType blitType = TargetBufferType::Colour, std::shared_ptr<const MaterialDefinition> debugMaterial = {}) const;
 
+        // Issues every command on painter as it was recorded, then restores whatever painter had bound
+        // Unlike playback(), this is part of the frame, so it's seen by any snapshot that painter is recording
+        void replay(Painter& painter) const;
+
         void addPendingTimestamp() override;
         void onTimestamp(TimestampType type, size_t idx, uint64_t value) override;
 
@@ -113,13 +119,15 @@ namespace Halley {
         };
 
         struct DrawData {
-            const Material* materialTemp;
-            std::shared_ptr<Material> material;
-            size_t numVertices;
-            Vector<char> vertexData;
-            Vector<IndexType> indices;
+            std::shared_ptr<const Material> material;
+            size_t numVertices; // Number of instances, if instanced
+            size_t vertexDataStart;
+            size_t vertexDataSize;
+            size_t indicesStart;
+            size_t numIndices;
             PrimitiveType primitive;
             bool allIndicesAreQuads;
+            bool instanced;
         };
 
         Vector<Vector<std::pair<CommandType, uint16_t>>> commands;
@@ -127,6 +135,8 @@ namespace Halley {
         Vector<SetClipData> setClipDatas;
         Vector<ClearData> clearDatas;
         Vector<DrawData> drawDatas;
+        Vector<char> vertexData;
+        Vector<IndexType> indexData;
 
     	std::atomic<int> pendingTimestamps;
         uint64_t startTime = 0;
@@ -141,5 +151,8 @@ namespace Halley {
         void playClear(Painter& painter, const ClearData& data) const;
         void playSetClip(Painter& painter, const SetClipData& data) const;
         void playDraw(Painter& painter, const DrawData& data, std::shared_ptr<const MaterialDefinition> debugMaterial) const;
+
+        gsl::span<const char> getVertexData(const DrawData& data) const;
+        gsl::span<const IndexType> getIndices(const DrawData& data) const;
     };
 }
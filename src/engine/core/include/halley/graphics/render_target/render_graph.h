@@ -21,12 +21,27 @@ namespace Halley {
 	class RenderGraphNode;
 
 	class RenderGraph {
+		friend class RenderGraphNode;
+
 	public:
 		using PaintMethod = std::function<void(Painter&)>;
 		using DrawCallback = std::function<void(SpriteMaskBase, Painter&)>;
 
+		struct RenderStats {
+			size_t nodes = 0;
+			size_t culledNodes = 0; // Not reaching any output, so never rendered
+			size_t passes = 0; // Nodes rendered
+			size_t parallelPasses = 0; // Nodes recorded on worker threads, then replayed in order
+			size_t waves = 0; // Groups of nodes that don't depend on each other
+			size_t targetsCreated = 0; // Textures (re)allocated this frame
+			size_t transientTargets = 0; // Targets taken from the transient pool
+			size_t transientTextures = 0; // Textures in the pool, shared between those targets
+			size_t transientBytes = 0;
+		};
+
 		RenderGraph();
 		explicit RenderGraph(std::shared_ptr<const RenderGraphDefinition> graphDefinition);
+		~RenderGraph();
 
 		void update();
 		void render(const RenderContext& rc, VideoAPI& video, std::optional<Vector2i> renderSize = {});
@@ -62,6 +77,16 @@ namespace Halley {
 
 		void resetGraph();
 
+		// Targets cleared by their node don't carry anything over, so nodes that aren't alive at the same time can share them
+		// Anything reaching a renderToTexture node is kept, as it can be read after the graph is done
+		void setTargetAliasing(bool enabled);
+
+		// Nodes that don't depend on each other record their draws on the CPU executors, and are then replayed in order
+		// Paint methods and the draw callback will be called from several threads at once, so only enable this if they're safe for it
+		void setParallelRecording(bool enabled);
+
+		const RenderStats& getRenderStats() const;
+
 	private:
 		enum class VariableType {
 			None,
@@ -87,6 +112,13 @@ namespace Halley {
 			mutable std::unique_ptr<Image> image;
 			std::function<void(Image&)> calllback;
 		};
+
+		struct TransientTexture {
+			std::shared_ptr<Texture> texture;
+			RenderGraphElementType type;
+			bool inUse = false;
+			bool usedThisFrame = false;
+		};
 		
 		Vector<std::unique_ptr<RenderGraphNode>> nodes;
 		std::map<GraphNodeId, RenderGraphNode*> nodeMap;
@@ -103,11 +135,24 @@ namespace Halley {
 		std::shared_ptr<const RenderGraphDefinition> graphDefinition;
 		int lastDefinitionVersion = 0;
 
+		bool targetAliasing = true;
+		bool parallelRecording = false;
+		Vector<TransientTexture> transientTextures;
+		RenderStats stats;
+
 		void addNode(GraphNodeId id, std::unique_ptr<RenderGraphNode> node);
 		RenderGraphNode* getNode(GraphNodeId id);
 		RenderGraphNode* tryGetNode(const String& id);
 
 		void loadDefinition(std::shared_ptr<const RenderGraphDefinition> definition);
+
+		void renderWave(const Vector<RenderGraphNode*>& wave, const RenderContext& rc, VideoAPI& video);
+		bool canRecordInParallel() const;
+
+		std::shared_ptr<Texture> acquireTransientTexture(VideoAPI& video, Vector2i size, RenderGraphElementType type);
+		void releaseTransientTextures(const RenderGraphNode& node);
+		bool isTextureNeeded(const std::shared_ptr<Texture>& texture) const;
+		void trimTransientTextures();
 	};
 
 
@@ -15,12 +15,14 @@ namespace Halley {
 	class Texture;
 	class RenderGraph;
 	class TextureRenderTarget;
+	class PainterCommandList;
 	
 	class RenderGraphNode {
 		friend class RenderGraph;
 	
 	public:
 		explicit RenderGraphNode(const RenderGraphNodeDefinition& definition);
+		~RenderGraphNode();
 
 	private:
 		struct OtherPin {
@@ -50,17 +52,20 @@ namespace Halley {
 		void startRender();
 		void prepareDependencyGraph(VideoAPI& video, std::optional<Vector2i> targetSize);
 		void prepareInputPin(InputPin& pin, VideoAPI& video, Vector2i targetSize);
-		void prepareTextures(VideoAPI& video, const RenderContext& rc);
-		
-		void render(const RenderGraph& graph, VideoAPI& video, const RenderContext& rc, Vector<RenderGraphNode*>& renderQueue);
+		void prepareTextures(RenderGraph& graph, VideoAPI& video, const RenderContext& rc);
 		void notifyOutputs(Vector<RenderGraphNode*>& renderQueue);
 
 		void resetTextures();
 		std::shared_ptr<Texture> makeTexture(VideoAPI& video, RenderGraphElementType type);
 		void updateTexture(std::shared_ptr<Texture> texture, RenderGraphElementType type);
+		static std::shared_ptr<Texture> createTexture(VideoAPI& video, Vector2i size, RenderGraphElementType type, const String& assetId);
 
 		void determineIfCanForwardRenderTarget();
 		void determineIfNeedsRenderTarget();
+		void determineIfTargetsAreTransient(bool aliasingEnabled);
+		bool isTransient(RenderGraphElementType type) const;
+		bool reachesPersistentNode() const;
+		bool canRecord() const;
 		
 		void renderNode(const RenderGraph& graph, const RenderContext& rc);
 		void renderNodePaintMethod(const RenderGraph& graph, const RenderContext& rc);
@@ -85,6 +90,7 @@ namespace Halley {
 		Vector<Variable> variables;
 		
 		bool activeInCurrentPass = false;
+		bool renderedInCurrentPass = false;
 		int depsLeft = 0;
 		Vector2i currentSize;
 
@@ -95,5 +101,8 @@ namespace Halley {
 		bool canForwardRenderTarget = false;
 		std::shared_ptr<TextureRenderTarget> renderTarget;
 		RenderGraphNode* reuseRenderTarget = nullptr;
+		bool transientTargets = false;
+
+		std::unique_ptr<PainterCommandList> commandList;
 	};
 }
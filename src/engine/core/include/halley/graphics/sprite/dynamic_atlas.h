@@ -0,0 +1,86 @@
+#pragma once
+
+#include "halley/data_structures/hash_map.h"
+#include "halley/data_structures/vector.h"
+#include "halley/maths/rect.h"
+#include "halley/text/halleystring.h"
+#include <memory>
+#include <optional>
+
+namespace Halley
+{
+	class Image;
+	class Material;
+	class MaterialDefinition;
+	class Sprite;
+	class Texture;
+	class VideoAPI;
+
+	// Packs small images created at runtime (icons, portraits, rendered text...) into shared texture pages, so sprites using them can share a material and batch
+	// Images go into the free space left on a page, and only the area they cover is uploaded to its texture
+	// A page is only repacked when it's too fragmented to fit a new image, and the least recently used images are evicted once all pages are full
+	// Pages with images already handed to sprites this frame are only repacked in update(), so sprites need to go through setSprite every frame they're drawn
+	class DynamicAtlas
+	{
+	public:
+		DynamicAtlas(VideoAPI& video, std::shared_ptr<const MaterialDefinition> materialDefinition, Vector2i pageSize = Vector2i(1024, 1024), size_t maxPages = 4, int padding = 1);
+		~DynamicAtlas();
+
+		DynamicAtlas(const DynamicAtlas& other) = delete;
+		DynamicAtlas& operator=(const DynamicAtlas& other) = delete;
+
+		// Adds an RGBA image, or replaces the one with the same id. Packing only happens on the next setSprite or update, so add a frame's worth of images first
+		void add(const String& id, const Image& image);
+		void remove(const String& id);
+		bool contains(const String& id) const;
+
+		// Points the sprite at the image's page and area, and counts it as used this frame
+		// Returns false if the image isn't in the atlas (never added, evicted, or too big for a page), in which case it needs adding again or its own texture
+		bool setSprite(Sprite& sprite, const String& id, bool applySize = true);
+
+		// Call once per frame, after sprites from setSprite are drawn
+		void update();
+
+		size_t getNumPages() const;
+		size_t getNumImages() const;
+		size_t getNumEvicted() const;
+
+	private:
+		struct Entry {
+			size_t page = 0;
+			Rect4i rect; // Including padding
+			uint64_t lastUsed = 0;
+			std::shared_ptr<Image> pending;
+		};
+
+		struct Page {
+			std::unique_ptr<Image> image;
+			std::shared_ptr<Texture> texture;
+			std::shared_ptr<Material> material;
+			Vector<Rect4i> freeRects;
+			std::optional<Rect4i> dirtyRect;
+
+			void markDirty(Rect4i rect);
+		};
+
+		VideoAPI& video;
+		std::shared_ptr<const MaterialDefinition> materialDefinition;
+		Vector2i pageSize;
+		size_t maxPages;
+		int padding;
+
+		HashMap<String, Entry> entries;
+		Vector<Page> pages;
+		Vector<String> pending;
+		Vector<String> deferred; // Only fit by repacking pages in use this frame, so placed on update()
+		uint64_t curFrame = 1;
+		size_t nEvicted = 0;
+
+		void packPending(bool frameDone);
+		bool tryPlace(size_t pageIdx, const String& id, bool frameDone);
+		bool repack(size_t pageIdx, const String& id, bool frameDone);
+		bool evictLeastRecentlyUsed();
+		void release(const Entry& entry);
+		void uploadPage(Page& page);
+	};
+}
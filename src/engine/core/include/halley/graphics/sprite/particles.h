@@ -13,6 +13,7 @@ namespace Halley {
 	class Polygon;
 	class Random;
 	class Animation;
+	class Painter;
 
 	enum class ParticleSpawnAreaShape : uint8_t {
 		Rectangle,
@@ -36,14 +37,28 @@ namespace Halley {
 	};
 	
 	class Particles {
-		struct Particle {
-			Vector3f pos;
-			Vector3f vel;
-			float scale = 1;
-			float time = 0;
-			float ttl = 1;
-			bool alive = true;
-			bool firstFrame = true;
+		// Structure of arrays, so particles can be updated four at a time with SIMD
+		struct ParticleData {
+			Vector<float> posX;
+			Vector<float> posY;
+			Vector<float> posZ;
+			Vector<float> velX;
+			Vector<float> velY;
+			Vector<float> velZ;
+			Vector<float> scale;
+			Vector<float> time;
+			Vector<float> ttl;
+			Vector<uint8_t> alive;
+			Vector<uint16_t> spriteIdx; // Index into baseSprites, only used when drawing directly
+
+			size_t size() const { return time.size(); }
+			void resize(size_t size);
+			void swap(size_t a, size_t b);
+
+			Vector3f getPos(size_t i) const { return Vector3f(posX[i], posY[i], posZ[i]); }
+			void setPos(size_t i, Vector3f pos) { posX[i] = pos.x; posY[i] = pos.y; posZ[i] = pos.z; }
+			Vector3f getVel(size_t i) const { return Vector3f(velX[i], velY[i], velZ[i]); }
+			void setVel(size_t i, Vector3f vel) { velX[i] = vel.x; velY[i] = vel.y; velZ[i] = vel.z; }
 		};
 		
 	public:
@@ -100,6 +115,13 @@ namespace Halley {
 		void setSprites(Vector<Sprite> sprites);
 		void setAnimation(std::shared_ptr<const Animation> animation);
 
+		// When direct draw is enabled (and possible, i.e. not animated, and all base sprites share the same material and aren't sliced),
+		// particles don't keep a Sprite each, and draw() writes their vertices straight from the particle state.
+		// getSprites() is empty in that case, so the emitter should be drawn with draw(), or added with SpritePainter::add(const Particles&, ...).
+		void setDirectDraw(bool enabled);
+		bool isDirectDraw() const;
+		void draw(Painter& painter) const;
+
 		bool isAnimated() const;
 		bool isAlive() const;
 		
@@ -123,12 +145,13 @@ namespace Halley {
 		float spawnRateMultiplier = 1.0f;
 		float speedMultiplier = 1.0f;
 
-		Vector<Sprite> sprites;
-		Vector<Particle> particles;
+		Vector<Sprite> sprites; // Not used when drawing directly
+		ParticleData particles;
 		Vector<AnimationPlayerLite> animationPlayers;
 		
 		size_t nParticlesAlive = 0;
 		size_t nParticlesVisible = 0;
+		size_t nParticlesStarted = 0; // Particles past this index were spawned since the last update, and haven't moved yet
 		float pendingSpawn = 0;
 
 		float spawnRate = 100;
@@ -153,6 +176,8 @@ namespace Halley {
 		bool destroyWhenDone = false;
 		bool positionSet = false;
 		bool relativePosition = false;
+		bool directDraw = false;
+		bool directDrawActive = false;
 		std::optional<int> maxParticles;
 		std::optional<int> burst;
 		std::optional<float> minHeight;
@@ -170,13 +195,19 @@ namespace Halley {
 
 		void start();
 		void initializeParticle(size_t index, float time, float totalTime);
+		void initializeSprite(size_t index, std::optional<size_t> baseSpriteIdx);
 		void updateParticles(float t);
+		void updateParticleRange(size_t start, size_t end, float t);
+		void updateSpriteRange(size_t start, size_t end);
+		void updateDirectDraw();
+		void writeVertexAttribs(size_t start, size_t end, char* dst, size_t stride) const;
+		void writeSpriteAttribs(size_t index, SpriteVertexAttrib& attrib) const;
 		void removeDeadParticles();
 		void spawn(size_t n, float time);
 
 		Vector3f getSpawnPosition() const;
 
-		void onSecondarySpawn(const Particle& particle, EntityId target);
+		void onSecondarySpawn(size_t index, EntityId target);
 
 		float getSpriteBorder(const Sprite& sprite) const;
 		void computeMaxBorder() const;
@@ -148,6 +148,9 @@ namespace Halley
 		Sprite& setCustom3(Vector4f custom3) { vertexAttrib.custom3 = custom3; return *this; }
 		Vector4f getCustom3() const { return vertexAttrib.custom3; }
 		Vector4f& getCustom3() { return vertexAttrib.custom3; }
+		const SpriteVertexAttrib& getVertexAttributes() const { return vertexAttrib; }
+		// For code that fills in many sprites at once (e.g. particles). Changing rotation this way doesn't update the bounds, use setRotation for that.
+		SpriteVertexAttrib& getMutableVertexAttributes() { return vertexAttrib; }
 
 		Sprite& setSliced(Vector4s slices);
 		Sprite& setNotSliced();
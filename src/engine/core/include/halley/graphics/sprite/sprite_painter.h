@@ -4,6 +4,7 @@
 #include <cstddef>
 #include "halley/maths/rect.h"
 #include <limits>
+#include <mutex>
 #include <optional>
 
 #include "ipainter.h"
@@ -19,6 +20,9 @@ namespace Halley
 	class Sprite;
 	class Painter;
 	class Material;
+	class Texture;
+	class TextureStreamer;
+	class Particles;
 
 	enum class SpritePainterEntryType
 	{
@@ -45,10 +49,12 @@ namespace Halley
 		uint32_t getIndex() const;
 		uint32_t getCount() const;
 		int getMask() const;
+		int getLayer() const;
 		const std::optional<Rect4f>& getClip() const;
 
 		Rect4f getBounds(const Rect4f& view, const Vector<Sprite>& cachedSprites, const Vector<TextRenderer>& cachedText) const;
-		bool isCompatibleWith(const SpritePainterEntry& other, const Vector<Sprite>& cachedSprites, const Vector<TextRenderer>& cachedText) const;
+		uint64_t getSortKey(const Vector<Sprite>& cachedSprites, const Vector<TextRenderer>& cachedText) const; // Material sort key of the first element, 0 if it has none
+		bool isCompatibleWith(const SpritePainterEntry& other, uint64_t sortKey, uint64_t otherSortKey, const Vector<Sprite>& cachedSprites, const Vector<TextRenderer>& cachedText) const; // Sort keys are used as a prefilter
 
 	private:
 		const void* ptr = nullptr;
@@ -102,9 +108,19 @@ namespace Halley
 		void add(const TextRenderer& sprite, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip = {});
 		void add(TextRenderer&& text, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip = {});
 		void addCopy(const TextRenderer& text, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip = {});
+		void add(gsl::span<const TextRenderer> texts, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip = {});
+		void addCopy(gsl::span<const TextRenderer> texts, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip = {});
 		void add(SpritePainterEntry::Callback callback, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip = {});
+		// Emitters drawing directly are added as a single entry that writes their vertices, otherwise this is the same as adding their sprites
+		// Like sprite spans, the emitter is referenced, so it must outlive draw()
+		void add(const Particles& particles, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip = {});
 		void add(Rect4f bounds);
 
+		// Draws on an unordered layer don't depend on each other's order (e.g. opaque or additive ones), so they're sorted by material instead of tie breaker
+		// Callbacks still keep their place, as nothing is known about what they draw
+		void setLayerUnordered(int layer, bool unordered = true);
+		bool isLayerUnordered(int layer) const;
+
 		void draw(SpriteMaskBase mask, Painter& painter) override;
 		std::optional<Rect4f> getBounds() const;
 
@@ -116,18 +132,28 @@ namespace Halley
 		Vector<TextRenderer> cachedText;
 		Vector<SpritePainterEntry::Callback> callbacks;
 		Vector<Rect4f> extraBounds;
+		Vector<int> unorderedLayers;
 		bool dirty = false;
 		bool forceCopy = false;
 		bool waitForSpriteLoad = true;
 		SpritePainterMaterialParamUpdater paramUpdater;
+		TextureStreamer* textureStreamer = nullptr;
 
+		// Render graph nodes sharing this painter can be recorded in parallel, so sorting, ordering (which uses memoryPool) and text are drawn under this
+		std::mutex drawMutex;
 		mutable TempMemoryPool memoryPool;
 
-		void draw(gsl::span<const Sprite> sprite, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const;
+		// Lowest mip level each texture was drawn at, gathered during a draw and only then reported to the streamer
+		using MipUsage = HashMap<const Texture*, int>;
+
+		void draw(gsl::span<const Sprite> sprite, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip, MipUsage* mipUsage) const;
 		void draw(gsl::span<const TextRenderer> text, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const;
 		void draw(const SpritePainterEntry::Callback& callback, Painter& painter, const std::optional<Rect4f>& clip) const;
+		static void recordMipUsage(MipUsage& mipUsage, const Texture* texture, int level);
+		void reportMipUsage(const MipUsage& mipUsage) const;
 
 		Vector<uint32_t> getSpriteDrawOrder(int mask, Rect4f view, bool reorder) const;
 		Vector<uint32_t> getSpriteDrawOrderReordered(int mask, Rect4f view) const;
+		void sortUnorderedLayers();
 	};
 }
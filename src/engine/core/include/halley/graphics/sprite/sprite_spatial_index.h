@@ -0,0 +1,71 @@
+#pragma once
+
+#include "sprite.h"
+#include "halley/data_structures/dynamic_grid.h"
+#include "halley/data_structures/vector.h"
+#include "halley/maths/rect.h"
+
+namespace Halley {
+	class SpritePainter;
+
+	// Keeps static and slow-moving sprites bucketed in a grid, so render systems only submit the ones in view instead of every sprite in the world
+	// Typically queried with the camera's getClippingRectangle()
+	class SpriteSpatialIndex {
+	public:
+		using Handle = uint32_t;
+
+		struct Stats {
+			size_t submitted = 0; // Sprites added to a painter
+			size_t culled = 0; // Sprites in the index that were outside the view
+		};
+
+		// Cells should be around the size of a typical sprite, or a bit larger
+		explicit SpriteSpatialIndex(float cellSize = 256.0f);
+
+		Handle add(Sprite sprite, int mask, int layer, float tieBreaker = 0);
+		void remove(Handle handle);
+		void clear();
+
+		// Only touches the grid if the sprite moved to different cells
+		void update(Handle handle, Sprite sprite);
+		const Sprite& getSprite(Handle handle) const;
+		size_t size() const;
+
+		// Every sprite whose bounds overlap area, ordered by handle
+		void query(Rect4f area, Vector<Handle>& result);
+
+		// Adds every sprite in view to the painter
+		// The painter references them, so the index can't be changed until the painter is done drawing
+		void submit(SpritePainter& painter, Rect4f view);
+
+		// Accumulated over every submit since the last reset, e.g. reset once per frame
+		const Stats& getStats() const;
+		void resetStats();
+
+	private:
+		struct Entry {
+			Sprite sprite;
+			Rect4f bounds;
+			Vector2i cellMin;
+			Vector2i cellMax;
+			int mask = 0;
+			int layer = 0;
+			float tieBreaker = 0;
+			uint32_t lastQuery = 0;
+			bool alive = false;
+		};
+
+		float cellSize;
+		Vector<Entry> entries;
+		Vector<Handle> freeHandles;
+		DynamicGrid<Vector<Handle>> grid;
+		std::optional<std::pair<Vector2i, Vector2i>> usedCells;
+		uint32_t curQuery = 0;
+		Stats stats;
+		Vector<Handle> queryResults;
+
+		Vector2i getCell(Vector2f pos) const;
+		void insertIntoCells(Handle handle);
+		void removeFromCells(Handle handle);
+	};
+}
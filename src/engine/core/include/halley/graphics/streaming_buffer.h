@@ -0,0 +1,33 @@
+#pragma once
+
+#include <gsl/gsl>
+
+namespace Halley {
+	// Ring of per-frame regions over memory that the backend reads from directly (e.g. a persistently mapped buffer)
+	// Each frame writes linearly into its own region, so a region is only reused after numRegions frames, once the backend has fenced it
+	class StreamingBuffer {
+	public:
+		constexpr static size_t alignment = 16;
+
+		StreamingBuffer(gsl::span<char> memory, size_t numRegions);
+
+		// Moves on to the next region and returns its index, the caller must make sure the backend is done reading from it
+		size_t startFrame();
+		size_t getCurrentRegion() const;
+
+		// Space left in the current region, writes start at the beginning of it
+		gsl::span<char> getFreeSpace() const;
+		void commit(size_t bytes);
+
+		bool contains(const void* data) const;
+		size_t getOffset(const void* data) const;
+
+	private:
+		gsl::span<char> memory;
+		size_t regionSize = 0;
+		size_t numRegions = 0;
+		size_t curRegion = 0;
+		size_t pos = 0;
+		size_t end = 0;
+	};
+}
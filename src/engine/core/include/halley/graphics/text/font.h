@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <array>
+#include <limits>
 #include "halley/graphics/texture.h"
 #include "halley/graphics/sprite/sprite.h"
 #include "halley/data_structures/hash_map.h"
@@ -23,23 +25,24 @@ namespace Halley
 			Vector2f horizontalBearing;
 			Vector2f verticalBearing;
 			Vector2f advance;
-			HashMap<int32_t, Vector2f> kerning;
+
+			// Where this glyph's pairs are in the font's kerning table, set by the Font
+			uint32_t kerningStart = 0;
+			uint32_t kerningCount = 0;
 			
 			Glyph();
 			Glyph(const Glyph& other) = default;
 			Glyph(Glyph&& other) noexcept = default;
-			Glyph(int charcode, Rect4f area, Vector2f size, Vector2f horizontalBearing, Vector2f verticalBearing, Vector2f advance, HashMap<int32_t, Vector2f> kerning);
+			Glyph(int charcode, Rect4f area, Vector2f size, Vector2f horizontalBearing, Vector2f verticalBearing, Vector2f advance);
 
 			Glyph& operator=(const Glyph& o) = default;
 			Glyph& operator=(Glyph&& o) noexcept = default;
 
-			Vector2f getKerning(int32_t charcode) const;
-
 			void serialize(Serializer& serializer) const;
 			void deserialize(Deserializer& deserializer);
 		};
 
-		Font() = default;
+		Font();
 		Font(String name, String imageName, float ascender, float height, float sizePt, float replacementScale, Vector2i imageSize);
 		Font(String name, String imageName, float ascender, float height, float sizePt, float replacementScale, Vector2i imageSize, float distanceFieldSmoothRadius, Vector<String> fallback, bool floorGlyphPosition);
 
@@ -50,7 +53,10 @@ namespace Halley
 
 		std::pair<const Glyph&, const Font&> getGlyph(int code) const;
 		const Glyph& getGlyphHere(int code) const;
+		const Glyph* tryGetGlyphHere(int code) const;
 		const Font& getFontForGlyph(int code) const;
+		Vector2f getKerning(int32_t left, int32_t right) const;
+		Vector2f getKerning(const Glyph& left, int32_t right) const;
 		float getLineHeightAtSize(float size) const;
 		float getAscenderDistance() const;
 		float getHeight() const;
@@ -62,9 +68,12 @@ namespace Halley
 		bool isDistanceField() const;
 		bool shouldFloorGlyphPosition() const;
 
-		void addGlyph(const Glyph& glyph);
+		// Adding glyphs in charcode order is fastest. Call finishAddingGlyphs once they're all in, before the font is used or serialized
+		void addGlyph(const Glyph& glyph, const HashMap<int32_t, Vector2f>& kerning = {});
+		void finishAddingGlyphs();
 
 		std::shared_ptr<Material> getMaterial() const;
+		void setMaterial(std::shared_ptr<Material> material);
 
 		void serialize(Serializer& deserializer) const;
 		void deserialize(Deserializer& deserializer);
@@ -86,7 +95,23 @@ namespace Halley
 		bool floorGlyphPosition;
 
 		std::shared_ptr<Material> material;
-		HashMap<int, Glyph> glyphs;
+
+		// Glyphs are sorted by charcode, with Latin-1 indexed directly and the rest found by binary search
+		// Kerning for every pair is kept in one table, sorted by left then right charcode, so each glyph's pairs are contiguous
+		constexpr static size_t latin1Size = 256;
+		constexpr static uint32_t noGlyph = std::numeric_limits<uint32_t>::max();
+
+		struct KerningPair {
+			uint64_t key;
+			Vector2f kerning;
+		};
+
+		Vector<Glyph> glyphs;
+		std::array<uint32_t, latin1Size> latin1Glyphs;
+		Vector<KerningPair> kerningPairs;
+		bool indicesValid = false;
+
+		void updateIndices();
 	};
 	
 }
@@ -134,6 +134,7 @@ namespace Halley
 		Rect4f getAABB() const;
 
 		bool isCompatibleWith(const TextRenderer& other) const; // Can be drawn as part of the same draw call
+		uint64_t getSortKey() const; // See Material::getSortKey, 0 if there's nothing to draw
 
 	private:
 		struct GlyphLayout {
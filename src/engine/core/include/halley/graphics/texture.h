@@ -28,6 +28,9 @@ namespace Halley
 
 		void load(TextureDescriptor descriptor);
 
+		// Uploads only area of image, which must have the texture's size and be RGBA, to an RGBA texture loaded with canBeUpdated
+		void updateRegion(const Image& image, Rect4i area);
+
 		static std::shared_ptr<Texture> loadResource(ResourceLoader& loader);
 		constexpr static AssetType getAssetType() { return AssetType::Texture; }
 
@@ -47,12 +50,16 @@ namespace Halley
 		void setAlphaMask(ImageMask mask);
 		bool hasOpaquePixels(Rect4i pixelBounds) const;
 
+		// Takes over other's GPU texture (e.g. the same image with different mips resident), without bumping the asset version or losing the alpha mask
+		void replaceWith(Texture&& other);
+
 	protected:
 		Vector2i size;
 		TextureDescriptor descriptor;
 		ImageMask mask;
 
 		virtual void doLoad(TextureDescriptor& descriptor);
+		virtual void doUpdateRegion(const Image& image, Rect4i area);
 		virtual void doCopyToTexture(Painter& painter, Texture& other) const;
 		virtual void doCopyToImage(Painter& painter, Image& image) const;
 		virtual size_t getVRamUsage() const;
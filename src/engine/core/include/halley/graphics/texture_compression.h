@@ -0,0 +1,25 @@
+#pragma once
+
+#include "texture_descriptor.h"
+#include "halley/utils/utils.h"
+#include <gsl/gsl>
+
+namespace Halley {
+	class Image;
+
+	// CPU encoder/decoder for the block compressed texture formats, so importing doesn't need a GPU
+	class TextureCompression {
+	public:
+		// Encodes an RGBA image, followed by mipLevels - 1 box filtered mips (each one half the size of the previous one)
+		static Bytes compress(const Image& image, TextureFormat format, int mipLevels = 1);
+
+		// Decodes the top mip level back to RGBA, for backends without support for the format
+		static std::unique_ptr<Image> decompress(gsl::span<const gsl::byte> data, TextureFormat format, Vector2i size);
+
+		static int getMaxMipLevels(Vector2i size);
+		static Vector2i getMipSize(Vector2i size, int level);
+		static size_t getMipChainByteSize(TextureFormat format, Vector2i size, int mipLevels);
+
+		static std::unique_ptr<Image> downsample(const Image& image);
+	};
+}
@@ -17,12 +17,14 @@ namespace Halley
 		BGRA5551,
 		BGRX,
 		SRGBA,
-		RGBAFloat16
+		RGBAFloat16,
+		BC1,
+		BC3
 	};
 
 	template <>
 	struct EnumNames<TextureFormat> {
-		constexpr std::array<const char*, 10> operator()() const {
+		constexpr std::array<const char*, 12> operator()() const {
 			return{{
 				"indexed",
 				"rgb",
@@ -33,7 +35,9 @@ namespace Halley
 				"rgba5551",
 				"xrgb",
 				"srgba",
-				"rgbaFloat16"
+				"rgbaFloat16",
+				"bc1",
+				"bc3"
 			}};
 		}
 	};
@@ -108,6 +112,8 @@ namespace Halley
 		PixelDataFormat pixelFormat = PixelDataFormat::Image;
 		TextureAddressMode addressMode = TextureAddressMode::Clamp;
 		TextureDescriptorImageData pixelData;
+		int mipLevels = 1; // Number of mip levels in the full chain, for block compressed formats that can't generate their own
+		int firstMipLevel = 0; // First mip in pixelData; the texture is allocated at that mip's size, but keeps reporting the full size
 
 		bool useMipMap = false;
 		bool useFiltering = false;
@@ -124,7 +130,12 @@ namespace Halley
 
 		TextureDescriptor& operator=(TextureDescriptor&& other) noexcept;
 
+		// Block compressed formats are sampled as RGBA, so they report 4 here; use getRowPitch or getByteSize for their storage size
 		static int getBytesPerPixel(TextureFormat format);
+		static bool isBlockCompressed(TextureFormat format);
+		static size_t getBlockByteSize(TextureFormat format);
+		static size_t getByteSize(TextureFormat format, Vector2i size);
+		static size_t getRowPitch(TextureFormat format, int width);
 
 		size_t getMemoryUsage() const;
 	};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "texture_descriptor.h"
+#include "halley/concurrency/future.h"
+#include "halley/data_structures/hash_map.h"
+#include "halley/resources/resource.h"
+#include <mutex>
+
+namespace Halley {
+	class ExecutionQueue;
+	class Texture;
+	class VideoAPI;
+
+	// Keeps only the mips that are actually needed of block compressed textures with mip chains resident in VRAM
+	// Textures start with just their small mips (up to baseSize), and are reloaded with more mips as draws report needing them
+	// Once over budget, the least recently used textures drop back to their small mips
+	class TextureStreamer {
+	public:
+		TextureStreamer(VideoAPI& video, size_t vramBudget, ExecutionQueue& uploadQueue, int baseSize = 64);
+		~TextureStreamer();
+
+		TextureStreamer(const TextureStreamer& other) = delete;
+		TextureStreamer& operator=(const TextureStreamer& other) = delete;
+
+		static bool canStream(const TextureDescriptor& descriptor);
+
+		// Loads the texture with its small mips only, keeping the whole chain in RAM to stream the rest from
+		// Can be called from any thread
+		void add(std::shared_ptr<Texture> texture, TextureDescriptor descriptor);
+
+		// Reports that the texture was drawn this frame needing the given mip (0 is full size). Can be called from any thread
+		void reportUsage(const Texture& texture, int mipLevel);
+
+		// Call once per frame, while nothing is rendering, as this is where textures get replaced
+		void update();
+
+		void setBudget(size_t bytes);
+		size_t getBudget() const;
+		ResourceMemoryUsage getMemoryUsage() const;
+		std::optional<int> getResidentMipLevel(const Texture& texture) const;
+		size_t getNumStreamedIn() const;
+		size_t getNumEvicted() const;
+
+		// Mip whose texels are closest to one per pixel, for an area of texels drawn over an area of pixels
+		static int getRequiredMipLevel(Vector2f texels, Vector2f pixels);
+
+	private:
+		struct Entry {
+			std::weak_ptr<Texture> texture;
+			Bytes data; // Whole mip chain
+			Vector2i size;
+			TextureFormat format;
+			int mipLevels;
+			bool useFiltering;
+			TextureAddressMode addressMode;
+
+			int baseLevel;
+			int residentLevel;
+			int targetLevel;
+			uint64_t lastUsed = 0;
+
+			Future<void> pending;
+			std::shared_ptr<Texture> pendingTexture;
+			int pendingLevel = 0;
+		};
+
+		VideoAPI& video;
+		ExecutionQueue& uploadQueue;
+		size_t budget;
+		int baseSize;
+
+		mutable std::mutex mutex;
+		HashMap<const Texture*, std::unique_ptr<Entry>> entries;
+		HashMap<const Texture*, int> reported;
+		uint64_t curFrame = 1;
+		size_t nStreamedIn = 0;
+		size_t nEvicted = 0;
+
+		void applyFinished(Entry& entry);
+		void requestLevel(Entry& entry, int level);
+		size_t getLevelBytes(const Entry& entry, int level) const;
+		TextureDescriptor makeDescriptor(const Entry& entry, int level) const;
+	};
+}
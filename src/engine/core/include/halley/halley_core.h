@@ -20,11 +20,16 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "halley/graph/base_graph.h"
 
 #include "halley/graphics/blend.h"
+#include "halley/graphics/headless_renderer.h"
 #include "halley/graphics/painter.h"
+#include "halley/graphics/painter_command_list.h"
 #include "halley/graphics/render_context.h"
 #include "halley/graphics/shader.h"
+#include "halley/graphics/streaming_buffer.h"
 #include "halley/graphics/texture.h"
+#include "halley/graphics/texture_compression.h"
 #include "halley/graphics/texture_descriptor.h"
+#include "halley/graphics/texture_streamer.h"
 
 #include "halley/graphics/material/material.h"
 #include "halley/graphics/material/material_definition.h"
@@ -49,10 +54,12 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 
 #include "halley/graphics/sprite/animation.h"
 #include "halley/graphics/sprite/animation_player.h"
+#include "halley/graphics/sprite/dynamic_atlas.h"
 #include "halley/graphics/sprite/particles.h"
 #include "halley/graphics/sprite/sprite.h"
 #include "halley/graphics/sprite/sprite_painter.h"
 #include "halley/graphics/sprite/sprite_sheet.h"
+#include "halley/graphics/sprite/sprite_spatial_index.h"
 
 #include "halley/graphics/window.h"
 
@@ -16,8 +16,10 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "bytes/fuzzer.h"
 
 #include "data_structures/bin_pack.h"
+#include "data_structures/collision_world.h"
 #include "data_structures/config_database.h"
 #include "data_structures/config_node.h"
+#include "data_structures/dynamic_aabb_tree.h"
 #include "data_structures/dynamic_grid.h"
 #include "data_structures/hash_map.h"
 #include "data_structures/mapped_pool.h"
@@ -31,6 +33,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "data_structures/ring_buffer.h"
 #include "data_structures/selection_set.h"
 #include "data_structures/simple_pool.h"
+#include "data_structures/static_bvh.h"
 #include "data_structures/temp_allocator.h"
 #include "data_structures/time_cache.h"
 #include "data_structures/tree_map.h"
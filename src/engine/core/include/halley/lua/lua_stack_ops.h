@@ -10,6 +10,7 @@
 namespace Halley {
 	class String;
 	class LuaState;
+	class ScriptDataValue;
 
 	using LuaCallback = std::function<int(LuaState&)>;
 
@@ -27,6 +28,7 @@ namespace Halley {
 		void push(Vector2i v);
 		void push(LuaCallback callback);
 		void push(const ConfigNode& node);
+		void push(const ScriptDataValue& value);
 		void pushTable(int nArrayIndices = 0, int nRecords = 0);
 
 		template <typename T>
@@ -76,6 +78,7 @@ namespace Halley {
 		Vector2i popVector2i();
 		ConfigNode popConfigNode();
 		ConfigNode popTable();
+		void popScriptDataValue(ScriptDataValue& value); // Same conversions as popConfigNode(), without boxing basic types
 		
 		bool isTopNil();
 		int getLength();
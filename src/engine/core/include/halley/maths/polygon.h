@@ -75,6 +75,12 @@ namespace Halley {
 		SATClassification classify(const Polygon& other, float epsilon = 0.0001f) const;
 		SATClassification classify(const LineSegment& line) const;
 
+		// Batch versions, testing this polygon against many points or polygons at once.
+		// Results are identical to calling the single versions for each element.
+		void isPointInside(gsl::span<const Vector2f> points, gsl::span<bool> result) const;
+		void collide(gsl::span<const Polygon> others, gsl::span<bool> result) const;
+		void classify(gsl::span<const Polygon> others, gsl::span<SATClassification> result, float epsilon = 0.0001f) const;
+
 		void setVertices(VertexList vertices);
 		const VertexList& getVertices() const { return vertices; }
 		const size_t getNumSides() const { return vertices.size(); }
@@ -136,6 +142,11 @@ namespace Halley {
 		void triangulate(Vector<Triangle>& dst) const;
 
 	private:
+		struct ProjectedAxis {
+			Vector2f axis;
+			Range<float> range;
+		};
+
 		Circle circle;
 		VertexList vertices;
 		bool convex = false;
@@ -144,12 +155,20 @@ namespace Halley {
 		float area = 0;
 		Rect4f aabb;
 
+		// Copy of the vertices in SoA layout, for the SIMD kernels. Padded with vertices[0] to a multiple of 4, plus one extra so that edge i always goes from i to i + 1
+		Vector<float> simdX;
+		Vector<float> simdY;
+
 		bool isPointInsideConvex(Vector2f point) const;
 		bool isPointInsideConcave(Vector2f point) const;
 
 		bool collideConvex(const Polygon &param, Vector2f *translation= nullptr, Vector2f *collisionPoint= nullptr) const;
 
 		Range<float> project(Vector2f axis) const;
+		Vector<ProjectedAxis> getProjectedEdgeAxes() const;
+		bool collideConvex(const Polygon& other, gsl::span<const ProjectedAxis> ownAxes) const;
+		SATClassification classify(const Polygon& other, gsl::span<const ProjectedAxis> ownAxes, float epsilon) const;
+		void updateSIMDVertices();
 		void unproject(const Vector2f &axis,const float point,Vector<Vector2f> &ver) const;
 		void realize();
 		void checkConvex();
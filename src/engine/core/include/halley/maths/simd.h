@@ -75,6 +75,20 @@ namespace Halley {
 #endif
         }
 
+		// Loads 8 floats laid out as a0 b0 a1 b1 a2 b2 a3 b3 (e.g. four Vector2f) into (a0 a1 a2 a3) and (b0 b1 b2 b3)
+		static inline void loadDeinterleaved(const float* src, SIMDVec4& a, SIMDVec4& b)
+        {
+#if defined(HAS_SSE)
+			const auto lo = _mm_loadu_ps(src);
+			const auto hi = _mm_loadu_ps(src + 4);
+			a = SIMDVec4(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+			b = SIMDVec4(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+#else
+			a = SIMDVec4(src[0], src[2], src[4], src[6]);
+			b = SIMDVec4(src[1], src[3], src[5], src[7]);
+#endif
+        }
+
 		inline void storeAligned(float* dst) const
         {
 #if defined(HAS_SSE)
@@ -174,6 +188,63 @@ namespace Halley {
 #endif
         }
 
+		// Comparisons return a lane mask (all bits set where true), to be combined with & and | and read with getMask()
+		inline SIMDVec4 lessOrEqual(const SIMDVec4& other) const
+        {
+#if defined(HAS_SSE)
+			return SIMDVec4(_mm_cmple_ps(x, other.x));
+#else
+			return fromMask(x[0] <= other.x[0], x[1] <= other.x[1], x[2] <= other.x[2], x[3] <= other.x[3]);
+#endif
+        }
+
+		inline SIMDVec4 lessThan(const SIMDVec4& other) const
+        {
+#if defined(HAS_SSE)
+			return SIMDVec4(_mm_cmplt_ps(x, other.x));
+#else
+			return fromMask(x[0] < other.x[0], x[1] < other.x[1], x[2] < other.x[2], x[3] < other.x[3]);
+#endif
+        }
+
+		inline SIMDVec4 operator&(const SIMDVec4& other) const
+        {
+#if defined(HAS_SSE)
+			return SIMDVec4(_mm_and_ps(x, other.x));
+#else
+			return fromMask(getLaneMask(0) && other.getLaneMask(0), getLaneMask(1) && other.getLaneMask(1), getLaneMask(2) && other.getLaneMask(2), getLaneMask(3) && other.getLaneMask(3));
+#endif
+        }
+
+		inline SIMDVec4 operator|(const SIMDVec4& other) const
+        {
+#if defined(HAS_SSE)
+			return SIMDVec4(_mm_or_ps(x, other.x));
+#else
+			return fromMask(getLaneMask(0) || other.getLaneMask(0), getLaneMask(1) || other.getLaneMask(1), getLaneMask(2) || other.getLaneMask(2), getLaneMask(3) || other.getLaneMask(3));
+#endif
+        }
+
+		// Returns ifTrue in lanes where mask is set, ifFalse elsewhere
+		static inline SIMDVec4 select(const SIMDVec4& mask, const SIMDVec4& ifTrue, const SIMDVec4& ifFalse)
+		{
+#if defined(HAS_SSE)
+			return SIMDVec4(_mm_or_ps(_mm_and_ps(mask.x, ifTrue.x), _mm_andnot_ps(mask.x, ifFalse.x)));
+#else
+			return SIMDVec4(mask.getLaneMask(0) ? ifTrue.x[0] : ifFalse.x[0], mask.getLaneMask(1) ? ifTrue.x[1] : ifFalse.x[1], mask.getLaneMask(2) ? ifTrue.x[2] : ifFalse.x[2], mask.getLaneMask(3) ? ifTrue.x[3] : ifFalse.x[3]);
+#endif
+		}
+
+		// Returns a 4-bit integer, with bit i set if lane i of the mask is set
+		inline int getMask() const
+        {
+#if defined(HAS_SSE)
+			return _mm_movemask_ps(x);
+#else
+			return (getLaneMask(0) ? 1 : 0) | (getLaneMask(1) ? 2 : 0) | (getLaneMask(2) ? 4 : 0) | (getLaneMask(3) ? 8 : 0);
+#endif
+        }
+
 		// Returns a[0] + a[1], a[2] + a[3], b[0] + b[1], b[2] + b[3]
 		static inline SIMDVec4 horizontalAdd(SIMDVec4 a, SIMDVec4 b)
 		{
@@ -213,6 +284,21 @@ namespace Halley {
 			x[2] = c;
 			x[3] = d;
 		}
+
+		static SIMDVec4 fromMask(bool a, bool b, bool c, bool d)
+		{
+			SIMDVec4 result;
+			const uint32_t bits[4] = { a ? 0xFFFFFFFFu : 0u, b ? 0xFFFFFFFFu : 0u, c ? 0xFFFFFFFFu : 0u, d ? 0xFFFFFFFFu : 0u };
+			memcpy(result.x, bits, sizeof(bits));
+			return result;
+		}
+
+		bool getLaneMask(int i) const
+		{
+			uint32_t bits;
+			memcpy(&bits, &x[i], sizeof(bits));
+			return (bits & 0x80000000u) != 0;
+		}
 #endif
     };
 }
@@ -4,6 +4,7 @@
 #include "navigation_query.h"
 #include "halley/maths/polygon.h"
 #include "halley/maths/base_transform.h"
+#include "halley/data_structures/static_bvh.h"
 
 namespace Halley {
 	class NavmeshSet;
@@ -136,6 +137,13 @@ namespace Halley {
 		[[nodiscard]] std::optional<Vector2f> findRayCollision(Ray ray, float maxDistance) const;
 		[[nodiscard]] std::pair<std::optional<Vector2f>, float> findRayCollision(Ray ray, float maxDistance, NodeId initialPolygon, float weightedDistance = 0, const NavmeshSet* navmeshSet = nullptr) const;
 
+		// Batched versions of the queries above, for running many queries on the same navmesh (e.g. AI line of sight).
+		// Results are identical to calling the single versions for each element. Queries are sorted by grid cell, and the ones that need a
+		// tree search walk it in packets of four, one point per SIMD lane.
+		void getNodesAt(gsl::span<const Vector2f> positions, gsl::span<std::optional<NodeId>> result) const;
+		void getClosestPointsTo(gsl::span<const Vector2f> positions, gsl::span<std::optional<Vector2f>> result, float anisotropy = 1.0f, float maxDist = std::numeric_limits<float>::infinity()) const;
+		void findRayCollisions(gsl::span<const Ray> rays, gsl::span<const float> maxDistances, gsl::span<std::optional<Vector2f>> result) const;
+
 		void setWorldPosition(Vector2f offset, Vector2i worldGridPos);
 		[[nodiscard]] Vector2i getWorldGridPos() const { return worldGridPos; }
 		[[nodiscard]] int getSubWorld() const { return subWorld; }
@@ -182,6 +190,8 @@ namespace Halley {
 
 		Vector2i gridSize = Vector2i(20, 20);
 		Vector<Vector<NodeId>> polyGrid; // Quick lookup of polygons
+		StaticBVH polygonBVH; // Used for distance queries
+		StaticBVH openEdgeBVH;
 
 		Vector2f origin;
 		Base2D normalisedCoordinatesBase;
@@ -199,6 +209,10 @@ namespace Halley {
 		void processPolygons();
 		void addPolygonsToGrid();
 		void addPolygonToGrid(const Polygon& poly, NodeId idx);
+		void buildPolygonBVH();
+		void buildOpenEdgeBVH();
+		Vector<size_t> getBatchOrder(gsl::span<const Vector2f> positions) const;
+		std::optional<NodeId> getNodeInCell(Vector2f position) const;
 		std::optional<Vector2i> getGridAt(Vector2f pos, bool allowOutside) const;
 		gsl::span<const NodeId> getPolygonsAt(Vector2f pos, bool allowOutside) const;
 		gsl::span<const NodeId> getPolygonsAt(Vector2i gridPos) const;
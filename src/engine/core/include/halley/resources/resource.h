@@ -260,6 +260,7 @@ namespace Halley
 	struct ResourceOptions {
 		bool retainPixelData = false;
 		bool retainShaderData = false;
+		size_t textureStreamingBudget = 0; // VRAM for streamed in mips of block compressed textures, 0 loads them whole
 		
 		ResourceOptions(bool retainPixelData = false, bool retainShaderData = false)
 			: retainPixelData(retainPixelData)
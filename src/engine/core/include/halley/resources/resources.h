@@ -33,6 +33,7 @@ namespace Halley {
 	
 	class ResourceLocator;
 	class HalleyAPI;
+	class TextureStreamer;
 	
 	class Resources {
 		friend class ResourceCollectionBase;
@@ -149,6 +150,7 @@ namespace Halley {
 		void reloadAssets(const std::map<AssetType, Vector<String>>& byType);
 
 		const ResourceOptions& getOptions() const { return options; }
+		TextureStreamer* getTextureStreamer() const { return textureStreamer.get(); }
 
 		void generateMemoryReport();
 
@@ -157,5 +159,6 @@ namespace Halley {
 		Vector<std::unique_ptr<ResourceCollectionBase>> resources;
 		const HalleyAPI* const api;
 		ResourceOptions options;
+		std::unique_ptr<TextureStreamer> textureStreamer;
 	};
 }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "halley/data_structures/config_node.h"
+#include "halley/data_structures/vector.h"
+#include "halley/graph/base_graph_enums.h"
+#include "script_data_value.h"
+#include "script_variables.h"
+
+namespace Halley {
+	class ScriptEnvironment;
+	class ScriptGraph;
+	class ScriptGraphNode;
+
+	using ScriptDataRegister = uint16_t;
+
+	enum class ScriptDataOpCode : uint8_t {
+		LoadConstant,	// dst = constants[arg]
+		LoadVariable,	// dst = variables[arg], in scope param
+		Fallback,		// dst = getData() of output pin a of node arg
+		ToBool,			// dst = bool(a)
+		Not,			// dst = !bool(a)
+		Xor,			// dst = bool(a) ^ bool(b)
+		Arithmetic,		// dst = a (MathOp param) b
+		Compare,		// dst = a (MathRelOp param) b
+		MakeVector,		// dst = Vector2f(float(a), float(b))
+		VectorX,		// dst = Vector2f(a).x
+		VectorY,		// dst = Vector2f(a).y
+		Jump,			// goto arg
+		JumpIfFalse,	// if !bool(a) goto arg
+		JumpIfTrue,		// if bool(a) goto arg
+		JumpIfDefined,	// if a is defined goto arg
+		Return			// return a
+	};
+
+	struct ScriptDataInstruction {
+		ScriptDataOpCode op;
+		uint8_t param;
+		ScriptDataRegister dst;
+		ScriptDataRegister a;
+		ScriptDataRegister b;
+		uint32_t arg;
+	};
+
+	// Data pin subgraphs of a ScriptGraph, lowered to a register-based instruction stream.
+	// Each connected input data pin gets an entry point, so reading it doesn't need to pull values through getData() and ConfigNodes.
+	class ScriptDataProgram {
+	public:
+		struct EntryPoint {
+			uint32_t start = 0;
+			uint16_t nRegisters = 0;
+		};
+
+		uint64_t getGraphHash() const { return graphHash; }
+		size_t getNumEntryPoints() const { return entryPoints.size(); }
+		size_t getNumInstructions() const { return code.size(); }
+
+		const EntryPoint* getEntryPoint(GraphNodeId nodeId, GraphPinId pinN) const
+		{
+			if (nodeId + 1 >= static_cast<int>(nodePinStart.size())) {
+				return nullptr;
+			}
+			const auto idx = nodePinStart[nodeId] + pinN;
+			if (idx >= nodePinStart[nodeId + 1] || pinEntryPoint[idx] < 0) {
+				return nullptr;
+			}
+			return &entryPoints[pinEntryPoint[idx]];
+		}
+
+		// Registers from base to base + entryPoint.nRegisters must be allocated
+		// The result is one of the registers, so it's only valid until they're modified or resized
+		const ScriptDataValue& run(ScriptEnvironment& environment, const EntryPoint& entryPoint, Vector<ScriptDataValue>& registers, size_t base) const;
+
+	private:
+		friend class ScriptDataCompiler;
+
+		uint64_t graphHash = 0;
+		Vector<ScriptDataInstruction> code;
+		Vector<ScriptDataValue> constants;
+		Vector<ScriptVariableKey> variables;
+		Vector<EntryPoint> entryPoints;
+		Vector<uint32_t> nodePinStart;
+		Vector<int32_t> pinEntryPoint;
+	};
+
+	// Builds a ScriptDataProgram for a graph. Node types must already be assigned.
+	// Nodes take part by implementing IScriptNodeType::compileData(); the ones that don't are evaluated through getData() by a Fallback instruction.
+	class ScriptDataCompiler {
+	public:
+		explicit ScriptDataCompiler(const ScriptGraph& graph);
+
+		std::shared_ptr<ScriptDataProgram> compile();
+
+		ScriptDataRegister allocateRegister();
+
+		// Emits code writing the value read by input pin pinN of node to dst
+		void compileInput(const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst);
+		ScriptDataRegister compileInput(const ScriptGraphNode& node, GraphPinId pinN);
+
+		void emit(ScriptDataOpCode op, ScriptDataRegister dst, ScriptDataRegister a = 0, ScriptDataRegister b = 0, uint8_t param = 0, uint32_t arg = 0);
+		void emitConstant(ScriptDataRegister dst, const ConfigNode& value);
+		uint32_t addVariable(const String& name);
+
+		// Returns the index of the jump instruction, to be passed to patchJump() once the target is known
+		size_t emitJump(ScriptDataOpCode op, ScriptDataRegister cond = 0);
+		void patchJump(size_t jumpInstruction);
+
+	private:
+		constexpr static int maxDepth = 64;
+
+		const ScriptGraph& graph;
+		std::shared_ptr<ScriptDataProgram> program;
+		ScriptDataRegister nRegisters = 0;
+		int depth = 0;
+
+		void compileOutput(const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst);
+	};
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include "halley/data_structures/config_node.h"
+#include "halley/maths/vector2.h"
+
+namespace Halley {
+	// A value held in a ScriptDataProgram register or in ScriptVariables.
+	// Basic types are kept unboxed, anything else (strings, sequences, maps...) is kept as a ConfigNode.
+	class ScriptDataValue {
+	public:
+		enum class Type : uint8_t {
+			Undefined,
+			Bool,
+			Int,
+			Float,
+			Vector2f,
+			EntityId,
+			Boxed
+		};
+
+		ScriptDataValue() = default;
+		explicit ScriptDataValue(const ConfigNode& node);
+
+		Type getType() const { return type; }
+
+		void set(const ConfigNode& node);
+		void set(ConfigNode&& node);
+		void set(const ScriptDataValue& other);
+		void setUndefined() { type = Type::Undefined; }
+		void setBool(bool value) { type = Type::Bool; b = value; }
+		void setInt(int value) { type = Type::Int; i = value; }
+		void setFloat(float value) { type = Type::Float; f = value; }
+		void setVector2f(Vector2f value) { type = Type::Vector2f; v = { value.x, value.y }; }
+
+		int getInt() const { return i; }
+		float getFloat() const { return f; }
+		Vector2f getVector2f() const { return Vector2f(v[0], v[1]); }
+
+		// These match ConfigNode's asBool(false), asFloat(0) and asVector2f({})
+		bool asBool() const;
+		float asFloat() const;
+		Vector2f asVector2f() const;
+
+		ConfigNode toConfigNode() const;
+
+	private:
+		Type type = Type::Undefined;
+		union {
+			bool b;
+			int i;
+			float f;
+			int64_t e;
+			std::array<float, 2> v;
+		};
+		ConfigNode boxed;
+	};
+}
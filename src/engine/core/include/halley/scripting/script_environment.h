@@ -67,6 +67,11 @@ namespace Halley {
             ReturnToOwner
         };
 
+        struct DataCacheStats {
+	        uint64_t evaluations = 0; // Reads of pure data nodes that had to be evaluated
+            uint64_t savedEvaluations = 0; // Reads of pure data nodes served from the per-tick cache
+        };
+
         using ScriptTargetRetriever = std::function<EntityId(const String&)>;
 
     	ScriptEnvironment(const HalleyAPI& api, World& world, Resources& resources, std::shared_ptr<ScriptNodeTypeCollection> nodeTypeCollection, bool isHost = true);
@@ -84,7 +89,33 @@ namespace Halley {
         IScriptStateData* getNodeData(GraphNodeId nodeId);
         void assignTypes(const ScriptGraph& graph);
 
+        // When enabled (the default), data pins are compiled into a ScriptDataProgram when a graph's types are assigned, and read through it
+        void setDataPinCompilationEnabled(bool enabled);
+        bool isDataPinCompilationEnabled() const;
+
+        // When enabled (the default), outputs of pure data nodes are only evaluated once per tick, see IScriptNodeType::isPureData
+        void setDataCacheEnabled(bool enabled);
+        bool isDataCacheEnabled() const;
+        const DataCacheStats& getDataCacheStats() const;
+        void resetDataCacheStats();
+
+        // Returns 0 if there's no cache available
+        uint32_t getDataCacheGeneration();
+
+        // Unlike the data cache generation, this only changes once per update (or dev console read), so nodes with side effects can use it to run once per tick
+        // Returns 0 if no state is being evaluated
+        uint32_t getEvaluationId() const;
+
+        // Workers update script states on other threads, see ScriptSystem. Call prepareWorker() before each use, as they share this environment's settings.
+        // Side effects reaching outside of the script state being updated (messages, script execution requests, system messages) are buffered until mergeWorker().
+        virtual std::unique_ptr<ScriptEnvironment> makeWorker() const;
+        void prepareWorker(ScriptEnvironment& worker) const;
+        void mergeWorker(ScriptEnvironment& worker);
+        bool isWorker() const;
+
     	ConfigNode readInputDataPin(const ScriptGraphNode& node, GraphPinId pinN);
+        // Same as readInputDataPin, but compiled data pins don't need to box their value into a ConfigNode
+        ScriptDataValue readInputDataValue(const ScriptGraphNode& node, GraphPinId pinN);
         ConfigNode readOutputDataPin(const ScriptGraphNode& node, GraphPinId pinN);
         EntityId readInputEntityId(const ScriptGraphNode& node, GraphPinId pinN, bool disconnectedIsSelf);
         EntityId readInputEntityIdRaw(const ScriptGraphNode& node, GraphPinId pinN);
@@ -187,11 +218,20 @@ namespace Halley {
         Vector<std::pair<EntityId, ScriptMessage>> scriptOutbox;
         Vector<EntityMessageData> entityOutbox;
         Vector<ScriptExecutionRequest> scriptExecutionRequestOutbox;
+        Vector<SystemMessageData> systemOutbox;
+        bool worker = false;
 
         ScriptTargetRetriever scriptTargetRetriever;
 
         const VariableTable* variableTable = nullptr;
 
+        bool dataPinCompilationEnabled = true;
+        Vector<ScriptDataValue> dataRegisters;
+        size_t dataRegistersUsed = 0;
+
+        bool dataCacheEnabled = true;
+        DataCacheStats dataCacheStats;
+
     private:
         bool updateThread(ScriptState& graphState, ScriptStateThread& thread, Vector<ScriptStateThread>& pendingThreads);
         void terminateStateWith(const ScriptGraph* scriptGraph);
@@ -217,6 +257,10 @@ namespace Halley {
         void processMessages(Time time, Vector<ScriptStateThread>& pending);
         void processControlEvents(Time time, Vector<ScriptStateThread>& pending);
 
+        ConfigNode evaluateInputDataPin(const ScriptGraphNode& node, GraphPinId pinN, const ScriptGraphNode::PinConnection& connection);
+        template <typename T>
+        T runDataProgram(const ScriptDataProgram& program, const ScriptDataProgram::EntryPoint& entryPoint);
+
     	EntityId getEntityIdFromUUID(const UUID& uuid) const override;
         UUID getUUIDFromEntityId(EntityId id) const override;
     };
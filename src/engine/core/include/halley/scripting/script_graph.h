@@ -9,6 +9,7 @@ namespace Halley {
 	class IScriptNodeType;
 	class ScriptNodeTypeCollection;
 	class ScriptGraph;
+	class ScriptDataProgram;
 	class World;
 
 	class ScriptGraphNode final : public BaseGraphNode {
@@ -132,6 +133,22 @@ namespace Halley {
 
 		const ScriptGraph* getPreviousVersion(uint64_t hash) const;
 
+		// Returns null if the graph hasn't been compiled since it last changed, see ScriptEnvironment::assignTypes
+		const ScriptDataProgram* getDataProgram() const;
+		void setDataProgram(std::shared_ptr<const ScriptDataProgram> program) const;
+
+		// True if the node and everything upstream of its data inputs is pure data, so its outputs can be cached, see IScriptNodeType::isPureData
+		// Always false until updatePureDataNodes() is called after types are assigned
+		bool isPureDataNode(GraphNodeId nodeId) const;
+		void updatePureDataNodes() const;
+
+		// Key for the "variable" setting of a node, resolved by updateVariableKeys() so it doesn't need to be looked up and hashed on every access
+		const ScriptVariableKey& getVariableKey(const ScriptGraphNode& node) const;
+		void updateVariableKeys() const;
+
+		// True if any node requires the main thread, see IScriptNodeType::requiresMainThread. Types must be assigned.
+		bool requiresMainThread() const;
+
 	private:
 		Vector<std::pair<GraphNodeId, GraphNodeId>> callerToCallee;
 		Vector<std::pair<GraphNodeId, GraphNodeId>> returnToCaller;
@@ -142,8 +159,15 @@ namespace Halley {
 		ConfigNode properties;
 
 		std::shared_ptr<ScriptGraph> previousVersion;
+		mutable std::shared_ptr<const ScriptDataProgram> dataProgram;
+		mutable Vector<uint8_t> pureDataNodes;
+		mutable uint64_t pureDataNodesHash = 0;
+		mutable std::optional<std::pair<uint64_t, bool>> mainThreadRequirement;
+		mutable Vector<ScriptVariableKey> variableKeys;
+		mutable uint64_t variableKeysHash = 0;
 
 		GraphNodeId findNodeRoot(GraphNodeId nodeId) const;
+		bool computePureDataNode(GraphNodeId nodeId) const;
 		void generateRoots();
 		[[nodiscard]] bool isMultiConnection(GraphNodePinType pinType) const override;
 	};
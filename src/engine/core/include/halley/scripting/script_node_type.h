@@ -1,5 +1,6 @@
 #pragma once
 #include "halley/entity/entity.h"
+#include "script_data_program.h"
 #include "script_graph.h"
 #include "script_state.h"
 #include "script_node_enums.h"
@@ -54,6 +55,19 @@ namespace Halley {
         virtual EntityId getEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN, IScriptStateData* curData) const = 0;
 		virtual ConfigNode getDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node, IScriptStateData* curData) const = 0;
 
+		// Pure data nodes have outputs that only depend on their data inputs, settings and script variables
+		// If all nodes upstream are pure too, their values are cached until the end of the tick, see ScriptState::getCachedData
+		virtual bool isPureData() const { return false; }
+
+		// Scripts containing any node that requires the main thread are never updated by workers.
+		// Only nodes known to stay within their script state (or to go through ScriptEnvironment's buffered outboxes) should return false,
+		// so anything that touches entities, UI, input, audio, Lua or other scripts' states stays on the main thread.
+		virtual bool requiresMainThread() const { return true; }
+
+		// Lowers the data output pin pinN to instructions writing its value to dst, see ScriptDataCompiler
+		// Return false if the node can't be compiled, and it'll be read through getData() instead
+		virtual bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const { return false; }
+
 		ConfigNode readDataPin(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const;
 		void writeDataPin(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const;
 		EntityId readEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t idx) const;
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "halley/data_structures/vector.h"
+#include "halley/entity/entity_id.h"
+#include "halley/time/halleytime.h"
+#include <gsl/gsl>
+#include <memory>
+
+namespace Halley {
+	class ScriptEnvironment;
+	class ScriptStateSet;
+	class ScriptVariables;
+
+	// Updates script states on the CPU executors, see ScriptingService::setParallelUpdate
+	class ScriptParallelUpdater {
+	public:
+		struct Entity {
+			EntityId entityId;
+			ScriptStateSet* states = nullptr;
+			ScriptVariables* variables = nullptr;
+		};
+
+		// True if the entity has states pending an update this frame, and none of them need the main thread
+		static bool canUpdateInParallel(ScriptEnvironment& env, const ScriptStateSet& states);
+
+		// Splits entities into contiguous chunks, each updated by its own worker environment, and then merges the workers' outboxes into env in chunk order,
+		// so the results are the same as a serial update. Does nothing if there isn't enough to split, leaving every state to be updated serially.
+		void update(ScriptEnvironment& env, gsl::span<const Entity> entities, Time t, size_t minEntitiesPerChunk = 16);
+
+	private:
+		Vector<std::unique_ptr<ScriptEnvironment>> workers;
+
+		static void updateChunk(ScriptEnvironment& env, gsl::span<const Entity> entities, Time t);
+	};
+}
@@ -222,7 +222,23 @@ namespace Halley {
     	void setFutureNodeValue(GraphNodeId id, std::optional<Future<ConfigNode>> future);
 		std::optional<Future<ConfigNode>> getFutureNodeValue(GraphNodeId id);
 
+		// Per-tick cache of pure data node outputs, see IScriptNodeType::isPureData()
+		// The generation changes at every tick (invalidateDataCache) and whenever local, shared or the given entity variables are written to
+		uint32_t getDataCacheGeneration(const ScriptVariables* entityVariables);
+		void invalidateDataCache();
+		const ConfigNode* getCachedData(GraphNodeId nodeId, GraphPinId pinId, uint32_t generation) const;
+		void setCachedData(GraphNodeId nodeId, GraphPinId pinId, uint32_t generation, ConfigNode value);
+
+		// Changes every time the environment updates, stops or reads from this state, regardless of variables being written to (never 0)
+		uint32_t getEvaluationId() const;
+		void startEvaluation();
+
 	private:
+		struct CachedData {
+			uint32_t generation = 0;
+			ConfigNode value;
+		};
+
 		std::shared_ptr<const ScriptGraph> scriptGraph;
 		const ScriptGraph* scriptGraphRef = nullptr;
 
@@ -248,6 +264,12 @@ namespace Halley {
 
 		HashMap<GraphNodeId, std::optional<Future<ConfigNode>>> futureNodeValues;
 
+		HashMap<uint32_t, CachedData> dataCache;
+		uint32_t dataCacheGeneration = 1;
+		const ScriptVariables* dataCacheEntityVariables = nullptr;
+		std::array<uint32_t, 3> dataCacheVariableVersions = {};
+		uint32_t evaluationId = 1;
+
     	void onNodeStartedIntrospection(GraphNodeId nodeId);
     	void onNodeEndedIntrospection(GraphNodeId nodeId);
 		void ensureNodeLoaded(const ScriptGraphNode& node, NodeState& state, const EntitySerializationContext& context);
@@ -1,10 +1,26 @@
 #pragma once
 #include "halley/data_structures/config_node.h"
 #include "halley/bytes/config_node_serializer_base.h"
+#include "script_data_value.h"
 
 namespace Halley {
 	class EntitySerializationContext;
 
+	// A variable name with its hash, so it can be resolved once (e.g. when a graph is loaded) and looked up without hashing strings
+	class ScriptVariableKey {
+	public:
+		ScriptVariableKey() = default;
+		explicit ScriptVariableKey(String name);
+		ScriptVariableKey(String name, uint64_t hash); // For names that were already hashed elsewhere
+
+		const String& getName() const { return name; }
+		uint64_t getHash() const { return hash; }
+
+	private:
+		String name;
+		uint64_t hash = 0;
+	};
+
 	class ScriptVariables {
 	public:
 		ScriptVariables() = default;
@@ -13,16 +29,39 @@ namespace Halley {
 		void load(const ConfigNode& node, const EntitySerializationContext& context);
 		ConfigNode toConfigNode(const EntitySerializationContext& context) const;
 
-		const ConfigNode& getVariable(const String& name) const;
-    	void setVariable(const String& name, ConfigNode value);
+		ConfigNode getVariable(const String& name) const;
+		ConfigNode getVariable(const ScriptVariableKey& key) const;
+		void setVariable(const String& name, ConfigNode value);
+		void setVariable(const ScriptVariableKey& key, ConfigNode value);
 		bool hasVariable(const String& name) const;
+		bool hasVariable(const ScriptVariableKey& key) const;
+
+		// Returns null if the variable isn't set
+		const ScriptDataValue* tryGetValue(const ScriptVariableKey& key) const;
+		void setValue(const ScriptVariableKey& key, const ScriptDataValue& value);
 
 		bool empty() const;
 		void clear();
 
+		// Changes whenever any variable is written to
+		uint32_t getVersion() const { return version; }
+
 	private:
-		ConfigNode dummy;
-		HashMap<String, ConfigNode> variables;
+		struct Slot {
+			uint64_t hash;
+			String name;
+			ScriptDataValue value;
+		};
+
+		// Sorted by hash, names with the same hash get a slot each
+		Vector<Slot> slots;
+		uint32_t version = 0;
+
+		// Returns whether the slot exists, and its index (or where it should be inserted)
+		std::pair<bool, size_t> findSlot(const ScriptVariableKey& key) const;
+		const Slot* tryGetSlot(const ScriptVariableKey& key) const;
+		Slot& getOrCreateSlot(const ScriptVariableKey& key);
+		void eraseSlot(const ScriptVariableKey& key);
 	};
 
 	template <>
@@ -14,6 +14,7 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "ui_factory.h"
 #include "ui_factory_tester.h"
 #include "ui_input.h"
+#include "ui_render_cache.h"
 #include "ui_root.h"
 #include "ui_sizer.h"
 #include "ui_style.h"
@@ -51,3 +52,5 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "widgets/ui_textinput.h"
 #include "widgets/ui_tooltip.h"
 #include "widgets/ui_tree_list.h"
+#include "widgets/ui_virtual_list.h"
+#include "widgets/ui_virtual_tree_list.h"
@@ -8,6 +8,7 @@ namespace Halley {
 	class Sprite;
 	class SpritePainter;
 	class Painter;
+	class UIRenderCache;
 
 	class UIPainter {
 	public:
@@ -23,16 +24,23 @@ namespace Halley {
 		void draw(std::function<void(Painter&)> f);
 		void addBounds(Rect4f bounds);
 
+		// Draws everything recorded in the cache, as long as it's valid for this painter (see canDraw)
+		void draw(const UIRenderCache& cache);
+		bool canDraw(const UIRenderCache& cache) const;
+
 		UIPainter clone() const;
 		UIPainter withAdjustedLayer(int delta) const;
 		UIPainter withClip(std::optional<Rect4f> clip) const;
 		UIPainter withMask(int mask) const;
 		UIPainter withNoClip() const;
+		// Draws through the returned painter go into the cache, which is cleared first, instead of the SpritePainter
+		UIPainter withRecording(UIRenderCache& cache) const;
 		UIPainter withAlpha(float alpha) const;
 		UIPainter withColour(Colour4f colour) const;
 
 		std::optional<Rect4f> getClip() const;
 		int getMask() const;
+		bool isRecording() const;
 
 	private:
 		SpritePainter* painter = nullptr;
@@ -42,6 +50,7 @@ namespace Halley {
 		std::optional<Colour4f> colourMultiplier;
 		mutable int currentPriority = 0;
 		const UIPainter* rootPainter = nullptr;
+		UIRenderCache* recording = nullptr;
 
 		float getCurrentPriorityAndIncrement() const;
 
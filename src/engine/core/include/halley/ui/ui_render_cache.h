@@ -0,0 +1,57 @@
+#pragma once
+
+#include "halley/data_structures/vector.h"
+#include "halley/graphics/sprite/sprite.h"
+#include "halley/graphics/text/text_renderer.h"
+#include "halley/maths/colour.h"
+#include "halley/maths/rect.h"
+#include <functional>
+#include <optional>
+
+namespace Halley {
+	class Painter;
+
+	// What a widget subtree drew through a UIPainter, kept so it can be drawn again without visiting the widgets
+	// Consecutive sprites or texts with the same mask, layer and clip are stored as one entry, and reach the SpritePainter as a single span
+	class UIRenderCache {
+	public:
+		bool isValid() const;
+		void invalidate();
+		void clear();
+
+		size_t getNumberOfEntries() const;
+
+	private:
+		friend class UIPainter;
+
+		enum class EntryType {
+			Sprites,
+			Texts,
+			Callback
+		};
+
+		struct Entry {
+			EntryType type;
+			int mask;
+			int layer;
+			std::optional<Rect4f> clip;
+			size_t start;
+			size_t count;
+		};
+
+		Vector<Entry> entries;
+		Vector<Sprite> sprites;
+		Vector<TextRenderer> texts;
+		Vector<std::function<void(Painter&)>> callbacks;
+		Vector<Rect4f> bounds;
+
+		// State of the painter it was recorded with, as it's baked into the entries
+		int mask = 0;
+		int layer = 0;
+		std::optional<Rect4f> clip;
+		std::optional<Colour4f> colourMultiplier;
+		bool valid = false;
+
+		void addEntry(EntryType type, size_t index, int mask, int layer, const std::optional<Rect4f>& clip);
+	};
+}
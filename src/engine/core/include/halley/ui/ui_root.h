@@ -122,7 +122,11 @@ namespace Halley {
 		std::shared_ptr<UIToolTip> toolTip;
 		UIInputType lastInputType = UIInputType::Keyboard;
 
-		Vector<std::shared_ptr<UIWidget>> widgetsCache;
+		// Widgets are visited through raw pointers, so any that get detached mid-update are held here until it's done
+		Vector<UIWidget*> widgetsCache;
+		Vector<std::shared_ptr<const UIWidget>> widgetsRemovedDuringUpdate;
+		uint32_t widgetsGeneration = 0;
+		bool updatingWidgets = false;
 
 		void updateWidgets(UIWidgetUpdateType type, Time t, UIInputType activeInputType, JoystickType joystickType);
 
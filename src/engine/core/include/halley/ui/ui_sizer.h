@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include "halley/maths/vector2.h"
 #include "halley/maths/vector4.h"
 #include "halley/maths/rect.h"
@@ -139,6 +140,7 @@ namespace Halley {
 		UISizer* findSizerFor(IUIElement* element);
 
 		void updateEnabled() const;
+		void invalidateLayout() const;
 		
 		void swapItems(int idxA, int idxB);
 
@@ -147,6 +149,7 @@ namespace Halley {
 		{
 			std::sort(entries.begin(), entries.end(), f);
 			sortChildrenBySizerOrder();
+			onEntriesChanged();
 		}
 
 	private:
@@ -164,6 +167,12 @@ namespace Halley {
 
 		UIParent* curParent = nullptr;
 
+		// Minimum sizes are cached until invalidateLayout() is called, which happens whenever the owning widget is marked as needing layout
+		mutable std::optional<Vector2f> minimumSize;
+		mutable std::optional<Vector2f> minimumSizeWithoutProportional;
+
+		void onEntriesChanged();
+
 		void reparentEntry(UISizerEntry& entry);
 		void unparentEntry(UISizerEntry& entry);
 
@@ -20,6 +20,7 @@ namespace Halley {
 	class UIAnchor;
 	class UIBehaviour;
 	class UIEventHandler;
+	class UIRenderCache;
 	class TextInputData;
 
 	enum class UIWidgetUpdateType {
@@ -161,6 +162,7 @@ namespace Halley {
 		}
 
 		void setMouseClip(std::optional<Rect4f> mouseClip, bool force);
+		const std::optional<Rect4f>& getMouseClip() const;
 
 		virtual void onManualControlCycleValue(int delta);
 		virtual void onManualControlAnalogueAdjustValue(float delta, Time t);
@@ -186,6 +188,12 @@ namespace Halley {
 		bool needsLayout() const;
 		void markAsNeedingLayout() final override;
 
+		// Records what this widget and its children draw, and draws that again instead of visiting them until something in the subtree changes
+		// Layout, activation and events handled in the subtree invalidate it. Widgets that change how they look in any other way should call invalidateRenderCache().
+		void setRenderCached(bool enabled);
+		bool isRenderCached() const;
+		void invalidateRenderCache();
+
 		virtual bool canReceiveFocus() const;
 		virtual bool canReceiveMouseExclusive() const;
 		std::shared_ptr<UIWidget> getFocusableOrAncestor();
@@ -210,7 +218,7 @@ namespace Halley {
 		virtual std::optional<Vector2f> transformToChildSpace(Vector2f pos) const;
 		virtual std::optional<MouseCursorMode> getMouseCursorMode() const;
 
-		virtual void collectWidgetsForUpdating(Vector<std::shared_ptr<UIWidget>>& dst);
+		virtual void collectWidgetsForUpdating(Vector<UIWidget*>& dst);
 		virtual void collectWidgetsForRendering(size_t curRootIdx, Vector<std::pair<std::shared_ptr<UIWidget>, size_t>>& dst, Vector<std::shared_ptr<UIWidget>>& dstRoots);
 
 	protected:
@@ -260,7 +268,8 @@ namespace Halley {
 
 	private:
 		void doDraw(UIPainter& painter) const;
-		void doUpdate(UIWidgetUpdateType updateType, Time t, UIInputType inputType, JoystickType joystickType, Vector<std::shared_ptr<UIWidget>>& dst);
+		void doDrawContents(UIPainter& painter) const;
+		void doUpdate(UIWidgetUpdateType updateType, Time t, UIInputType inputType, JoystickType joystickType, Vector<UIWidget*>& dst);
 		void doPostUpdate();
 
 		void setParent(UIParent* parent);
@@ -268,6 +277,7 @@ namespace Halley {
 		void notifyTreeRemovedFromRoot(UIRoot& root);
 
 		void setWidgetRect(Rect4f rect);
+		bool isInLayout() const;
 		void resetInputResults();
 		void updateActive(bool wasActiveBefore);
 		void notifyActivationChange(bool active);
@@ -297,6 +307,7 @@ namespace Halley {
 		std::optional<UISizer> sizer;
 
 		mutable Vector2f layoutSize;
+		Rect4f layoutRect;
 
 		std::shared_ptr<UIEventHandler> eventHandler;
 		std::shared_ptr<UIValidator> validator;
@@ -305,6 +316,7 @@ namespace Halley {
 		Vector<std::shared_ptr<UIBehaviour>> behaviours;
 
 		std::unique_ptr<LocalisedString> toolTip;
+		std::unique_ptr<UIRenderCache> renderCache;
 
 		int childLayerAdjustment = 0;
 
@@ -315,6 +327,8 @@ namespace Halley {
 		bool focused = false;
 		bool mouseOver = false;
 		bool positionUpdated = false;
+		bool layoutDirty = true;
+		bool inLayout = false;
 		bool modal = true;
 		bool mouseBlocker = true;
 		bool mouseInteraction = false;
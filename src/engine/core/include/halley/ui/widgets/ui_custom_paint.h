@@ -10,6 +10,8 @@ namespace Halley {
 
         void setCallback(DrawCallback callback);
 
+		void update(Time t, bool moved) override;
+
 		void draw(UIPainter& painter) const override;
 
     private:
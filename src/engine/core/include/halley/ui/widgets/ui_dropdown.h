@@ -98,6 +98,7 @@ namespace Halley {
 		};
 		
 		Sprite sprite;
+		const char* curSpriteName = nullptr;
 		UIInputButtons inputButtons;
 		std::shared_ptr<UIWidget> dropdownWindow;
 		std::shared_ptr<UIScrollPane> scrollPane;
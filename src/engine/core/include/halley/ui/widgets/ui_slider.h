@@ -83,6 +83,7 @@ namespace Halley {
 		Vector4f extra;
 
 		bool dirtyThumb = true;
+		float drawnValue = -1.0f;
 		UIStyle thumbStyle;
 
 		Sprite bar;
@@ -146,6 +146,7 @@ namespace Halley {
 		float caretTime = 0;
 		int caretPos = 0;
 		bool caretShowing = false;
+		bool wasFocused = false;
 		bool mouseHeld = false;
 
 		bool multiLine = false;
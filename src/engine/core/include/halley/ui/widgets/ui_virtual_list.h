@@ -0,0 +1,153 @@
+#pragma once
+
+#include "../ui_widget.h"
+#include "../ui_style.h"
+#include "halley/graphics/sprite/sprite.h"
+#include "ui_list.h"
+
+namespace Halley {
+	class UIVirtualList;
+
+	class IUIVirtualListSource {
+	public:
+		virtual ~IUIVirtualListSource() = default;
+
+		virtual size_t getNumberOfItems() const = 0;
+		virtual String getItemId(size_t idx) const = 0;
+		virtual std::optional<size_t> getItemIndex(const String& id) const;
+
+		// Rows are recycled as the list scrolls: makeItemWidget() creates an empty row, and bindItemWidget() fills it with item idx
+		virtual std::shared_ptr<UIWidget> makeItemWidget(UIVirtualList& list) = 0;
+		virtual void bindItemWidget(UIVirtualList& list, UIWidget& widget, size_t idx) = 0;
+	};
+
+	// A vertical list that only has widgets for the rows that are visible, plus an overscan margin on each side
+	// All rows have the same height, so the list can be scrolled through without knowing anything about the rows outside the view
+	class UIVirtualList : public UIWidget {
+	public:
+		using SelectionMode = UIList::SelectionMode;
+
+		// Style is optional, see UIList for the keys used. If rowHeight is zero, it's taken from the item style's minSize.
+		explicit UIVirtualList(String id, std::optional<UIStyle> style = {}, float rowHeight = 0);
+
+		void setSource(std::shared_ptr<IUIVirtualListSource> source);
+		const std::shared_ptr<IUIVirtualListSource>& getSource() const;
+
+		// Call when the source's items changed. Selected indices past the end are dropped.
+		void refresh();
+		void refreshItem(size_t idx);
+
+		size_t getCount() const;
+		float getRowHeight() const;
+		void setOverscan(size_t rows);
+
+		bool setSelectedOption(int option, SelectionMode mode = SelectionMode::Normal);
+		bool setSelectedOptionId(const String& id, SelectionMode mode = SelectionMode::Normal);
+		int getSelectedOption() const;
+		String getSelectedOptionId() const;
+		Vector<int> getSelectedOptions() const;
+		Vector<String> getSelectedOptionIds() const;
+		bool isSelected(size_t idx) const;
+		std::optional<int> getHoveredOption() const;
+
+		Rect4f getOptionRect(int option) const;
+		std::optional<size_t> getItemAt(Vector2f pos) const;
+		void showCurSelection(bool centre);
+
+		// Materialized rows, sorted by index
+		std::pair<size_t, size_t> getMaterializedRange() const;
+		std::shared_ptr<UIWidget> tryGetItemWidget(size_t idx) const;
+
+		bool isMultiSelect() const;
+		void setMultiSelect(bool enabled);
+		void setRequiresSelection(bool requireSelection);
+		bool isSingleClickAccept() const;
+		void setSingleClickAccept(bool enabled);
+		void setScrollToSelection(bool value);
+		bool isAcceptKeyboardInput() const;
+		void setAcceptKeyboardInput(bool value);
+		void setFocusable(bool focusable);
+
+		bool canReceiveFocus() const override;
+		Vector2f getLayoutMinimumSize(bool force) const override;
+		Vector2f getLayoutOriginPosition() const override;
+
+		void pressMouse(Vector2f mousePos, int button, KeyMods keyMods) override;
+		void releaseMouse(Vector2f mousePos, int button) override;
+		void onMouseOver(Vector2f mousePos) override;
+		void onMouseLeft(Vector2f mousePos) override;
+
+		void readFromDataBind() override;
+
+		// Materializes the rows intersecting the view, which is the list's rect clipped by the parent scroll pane, if any
+		void updateVisibleRows();
+		void updateVisibleRows(Rect4f view);
+
+	protected:
+		void draw(UIPainter& painter) const override;
+		void update(Time t, bool moved) override;
+
+		void onGamepadInput(const UIInputResults& input, Time time) override;
+		bool onKeyPress(KeyboardKeyPress key) override;
+		void moveSelection(int delta, bool wrap);
+
+		virtual void onAccept();
+		virtual void onCancel();
+
+		// Replaces the selection without notifying, for when items are moved around by the owner. Call refresh() afterwards if the count changed.
+		void setSelection(Vector<size_t> indices, int curOption);
+
+	private:
+		struct Row {
+			size_t idx;
+			std::shared_ptr<UIWidget> widget;
+			bool selected = false;
+			bool hovered = false;
+		};
+
+		std::shared_ptr<IUIVirtualListSource> source;
+		size_t nItems = 0;
+		float rowHeight = 0;
+		float gap = 0;
+		size_t overscan = 4;
+
+		Vector<Row> rows;
+		Vector<std::shared_ptr<UIWidget>> pool;
+		size_t firstRow = 0;
+		mutable float minWidth = 0;
+
+		Vector<size_t> selection;
+		int curOption = -1;
+		int curHover = -1;
+		size_t rowsPerPage = 1;
+
+		Sprite sprite;
+		Sprite selectedSprite;
+		Sprite hoverSprite;
+
+		int pressedOption = -1;
+		KeyMods pressedMods = KeyMods::None;
+		int lastClickedOption = -1;
+		Time timeSinceClick = 100.0;
+
+		bool multiSelect = false;
+		bool requiresSelection = true;
+		bool singleClickAccept = true;
+		bool scrollToSelection = true;
+		bool acceptKeyboardInput = true;
+		bool focusable = true;
+		bool notifyItemSelectionEnabled = true;
+
+		float getRowStride() const;
+		void materializeRows(size_t first, size_t last);
+		void rebindRows();
+		void updateRowStates();
+		void sendRowState(Row& row, bool force);
+		void setHover(int option);
+
+		bool changeSelection(int newItem, SelectionMode mode);
+		void select(size_t idx, bool selected);
+		void notifyNewItemSelected();
+		SelectionMode getMode(KeyMods mods, int button) const;
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ui_virtual_list.h"
+#include "halley/text/i18n.h"
+
+namespace Halley {
+	// A tree list built on UIVirtualList, for trees too big for UITreeList
+	// The tree is flattened into the visible rows whenever its structure changes, and only the rows in view have widgets
+	class UIVirtualTreeList : public UIVirtualList {
+	public:
+		UIVirtualTreeList(String id, UIStyle style);
+
+		void addTreeItem(const String& id, const String& parentId, size_t childIndex, const LocalisedString& label, Sprite icon = Sprite(), bool expanded = true);
+		void removeItem(const String& id);
+		void clearTree();
+
+		void setLabel(const String& id, const LocalisedString& label, Sprite icon);
+		void setExpanded(const String& id, bool expanded);
+		bool isExpanded(const String& id) const;
+		void expandParentsOfId(const String& id);
+
+		bool hasTreeItem(const String& id) const;
+		size_t getNumberOfTreeItems() const;
+		String getParentId(const String& id) const;
+
+		// Flattens the tree into rows, if its structure changed. Called on update.
+		void updateTree();
+
+	protected:
+		void update(Time t, bool moved) override;
+		bool onKeyPress(KeyboardKeyPress key) override;
+
+	private:
+		class Source;
+		class Row;
+
+		struct Node {
+			String id;
+			LocalisedString label;
+			Sprite icon;
+			Node* parent = nullptr;
+			Vector<Node*> children;
+			size_t childIndex = 0;
+			std::optional<size_t> row;
+			bool expanded = true;
+		};
+
+		Node root;
+		HashMap<String, std::unique_ptr<Node>> nodes;
+		Vector<Node*> flatNodes;
+		bool needsUpdate = false;
+
+		Node* tryGetNode(const String& id);
+		const Node* tryGetNode(const String& id) const;
+		Node& getNodeOrRoot(const String& id);
+		void removeNode(Node& node, Vector<std::unique_ptr<Node>>& removed);
+		void flatten(Node& node);
+		void onExpandedChanged(const String& id, bool expanded);
+
+		std::shared_ptr<UIWidget> makeRowWidget();
+		void bindRowWidget(UIWidget& widget, size_t idx);
+	};
+}
@@ -0,0 +1,128 @@
+#include "halley/data_structures/collision_world.h"
+
+using namespace Halley;
+
+CollisionShape::CollisionShape(Circle circle)
+	: type(Type::Circle)
+	, circle(circle)
+{
+}
+
+CollisionShape::CollisionShape(Polygon polygon)
+	: type(Type::Polygon)
+	, polygon(std::move(polygon))
+{
+	Expects(this->polygon.isConvex());
+}
+
+const Circle& CollisionShape::getCircle() const
+{
+	Expects(type == Type::Circle);
+	return circle;
+}
+
+const Polygon& CollisionShape::getPolygon() const
+{
+	Expects(type == Type::Polygon);
+	return polygon;
+}
+
+Rect4f CollisionShape::getAABB() const
+{
+	return type == Type::Circle ? circle.getAABB() : polygon.getAABB();
+}
+
+bool CollisionShape::overlaps(const CollisionShape& other) const
+{
+	if (type == Type::Circle && other.type == Type::Circle) {
+		return circle.overlaps(other.circle);
+	} else if (type == Type::Polygon && other.type == Type::Polygon) {
+		return polygon.collide(other.polygon);
+	} else {
+		const auto& c = type == Type::Circle ? circle : other.circle;
+		const auto& p = type == Type::Polygon ? polygon : other.polygon;
+		return p.getDistanceTo(c.getCentre()) <= c.getRadius();
+	}
+}
+
+std::optional<Ray::RayCastResult> CollisionShape::rayCast(const Ray& ray) const
+{
+	return type == Type::Circle ? ray.castCircle(circle) : ray.castPolygon(polygon);
+}
+
+CollisionWorld::CollisionWorld(float margin)
+	: tree(margin)
+{
+}
+
+CollisionWorld::Handle CollisionWorld::add(CollisionShape shape, uint64_t userData)
+{
+	const auto handle = tree.insert(shape.getAABB());
+	if (handle >= static_cast<Handle>(entries.size())) {
+		entries.reserve(handle + 1); // resize() alone doesn't grow geometrically
+		entries.resize(handle + 1);
+	}
+	entries[handle] = Entry{ std::move(shape), userData };
+	return handle;
+}
+
+void CollisionWorld::remove(Handle handle)
+{
+	getEntry(handle);
+	tree.remove(handle);
+	entries[handle].reset();
+}
+
+void CollisionWorld::setShape(Handle handle, CollisionShape shape, Vector2f displacement)
+{
+	getEntry(handle);
+	tree.move(handle, shape.getAABB(), displacement);
+	entries[handle]->shape = std::move(shape);
+}
+
+const CollisionShape& CollisionWorld::getShape(Handle handle) const
+{
+	return getEntry(handle).shape;
+}
+
+uint64_t CollisionWorld::getUserData(Handle handle) const
+{
+	return getEntry(handle).userData;
+}
+
+void CollisionWorld::getCollisions(Vector<Pair>& result) const
+{
+	const size_t start = result.size();
+	tree.getOverlappingPairs(result);
+
+	// Narrowphase
+	const auto end = std::remove_if(result.begin() + start, result.end(), [&] (const Pair& pair)
+	{
+		return !entries[pair.first]->shape.overlaps(entries[pair.second]->shape);
+	});
+	result.erase(end, result.end());
+}
+
+std::optional<CollisionWorld::RayCastHit> CollisionWorld::rayCast(const Ray& ray, float maxDistance) const
+{
+	std::optional<RayCastHit> best;
+	tree.rayCast(ray, maxDistance, [&] (Handle handle, float curMax) -> float
+	{
+		if (const auto hit = entries[handle]->shape.rayCast(ray)) {
+			if (hit->distance <= curMax && (!best || hit->distance < best->result.distance)) {
+				best = RayCastHit{ handle, *hit };
+				return hit->distance;
+			}
+		}
+		return curMax;
+	});
+	return best;
+}
+
+const CollisionWorld::Entry& CollisionWorld::getEntry(Handle handle) const
+{
+	if (handle < 0 || handle >= static_cast<Handle>(entries.size()) || !entries[handle]) {
+		throw Exception("Invalid collision world handle: " + toString(handle), HalleyExceptions::Utils);
+	}
+	return *entries[handle];
+}
@@ -0,0 +1,368 @@
+#include "halley/data_structures/dynamic_aabb_tree.h"
+#include "halley/utils/algorithm.h"
+
+using namespace Halley;
+
+DynamicAABBTree::DynamicAABBTree(float margin, float displacementMultiplier)
+	: margin(margin)
+	, displacementMultiplier(displacementMultiplier)
+{
+}
+
+DynamicAABBTree::Handle DynamicAABBTree::insert(Rect4f bounds)
+{
+	const auto leaf = allocateNode();
+	auto& node = nodes[leaf];
+	node.bounds = bounds.grow(margin);
+	node.height = 0;
+	node.moved = true;
+	moved.push_back(leaf);
+
+	insertLeaf(leaf);
+	++nElements;
+	return leaf;
+}
+
+void DynamicAABBTree::remove(Handle handle)
+{
+	Expects(handle >= 0 && handle < static_cast<Handle>(nodes.size()));
+	Expects(nodes[handle].isLeaf() && nodes[handle].height == 0);
+
+	if (nodes[handle].moved) {
+		std_ex::erase(moved, handle);
+	}
+	removeLeaf(handle);
+	freeNode(handle);
+	--nElements;
+}
+
+bool DynamicAABBTree::move(Handle handle, Rect4f bounds, Vector2f displacement)
+{
+	Expects(handle >= 0 && handle < static_cast<Handle>(nodes.size()));
+	auto& node = nodes[handle];
+	Expects(node.isLeaf() && node.height == 0);
+
+	if (node.bounds.contains(bounds)) {
+		// Still inside the fat bounds, unless they've become much larger than needed
+		const auto largeBounds = bounds.grow(4 * margin);
+		if (largeBounds.contains(node.bounds)) {
+			return false;
+		}
+	}
+
+	// Extend the fat bounds along the movement, so it can keep moving for a while without being reinserted
+	const auto d = displacement * displacementMultiplier;
+	auto fatBounds = bounds.grow(margin);
+	fatBounds = fatBounds.grow(d.x < 0 ? -d.x : 0, d.y < 0 ? -d.y : 0, d.x > 0 ? d.x : 0, d.y > 0 ? d.y : 0);
+
+	removeLeaf(handle);
+	nodes[handle].bounds = fatBounds;
+	insertLeaf(handle);
+
+	if (!nodes[handle].moved) {
+		nodes[handle].moved = true;
+		moved.push_back(handle);
+	}
+	return true;
+}
+
+void DynamicAABBTree::clear()
+{
+	nodes.clear();
+	moved.clear();
+	root = InvalidHandle;
+	freeList = InvalidHandle;
+	nElements = 0;
+}
+
+Rect4f DynamicAABBTree::getFatBounds(Handle handle) const
+{
+	return nodes.at(handle).bounds;
+}
+
+int DynamicAABBTree::getHeight() const
+{
+	return root == InvalidHandle ? 0 : nodes[root].height;
+}
+
+void DynamicAABBTree::getOverlappingPairs(Vector<Pair>& result) const
+{
+	if (root == InvalidHandle) {
+		return;
+	}
+
+	// Traverse the tree against itself, rather than querying it once per leaf. This skips whole subtrees whose bounds don't overlap, and visits each pair of nodes at most once.
+	Vector<Pair> stack;
+	stack.reserve(StackSize);
+	stack.emplace_back(root, root);
+
+	while (!stack.empty()) {
+		const auto [aIdx, bIdx] = stack.back();
+		stack.pop_back();
+		const auto& a = nodes[aIdx];
+
+		if (aIdx == bIdx) {
+			if (!a.isLeaf()) {
+				stack.emplace_back(a.child0, a.child0);
+				stack.emplace_back(a.child1, a.child1);
+				stack.emplace_back(a.child0, a.child1);
+			}
+			continue;
+		}
+
+		const auto& b = nodes[bIdx];
+		if (!a.bounds.overlaps(b.bounds)) {
+			continue;
+		}
+
+		if (a.isLeaf() && b.isLeaf()) {
+			result.emplace_back(std::min(aIdx, bIdx), std::max(aIdx, bIdx));
+		} else if (b.isLeaf() || (!a.isLeaf() && a.height >= b.height)) {
+			stack.emplace_back(a.child0, bIdx);
+			stack.emplace_back(a.child1, bIdx);
+		} else {
+			stack.emplace_back(aIdx, b.child0);
+			stack.emplace_back(aIdx, b.child1);
+		}
+	}
+}
+
+void DynamicAABBTree::getNewOverlappingPairs(Vector<Pair>& result)
+{
+	const size_t startIdx = result.size();
+
+	for (const auto handle: moved) {
+		query(nodes[handle].bounds, [&] (Handle other)
+		{
+			// If both moved, only report the pair from the lowest handle
+			if (other != handle && !(nodes[other].moved && other < handle)) {
+				result.emplace_back(std::min(handle, other), std::max(handle, other));
+			}
+			return true;
+		});
+	}
+
+	for (const auto handle: moved) {
+		nodes[handle].moved = false;
+	}
+	moved.clear();
+
+	std::sort(result.begin() + startIdx, result.end());
+}
+
+DynamicAABBTree::Handle DynamicAABBTree::allocateNode()
+{
+	if (freeList == InvalidHandle) {
+		nodes.emplace_back();
+		return static_cast<Handle>(nodes.size() - 1);
+	}
+
+	const auto idx = freeList;
+	freeList = nodes[idx].parent;
+	nodes[idx] = Node();
+	return idx;
+}
+
+void DynamicAABBTree::freeNode(Handle idx)
+{
+	auto& node = nodes[idx];
+	node.parent = freeList;
+	node.child0 = InvalidHandle;
+	node.child1 = InvalidHandle;
+	node.height = -1;
+	node.moved = false;
+	freeList = idx;
+}
+
+void DynamicAABBTree::insertLeaf(Handle leaf)
+{
+	if (root == InvalidHandle) {
+		root = leaf;
+		nodes[root].parent = InvalidHandle;
+		return;
+	}
+
+	// Find the best sibling, by descending the tree towards the child that would grow the least (surface area heuristic)
+	const auto leafBounds = nodes[leaf].bounds;
+	Handle sibling = root;
+	while (!nodes[sibling].isLeaf()) {
+		const auto& node = nodes[sibling];
+		const float area = getPerimeter(node.bounds);
+		const float combinedArea = getPerimeter(node.bounds.merge(leafBounds));
+
+		// Cost of creating a new parent for this node and the new leaf, and minimum cost of pushing the leaf further down
+		const float cost = 2.0f * combinedArea;
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto getDescendCost = [&] (Handle child)
+		{
+			const auto& c = nodes[child];
+			const float newArea = getPerimeter(c.bounds.merge(leafBounds));
+			return c.isLeaf() ? newArea + inheritanceCost : newArea - getPerimeter(c.bounds) + inheritanceCost;
+		};
+		const float cost0 = getDescendCost(node.child0);
+		const float cost1 = getDescendCost(node.child1);
+
+		if (cost < cost0 && cost < cost1) {
+			break;
+		}
+		sibling = cost0 < cost1 ? node.child0 : node.child1;
+	}
+
+	// Create a new parent for the sibling and the leaf
+	const auto oldParent = nodes[sibling].parent;
+	const auto newParent = allocateNode();
+	{
+		auto& p = nodes[newParent];
+		p.parent = oldParent;
+		p.bounds = leafBounds.merge(nodes[sibling].bounds);
+		p.height = nodes[sibling].height + 1;
+		p.child0 = sibling;
+		p.child1 = leaf;
+	}
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent == InvalidHandle) {
+		root = newParent;
+	} else if (nodes[oldParent].child0 == sibling) {
+		nodes[oldParent].child0 = newParent;
+	} else {
+		nodes[oldParent].child1 = newParent;
+	}
+
+	refit(nodes[leaf].parent);
+}
+
+void DynamicAABBTree::removeLeaf(Handle leaf)
+{
+	if (leaf == root) {
+		root = InvalidHandle;
+		return;
+	}
+
+	const auto parent = nodes[leaf].parent;
+	const auto grandParent = nodes[parent].parent;
+	const auto sibling = nodes[parent].child0 == leaf ? nodes[parent].child1 : nodes[parent].child0;
+
+	if (grandParent == InvalidHandle) {
+		root = sibling;
+		nodes[sibling].parent = InvalidHandle;
+		freeNode(parent);
+	} else {
+		// Replace the parent with the sibling
+		if (nodes[grandParent].child0 == parent) {
+			nodes[grandParent].child0 = sibling;
+		} else {
+			nodes[grandParent].child1 = sibling;
+		}
+		nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		refit(grandParent);
+	}
+}
+
+void DynamicAABBTree::refit(Handle idx)
+{
+	// Walk back up the tree, fixing heights and bounds
+	while (idx != InvalidHandle) {
+		idx = balance(idx);
+
+		auto& node = nodes[idx];
+		const auto& child0 = nodes[node.child0];
+		const auto& child1 = nodes[node.child1];
+		node.height = 1 + std::max(child0.height, child1.height);
+		node.bounds = child0.bounds.merge(child1.bounds);
+
+		idx = node.parent;
+	}
+}
+
+DynamicAABBTree::Handle DynamicAABBTree::balance(Handle aIdx)
+{
+	// If a's children are unbalanced, rotates the taller one up, and returns the index of the node now at a's position
+	auto& a = nodes[aIdx];
+	if (a.isLeaf() || a.height < 2) {
+		return aIdx;
+	}
+
+	const auto bIdx = a.child0;
+	const auto cIdx = a.child1;
+	const int heightDiff = nodes[cIdx].height - nodes[bIdx].height;
+	if (heightDiff >= -1 && heightDiff <= 1) {
+		return aIdx;
+	}
+
+	// Rotate the taller child up into a's place. Its taller grandchild stays with it, the other one moves under a
+	const bool rotateC = heightDiff > 1;
+	const auto upIdx = rotateC ? cIdx : bIdx;
+	const auto otherIdx = rotateC ? bIdx : cIdx;
+	auto& up = nodes[upIdx];
+	const auto fIdx = up.child0;
+	const auto gIdx = up.child1;
+
+	// Swap a and up
+	up.child0 = aIdx;
+	up.parent = a.parent;
+	a.parent = upIdx;
+
+	if (up.parent == InvalidHandle) {
+		root = upIdx;
+	} else if (nodes[up.parent].child0 == aIdx) {
+		nodes[up.parent].child0 = upIdx;
+	} else {
+		nodes[up.parent].child1 = upIdx;
+	}
+
+	// Keep the taller grandchild under up, move the other one under a
+	const bool keepF = nodes[fIdx].height > nodes[gIdx].height;
+	const auto keptIdx = keepF ? fIdx : gIdx;
+	const auto movedIdx = keepF ? gIdx : fIdx;
+
+	up.child1 = keptIdx;
+	if (rotateC) {
+		a.child1 = movedIdx;
+	} else {
+		a.child0 = movedIdx;
+	}
+	nodes[movedIdx].parent = aIdx;
+
+	a.bounds = nodes[otherIdx].bounds.merge(nodes[movedIdx].bounds);
+	a.height = 1 + std::max(nodes[otherIdx].height, nodes[movedIdx].height);
+	up.bounds = a.bounds.merge(nodes[keptIdx].bounds);
+	up.height = 1 + std::max(a.height, nodes[keptIdx].height);
+
+	return upIdx;
+}
+
+float DynamicAABBTree::getPerimeter(const Rect4f& rect)
+{
+	return 2.0f * (rect.getWidth() + rect.getHeight());
+}
+
+bool DynamicAABBTree::rayHitsBounds(Vector2f origin, Vector2f invDir, const Rect4f& bounds, float maxDistance)
+{
+	// Slab test
+	float tMin = 0;
+	float tMax = maxDistance;
+
+	auto testSlab = [&] (float o, float inv, float minVal, float maxVal) -> bool
+	{
+		if (std::isinf(inv)) {
+			// Parallel to the slab
+			return o >= minVal && o <= maxVal;
+		}
+		float t0 = (minVal - o) * inv;
+		float t1 = (maxVal - o) * inv;
+		if (t0 > t1) {
+			std::swap(t0, t1);
+		}
+		tMin = std::max(tMin, t0);
+		tMax = std::min(tMax, t1);
+		return tMin <= tMax;
+	};
+
+	return testSlab(origin.x, invDir.x, bounds.getLeft(), bounds.getRight())
+		&& testSlab(origin.y, invDir.y, bounds.getTop(), bounds.getBottom());
+}
@@ -0,0 +1,106 @@
+#include "halley/data_structures/static_bvh.h"
+#include <limits>
+
+using namespace Halley;
+
+StaticBVH::StaticBVH(gsl::span<const Rect4f> bounds)
+{
+	build(bounds);
+}
+
+void StaticBVH::build(gsl::span<const Rect4f> bounds)
+{
+	clear();
+	if (bounds.empty()) {
+		return;
+	}
+
+	Vector<BuildEntry> entries;
+	entries.reserve(bounds.size());
+	for (size_t i = 0; i < bounds.size(); ++i) {
+		entries.push_back(BuildEntry{ bounds[i], bounds[i].getCenter(), static_cast<Index>(i) });
+	}
+
+	nodes.reserve(bounds.size() / (Width - 1) + 1);
+	buildNode(entries);
+}
+
+void StaticBVH::clear()
+{
+	nodes.clear();
+}
+
+int32_t StaticBVH::buildNode(gsl::span<BuildEntry> entries)
+{
+	// Split into up to four groups, by halving along the longest axis twice
+	std::array<gsl::span<BuildEntry>, Width> groups;
+	size_t nGroups = 0;
+
+	auto split = [] (gsl::span<BuildEntry> range) -> std::pair<gsl::span<BuildEntry>, gsl::span<BuildEntry>>
+	{
+		auto centres = Rect4f(range[0].centre, range[0].centre);
+		for (const auto& e: range) {
+			centres = centres.merge(e.centre);
+		}
+		const bool alongX = centres.getWidth() >= centres.getHeight();
+
+		const size_t mid = range.size() / 2;
+		std::nth_element(range.begin(), range.begin() + mid, range.end(), [&] (const BuildEntry& a, const BuildEntry& b)
+		{
+			return alongX ? a.centre.x < b.centre.x : a.centre.y < b.centre.y;
+		});
+		return { range.subspan(0, mid), range.subspan(mid) };
+	};
+
+	if (entries.size() <= Width) {
+		for (size_t i = 0; i < entries.size(); ++i) {
+			groups[nGroups++] = entries.subspan(i, 1);
+		}
+	} else {
+		const auto [a, b] = split(entries);
+		for (const auto& half: { a, b }) {
+			const auto [c, d] = split(half);
+			groups[nGroups++] = c;
+			groups[nGroups++] = d;
+		}
+	}
+
+	const auto nodeIdx = static_cast<int32_t>(nodes.size());
+	nodes.emplace_back();
+
+	for (size_t i = 0; i < Width; ++i) {
+		if (i >= nGroups) {
+			constexpr float inf = std::numeric_limits<float>::infinity();
+			auto& node = nodes[nodeIdx];
+			node.minX[i] = inf;
+			node.minY[i] = inf;
+			node.maxX[i] = -inf;
+			node.maxY[i] = -inf;
+			node.child[i] = EmptySlot;
+			continue;
+		}
+
+		const bool isLeaf = groups[i].size() == 1;
+		const auto bounds = isLeaf ? groups[i][0].bounds : getBounds(groups[i]);
+		const auto child = isLeaf ? -static_cast<int32_t>(groups[i][0].idx) - 1 : buildNode(groups[i]);
+
+		// Note that nodes might have been reallocated by the recursion above
+		auto& node = nodes[nodeIdx];
+		node.minX[i] = bounds.getLeft();
+		node.minY[i] = bounds.getTop();
+		node.maxX[i] = bounds.getRight();
+		node.maxY[i] = bounds.getBottom();
+		node.child[i] = child;
+	}
+
+	return nodeIdx;
+}
+
+Rect4f StaticBVH::getBounds(gsl::span<const BuildEntry> entries)
+{
+	auto result = entries[0].bounds;
+	for (const auto& e: entries) {
+		result = result.merge(e.bounds);
+	}
+	return result;
+}
@@ -31,9 +31,10 @@ char* TempMemoryPool::allocate(size_t n, size_t alignment)
 	}
 
 	// Pool is full!
-	if (allowPaging && n < capacity) {
+	if (allowPaging) {
 		if (!nextPage) {
-			nextPage = std::make_unique<TempMemoryPool>(capacity, allowPaging);
+			// Requests that don't fit in a regular page get a page big enough for them, which is then kept for the following frames
+			nextPage = std::make_unique<TempMemoryPool>(std::max(capacity, 2 * (n + alignment)), allowPaging);
 		}
 		return nextPage->allocate(n, alignment);
 	}
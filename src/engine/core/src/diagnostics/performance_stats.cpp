@@ -286,7 +286,9 @@ void PerformanceStatsView::drawHeader(Painter& painter, bool simple)
 	strBuilder.append(toString(painter.getPrevDrawCalls()));
 	strBuilder.append(" calls | ");
 	strBuilder.append(toString(painter.getPrevTriangles()));
-	strBuilder.append(" tris\n");
+	strBuilder.append(" tris | ");
+	strBuilder.append(toString(painter.getPrevBindsAvoided()));
+	strBuilder.append(" binds saved\n");
 	strBuilder.append(formatTime(updateAvgTime), updateCol);
 	strBuilder.append(" ms / ");
 	strBuilder.append(formatTime(cpuRenderAvgTime), renderCol);
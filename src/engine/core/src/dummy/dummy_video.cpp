@@ -88,6 +88,11 @@ void DummyTexture::doLoad(TextureDescriptor&)
 	doneLoading();
 }
 
+void DummyTexture::reload(Resource&& resource)
+{
+	moveFrom(dynamic_cast<DummyTexture&>(resource));
+}
+
 int DummyShader::getUniformLocation(const String&, ShaderType)
 {
 	return 0;
@@ -116,6 +121,15 @@ void DummyPainter::setVertices(const MaterialDefinition&, size_t, const void*, s
 
 void DummyPainter::drawTriangles(size_t) {}
 
+bool DummyPainter::supportsInstancing() const
+{
+	return true;
+}
+
+void DummyPainter::setInstances(const MaterialDefinition&, size_t, const void*) {}
+
+void DummyPainter::drawInstancedQuads(size_t) {}
+
 void DummyPainter::setViewPort(Rect4i) {}
 
 void DummyPainter::setClip(Rect4i, bool) {}
@@ -123,3 +137,23 @@ void DummyPainter::setClip(Rect4i, bool) {}
 void DummyPainter::setMaterialData(const Material&) {}
 
 void DummyPainter::onUpdateProjection(Material&, bool) {}
+
+gsl::span<char> DummyPainter::getVertexStreamMemory()
+{
+	if (vertexStreamMemory.empty()) {
+		vertexStreamMemory.resize(16 * 1024 * 1024);
+	}
+	return vertexStreamMemory;
+}
+
+gsl::span<char> DummyPainter::getIndexStreamMemory()
+{
+	if (indexStreamMemory.empty()) {
+		indexStreamMemory.resize(2 * 1024 * 1024);
+	}
+	return indexStreamMemory;
+}
+
+void DummyPainter::setStreamedVertices(const MaterialDefinition&, size_t, size_t, size_t, size_t, bool) {}
+
+void DummyPainter::setStreamedInstances(const MaterialDefinition&, size_t, size_t) {}
@@ -35,6 +35,7 @@ namespace Halley {
 	public:
 		explicit DummyTexture(Vector2i size);
 		void doLoad(TextureDescriptor& descriptor) override;
+		void reload(Resource&& resource) override;
 	};
 
 	class DummyShader : public Shader
@@ -60,9 +61,22 @@ namespace Halley {
 		void doEndRender() override;
 		void setVertices(const MaterialDefinition& material, size_t numVertices, const void* vertexData, size_t numIndices, const IndexType* indices, bool standardQuadsOnly) override;
 		void drawTriangles(size_t numIndices) override;
+		bool supportsInstancing() const override;
+		void setInstances(const MaterialDefinition& material, size_t numInstances, const void* instanceData) override;
+		void drawInstancedQuads(size_t numInstances) override;
 		void setViewPort(Rect4i rect) override;
 		void setClip(Rect4i clip, bool enable) override;
 		void setMaterialData(const Material& material) override;
 		void onUpdateProjection(Material& material, bool hashChanged) override;
+
+		gsl::span<char> getVertexStreamMemory() override;
+		gsl::span<char> getIndexStreamMemory() override;
+		void setStreamedVertices(const MaterialDefinition& material, size_t numVertices, size_t vertexOffset, size_t numIndices, size_t indexOffset, bool standardQuadsOnly) override;
+		void setStreamedInstances(const MaterialDefinition& material, size_t numInstances, size_t offset) override;
+
+	private:
+		// Stands in for persistently mapped buffers
+		Vector<char> vertexStreamMemory;
+		Vector<char> indexStreamMemory;
 	};
 }
@@ -22,6 +22,16 @@ ScriptEnvironment& ScriptingService::getEnvironment() const
 	return *scriptEnvironment;
 }
 
+void ScriptingService::setParallelUpdate(bool enabled)
+{
+	parallelUpdate = enabled;
+}
+
+bool ScriptingService::isParallelUpdate() const
+{
+	return parallelUpdate;
+}
+
 ConfigNode ScriptingService::evaluateExpression(const String& expression, bool useResultCache) const
 {
 	if (useResultCache) {
@@ -91,5 +101,6 @@ std::shared_ptr<ScriptingService> ScriptingService::clone(std::unique_ptr<Script
 		result->setLuaGlobal(key, value);
 	}
 	result->resultCache = resultCache;
+	result->parallelUpdate = parallelUpdate;
 	return result;
 }
@@ -20,6 +20,7 @@
 #include "../dummy/dummy_plugins.h"
 #include "halley/entry/entry_point.h"
 #include "halley/graphics/render_snapshot.h"
+#include "halley/graphics/texture_streamer.h"
 #include "halley/devcon/devcon_client.h"
 #include "halley/input/input_joystick.h"
 #include "halley/net/connection/network_service.h"
@@ -432,6 +433,11 @@ void Core::tickFrame(Time time)
 		}
 	}
 
+	// Nothing is rendering at this point, so streamed textures can be swapped
+	if (auto* streamer = resources->getTextureStreamer()) {
+		streamer->update();
+	}
+
 	endFrameData(multithreaded, time);
 	BaseFrameData::setThreadFrameData(nullptr);
 
@@ -0,0 +1,189 @@
+#include "halley/graphics/headless_renderer.h"
+
+#include "halley/graphics/camera.h"
+#include "halley/graphics/painter.h"
+#include "halley/graphics/render_context.h"
+#include "halley/graphics/shader.h"
+#include "halley/graphics/texture.h"
+#include "halley/graphics/material/material_definition.h"
+#include "halley/graphics/render_target/render_target_screen.h"
+#include "halley/resources/resource_locator.h"
+#include "halley/resources/resources.h"
+#include "../dummy/dummy_system.h"
+#include "../dummy/dummy_video.h"
+
+using namespace Halley;
+
+namespace {
+	Vector<MaterialAttribute> makeAttributes(std::initializer_list<std::pair<const char*, ShaderParameterType>> entries)
+	{
+		Vector<MaterialAttribute> result;
+		for (const auto& [name, type]: entries) {
+			result.emplace_back(name, type, 0);
+		}
+		return result;
+	}
+
+	// See shared_assets/material/sprite_base.material
+	Vector<MaterialAttribute> makeSpriteAttributes()
+	{
+		auto result = makeAttributes({
+			{ "vertPos", ShaderParameterType::Float4 },
+			{ "position", ShaderParameterType::Float2 },
+			{ "pivot", ShaderParameterType::Float2 },
+			{ "size", ShaderParameterType::Float2 },
+			{ "scale", ShaderParameterType::Float2 },
+			{ "colour", ShaderParameterType::Float4 },
+			{ "texCoord0", ShaderParameterType::Float4 },
+			{ "texCoord1", ShaderParameterType::Float4 },
+			{ "custom0", ShaderParameterType::Float4 },
+			{ "custom1", ShaderParameterType::Float4 },
+			{ "custom2", ShaderParameterType::Float4 },
+			{ "custom3", ShaderParameterType::Float4 },
+			{ "rotation", ShaderParameterType::Float },
+			{ "textureRotation", ShaderParameterType::Float }
+		});
+		result[0].isVertexPos = true;
+		return result;
+	}
+
+	// See shared_assets/material/line_base.material
+	Vector<MaterialAttribute> makeLineAttributes()
+	{
+		return makeAttributes({
+			{ "colour", ShaderParameterType::Float4 },
+			{ "dashing", ShaderParameterType::Float4 },
+			{ "position", ShaderParameterType::Float2 },
+			{ "normal", ShaderParameterType::Float2 },
+			{ "width", ShaderParameterType::Float2 }
+		});
+	}
+
+	// See shared_assets/material/blit.material
+	Vector<MaterialAttribute> makeBlitAttributes()
+	{
+		return makeAttributes({
+			{ "position", ShaderParameterType::Float4 },
+			{ "texCoord0", ShaderParameterType::Float4 }
+		});
+	}
+}
+
+HeadlessRenderer::HeadlessRenderer(Vector2i screenSize)
+{
+	system = std::make_shared<DummySystemAPI>();
+	video = std::make_shared<DummyVideoAPI>(*system);
+	api.system = system.get();
+	api.video = video.get();
+
+	resources = std::make_unique<Resources>(std::unique_ptr<ResourceLocator>(), api, ResourceOptions());
+	resources->init<Texture>();
+	resources->init<MaterialDefinition>();
+	resources->of<Texture>().setResourceLoader([this] (std::string_view name, ResourceLoadPriority)
+	{
+		return makeTexture(name);
+	});
+	resources->of<MaterialDefinition>().setResourceLoader([this] (std::string_view name, ResourceLoadPriority)
+	{
+		return makeMaterialDefinition(name);
+	});
+
+	painter = video->makePainter(*resources);
+	screenTarget = std::make_unique<ScreenRenderTarget>(Rect4i(Vector2i(), screenSize));
+	camera = std::make_unique<Camera>(Vector2f(screenSize) * 0.5f);
+}
+
+HeadlessRenderer::~HeadlessRenderer()
+{
+	painter.reset();
+	resources.reset();
+}
+
+const HalleyAPI& HeadlessRenderer::getAPI() const
+{
+	return api;
+}
+
+Resources& HeadlessRenderer::getResources() const
+{
+	return *resources;
+}
+
+Painter& HeadlessRenderer::getPainter() const
+{
+	return *painter;
+}
+
+Camera& HeadlessRenderer::getCamera() const
+{
+	return *camera;
+}
+
+void HeadlessRenderer::render(const std::function<void(RenderContext&)>& f)
+{
+	video->startRender();
+	painter->startRender();
+	{
+		RenderContext context(*painter, *camera, *screenTarget);
+		f(context);
+	}
+	painter->endRender();
+	video->finishRender();
+}
+
+std::shared_ptr<MaterialDefinition> HeadlessRenderer::makeMaterialDefinition(std::string_view name) const
+{
+	auto uniform = [] (const char* name, ShaderParameterType type)
+	{
+		return MaterialUniform(name, type, ShaderParameterSemanticType::Number, {}, 0, false);
+	};
+
+	const auto nameStr = String(name);
+	auto result = std::make_shared<MaterialDefinition>();
+	result->setName(nameStr);
+
+	Vector<MaterialUniformBlock> uniformBlocks;
+	uniformBlocks.emplace_back("HalleyBlock", Vector<MaterialUniform>{
+		uniform("u_mvp", ShaderParameterType::Matrix4),
+		uniform("u_viewPortSize", ShaderParameterType::Float2)
+	});
+
+	int nPasses = 1;
+	if (nameStr == "Halley/MaterialBase") {
+		nPasses = 0;
+	} else if (nameStr == "Halley/SolidLine" || nameStr == "Halley/SolidPolygon") {
+		result->setAttributes(makeLineAttributes());
+	} else if (nameStr.startsWith("Halley/Blit")) {
+		result->setAttributes(makeBlitAttributes());
+		result->setTextures({ MaterialTexture("tex0", "", TextureSamplerType::Texture2D) });
+	} else if (nameStr == "Halley/Text") {
+		// See shared_assets/material/text.material
+		result->setAttributes(makeSpriteAttributes());
+		result->setTextures({ MaterialTexture("tex0", "", TextureSamplerType::Texture2D) });
+		uniformBlocks.emplace_back("MaterialBlock", Vector<MaterialUniform>{
+			uniform("u_smoothness", ShaderParameterType::Float),
+			uniform("u_outline", ShaderParameterType::Float),
+			uniform("u_shadowSmoothness", ShaderParameterType::Float),
+			uniform("u_shadowDistance", ShaderParameterType::Float2),
+			uniform("u_outlineColour", ShaderParameterType::Float4),
+			uniform("u_shadowColour", ShaderParameterType::Float4)
+		});
+		nPasses = 3;
+	} else {
+		result->setAttributes(makeSpriteAttributes());
+		result->setTextures({ MaterialTexture("image", "", TextureSamplerType::Texture2D) });
+	}
+
+	result->setUniformBlocks(std::move(uniformBlocks));
+	for (int i = 0; i < nPasses; ++i) {
+		result->addPass(MaterialPass(video->createShader(ShaderDefinition()), BlendMode::Alpha));
+	}
+
+	result->initialize(*video);
+	return result;
+}
+
+std::shared_ptr<Texture> HeadlessRenderer::makeTexture(std::string_view name) const
+{
+	return video->createTexture(Vector2i(256, 256));
+}
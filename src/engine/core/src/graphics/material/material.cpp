@@ -2,7 +2,6 @@
 #include "halley/graphics/material/material.h"
 #include "halley/graphics/material/material_definition.h"
 #include "halley/graphics/material/material_parameter.h"
-#include "halley/graphics/painter.h"
 #include "halley/graphics/shader.h"
 #include "halley/api/video_api.h"
 #include "halley/graphics/sprite/sprite_sheet.h"
@@ -12,9 +11,8 @@
 using namespace Halley;
 
 namespace {
-	const Material* currentMaterial = nullptr;
-	int currentPass = 0;
-	uint64_t currentHash = 0;
+	// Only taken the first time a hash is read after a change, so it doesn't need to be per material
+	std::mutex hashMutex;
 }
 
 MaterialDataBlock::MaterialDataBlock()
@@ -28,16 +26,43 @@ MaterialDataBlock::MaterialDataBlock(MaterialDataBlockType type, size_t size, in
 {
 }
 
+MaterialDataBlock::MaterialDataBlock(const MaterialDataBlock& other)
+	: data(other.data)
+	, dataBlockType(other.dataBlockType)
+	, bindPoint(other.bindPoint)
+{
+}
+
 MaterialDataBlock::MaterialDataBlock(MaterialDataBlock&& other) noexcept
 	: data(std::move(other.data))
 	, dataBlockType(other.dataBlockType)
-	, needToUpdateHash(other.needToUpdateHash)
+	, needToUpdateHash(other.needToUpdateHash.load())
 	, bindPoint(other.bindPoint)
 	, hash(other.hash)
 {
 	other.hash = 0;
 }
 
+MaterialDataBlock& MaterialDataBlock::operator=(const MaterialDataBlock& other)
+{
+	data = other.data;
+	dataBlockType = other.dataBlockType;
+	bindPoint = other.bindPoint;
+	needToUpdateHash = true;
+	return *this;
+}
+
+MaterialDataBlock& MaterialDataBlock::operator=(MaterialDataBlock&& other) noexcept
+{
+	data = std::move(other.data);
+	dataBlockType = other.dataBlockType;
+	bindPoint = other.bindPoint;
+	needToUpdateHash = other.needToUpdateHash.load();
+	hash = other.hash;
+	other.hash = 0;
+	return *this;
+}
+
 gsl::span<const gsl::byte> MaterialDataBlock::getData() const
 {
 	return gsl::as_bytes(gsl::span<const Byte>(data));
@@ -45,11 +70,14 @@ gsl::span<const gsl::byte> MaterialDataBlock::getData() const
 
 uint64_t MaterialDataBlock::getHash() const
 {
-	if (needToUpdateHash) {
-		needToUpdateHash = false;
-		Hash::Hasher hasher;
-		hasher.feedBytes(getData());
-		hash = hasher.digest();
+	if (needToUpdateHash.load(std::memory_order_acquire)) {
+		std::unique_lock<std::mutex> lock(hashMutex);
+		if (needToUpdateHash.load(std::memory_order_relaxed)) {
+			Hash::Hasher hasher;
+			hasher.feedBytes(getData());
+			hash = hasher.digest();
+			needToUpdateHash.store(false, std::memory_order_release);
+		}
 	}
 	return hash;
 }
@@ -174,26 +202,6 @@ void Material::initUniforms(bool forceLocalBlocks)
 	}
 }
 
-void Material::bind(int passNumber, Painter& painter) const
-{
-	// Avoid redundant work
-	if (currentMaterial == this && currentPass == passNumber && currentHash == getFullHash()) {
-		return;
-	}
-	currentMaterial = this;
-	currentPass = passNumber;
-	currentHash = getFullHash();
-
-	painter.setMaterialPass(*this, passNumber);
-}
-
-void Material::resetBindCache()
-{
-	currentMaterial = nullptr;
-	currentPass = 0;
-	currentHash = 0;
-}
-
 bool Material::operator==(const Material& other) const
 {
 	// Same instance
@@ -287,6 +295,18 @@ bool Material::isUniformEqualTo(int blockNumber, size_t offset, ShaderParameterT
 	return dataBlocks[blockNumber].isEqualTo(offset, type, data);
 }
 
+void Material::updateHashes() const
+{
+	// Readers that see the flag cleared also see the values written before it was cleared
+	if (needToUpdateHash.load(std::memory_order_acquire)) {
+		std::unique_lock<std::mutex> lock(hashMutex);
+		if (needToUpdateHash.load(std::memory_order_relaxed)) {
+			computeHashes();
+			needToUpdateHash.store(false, std::memory_order_release);
+		}
+	}
+}
+
 void Material::computeHashes() const
 {
 	Hash::Hasher hasher;
@@ -309,6 +329,20 @@ void Material::computeHashes() const
 	}
 
 	fullHashValue = hasher.digest();
+
+	hasher.reset();
+	hasher.feed(materialDefinition.get());
+	const auto shaderHash = hasher.digest();
+	hasher.feed(stencilReferenceOverride.has_value());
+	hasher.feed(stencilReferenceOverride.value_or(0));
+	hasher.feed(depthStencilEnabled);
+	for (const auto& texture: textures) {
+		hasher.feed(texture.get());
+	}
+	stateHashValue = hasher.digest();
+
+	// 24 bits of shader, 24 bits of textures and state, 16 bits of uniform data
+	sortKeyValue = ((shaderHash >> 40) << 40) | ((stateHashValue >> 40) << 16) | (partialHashValue >> 48);
 }
 
 const std::shared_ptr<const Texture>& Material::getFallbackTexture() const
@@ -498,22 +532,28 @@ bool Material::hasParameter(std::string_view name) const
 
 uint64_t Material::getPartialHash() const
 {
-	if (needToUpdateHash) {
-		computeHashes();
-		needToUpdateHash = false;
-	}
+	updateHashes();
 	return partialHashValue;
 }
 
 uint64_t Material::getFullHash() const
 {
-	if (needToUpdateHash) {
-		computeHashes();
-		needToUpdateHash = false;
-	}
+	updateHashes();
 	return fullHashValue;
 }
 
+uint64_t Material::getStateHash() const
+{
+	updateHashes();
+	return stateHashValue;
+}
+
+uint64_t Material::getSortKey() const
+{
+	updateHashes();
+	return sortKeyValue;
+}
+
 MaterialParameter Material::getParameter(std::string_view name)
 {
 	for (const auto& block: materialDefinition->getUniformBlocks()) {
@@ -356,6 +356,11 @@ size_t MaterialDefinition::getVertexPosOffset() const
 	return size_t(vertexPosOffset);
 }
 
+bool MaterialDefinition::hasVertexPos() const
+{
+	return std::any_of(attributes.begin(), attributes.end(), [] (const MaterialAttribute& a) { return a.isVertexPos; });
+}
+
 void MaterialDefinition::setAttributes(Vector<MaterialAttribute> attributes)
 {
 	this->attributes = std::move(attributes);
@@ -13,6 +13,7 @@
 
 #include "halley/api/video_api.h"
 #include "halley/graphics/render_snapshot.h"
+#include "halley/graphics/streaming_buffer.h"
 #include "halley/maths/bezier.h"
 #include "halley/maths/polygon.h"
 #include "halley/support/logger.h"
@@ -48,21 +49,40 @@ Painter::~Painter()
 
 void Painter::startRender()
 {
-	Material::resetBindCache();
+	resetBindCache();
 	prevDrawCalls = nDrawCalls;
 	prevTriangles = nTriangles;
 	prevVertices = nVertices;
-	nDrawCalls = nTriangles = nVertices = 0;
+	prevBytesUploaded = nBytesUploaded;
+	prevBytesStreamed = nBytesStreamed;
+	prevBindsAvoided = nBindsAvoided;
+	nDrawCalls = nTriangles = nVertices = nBytesUploaded = nBytesStreamed = nBindsAvoided = 0;
 	frameStart = frameEnd = 0;
 
 	refreshConstantBufferCache();
 	resetPending();
 	doStartRender();
+
+	if (!vertexStream) {
+		const auto vertexMemory = getVertexStreamMemory();
+		const auto indexMemory = getIndexStreamMemory();
+		if (!vertexMemory.empty() && !indexMemory.empty()) {
+			vertexStream = std::make_unique<StreamingBuffer>(vertexMemory, streamRegions);
+			indexStream = std::make_unique<StreamingBuffer>(indexMemory, streamRegions);
+		}
+	}
+	if (vertexStream) {
+		waitForStreamRegion(vertexStream->startFrame());
+		indexStream->startFrame();
+	}
 }
 
 void Painter::endRender()
 {
 	flush();
+	if (vertexStream) {
+		fenceStreamRegion(vertexStream->getCurrentRegion());
+	}
 	
 	ProfilerEvent event(ProfilerEventType::PainterEndRender);
 	doEndRender();
@@ -98,12 +118,16 @@ void Painter::clear(std::optional<Colour> colour, std::optional<float> depth, st
 	if (recordingSnapshot) {
 		const auto commandIdx = recordingSnapshot->getNumCommands();
 		recordingSnapshot->clear(colour, depth, stencil);
+		if (deferred) {
+			return;
+		}
 		recordTimestamp(TimestampType::CommandStart, commandIdx);
 		doClear(colour, depth, stencil);
 		recordTimestamp(TimestampType::CommandEnd, commandIdx);
 	} else {
 		doClear(colour, depth, stencil);
 	}
+	resetBindCache();
 }
 
 static Vector4f& getVertPos(char* vertexAttrib, size_t vertPosOffset)
@@ -119,7 +143,7 @@ Painter::PainterVertexData Painter::addDrawData(const std::shared_ptr<const Mate
 	if (numVertices > maxVertices) {
 		throw Exception("Too many vertices in draw call: " + toString(numVertices) + ", maximum is " + toString(maxVertices), HalleyExceptions::Graphics);
 	}
-	if (verticesPending + numVertices > maxVertices) {
+	if (verticesPending + numVertices > maxVertices || instancesPending > 0) {
 		flushPending();
 	}
 
@@ -134,11 +158,10 @@ Painter::PainterVertexData Painter::addDrawData(const std::shared_ptr<const Mate
 	result.vertexSize = material->getDefinition().getVertexSize();
 	result.vertexStride = material->getDefinition().getVertexStride();
 	result.dataSize = numVertices * result.vertexStride;
-	makeSpaceForPendingVertices(result.dataSize);
-	makeSpaceForPendingIndices(numIndices);
+	makeSpaceForPending(result.dataSize, numIndices);
 
-	result.dstVertex = vertexBuffer.data() + bytesPending;
-	result.dstIndex = indexBuffer.data() + indicesPending;
+	result.dstVertex = getPendingVertices() + bytesPending;
+	result.dstIndex = getPendingIndices() + indicesPending;
 	result.firstIndex = static_cast<IndexType>(verticesPending);
 
 	indicesPending += numIndices;
@@ -151,6 +174,36 @@ Painter::PainterVertexData Painter::addDrawData(const std::shared_ptr<const Mate
 	return result;
 }
 
+char* Painter::addInstanceData(const std::shared_ptr<const Material>& material, size_t numInstances)
+{
+	updateClip();
+
+	if (verticesPending > 0) {
+		flushPending();
+	}
+
+	Expects(material != nullptr);
+	Expects(numInstances > 0);
+
+	startDrawCall(material);
+
+	const size_t dataSize = numInstances * material->getDefinition().getVertexStride();
+	makeSpaceForPending(dataSize, 0);
+	char* result = getPendingVertices() + bytesPending;
+
+	instancesPending += numInstances;
+	bytesPending += dataSize;
+
+	pendingDebugGroupStack = curDebugGroupStack;
+
+	return result;
+}
+
+bool Painter::canDrawInstanced(const MaterialDefinition& material) const
+{
+	return instancingEnabled && supportsInstancing() && material.hasVertexPos();
+}
+
 void Painter::draw(const std::shared_ptr<const Material>& material, size_t numVertices, const void* vertexData, gsl::span<const IndexType> indices, PrimitiveType primitiveType)
 {
 	Expects(primitiveType == PrimitiveType::Triangle);
@@ -180,6 +233,13 @@ void Painter::drawSprites(const std::shared_ptr<const Material>& material, size_
 {
 	Expects(vertexData != nullptr);
 
+	if (totalNumSprites > 0 && canDrawInstanced(material->getDefinition())) {
+		// The vertPos in each sprite's data is left as is, the backend supplies it from the unit quad
+		char* dst = addInstanceData(material, totalNumSprites);
+		memcpy(dst, vertexData, totalNumSprites * material->getDefinition().getVertexStride());
+		return;
+	}
+
 	constexpr size_t verticesPerSprite = 4;
 	constexpr size_t maxSpritesPerCall = (static_cast<size_t>(std::numeric_limits<IndexType>::max()) + 1) / verticesPerSprite;
 	size_t numSpritesLeft = totalNumSprites;
@@ -213,6 +273,47 @@ void Painter::drawSprites(const std::shared_ptr<const Material>& material, size_
 	}
 }
 
+void Painter::drawSprites(const std::shared_ptr<const Material>& material, size_t totalNumSprites, const SpriteWriter& writeSprites)
+{
+	if (totalNumSprites == 0) {
+		return;
+	}
+
+	if (canDrawInstanced(material->getDefinition())) {
+		char* dst = addInstanceData(material, totalNumSprites);
+		writeSprites(0, totalNumSprites, dst, material->getDefinition().getVertexStride());
+		return;
+	}
+
+	constexpr size_t verticesPerSprite = 4;
+	constexpr size_t maxSpritesPerCall = (static_cast<size_t>(std::numeric_limits<IndexType>::max()) + 1) / verticesPerSprite;
+	const size_t vertPosOffset = material->getDefinition().getVertexPosOffset();
+
+	for (size_t start = 0; start < totalNumSprites; start += maxSpritesPerCall) {
+		const size_t numSprites = std::min(totalNumSprites - start, maxSpritesPerCall);
+		const auto result = addDrawData(material, verticesPerSprite * numSprites, numSprites * 6, true);
+
+		// Each sprite is written to its first vertex, and then copied to the other three
+		const size_t spriteStride = verticesPerSprite * result.vertexStride;
+		writeSprites(start, start + numSprites, result.dstVertex, spriteStride);
+
+		for (size_t i = 0; i < numSprites; i++) {
+			char* sprite = result.dstVertex + i * spriteStride;
+			for (size_t j = 0; j < verticesPerSprite; j++) {
+				if (j > 0) {
+					memcpy(sprite + j * result.vertexStride, sprite, result.vertexSize);
+				}
+
+				constexpr static Vector2f vertPosList[] = { Vector2f(0, 0), Vector2f(1, 0), Vector2f(1, 1), Vector2f(0, 1)};
+				const auto vertPos = Vector4f(vertPosList[j], vertPosList[j]);
+				memcpy(sprite + j * result.vertexStride + vertPosOffset, &vertPos, sizeof(vertPos));
+			}
+		}
+
+		generateQuadIndices(result.firstIndex, numSprites, result.dstIndex);
+	}
+}
+
 void Painter::drawSlicedSprite(const std::shared_ptr<const Material>& material, Vector2f scale, Vector4f slices, const void* vertexData)
 {
 	Expects(vertexData != nullptr);
@@ -489,6 +590,19 @@ void Painter::blitTexture(const std::shared_ptr<const Texture>& texture, TargetB
 	material->set(0, std::shared_ptr<const Texture>{});
 }
 
+void Painter::setInstancingEnabled(bool enabled)
+{
+	if (instancingEnabled != enabled) {
+		flush();
+		instancingEnabled = enabled;
+	}
+}
+
+bool Painter::isInstancingEnabled() const
+{
+	return instancingEnabled;
+}
+
 void Painter::setLogging(bool logging)
 {
 	this->logging = logging;
@@ -529,13 +643,15 @@ void Painter::stopRecording()
 
 		recordTimestamp(TimestampType::FrameEnd, 0);
 		endPerformanceMeasurement();
-
-		if (recordingSnapshot) {
-			recordingSnapshot->end();
-			recordingSnapshot = nullptr;
-		}
 		recordingPerformance = false;
 	}
+
+	// Backends without performance measurement still record snapshots
+	if (recordingSnapshot) {
+		flush();
+		recordingSnapshot->end();
+		recordingSnapshot = nullptr;
+	}
 }
 
 bool Painter::startPerformanceMeasurement()
@@ -579,6 +695,46 @@ void Painter::onTimestamp(ITimestampRecorder* snapshot, TimestampType type, size
 	}
 }
 
+void Painter::makeSpaceForPending(size_t numBytes, size_t numIndices)
+{
+	auto fitsInStream = [&] ()
+	{
+		return vertexStream
+			&& bytesPending + numBytes <= vertexStream->getFreeSpace().size()
+			&& (indicesPending + numIndices) * sizeof(IndexType) <= indexStream->getFreeSpace().size();
+	};
+
+	if (pendingInStream) {
+		if (fitsInStream()) {
+			return;
+		}
+
+		// Region is running out, draw what's there and start this batch over
+		auto material = materialPending;
+		flushPending();
+		startDrawCall(material);
+	}
+
+	if (bytesPending == 0 && indicesPending == 0) {
+		pendingInStream = fitsInStream();
+	}
+
+	if (!pendingInStream) {
+		makeSpaceForPendingVertices(numBytes);
+		makeSpaceForPendingIndices(numIndices);
+	}
+}
+
+char* Painter::getPendingVertices()
+{
+	return pendingInStream ? vertexStream->getFreeSpace().data() : vertexBuffer.data();
+}
+
+IndexType* Painter::getPendingIndices()
+{
+	return pendingInStream ? reinterpret_cast<IndexType*>(indexStream->getFreeSpace().data()) : indexBuffer.data();
+}
+
 void Painter::makeSpaceForPendingVertices(size_t numBytes)
 {
 	size_t requiredSize = bytesPending + numBytes;
@@ -609,7 +765,7 @@ void Painter::unbind(RenderContext& context)
 	flush();
 
 	if (recordingSnapshot) {
-		recordingSnapshot->unbind(context);
+		recordingSnapshot->unbind();
 	}
 
 	doUnbind();
@@ -626,7 +782,9 @@ void Painter::doBind(const Camera& cam, RenderTarget& renderTarget)
 		throw Exception("No active render target", HalleyExceptions::Core);
 	}
 	camera.activeRenderTarget = activeRenderTarget;
-	activeRenderTarget->onBind(*this);
+	if (!deferred) {
+		activeRenderTarget->onBind(*this);
+	}
 
 	// Set viewport
 	viewPort = camera.getActiveViewPort();
@@ -640,10 +798,13 @@ void Painter::doBind(const Camera& cam, RenderTarget& renderTarget)
 void Painter::doUnbind()
 {
 	if (activeRenderTarget) {
-		activeRenderTarget->onUnbind(*this);
+		if (!deferred) {
+			activeRenderTarget->onUnbind(*this);
+		}
 		activeRenderTarget = nullptr;
 		camera.activeRenderTarget = nullptr;
 	}
+	resetBindCache();
 }
 
 void Painter::setRelativeClip(Rect4f rect)
@@ -705,6 +866,47 @@ MaterialConstantBuffer& Painter::getConstantBuffer(const MaterialDataBlock& data
 	}
 }
 
+void Painter::bindMaterialPass(const Material& material, int pass)
+{
+	const auto stateHash = material.getStateHash();
+	if (bindCache.definition == &material.getDefinition() && bindCache.pass == pass && bindCache.stateHash == stateHash) {
+		if (logging) {
+			++nBindsAvoided;
+		}
+		return;
+	}
+
+	bindCache.definition = &material.getDefinition();
+	bindCache.pass = pass;
+	bindCache.stateHash = stateHash;
+	setMaterialPass(material, pass);
+}
+
+void Painter::bindMaterialData(const Material& material)
+{
+	uint64_t dataHash = 0;
+	for (const auto& dataBlock: material.getDataBlocks()) {
+		if (dataBlock.getType() != MaterialDataBlockType::SharedExternal) {
+			dataHash = combineHash64(combineHash64(dataHash, static_cast<uint64_t>(dataBlock.getBindPoint())), dataBlock.getHash());
+		}
+	}
+
+	if (bindCache.dataHash == dataHash) {
+		if (logging) {
+			++nBindsAvoided;
+		}
+		return;
+	}
+
+	bindCache.dataHash = dataHash;
+	setMaterialData(material);
+}
+
+void Painter::resetBindCache()
+{
+	bindCache = BindCache();
+}
+
 void Painter::refreshConstantBufferCache()
 {
 	for (auto& [k, v]: constantBuffers) {
@@ -727,10 +929,17 @@ void Painter::startDrawCall(const std::shared_ptr<const Material>& material)
 
 void Painter::flushPending()
 {
-	if (verticesPending > 0) {
-		auto vertexSpan = gsl::span<char>(vertexBuffer.data(), verticesPending * materialPending->getDefinition().getVertexStride());
-		auto indexSpan = gsl::span<const IndexType>(indexBuffer.data(), indicesPending);
-		executeDrawPrimitives(*materialPending, verticesPending, vertexSpan, indexSpan, PrimitiveType::Triangle, allIndicesAreQuads);
+	if (instancesPending > 0) {
+		executeDrawInstancedQuads(materialPending, instancesPending, gsl::span<const char>(getPendingVertices(), bytesPending));
+	} else if (verticesPending > 0) {
+		auto vertexSpan = gsl::span<char>(getPendingVertices(), verticesPending * materialPending->getDefinition().getVertexStride());
+		auto indexSpan = gsl::span<const IndexType>(getPendingIndices(), indicesPending);
+		executeDrawPrimitives(materialPending, verticesPending, vertexSpan, indexSpan, PrimitiveType::Triangle, allIndicesAreQuads);
+	}
+
+	if (pendingInStream) {
+		vertexStream->commit(bytesPending);
+		indexStream->commit(indicesPending * sizeof(IndexType));
 	}
 
 	resetPending();
@@ -741,40 +950,55 @@ void Painter::resetPending()
 	bytesPending = 0;
 	verticesPending = 0;
 	indicesPending = 0;
+	instancesPending = 0;
 	allIndicesAreQuads = true;
-	if (materialPending) {
-		Material::resetBindCache();
-		materialPending.reset();
-	}
+	pendingInStream = false;
+	materialPending.reset();
 	pendingDebugGroupStack = curDebugGroupStack;
 }
 
-void Painter::executeDrawPrimitives(const Material& material, size_t numVertices, gsl::span<const char> vertexData, gsl::span<const IndexType> indices, PrimitiveType primitiveType, bool allIndicesAreQuads)
+void Painter::executeDrawPrimitives(const std::shared_ptr<const Material>& materialPtr, size_t numVertices, gsl::span<const char> vertexData, gsl::span<const IndexType> indices, PrimitiveType primitiveType, bool allIndicesAreQuads)
 {
 	Expects(primitiveType == PrimitiveType::Triangle);
 
-	ProfilerEvent event(ProfilerEventType::PainterDrawCall);
-
 	size_t commandIdx = 0;
 	if (recordingSnapshot) {
 		commandIdx = recordingSnapshot->getNumCommands();
-		recordingSnapshot->draw(material, numVertices, vertexData, indices, primitiveType, allIndicesAreQuads);
+		recordingSnapshot->draw(materialPtr, numVertices, vertexData, indices, primitiveType, allIndicesAreQuads);
+		if (deferred) {
+			return;
+		}
 		recordTimestamp(TimestampType::CommandStart, commandIdx);
 	}
 
+	ProfilerEvent event(ProfilerEventType::PainterDrawCall);
+	const auto& material = *materialPtr;
+
 	startDrawCall();
 
 	// Load vertices
-	setVertices(material.getDefinition(), numVertices, vertexData.data(), indices.size(), indices.data(), allIndicesAreQuads);
+	const size_t bytes = vertexData.size_bytes() + (allIndicesAreQuads ? 0 : indices.size_bytes());
+	if (vertexStream && vertexStream->contains(vertexData.data())) {
+		setStreamedVertices(material.getDefinition(), numVertices, vertexStream->getOffset(vertexData.data()), indices.size(), indexStream->getOffset(indices.data()), allIndicesAreQuads);
+		if (logging) {
+			nBytesStreamed += bytes;
+		}
+	} else {
+		setVertices(material.getDefinition(), numVertices, vertexData.data(), indices.size(), indices.data(), allIndicesAreQuads);
+	}
+	
+	if (logging) {
+		nBytesUploaded += bytes;
+	}
 	
 	// Load material uniforms
-	setMaterialData(material);
+	bindMaterialData(material);
 
 	// Go through each pass
 	for (int i = 0; i < material.getDefinition().getNumPasses(); i++) {
 		if (material.isPassEnabled(i)) {
 			// Bind pass
-			material.bind(i, *this);
+			bindMaterialPass(material, i);
 			if (recordingSnapshot) {
 				recordTimestamp(TimestampType::CommandSetupDone, commandIdx);
 			}
@@ -798,6 +1022,61 @@ void Painter::executeDrawPrimitives(const Material& material, size_t numVertices
 	}
 }
 
+void Painter::executeDrawInstancedQuads(const std::shared_ptr<const Material>& materialPtr, size_t numInstances, gsl::span<const char> instanceData)
+{
+	size_t commandIdx = 0;
+	if (recordingSnapshot) {
+		commandIdx = recordingSnapshot->getNumCommands();
+		recordingSnapshot->drawInstancedQuads(materialPtr, numInstances, instanceData);
+		if (deferred) {
+			return;
+		}
+		recordTimestamp(TimestampType::CommandStart, commandIdx);
+	}
+
+	ProfilerEvent event(ProfilerEventType::PainterDrawCall);
+	const auto& material = *materialPtr;
+
+	startDrawCall();
+
+	if (vertexStream && vertexStream->contains(instanceData.data())) {
+		setStreamedInstances(material.getDefinition(), numInstances, vertexStream->getOffset(instanceData.data()));
+		if (logging) {
+			nBytesStreamed += instanceData.size_bytes();
+		}
+	} else {
+		setInstances(material.getDefinition(), numInstances, instanceData.data());
+	}
+	if (logging) {
+		nBytesUploaded += instanceData.size_bytes();
+	}
+
+	bindMaterialData(material);
+
+	for (int i = 0; i < material.getDefinition().getNumPasses(); i++) {
+		if (material.isPassEnabled(i)) {
+			bindMaterialPass(material, i);
+			if (recordingSnapshot) {
+				recordTimestamp(TimestampType::CommandSetupDone, commandIdx);
+			}
+
+			drawInstancedQuads(numInstances);
+
+			if (logging) {
+				nDrawCalls++;
+				nTriangles += numInstances * 2;
+				nVertices += numInstances * 4;
+			}
+		}
+	}
+
+	endDrawCall();
+
+	if (recordingSnapshot) {
+		recordTimestamp(TimestampType::CommandEnd, commandIdx);
+	}
+}
+
 IndexType* Painter::getStandardQuadIndices(size_t numQuads)
 {
 	size_t sz = numQuads * 6;
@@ -888,6 +1167,7 @@ void Painter::updateProjection()
 	halleyGlobalMaterial->set("u_mvp", projection);
 	halleyGlobalMaterial->set("u_viewPortSize", viewPortSize);
 	onUpdateProjection(*halleyGlobalMaterial, oldHash != halleyGlobalMaterial->getFullHash());
+	resetBindCache();
 }
 
 void Painter::updateClip()
@@ -905,6 +1185,7 @@ void Painter::updateClip()
 
 		flushPending();
 		setClip(targetClip, enableClip);
+		resetBindCache();
 		if (recordingSnapshot) {
 			recordingSnapshot->setClip(targetClip, enableClip);
 		}
@@ -0,0 +1,80 @@
+#include "halley/graphics/painter_command_list.h"
+
+#include "halley/graphics/painter.h"
+#include "halley/graphics/render_context.h"
+
+using namespace Halley;
+
+namespace {
+	// Never reaches the backend, everything it does goes into the list's RenderSnapshot
+	class CommandListPainter final : public Painter {
+	public:
+		CommandListPainter(VideoAPI& video, Resources& resources, bool instancing)
+			: Painter(video, resources)
+			, instancing(instancing)
+		{}
+
+	protected:
+		void doStartRender() override {}
+		void doEndRender() override {}
+		void setVertices(const MaterialDefinition& material, size_t numVertices, const void* vertexData, size_t numIndices, const IndexType* indices, bool standardQuadsOnly) override {}
+		void drawTriangles(size_t numIndices) override {}
+		bool supportsInstancing() const override { return instancing; }
+		void doClear(std::optional<Colour> colour, std::optional<float> depth, std::optional<uint8_t> stencil) override {}
+		void setMaterialPass(const Material& material, int pass) override {}
+		void setMaterialData(const Material& material) override {}
+		void setViewPort(Rect4i rect) override {}
+		void setClip(Rect4i clip, bool enable) override {}
+		void onUpdateProjection(Material& material, bool hashChanged) override {}
+
+	private:
+		bool instancing;
+	};
+}
+
+PainterCommandList::PainterCommandList(Painter& painter)
+	: target(painter)
+{
+	this->painter = std::make_unique<CommandListPainter>(painter.video, painter.resources, painter.supportsInstancing());
+	this->painter->deferred = true;
+	this->painter->recordingSnapshot = &commands;
+}
+
+PainterCommandList::~PainterCommandList() = default;
+
+void PainterCommandList::record(const RenderContext& context, const std::function<void(RenderContext&)>& f)
+{
+	auto& p = *painter;
+	p.resetPending();
+	p.instancingEnabled = target.instancingEnabled;
+
+	// Whatever clip the target painter has when this is replayed, the first draw should set its own
+	p.curClip = Rect4i(0, 0, 1, 1);
+
+	commands.start();
+	{
+		RenderContext recordingContext(p, context.getCamera(), context.getDefaultRenderTarget());
+		f(recordingContext);
+	}
+	p.flush();
+}
+
+void PainterCommandList::replay(Painter& painter) const
+{
+	commands.replay(painter);
+}
+
+void PainterCommandList::clear()
+{
+	commands.start();
+}
+
+size_t PainterCommandList::getNumCommands() const
+{
+	return commands.getNumCommands();
+}
+
+bool PainterCommandList::isEmpty() const
+{
+	return commands.getNumCommands() == 0;
+}
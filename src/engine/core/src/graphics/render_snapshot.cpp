@@ -18,6 +18,8 @@ void RenderSnapshot::start()
 	setClipDatas.clear();
 	clearDatas.clear();
 	drawDatas.clear();
+	vertexData.clear();
+	indexData.clear();
 }
 
 void RenderSnapshot::end()
@@ -35,12 +37,17 @@ void RenderSnapshot::end()
 }
 
 void RenderSnapshot::bind(RenderContext& context)
+{
+	bind(context.getCamera(), context.getDefaultRenderTarget());
+}
+
+void RenderSnapshot::bind(const Camera& camera, RenderTarget& renderTarget)
 {
 	getCurDrawCall().emplace_back(CommandType::Bind, static_cast<uint16_t>(bindDatas.size()));
-	bindDatas.push_back(BindData{ context.getCamera(), &context.getDefaultRenderTarget() });
+	bindDatas.push_back(BindData{ camera, &renderTarget });
 }
 
-void RenderSnapshot::unbind(RenderContext& context)
+void RenderSnapshot::unbind()
 {
 	getCurDrawCall().emplace_back(CommandType::Unbind, 0);
 }
@@ -58,17 +65,28 @@ void RenderSnapshot::clear(std::optional<Colour4f> colour, std::optional<float>
 	finishDrawCall();
 }
 
-void RenderSnapshot::draw(const Material& material, size_t numVertices, gsl::span<const char> vertexData, gsl::span<const IndexType> indices, PrimitiveType primitive, bool allIndicesAreQuads)
+void RenderSnapshot::draw(std::shared_ptr<const Material> material, size_t numVertices, gsl::span<const char> vertices, gsl::span<const IndexType> indices, PrimitiveType primitive, bool allIndicesAreQuads)
+{
+	getCurDrawCall().emplace_back(CommandType::Draw, static_cast<uint16_t>(drawDatas.size()));
+	drawDatas.push_back(DrawData{ std::move(material), numVertices, vertexData.size(), vertices.size(), indexData.size(), indices.size(), primitive, allIndicesAreQuads, false });
+	vertexData.insert(vertexData.end(), vertices.begin(), vertices.end());
+	indexData.insert(indexData.end(), indices.begin(), indices.end());
+	finishDrawCall();
+}
+
+void RenderSnapshot::drawInstancedQuads(std::shared_ptr<const Material> material, size_t numInstances, gsl::span<const char> instanceData)
 {
 	getCurDrawCall().emplace_back(CommandType::Draw, static_cast<uint16_t>(drawDatas.size()));
-	drawDatas.push_back(DrawData{ &material, {}, numVertices, Vector<char>(vertexData.begin(), vertexData.end()), Vector<IndexType>(indices.begin(), indices.end()), primitive, allIndicesAreQuads });
+	drawDatas.push_back(DrawData{ std::move(material), numInstances, vertexData.size(), instanceData.size(), indexData.size(), 0, PrimitiveType::Triangle, true, true });
+	vertexData.insert(vertexData.end(), instanceData.begin(), instanceData.end());
 	finishDrawCall();
 }
 
 void RenderSnapshot::finish()
 {
+	// Materials can change after the frame, so keep them as they were drawn
 	for (auto& drawData: drawDatas) {
-		drawData.material = drawData.materialTemp->clone();
+		drawData.material = drawData.material->clone();
 	}
 }
 
@@ -116,7 +134,7 @@ RenderSnapshot::CommandInfo RenderSnapshot::getCommandInfo(size_t commandIdx) co
 				result.textures.push_back(texture->getAssetId());
 			}
 		}
-		result.numTriangles = curDraw.indices.size() / 3;
+		result.numTriangles = curDraw.instanced ? curDraw.numVertices * 2 : curDraw.numIndices / 3;
 
 		if (const auto* prevDraw = getLastDraw()) {
 			const auto prevMat = prevDraw->material;
@@ -210,6 +228,7 @@ RenderSnapshot::PlaybackResult RenderSnapshot::playback(Painter& painter, std::o
 	painter.doUnbind();
 	painter.doBind(startCamera, *startRenderTarget);
 	painter.setClip(Rect4i(), false);
+	painter.resetBindCache();
 
 	if (startRenderTarget != finalRenderTarget) {
 		const auto* texRenderTarget = dynamic_cast<TextureRenderTarget*>(finalRenderTarget);
@@ -225,6 +244,72 @@ RenderSnapshot::PlaybackResult RenderSnapshot::playback(Painter& painter, std::o
 	return PlaybackResult{ finalRenderTarget ? finalRenderTarget->getName() : "" };
 }
 
+void RenderSnapshot::replay(Painter& painter) const
+{
+	if (commands.empty()) {
+		return;
+	}
+
+	painter.flush();
+
+	const auto startCamera = painter.camera;
+	auto* startRenderTarget = painter.activeRenderTarget;
+	const auto startClip = painter.pendingClip;
+	auto* recorder = painter.recordingSnapshot;
+
+	for (const auto& drawCall: commands) {
+		for (const auto& [type, idx]: drawCall) {
+			switch (type) {
+			case CommandType::Bind:
+				if (recorder) {
+					recorder->bind(bindDatas[idx].camera, *bindDatas[idx].renderTarget);
+				}
+				playBind(painter, bindDatas[idx]);
+				break;
+
+			case CommandType::Unbind:
+				if (recorder) {
+					recorder->unbind();
+				}
+				playUnbind(painter);
+				break;
+
+			case CommandType::Clear:
+				playClear(painter, clearDatas[idx]);
+				break;
+
+			case CommandType::SetClip:
+				{
+					// Keep painter's view of the clip in sync, so it knows whether it needs to change it again afterwards
+					const auto& data = setClipDatas[idx];
+					painter.curClip = data.enable ? std::optional<Rect4i>(data.rect) : std::optional<Rect4i>();
+					if (recorder) {
+						recorder->setClip(data.rect, data.enable);
+					}
+					playSetClip(painter, data);
+				}
+				break;
+
+			case CommandType::Draw:
+				playDraw(painter, drawDatas[idx], {});
+				break;
+
+			case CommandType::Undefined:
+				break;
+			}
+		}
+	}
+
+	if (startRenderTarget) {
+		painter.doUnbind();
+		if (recorder) {
+			recorder->bind(startCamera, *startRenderTarget);
+		}
+		painter.doBind(startCamera, *startRenderTarget);
+		painter.setClip(startClip);
+	}
+}
+
 void RenderSnapshot::addPendingTimestamp()
 {
 	++pendingTimestamps;
@@ -311,6 +396,7 @@ void RenderSnapshot::playClear(Painter& painter, const ClearData& data) const
 void RenderSnapshot::playSetClip(Painter& painter, const SetClipData& data) const
 {
 	painter.setClip(data.rect, data.enable);
+	painter.resetBindCache();
 }
 
 void RenderSnapshot::playDraw(Painter& painter, const DrawData& data, std::shared_ptr<const MaterialDefinition> debugMaterial) const
@@ -319,14 +405,29 @@ void RenderSnapshot::playDraw(Painter& painter, const DrawData& data, std::share
 	if (debugMaterial) {
 		const auto& srcPass = debugMaterial->getPass(0);
 
-		material = material->clone();
-		auto definition = std::make_shared<MaterialDefinition>(material->getDefinition());
+		auto debugCopy = material->clone();
+		auto definition = std::make_shared<MaterialDefinition>(debugCopy->getDefinition());
 		for (auto& pass: definition->getPasses()) {
 			pass.replacePixelShader(srcPass, painter.video);
 			pass.setBlend(srcPass.getBlend());
 			pass.getDepthStencil() = srcPass.getDepthStencil();
 		}
-		material->setDefinition(std::move(definition));
+		debugCopy->setDefinition(std::move(definition));
+		material = std::move(debugCopy);
+	}
+	if (data.instanced) {
+		painter.executeDrawInstancedQuads(material, data.numVertices, getVertexData(data));
+	} else {
+		painter.executeDrawPrimitives(material, data.numVertices, getVertexData(data), getIndices(data), data.primitive, data.allIndicesAreQuads);
 	}
-	painter.executeDrawPrimitives(*material, data.numVertices, data.vertexData, data.indices, data.primitive, data.allIndicesAreQuads);
+}
+
+gsl::span<const char> RenderSnapshot::getVertexData(const DrawData& data) const
+{
+	return gsl::span<const char>(vertexData).subspan(data.vertexDataStart, data.vertexDataSize);
+}
+
+gsl::span<const IndexType> RenderSnapshot::getIndices(const DrawData& data) const
+{
+	return gsl::span<const IndexType>(indexData).subspan(data.indicesStart, data.numIndices);
 }
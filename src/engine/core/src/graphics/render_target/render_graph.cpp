@@ -1,6 +1,9 @@
 #include "halley/graphics/render_target/render_graph.h"
 #include "halley/api/video_api.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/graphics/painter_command_list.h"
 #include "halley/graphics/render_context.h"
+#include "halley/graphics/texture.h"
 #include "halley/graphics/material/material.h"
 #include "halley/graphics/render_target/render_graph_definition.h"
 #include "halley/graphics/render_target/render_graph_node.h"
@@ -20,6 +23,8 @@ RenderGraph::RenderGraph(std::shared_ptr<const RenderGraphDefinition> def)
 	loadDefinition(std::move(def));
 }
 
+RenderGraph::~RenderGraph() = default;
+
 void RenderGraph::loadDefinition(std::shared_ptr<const RenderGraphDefinition> definition)
 {
 	nodes.clear();
@@ -103,10 +108,17 @@ void RenderGraph::render(const RenderContext& rc, VideoAPI& video, std::optional
 {
 	update();
 
+	stats = {};
+	stats.nodes = nodes.size();
+
 	for (auto& node: nodes) {
 		node->startRender();
 	}
+	for (auto& transient: transientTextures) {
+		transient.inUse = false;
+	}
 
+	// Nodes are only activated by the outputs they reach, everything else is culled
 	const auto renderSize = requestedRenderSize.value_or(rc.getDefaultRenderTarget().getViewPort().getSize());
 	for (auto& node: nodes) {
 		if (node->method == RenderGraphMethod::Output
@@ -121,25 +133,167 @@ void RenderGraph::render(const RenderContext& rc, VideoAPI& video, std::optional
 	for (auto& node: nodes) {
 		node->determineIfNeedsRenderTarget();
 	}
+	for (auto& node: nodes) {
+		node->determineIfTargetsAreTransient(targetAliasing);
+	}
 	
-	Vector<RenderGraphNode*> renderQueue;
-	renderQueue.reserve(nodes.size());
+	Vector<RenderGraphNode*> wave;
+	Vector<RenderGraphNode*> nextWave;
+	wave.reserve(nodes.size());
+	nextWave.reserve(nodes.size());
 	for (auto& node: nodes) {
-		if (node->activeInCurrentPass && node->depsLeft == 0) {
-			renderQueue.push_back(node.get());
+		if (!node->activeInCurrentPass) {
+			++stats.culledNodes;
+		} else if (node->depsLeft == 0) {
+			wave.push_back(node.get());
 		}
 	}
 
-	for (size_t i = 0; i < renderQueue.size(); ++i) {
-		renderQueue[i]->render(*this, video, rc, renderQueue);
+	// Each wave only has nodes whose dependencies were all rendered by the previous ones
+	while (!wave.empty()) {
+		renderWave(wave, rc, video);
+
+		nextWave.clear();
+		for (auto* node: wave) {
+			node->notifyOutputs(nextWave);
+			node->renderedInCurrentPass = true;
+		}
+		for (auto* node: wave) {
+			releaseTransientTextures(*node);
+		}
+
+		std::swap(wave, nextWave);
 	}
 
+	trimTransientTextures();
+
 	RenderContext(rc).bind([] (Painter& painter)
 	{
 		painter.flush();
 	});
 }
 
+void RenderGraph::renderWave(const Vector<RenderGraphNode*>& wave, const RenderContext& rc, VideoAPI& video)
+{
+	++stats.waves;
+	stats.passes += wave.size();
+
+	for (auto* node: wave) {
+		node->prepareTextures(*this, video, rc);
+	}
+
+	Vector<RenderGraphNode*> recorded;
+	if (parallelRecording && wave.size() > 1 && canRecordInParallel()) {
+		for (auto* node: wave) {
+			if (node->canRecord()) {
+				recorded.push_back(node);
+			}
+		}
+		if (recorded.size() < 2) {
+			recorded.clear();
+		}
+	}
+
+	if (!recorded.empty()) {
+		RenderContext(rc).bind([&] (Painter& painter)
+		{
+			for (auto* node: recorded) {
+				if (!node->commandList) {
+					node->commandList = std::make_unique<PainterCommandList>(painter);
+				}
+			}
+
+			Concurrent::foreach(recorded.begin(), recorded.end(), [&] (RenderGraphNode* node)
+			{
+				node->commandList->record(rc, [&] (RenderContext& context)
+				{
+					node->renderNode(*this, context);
+				});
+			});
+
+			for (auto* node: recorded) {
+				node->commandList->replay(painter);
+			}
+		});
+		stats.parallelPasses += recorded.size();
+	}
+
+	for (auto* node: wave) {
+		if (!std_ex::contains(recorded, node)) {
+			node->renderNode(*this, rc);
+		}
+	}
+}
+
+bool RenderGraph::canRecordInParallel() const
+{
+	return Executors::hasInstance() && Executors::getCPU().threadCount() > 0;
+}
+
+std::shared_ptr<Texture> RenderGraph::acquireTransientTexture(VideoAPI& video, Vector2i size, RenderGraphElementType type)
+{
+	++stats.transientTargets;
+
+	for (auto& transient: transientTextures) {
+		if (!transient.inUse && transient.type == type && transient.texture->getSize() == size) {
+			transient.inUse = true;
+			transient.usedThisFrame = true;
+			return transient.texture;
+		}
+	}
+
+	auto& transient = transientTextures.emplace_back();
+	transient.texture = RenderGraphNode::createTexture(video, size, type, "renderGraph/transient" + toString(transientTextures.size() - 1));
+	transient.type = type;
+	transient.inUse = true;
+	transient.usedThisFrame = true;
+	++stats.targetsCreated;
+	return transient.texture;
+}
+
+void RenderGraph::releaseTransientTextures(const RenderGraphNode& node)
+{
+	for (const auto& input: node.inputPins) {
+		if (!input.texture) {
+			continue;
+		}
+
+		for (auto& transient: transientTextures) {
+			if (transient.inUse && transient.texture == input.texture) {
+				transient.inUse = isTextureNeeded(input.texture);
+				break;
+			}
+		}
+	}
+}
+
+bool RenderGraph::isTextureNeeded(const std::shared_ptr<Texture>& texture) const
+{
+	// Textures only move forward to nodes that haven't rendered yet, so once none of them hold it, it's free
+	for (const auto& node: nodes) {
+		if (node->activeInCurrentPass && !node->renderedInCurrentPass) {
+			for (const auto& input: node->inputPins) {
+				if (input.texture == texture) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+void RenderGraph::trimTransientTextures()
+{
+	// Anything not needed this frame (e.g. after a resize) is dropped
+	std_ex::erase_if(transientTextures, [] (const TransientTexture& transient) { return !transient.usedThisFrame; });
+
+	for (auto& transient: transientTextures) {
+		transient.usedThisFrame = false;
+		stats.transientBytes += TextureDescriptor::getByteSize(transient.type == RenderGraphElementType::ColourBuffer ? TextureFormat::RGBA : TextureFormat::Depth, transient.texture->getSize());
+	}
+	stats.transientTextures = transientTextures.size();
+}
+
 void RenderGraph::clearCameras()
 {
 	cameras.clear();
@@ -340,6 +494,21 @@ void RenderGraph::resetGraph()
 	loadDefinition(graphDefinition);
 }
 
+void RenderGraph::setTargetAliasing(bool enabled)
+{
+	targetAliasing = enabled;
+}
+
+void RenderGraph::setParallelRecording(bool enabled)
+{
+	parallelRecording = enabled;
+}
+
+const RenderGraph::RenderStats& RenderGraph::getRenderStats() const
+{
+	return stats;
+}
+
 void RenderGraph::Variable::apply(Material& material, const String& name) const
 {
 	switch (type) {
@@ -4,6 +4,7 @@
 
 #include "halley/graphics/render_target/render_graph.h"
 #include "halley/api/video_api.h"
+#include "halley/graphics/painter_command_list.h"
 #include "halley/graphics/render_context.h"
 #include "halley/graphics/texture.h"
 #include "halley/graphics/material/material.h"
@@ -67,9 +68,12 @@ RenderGraphNode::RenderGraphNode(const RenderGraphNodeDefinition& definition)
 	}
 }
 
+RenderGraphNode::~RenderGraphNode() = default;
+
 void RenderGraphNode::startRender()
 {
 	activeInCurrentPass = false;
+	renderedInCurrentPass = false;
 	ownRenderTarget = false;
 	canForwardRenderTarget = false;
 	depsLeft = 0;
@@ -161,6 +165,61 @@ void RenderGraphNode::determineIfNeedsRenderTarget()
 	ownRenderTarget = !reuseRenderTarget && !isOutput;
 }
 
+void RenderGraphNode::determineIfTargetsAreTransient(bool aliasingEnabled)
+{
+	if (!activeInCurrentPass) {
+		return;
+	}
+
+	// Pool textures only belong to a node for the frame they were taken on, and inputs get set again as their nodes render
+	for (auto& input: inputPins) {
+		if (!input.others.empty() || isTransient(input.type)) {
+			input.texture.reset();
+		}
+	}
+
+	transientTargets = aliasingEnabled && ownRenderTarget && !reachesPersistentNode();
+}
+
+bool RenderGraphNode::isTransient(RenderGraphElementType type) const
+{
+	if (!transientTargets) {
+		return false;
+	}
+	if (type == RenderGraphElementType::ColourBuffer) {
+		return colourClear.has_value();
+	} else if (type == RenderGraphElementType::DepthStencilBuffer) {
+		return depthClear.has_value() || stencilClear.has_value();
+	}
+	return false;
+}
+
+bool RenderGraphNode::reachesPersistentNode() const
+{
+	// Follows the buffers this node renders to along every node that renders on top of them
+	for (const auto& output: outputPins) {
+		for (const auto& other: output.others) {
+			if (!other.node->activeInCurrentPass) {
+				continue;
+			}
+			if (other.node->method == RenderGraphMethod::RenderToTexture) {
+				return true;
+			}
+			const auto inputType = other.node->inputPins[other.otherId].type;
+			if ((inputType == RenderGraphElementType::ColourBuffer || inputType == RenderGraphElementType::DepthStencilBuffer) && other.node->reachesPersistentNode()) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool RenderGraphNode::canRecord() const
+{
+	// Image outputs read back immediately, and nodes without a target blit, neither of which can be recorded
+	return renderTarget && (method == RenderGraphMethod::Paint || method == RenderGraphMethod::Overlay);
+}
+
 std::shared_ptr<TextureRenderTarget> RenderGraphNode::getRenderTarget(VideoAPI& video)
 {
 	if (ownRenderTarget) {
@@ -182,12 +241,16 @@ void RenderGraphNode::resetTextures()
 }
 
 std::shared_ptr<Texture> RenderGraphNode::makeTexture(VideoAPI& video, RenderGraphElementType type)
+{
+	return createTexture(video, Vector2i::max(currentSize, Vector2i(4, 4)), type, "renderGraph/" + id);
+}
+
+std::shared_ptr<Texture> RenderGraphNode::createTexture(VideoAPI& video, Vector2i size, RenderGraphElementType type, const String& assetId)
 {
 	Expects (type == RenderGraphElementType::ColourBuffer || type == RenderGraphElementType::DepthStencilBuffer);
 
-	const auto size = Vector2i::max(currentSize, Vector2i(4, 4));
 	auto texture = video.createTexture(size);
-	texture->setAssetId("renderGraph/" + id + "/" + (type == RenderGraphElementType::ColourBuffer ? "colour" : "depthStencil"));
+	texture->setAssetId(assetId + "/" + (type == RenderGraphElementType::ColourBuffer ? "colour" : "depthStencil"));
 
 	auto desc = TextureDescriptor(size, type == RenderGraphElementType::ColourBuffer ? TextureFormat::RGBA : TextureFormat::Depth);
 	desc.isRenderTarget = true;
@@ -207,38 +270,36 @@ void RenderGraphNode::updateTexture(std::shared_ptr<Texture> texture, RenderGrap
 	texture->load(std::move(desc));
 }
 
-void RenderGraphNode::render(const RenderGraph& graph, VideoAPI& video, const RenderContext& rc, Vector<RenderGraphNode*>& renderQueue)
-{
-	prepareTextures(video, rc);
-	renderNode(graph, rc);
-	notifyOutputs(renderQueue);
-}
-
-void RenderGraphNode::prepareTextures(VideoAPI& video, const RenderContext& rc)
+void RenderGraphNode::prepareTextures(RenderGraph& graph, VideoAPI& video, const RenderContext& rc)
 {
 	getRenderTarget(video);
 
-	bool updated = false;
 	if (!reuseRenderTarget) {
 		int colourIdx = 0;
 		for (auto& input: inputPins) {
 			if (renderTarget) {
 				// Create Colour/DepthStencil textures for render target, if needed
 				if (input.others.empty() && (input.type == RenderGraphElementType::ColourBuffer || input.type == RenderGraphElementType::DepthStencilBuffer)) {
-					if (!input.texture) {
-						updated = true;
+					if (isTransient(input.type)) {
+						input.texture = graph.acquireTransientTexture(video, Vector2i::max(currentSize, Vector2i(4, 4)), input.type);
+					} else if (!input.texture) {
 						input.texture = makeTexture(video, input.type);
+						++graph.stats.targetsCreated;
 					} else {
 						if (input.texture->getSize() != currentSize) {
 							updateTexture(input.texture, input.type);
+							++graph.stats.targetsCreated;
 						}
 					}
 				}
 
-				// Assign textures to render target
-				if (input.type == RenderGraphElementType::ColourBuffer && (!renderTarget->hasColourBuffer(colourIdx) || updated)) {
-					renderTarget->setTarget(colourIdx++, input.texture);
-				} else if (input.type == RenderGraphElementType::DepthStencilBuffer && (!renderTarget->hasDepthBuffer() || updated)) {
+				// Assign textures to render target (these only change anything if the texture is different)
+				if (input.type == RenderGraphElementType::ColourBuffer) {
+					if (input.texture) {
+						renderTarget->setTarget(colourIdx, input.texture);
+					}
+					++colourIdx;
+				} else if (input.type == RenderGraphElementType::DepthStencilBuffer && input.texture) {
 					renderTarget->setDepthTexture(input.texture);
 				}
 			} else {
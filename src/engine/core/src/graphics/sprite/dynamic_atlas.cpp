@@ -0,0 +1,358 @@
+#include "halley/graphics/sprite/dynamic_atlas.h"
+#include "halley/api/video_api.h"
+#include "halley/file_formats/image.h"
+#include "halley/graphics/texture.h"
+#include "halley/graphics/material/material.h"
+#include "halley/graphics/material/material_definition.h"
+#include "halley/graphics/sprite/sprite.h"
+#include "halley/support/exception.h"
+#include "halley/utils/algorithm.h"
+
+using namespace Halley;
+
+namespace {
+	// Guillotine packing: the smallest free rect that fits is used, and whatever is left of it is split in two
+	// (BinPack only packs a whole set of rects at once, while pages here take images one at a time and keep the rest in place)
+	std::optional<Rect4i> allocate(Vector<Rect4i>& freeRects, Vector2i size)
+	{
+		std::optional<size_t> best;
+		for (size_t i = 0; i < freeRects.size(); ++i) {
+			const auto& r = freeRects[i];
+			if (r.getWidth() >= size.x && r.getHeight() >= size.y && (!best || r.getWidth() * r.getHeight() < freeRects[*best].getWidth() * freeRects[*best].getHeight())) {
+				best = i;
+			}
+		}
+		if (!best) {
+			return {};
+		}
+
+		const auto free = freeRects[*best];
+		freeRects[*best] = freeRects.back();
+		freeRects.pop_back();
+
+		auto addFree = [&] (Rect4i rect)
+		{
+			if (rect.getWidth() > 0 && rect.getHeight() > 0) {
+				freeRects.push_back(rect);
+			}
+		};
+
+		// Split along the longer leftover, so the bigger piece stays in one
+		const auto pos = free.getTopLeft();
+		const int w = free.getWidth() - size.x;
+		const int h = free.getHeight() - size.y;
+		if (w > h) {
+			addFree(Rect4i(pos.x + size.x, pos.y, w, free.getHeight()));
+			addFree(Rect4i(pos.x, pos.y + size.y, size.x, h));
+		} else {
+			addFree(Rect4i(pos.x + size.x, pos.y, w, size.y));
+			addFree(Rect4i(pos.x, pos.y + size.y, free.getWidth(), h));
+		}
+		return Rect4i(pos, size.x, size.y);
+	}
+
+	void clearArea(Image& image, Rect4i area)
+	{
+		const auto pixels = image.getPixels4BPP();
+		const int width = image.getSize().x;
+		for (int y = area.getTop(); y < area.getBottom(); ++y) {
+			std::fill_n(pixels.begin() + y * width + area.getLeft(), area.getWidth(), 0);
+		}
+	}
+}
+
+void DynamicAtlas::Page::markDirty(Rect4i rect)
+{
+	dirtyRect = dirtyRect ? dirtyRect->merge(rect) : rect;
+}
+
+DynamicAtlas::DynamicAtlas(VideoAPI& video, std::shared_ptr<const MaterialDefinition> materialDefinition, Vector2i pageSize, size_t maxPages, int padding)
+	: video(video)
+	, materialDefinition(std::move(materialDefinition))
+	, pageSize(pageSize)
+	, maxPages(std::max(maxPages, size_t(1)))
+	, padding(padding)
+{
+	Expects(this->materialDefinition != nullptr);
+}
+
+DynamicAtlas::~DynamicAtlas() = default;
+
+void DynamicAtlas::add(const String& id, const Image& image)
+{
+	if (image.getFormat() != Image::Format::RGBA) {
+		throw Exception("Image \"" + id + "\" added to dynamic atlas isn't RGBA.", HalleyExceptions::Graphics);
+	}
+
+	const auto paddedSize = image.getSize() + Vector2i(2 * padding, 2 * padding);
+	if (const auto iter = entries.find(id); iter != entries.end() && !iter->second.pending) {
+		if (iter->second.rect.getSize() == paddedSize) {
+			// Same size, just replace the pixels
+			auto& page = pages[iter->second.page];
+			const auto pos = iter->second.rect.getTopLeft() + Vector2i(padding, padding);
+			page.image->blitFrom(pos, image);
+			page.markDirty(Rect4i(pos, image.getSize().x, image.getSize().y));
+			return;
+		}
+		release(iter->second);
+	}
+
+	auto copy = std::make_shared<Image>(Image::Format::RGBA, image.getSize(), false);
+	copy->blitFrom(Vector2i(), image);
+
+	auto& entry = entries[id];
+	entry.pending = std::move(copy);
+	entry.lastUsed = curFrame;
+	if (!std_ex::contains(pending, id) && !std_ex::contains(deferred, id)) {
+		pending.push_back(id);
+	}
+}
+
+void DynamicAtlas::remove(const String& id)
+{
+	if (const auto iter = entries.find(id); iter != entries.end()) {
+		if (!iter->second.pending) {
+			release(iter->second);
+		}
+		entries.erase(iter);
+	}
+}
+
+bool DynamicAtlas::contains(const String& id) const
+{
+	return entries.find(id) != entries.end();
+}
+
+bool DynamicAtlas::setSprite(Sprite& sprite, const String& id, bool applySize)
+{
+	packPending(false);
+
+	const auto iter = entries.find(id);
+	if (iter == entries.end() || iter->second.pending) {
+		return false;
+	}
+
+	auto& entry = iter->second;
+	auto& page = pages[entry.page];
+	if (page.dirtyRect) {
+		uploadPage(page);
+	}
+	entry.lastUsed = curFrame;
+
+	const auto area = entry.rect.shrink(padding);
+	sprite.setMaterial(page.material);
+	sprite.setTexRect0(Rect4f(area) / Vector2f(pageSize));
+	if (applySize) {
+		sprite.setSize(Vector2f(area.getSize()));
+	}
+	return true;
+}
+
+void DynamicAtlas::update()
+{
+	pending.insert(pending.end(), deferred.begin(), deferred.end());
+	deferred.clear();
+	packPending(true);
+	for (auto& page: pages) {
+		if (page.dirtyRect) {
+			uploadPage(page);
+		}
+	}
+	++curFrame;
+}
+
+size_t DynamicAtlas::getNumPages() const
+{
+	return pages.size();
+}
+
+size_t DynamicAtlas::getNumImages() const
+{
+	return entries.size();
+}
+
+size_t DynamicAtlas::getNumEvicted() const
+{
+	return nEvicted;
+}
+
+void DynamicAtlas::packPending(bool frameDone)
+{
+	if (pending.empty()) {
+		return;
+	}
+
+	// Biggest first, they're the hardest to fit
+	auto getArea = [&] (const String& id)
+	{
+		const auto iter = entries.find(id);
+		return iter != entries.end() && iter->second.pending ? iter->second.pending->getSize().x * iter->second.pending->getSize().y : 0;
+	};
+	std::sort(pending.begin(), pending.end(), [&] (const String& a, const String& b) { return getArea(a) > getArea(b); });
+
+	for (const auto& id: pending) {
+		const auto iter = entries.find(id);
+		if (iter == entries.end() || !iter->second.pending) {
+			continue;
+		}
+
+		const auto size = iter->second.pending->getSize() + Vector2i(2 * padding, 2 * padding);
+		bool placed = false;
+		if (size.x <= pageSize.x && size.y <= pageSize.y) {
+			while (!placed) {
+				for (size_t i = 0; i < pages.size() && !placed; ++i) {
+					placed = tryPlace(i, id, frameDone);
+				}
+				if (!placed && pages.size() < maxPages) {
+					auto& page = pages.emplace_back();
+					page.image = std::make_unique<Image>(Image::Format::RGBA, pageSize);
+					page.freeRects.push_back(Rect4i(Vector2i(), pageSize));
+					placed = tryPlace(pages.size() - 1, id, frameDone);
+				}
+				if (!placed && !evictLeastRecentlyUsed()) {
+					break;
+				}
+			}
+
+			if (!placed && !frameDone) {
+				// Repacking might still make room once this frame's sprites are drawn
+				deferred.push_back(id);
+				continue;
+			}
+		}
+
+		if (!placed) {
+			entries.erase(id);
+		}
+	}
+	pending.clear();
+}
+
+bool DynamicAtlas::tryPlace(size_t pageIdx, const String& id, bool frameDone)
+{
+	auto& page = pages[pageIdx];
+	auto& entry = entries.at(id);
+
+	const auto rect = allocate(page.freeRects, entry.pending->getSize() + Vector2i(2 * padding, 2 * padding));
+	if (!rect) {
+		// The free space might just be fragmented
+		return repack(pageIdx, id, frameDone);
+	}
+
+	// Whatever was there before might have left pixels in the padding
+	clearArea(*page.image, *rect);
+	page.image->blitFrom(rect->getTopLeft() + Vector2i(padding, padding), *entry.pending);
+	page.markDirty(*rect);
+	entry.pending.reset();
+	entry.rect = *rect;
+	entry.page = pageIdx;
+
+	return true;
+}
+
+bool DynamicAtlas::repack(size_t pageIdx, const String& id, bool frameDone)
+{
+	auto& page = pages[pageIdx];
+	const auto pad = Vector2i(padding, padding);
+	auto getSize = [&] (const Entry& e) { return e.pending ? e.pending->getSize() + 2 * pad : e.rect.getSize(); };
+
+	Vector<Entry*> pageEntries;
+	pageEntries.push_back(&entries.at(id));
+	for (auto& [k, e]: entries) {
+		if (!e.pending && e.page == pageIdx) {
+			if (!frameDone && e.lastUsed == curFrame) {
+				// Sprites already have its current rect this frame
+				return false;
+			}
+			pageEntries.push_back(&e);
+		}
+	}
+
+	int totalArea = 0;
+	for (const auto* e: pageEntries) {
+		totalArea += getSize(*e).x * getSize(*e).y;
+	}
+	if (totalArea > pageSize.x * pageSize.y) {
+		return false;
+	}
+
+	// Biggest first, they're the hardest to fit
+	std::sort(pageEntries.begin(), pageEntries.end(), [&] (const Entry* a, const Entry* b)
+	{
+		return getSize(*a).x * getSize(*a).y > getSize(*b).x * getSize(*b).y;
+	});
+
+	Vector<Rect4i> freeRects = { Rect4i(Vector2i(), pageSize) };
+	Vector<Rect4i> rects;
+	for (const auto* e: pageEntries) {
+		const auto rect = allocate(freeRects, getSize(*e));
+		if (!rect) {
+			return false;
+		}
+		rects.push_back(*rect);
+	}
+
+	// Everything on the page may have moved, so rebuild it
+	auto image = std::make_unique<Image>(Image::Format::RGBA, pageSize);
+	for (size_t i = 0; i < pageEntries.size(); ++i) {
+		auto& entry = *pageEntries[i];
+		if (entry.pending) {
+			image->blitFrom(rects[i].getTopLeft() + pad, *entry.pending);
+			entry.pending.reset();
+		} else {
+			image->blitFrom(rects[i].getTopLeft() + pad, *page.image, entry.rect.shrink(padding));
+		}
+		entry.rect = rects[i];
+		entry.page = pageIdx;
+	}
+	page.image = std::move(image);
+	page.freeRects = std::move(freeRects);
+	page.markDirty(Rect4i(Vector2i(), pageSize));
+
+	return true;
+}
+
+bool DynamicAtlas::evictLeastRecentlyUsed()
+{
+	// Anything used this frame is still being drawn, so can't go
+	auto oldest = entries.end();
+	for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+		const auto& e = iter->second;
+		if (!e.pending && e.lastUsed < curFrame && (oldest == entries.end() || e.lastUsed < oldest->second.lastUsed)) {
+			oldest = iter;
+		}
+	}
+
+	if (oldest == entries.end()) {
+		return false;
+	}
+	release(oldest->second);
+	entries.erase(oldest);
+	++nEvicted;
+	return true;
+}
+
+void DynamicAtlas::release(const Entry& entry)
+{
+	// The old pixels stay until something else is placed there
+	pages[entry.page].freeRects.push_back(entry.rect);
+}
+
+void DynamicAtlas::uploadPage(Page& page)
+{
+	if (page.texture) {
+		// Same texture and material, so sprites already pointing at the page stay batched with new ones
+		page.texture->updateRegion(*page.image, *page.dirtyRect);
+	} else {
+		page.texture = std::shared_ptr<Texture>(video.createTexture(pageSize));
+		TextureDescriptor desc(pageSize, TextureFormat::RGBA);
+		desc.canBeUpdated = true;
+		desc.pixelData = page.image->clone();
+		page.texture->startLoading();
+		page.texture->load(std::move(desc));
+
+		page.material = std::make_shared<Material>(materialDefinition);
+		page.material->set(0, page.texture);
+	}
+	page.dirtyRect.reset();
+}
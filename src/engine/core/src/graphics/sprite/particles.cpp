@@ -1,11 +1,88 @@
 #include "halley/graphics/sprite/particles.h"
 
+#include "halley/concurrency/concurrent.h"
+#include "halley/graphics/painter.h"
+#include "halley/graphics/material/material.h"
+#include "halley/graphics/material/material_definition.h"
 #include "halley/maths/polygon.h"
 #include "halley/maths/random.h"
+#include "halley/maths/simd.h"
 #include "halley/support/logger.h"
 
 using namespace Halley;
 
+namespace {
+	// Calls f(start, end) over consecutive ranges of n particles, splitting large emitters across the CPU worker threads.
+	// Ranges always start at a multiple of 4, so they can be processed with SIMD.
+	// The calling thread claims ranges too, and only waits for ranges that a worker has already started. That way this can't
+	// deadlock when called from a worker itself (e.g. a system updating in parallel) while every other worker is busy.
+	template <typename F>
+	void forEachParticleRange(size_t n, F f)
+	{
+		constexpr size_t rangeSize = 4096;
+
+		const size_t nRanges = (n + rangeSize - 1) / rangeSize;
+		if (nRanges <= 1 || !Executors::hasInstance() || Executors::getCPU().threadCount() == 0) {
+			f(0, n);
+			return;
+		}
+
+		// Helpers that only get to run after every range is claimed return straight away, without touching f
+		struct State {
+			std::atomic<size_t> next = 0;
+			std::atomic<size_t> done = 0;
+		};
+		const auto state = std::make_shared<State>();
+		auto run = [state, &f, n, nRanges] ()
+		{
+			for (size_t i = state->next++; i < nRanges; i = state->next++) {
+				f(i * rangeSize, std::min(n, (i + 1) * rangeSize));
+				++state->done;
+			}
+		};
+
+		const size_t nHelpers = std::min(nRanges - 1, Executors::getCPU().threadCount());
+		for (size_t i = 0; i < nHelpers; ++i) {
+			Executors::getCPU().addToQueue(run);
+		}
+		run();
+
+		while (state->done < nRanges) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void Particles::ParticleData::resize(size_t size)
+{
+	posX.resize(size);
+	posY.resize(size);
+	posZ.resize(size);
+	velX.resize(size);
+	velY.resize(size);
+	velZ.resize(size);
+	scale.resize(size);
+	time.resize(size);
+	ttl.resize(size);
+	alive.resize(size);
+	spriteIdx.resize(size);
+}
+
+void Particles::ParticleData::swap(size_t a, size_t b)
+{
+	std::swap(posX[a], posX[b]);
+	std::swap(posY[a], posY[b]);
+	std::swap(posZ[a], posZ[b]);
+	std::swap(velX[a], velX[b]);
+	std::swap(velY[a], velY[b]);
+	std::swap(velZ[a], velZ[b]);
+	std::swap(scale[a], scale[b]);
+	std::swap(time[a], time[b]);
+	std::swap(ttl[a], ttl[b]);
+	std::swap(alive[a], alive[b]);
+	std::swap(spriteIdx[a], spriteIdx[b]);
+}
+
 Particles::Particles()
 	: rng(&Random::getGlobal())
 {
@@ -83,6 +160,7 @@ void Particles::load(const ConfigNode& node, Resources& resources, const EntityS
 	rotateTowardsMovement = node["rotateTowardsMovement"].asBool(false);
 	destroyWhenDone = node["destroyWhenDone"].asBool(false);
 	relativePosition = node["relativePosition"].asBool(false);
+	directDraw = node["directDraw"].asBool(false);
 	velScale = node["velScale"].asVector3f(Vector3f(1, 1, 1));
 	minHeight = node["minHeight"].asOptional<float>();
 	startHeight = node["startHeight"].asFloat(0);
@@ -92,6 +170,7 @@ void Particles::load(const ConfigNode& node, Resources& resources, const EntityS
 	onDeath = ConfigNodeSerializer<EntityId>().deserialize(context, node["onDeath"]);
 
 	maxBorder = {};
+	updateDirectDraw();
 }
 
 ConfigNode Particles::toConfigNode(const EntitySerializationContext& context) const
@@ -115,6 +194,7 @@ ConfigNode Particles::toConfigNode(const EntitySerializationContext& context) co
 	result["rotateTowardsMovement"] = rotateTowardsMovement;
 	result["destroyWhenDone"] = destroyWhenDone;
 	result["relativePosition"] = relativePosition;
+	result["directDraw"] = directDraw;
 	result["velScale"] = velScale;
 	result["minHeight"] = minHeight;
 	result["startHeight"] = startHeight;
@@ -179,8 +259,10 @@ void Particles::setPosition(Vector3f pos)
 		const auto delta = pos - position;
 		if (delta.squaredLength() > 0.000001f) {
 			if (relativePosition) {
-				for (auto& particle: particles) {
-					particle.pos += delta;
+				for (size_t i = 0; i < nParticlesAlive; ++i) {
+					particles.posX[i] += delta.x;
+					particles.posY[i] += delta.y;
+					particles.posZ[i] += delta.z;
 				}
 			}
 
@@ -331,7 +413,7 @@ void Particles::update(Time t)
 
 	// Update visibility
 	nParticlesVisible = nParticlesAlive;
-	if (nParticlesVisible > 0 && !sprites[0].hasMaterial()) {
+	if (nParticlesVisible > 0 && !(directDrawActive ? baseSprites[0] : sprites[0]).hasMaterial()) {
 		nParticlesVisible = 0;
 	}
 }
@@ -339,11 +421,61 @@ void Particles::update(Time t)
 void Particles::setSprites(Vector<Sprite> sprites)
 {
 	baseSprites = std::move(sprites);
+	updateDirectDraw();
 }
 
 void Particles::setAnimation(std::shared_ptr<const Animation> animation)
 {
 	baseAnimation = std::move(animation);
+	updateDirectDraw();
+}
+
+void Particles::setDirectDraw(bool enabled)
+{
+	directDraw = enabled;
+	updateDirectDraw();
+}
+
+bool Particles::isDirectDraw() const
+{
+	return directDrawActive;
+}
+
+void Particles::updateDirectDraw()
+{
+	const bool canDrawDirect = !isAnimated() && !baseSprites.empty() && baseSprites.size() <= std::numeric_limits<uint16_t>::max()
+		&& std::all_of(baseSprites.begin(), baseSprites.end(), [&] (const Sprite& sprite)
+		{
+			return sprite.getMaterialPtr() == baseSprites[0].getMaterialPtr() && !sprite.isSliced();
+		});
+	const bool active = directDraw && canDrawDirect;
+
+	if (active && directDrawActive) {
+		// Base sprites might have changed, so make sure every particle still points at one
+		for (size_t i = 0; i < nParticlesAlive; ++i) {
+			if (particles.spriteIdx[i] >= baseSprites.size()) {
+				particles.spriteIdx[i] = static_cast<uint16_t>(rng->getRandomIndex(baseSprites));
+			}
+		}
+	} else if (active != directDrawActive) {
+		directDrawActive = active;
+		if (directDrawActive) {
+			sprites.clear();
+			sprites.shrink_to_fit();
+			for (size_t i = 0; i < nParticlesAlive; ++i) {
+				particles.spriteIdx[i] = static_cast<uint16_t>(rng->getRandomIndex(baseSprites));
+			}
+		} else {
+			// Particles that are already alive get a sprite the same way spawn() would give them one
+			sprites.resize(particles.size());
+			if (isAnimated()) {
+				animationPlayers.resize(particles.size(), AnimationPlayerLite(baseAnimation));
+			}
+			for (size_t i = 0; i < nParticlesAlive; ++i) {
+				initializeSprite(i, particles.spriteIdx[i]);
+			}
+		}
+	}
 }
 
 bool Particles::isAnimated() const
@@ -358,11 +490,23 @@ bool Particles::isAlive() const
 
 gsl::span<Sprite> Particles::getSprites()
 {
+	if (directDrawActive) {
+		if (nParticlesVisible > 0) {
+			Logger::logWarning("Particles::getSprites() called on an emitter drawing directly, use Particles::draw() or SpritePainter::add(const Particles&, ...) instead.", true);
+		}
+		return {};
+	}
 	return gsl::span<Sprite>(sprites).subspan(0, nParticlesVisible);
 }
 
 gsl::span<const Sprite> Particles::getSprites() const
 {
+	if (directDrawActive) {
+		if (nParticlesVisible > 0) {
+			Logger::logWarning("Particles::getSprites() called on an emitter drawing directly, use Particles::draw() or SpritePainter::add(const Particles&, ...) instead.", true);
+		}
+		return {};
+	}
 	return gsl::span<const Sprite>(sprites).subspan(0, nParticlesVisible);
 }
 
@@ -374,15 +518,14 @@ void Particles::setSecondarySpawner(IParticleSpawner* spawner)
 void Particles::spawnAt(Vector3f pos)
 {
 	spawn(1, 0.0f);
-	particles[nParticlesAlive - 1].pos = pos;
+	particles.setPos(nParticlesAlive - 1, pos);
 }
 
 void Particles::destroyOverlapping(const Polygon& polygon)
 {
 	for (size_t i = 0; i < nParticlesAlive; ++i) {
-		auto& particle = particles[i];
-		if (polygon.isPointInside(particle.pos.xy())) {
-			particle.alive = false;
+		if (polygon.isPointInside(Vector2f(particles.posX[i], particles.posY[i]))) {
+			particles.alive[i] = 0;
 		}
 	}
 }
@@ -390,9 +533,8 @@ void Particles::destroyOverlapping(const Polygon& polygon)
 void Particles::destroyOverlapping(const Ellipse& ellipse)
 {
 	for (size_t i = 0; i < nParticlesAlive; ++i) {
-		auto& particle = particles[i];
-		if (ellipse.contains(particle.pos.xy())) {
-			particle.alive = false;
+		if (ellipse.contains(Vector2f(particles.posX[i], particles.posY[i]))) {
+			particles.alive[i] = 0;
 		}
 	}
 }
@@ -400,9 +542,8 @@ void Particles::destroyOverlapping(const Ellipse& ellipse)
 void Particles::destroyOverlapping(const Circle& circle)
 {
 	for (size_t i = 0; i < nParticlesAlive; ++i) {
-		auto& particle = particles[i];
-		if (circle.contains(particle.pos.xy())) {
-			particle.alive = false;
+		if (circle.contains(Vector2f(particles.posX[i], particles.posY[i]))) {
+			particles.alive[i] = 0;
 		}
 	}
 }
@@ -418,6 +559,8 @@ void Particles::spawn(size_t n, float time)
 	const size_t size = std::max(size_t(8), nextPowerOf2(nParticlesAlive));
 	if (particles.size() < size) {
 		particles.resize(size);
+	}
+	if (sprites.size() < size && !directDrawActive) {
 		sprites.resize(size);
 	}
 	if (animationPlayers.size() < size && isAnimated()) {
@@ -435,20 +578,32 @@ void Particles::initializeParticle(size_t index, float time, float totalTime)
 	const auto startAzimuth = Angle1f::fromDegrees(rng->getFloat(azimuth));
 	const auto startElevation = Angle1f::fromDegrees(rng->getFloat(altitude));
 	
-	auto& particle = particles[index];
-	particle.firstFrame = true;
-	particle.alive = true;
-	particle.time = time;
-	particle.ttl = rng->getFloat(ttl);
-	//particle.angle = rotateTowardsMovement ? startAzimuth : Angle1f();
-	particle.scale = rng->getFloat(initialScale);
-
-	particle.vel = Vector3f(rng->getFloat(speed) * speedMultiplier, startAzimuth, startElevation);
-	const bool stopped = stopTime > 0.00001f && particle.time + stopTime >= particle.ttl;
+	const float particleTtl = rng->getFloat(ttl);
+	particles.alive[index] = 1;
+	particles.time[index] = time;
+	particles.ttl[index] = particleTtl;
+	particles.scale[index] = rng->getFloat(initialScale);
+
+	const auto vel = Vector3f(rng->getFloat(speed) * speedMultiplier, startAzimuth, startElevation);
+	const bool stopped = stopTime > 0.00001f && time + stopTime >= particleTtl;
 	const auto a = stopped ? Vector3f() : acceleration;
 	const auto spawnPosSmear = totalTime > 0.00001f ? lerp(position - lastPosition, Vector3f(), time / totalTime) : Vector3f();
-	particle.pos = getSpawnPosition() + spawnPosSmear + (particle.vel * time + a * (0.5f * time * time)) * velScale;
+	particles.setVel(index, vel);
+	particles.setPos(index, getSpawnPosition() + spawnPosSmear + (vel * time + a * (0.5f * time * time)) * velScale);
+
+	if (directDrawActive) {
+		particles.spriteIdx[index] = static_cast<uint16_t>(rng->getRandomIndex(baseSprites));
+	} else {
+		initializeSprite(index, {});
+	}
+
+	if (onSpawn) {
+		onSecondarySpawn(index, onSpawn);
+	}
+}
 
+void Particles::initializeSprite(size_t index, std::optional<size_t> baseSpriteIdx)
+{
 	auto& sprite = sprites[index];
 	if (isAnimated()) {
 		auto& anim = animationPlayers[index];
@@ -456,95 +611,227 @@ void Particles::initializeParticle(size_t index, float time, float totalTime)
 	} else if (!baseSprites.empty()) {
 		// Optimization: if there's only one baseSprite, and this sprite has a material, then we don't need to update it at all here
 		if (!sprite.hasMaterial() || baseSprites.size() >= 2) {
-			sprite.copyFrom(rng->getRandomElement(baseSprites), false);
+			const bool validIdx = baseSpriteIdx && *baseSpriteIdx < baseSprites.size();
+			sprite.copyFrom(validIdx ? baseSprites[*baseSpriteIdx] : rng->getRandomElement(baseSprites), false);
+			if (!rotateTowardsMovement) {
+				// Rotation is always written as 0 from now on
+				sprite.setRotation(Angle1f());
+			}
 		}
 	}
-
-	if (onSpawn) {
-		onSecondarySpawn(particle, onSpawn);
-	}
 }
 
 void Particles::updateParticles(float time)
 {
-	const bool hasAnim = isAnimated();
+	forEachParticleRange(nParticlesAlive, [&] (size_t start, size_t end)
+	{
+		updateParticleRange(start, end, time);
+	});
+
+	if (directionScatter > 0.00001f) {
+		// This draws from rng, so it's kept serial and in order
+		for (size_t i = 0; i < nParticlesAlive; ++i) {
+			if (particles.time[i] < particles.ttl[i]) {
+				const auto vel = particles.getVel(i);
+				particles.setVel(i, Vector3f(vel.xy().rotate(Angle1f::fromDegrees(rng->getFloat(-directionScatter * time, directionScatter * time))), vel.z));
+			}
+		}
+	}
 
-	for (size_t i = 0; i < nParticlesAlive; ++i) {
-		if (hasAnim) {
+	removeDeadParticles();
+	nParticlesStarted = nParticlesAlive;
+}
+
+void Particles::updateParticleRange(size_t start, size_t end, float time)
+{
+	if (isAnimated()) {
+		for (size_t i = start; i < end; ++i) {
 			animationPlayers[i].update(time, sprites[i]);
 		}
+	}
 
-		auto& particle = particles[i];
+	// Particles are updated four at a time. The arrays are always sized to a multiple of 4 (see spawn()), so it's safe to go past the last particle alive.
+	const size_t alignedEnd = alignUp(end, size_t(4));
+	Expects(alignedEnd <= particles.size());
+
+	const auto zero = SIMDVec4::loadZero();
+	const auto dt = SIMDVec4::loadSingleValue(time);
+	const auto halfDt2 = SIMDVec4::loadSingleValue(0.5f * time * time);
+	const auto accX = SIMDVec4::loadSingleValue(acceleration.x);
+	const auto accY = SIMDVec4::loadSingleValue(acceleration.y);
+	const auto accZ = SIMDVec4::loadSingleValue(acceleration.z);
+	const auto velScaleX = SIMDVec4::loadSingleValue(velScale.x);
+	const auto velScaleY = SIMDVec4::loadSingleValue(velScale.y);
+	const auto velScaleZ = SIMDVec4::loadSingleValue(velScale.z);
+
+	const bool hasStopTime = stopTime > 0.00001f;
+	const auto stopTimeV = SIMDVec4::loadSingleValue(stopTime);
+	const auto stopDamp = SIMDVec4::loadSingleValue(damp(1.0f, 0.0f, 10.0f, time));
+	const bool hasSpeedDamp = speedDamp > 0.0001f;
+	const auto speedDampV = SIMDVec4::loadSingleValue(damp(1.0f, 0.0f, speedDamp, time));
+	const auto minHeightV = SIMDVec4::loadSingleValue(minHeight.value_or(0.0f));
+
+	alignas(16) constexpr float laneOffsets[] = { 0, 1, 2, 3 };
+	const auto laneIdx = SIMDVec4::loadAligned(laneOffsets);
+	const auto nStarted = SIMDVec4::loadSingleValue(static_cast<float>(nParticlesStarted));
+
+	for (size_t i = start; i < alignedEnd; i += 4) {
+		const auto t = SIMDVec4::loadUnaligned(&particles.time[i]) + dt;
+		const auto ttls = SIMDVec4::loadUnaligned(&particles.ttl[i]);
+		const auto alive = t.lessThan(ttls);
+		const auto stopped = hasStopTime ? ttls.lessOrEqual(t + stopTimeV) : zero;
+
+		// Particles spawned this frame already had their position computed for their spawn time
+		const auto started = (SIMDVec4::loadSingleValue(static_cast<float>(i)) + laneIdx).lessThan(nStarted);
+		const auto move = alive & started;
+
+		auto posX = SIMDVec4::loadUnaligned(&particles.posX[i]);
+		auto posY = SIMDVec4::loadUnaligned(&particles.posY[i]);
+		auto posZ = SIMDVec4::loadUnaligned(&particles.posZ[i]);
+		auto velX = SIMDVec4::loadUnaligned(&particles.velX[i]);
+		auto velY = SIMDVec4::loadUnaligned(&particles.velY[i]);
+		auto velZ = SIMDVec4::loadUnaligned(&particles.velZ[i]);
+
+		const auto ax = SIMDVec4::select(stopped, zero, accX);
+		const auto ay = SIMDVec4::select(stopped, zero, accY);
+		const auto az = SIMDVec4::select(stopped, zero, accZ);
+
+		posX = SIMDVec4::select(move, posX + (velX * dt + ax * halfDt2) * velScaleX, posX);
+		posY = SIMDVec4::select(move, posY + (velY * dt + ay * halfDt2) * velScaleY, posY);
+		posZ = SIMDVec4::select(move, posZ + (velZ * dt + az * halfDt2) * velScaleZ, posZ);
+		velX = SIMDVec4::select(move, velX + ax * dt, velX);
+		velY = SIMDVec4::select(move, velY + ay * dt, velY);
+		velZ = SIMDVec4::select(move, velZ + az * dt, velZ);
+
+		if (hasStopTime) {
+			velX = SIMDVec4::select(stopped, velX * stopDamp, velX);
+			velY = SIMDVec4::select(stopped, velY * stopDamp, velY);
+			velZ = SIMDVec4::select(stopped, velZ * stopDamp, velZ);
+		}
+		if (hasSpeedDamp) {
+			velX = velX * speedDampV;
+			velY = velY * speedDampV;
+			velZ = velZ * speedDampV;
+		}
 
-		particle.time += time;
-		if (particle.time >= particle.ttl) {
-			particle.alive = false;
+		t.storeUnaligned(&particles.time[i]);
+		posX.storeUnaligned(&particles.posX[i]);
+		posY.storeUnaligned(&particles.posY[i]);
+		posZ.storeUnaligned(&particles.posZ[i]);
+		velX.storeUnaligned(&particles.velX[i]);
+		velY.storeUnaligned(&particles.velY[i]);
+		velZ.storeUnaligned(&particles.velZ[i]);
+
+		int deadMask = ~alive.getMask() & 0xF;
+		if (minHeight) {
+			deadMask |= posZ.lessThan(minHeightV).getMask();
 		}
-		else {
-			const bool stopped = stopTime > 0.00001f && particle.time + stopTime >= particle.ttl;
-			const auto a = stopped ? Vector3f() : acceleration;
-			if (particle.firstFrame) {
-				particle.firstFrame = false;
-			}
-			else {
-				particle.pos += (particle.vel * time + a * (0.5f * time * time)) * velScale;
-				particle.vel += a * time;
+		if (deadMask != 0) {
+			for (size_t j = 0; j < 4; ++j) {
+				if (deadMask & (1 << j)) {
+					particles.alive[i + j] = 0;
+				}
 			}
+		}
+	}
+}
 
-			if (minHeight && particle.pos.z < minHeight) {
-				particle.alive = false;
-			}
+void Particles::updateSprites(Time t)
+{
+	if (directDrawActive) {
+		// Sprite state is computed as the vertices are written, in draw()
+		return;
+	}
 
-			if (stopped) {
-				particle.vel = damp(particle.vel, Vector3f(), 10.0f, time);
-			}
+	// The gradient is precomputed lazily, so make sure that happens before it's read from several threads
+	colourGradient.evaluatePrecomputed(0.0f);
 
-			if (speedDamp > 0.0001f) {
-				particle.vel = damp(particle.vel, Vector3f(), speedDamp, time);
-			}
+	forEachParticleRange(nParticlesAlive, [&] (size_t start, size_t end)
+	{
+		updateSpriteRange(start, end);
+	});
+}
 
-			if (directionScatter > 0.00001f) {
-				particle.vel = Vector3f(particle.vel.xy().rotate(Angle1f::fromDegrees(rng->getFloat(-directionScatter * time, directionScatter * time))), particle.vel.z);
-			}
+void Particles::updateSpriteRange(size_t start, size_t end)
+{
+	for (size_t i = start; i < end; ++i) {
+		auto& sprite = sprites[i];
+		writeSpriteAttribs(i, sprite.getMutableVertexAttributes());
+		if (rotateTowardsMovement) {
+			// Keeps the sprite's bounds right
+			sprite.setRotation(Angle1f::fromRadians(sprite.getVertexAttributes().rotation, false));
 		}
 	}
-
-	removeDeadParticles();
 }
 
-void Particles::updateSprites(Time t)
+void Particles::draw(Painter& painter) const
 {
-	for (size_t i = 0; i < nParticlesAlive; ++i) {
-		const auto& particle = particles[i];
+	if (!directDrawActive) {
+		Sprite::draw(getSprites(), painter);
+		return;
+	}
 
-		Angle1f angle;
-		if (rotateTowardsMovement && particle.vel.squaredLength() > 0.001f) {
-			angle = (particle.vel.xy() + Vector2f(0, particle.vel.z)).angle();
-		}
+	if (nParticlesVisible == 0) {
+		return;
+	}
+
+	// Each sprite is its vertex attributes, preceded by the vertex position (which the painter fills in)
+	const auto& material = baseSprites[0].getMaterialPtr();
+	Expects(material->getDefinition().getVertexStride() == sizeof(SpriteVertexAttrib) + sizeof(Vector4f));
 
-		const float t = particle.time / particle.ttl;
+	// Written straight into the painter's vertex buffer, as a single draw call since they all share the material
+	painter.drawSprites(material, nParticlesVisible, [this] (size_t start, size_t end, char* dst, size_t spriteStride)
+	{
+		writeVertexAttribs(start, end, dst, spriteStride);
+	});
+}
 
-		sprites[i]
-			.setPosition(particle.pos.xy() + Vector2f(0, -particle.pos.z))
-			.setRotation(angle)
-			.setScale(scaleCurve.evaluate(t) * particle.scale)
-			.setColour(colourGradient.evaluatePrecomputed(t))
-			.setCustom1(Vector4f(particle.pos.xy(), 0, 0));
+void Particles::writeVertexAttribs(size_t start, size_t end, char* dst, size_t stride) const
+{
+	for (size_t i = start; i < end; ++i) {
+		auto& attrib = *reinterpret_cast<SpriteVertexAttrib*>(dst + (i - start) * stride + sizeof(Vector4f));
+		attrib = baseSprites[particles.spriteIdx[i]].getVertexAttributes();
+		writeSpriteAttribs(i, attrib);
 	}
 }
 
+void Particles::writeSpriteAttribs(size_t index, SpriteVertexAttrib& attrib) const
+{
+	const auto posX = particles.posX[index];
+	const auto posY = particles.posY[index];
+	const auto velX = particles.velX[index];
+	const auto velY = particles.velY[index];
+	const auto velZ = particles.velZ[index];
+
+	float rotation = 0;
+	if (rotateTowardsMovement && velX * velX + velY * velY + velZ * velZ > 0.001f) {
+		rotation = Vector2f(velX, velY + velZ).angle().getRadians();
+	}
+
+	const float t = particles.time[index] / particles.ttl[index];
+	const float scale = scaleCurve.evaluate(t) * particles.scale[index];
+
+	attrib.pos = Vector2f(posX, posY - particles.posZ[index]);
+	attrib.rotation = rotation;
+	attrib.scale = Vector2f(scale, scale);
+	attrib.colour = colourGradient.evaluatePrecomputed(t);
+	attrib.custom1 = Vector4f(posX, posY, 0, 0);
+}
+
 void Particles::removeDeadParticles()
 {
 	for (size_t i = 0; i < nParticlesAlive; ) {
-		if (!particles[i].alive) {
+		if (!particles.alive[i]) {
 			if (onDeath) {
-				onSecondarySpawn(particles[i], onDeath);
+				onSecondarySpawn(i, onDeath);
 			}
 
 			if (i != nParticlesAlive - 1) {
 				// Swap with last particle that's alive
-				std::swap(particles[i], particles[nParticlesAlive - 1]);
-				std::swap(sprites[i], sprites[nParticlesAlive - 1]);
+				particles.swap(i, nParticlesAlive - 1);
+				if (!directDrawActive) {
+					std::swap(sprites[i], sprites[nParticlesAlive - 1]);
+				}
 				if (isAnimated()) {
 					std::swap(animationPlayers[i], animationPlayers[nParticlesAlive - 1]);
 				}
@@ -570,10 +857,10 @@ Vector3f Particles::getSpawnPosition() const
 	return position + Vector3f(pos + spawnPositionOffset, startHeight);
 }
 
-void Particles::onSecondarySpawn(const Particle& particle, EntityId target)
+void Particles::onSecondarySpawn(size_t index, EntityId target)
 {
 	if (secondarySpawner && target) {
-		secondarySpawner->spawn(particle.pos, target);
+		secondarySpawner->spawn(particles.getPos(index), target);
 	}
 }
 
@@ -583,11 +870,37 @@ std::optional<Rect4f> Particles::getAABB() const
 		return {};
 	}
 
-	Vector2f minPos = particles[0].pos.xy() + Vector2f(0, -particles[0].pos.z);
+	Vector2f minPos = Vector2f(particles.posX[0], particles.posY[0] - particles.posZ[0]);
 	Vector2f maxPos = minPos;
 
-	for (size_t i = 1; i < nParticlesAlive; ++i) {
-		const auto p = particles[i].pos.xy() + Vector2f(0, -particles[i].pos.z);
+	const size_t nBlocks = nParticlesAlive / 4;
+	if (nBlocks > 0) {
+		auto minX = SIMDVec4::loadSingleValue(minPos.x);
+		auto minY = SIMDVec4::loadSingleValue(minPos.y);
+		auto maxX = minX;
+		auto maxY = minY;
+		for (size_t i = 0; i < nBlocks * 4; i += 4) {
+			const auto x = SIMDVec4::loadUnaligned(&particles.posX[i]);
+			const auto y = SIMDVec4::loadUnaligned(&particles.posY[i]) - SIMDVec4::loadUnaligned(&particles.posZ[i]);
+			minX = minX.min(x);
+			minY = minY.min(y);
+			maxX = maxX.max(x);
+			maxY = maxY.max(y);
+		}
+
+		alignas(16) std::array<float, 4> lanes[4];
+		minX.storeAligned(lanes[0].data());
+		minY.storeAligned(lanes[1].data());
+		maxX.storeAligned(lanes[2].data());
+		maxY.storeAligned(lanes[3].data());
+		for (size_t j = 0; j < 4; ++j) {
+			minPos = Vector2f::min(minPos, Vector2f(lanes[0][j], lanes[1][j]));
+			maxPos = Vector2f::max(maxPos, Vector2f(lanes[2][j], lanes[3][j]));
+		}
+	}
+
+	for (size_t i = nBlocks * 4; i < nParticlesAlive; ++i) {
+		const auto p = Vector2f(particles.posX[i], particles.posY[i] - particles.posZ[i]);
 		minPos = Vector2f::min(minPos, p);
 		maxPos = Vector2f::max(maxPos, p);
 	}
@@ -6,6 +6,10 @@
 #include "halley/graphics/material/material.h"
 #include "halley/graphics/material/material_definition.h"
 #include "halley/graphics/text/text_renderer.h"
+#include "halley/graphics/sprite/particles.h"
+#include "halley/graphics/texture.h"
+#include "halley/graphics/texture_streamer.h"
+#include "halley/resources/resources.h"
 #include "halley/utils/algorithm.h"
 
 using namespace Halley;
@@ -100,6 +104,11 @@ int SpritePainterEntry::getMask() const
 	return mask;
 }
 
+int SpritePainterEntry::getLayer() const
+{
+	return layer;
+}
+
 const std::optional<Rect4f>& SpritePainterEntry::getClip() const
 {
 	return clip;
@@ -138,26 +147,38 @@ Rect4f SpritePainterEntry::getBounds(const Rect4f& view, const Vector<Sprite>& c
 	}
 }
 
-bool SpritePainterEntry::isCompatibleWith(const SpritePainterEntry& other, const Vector<Sprite>& cachedSprites, const Vector<TextRenderer>& cachedText) const
+uint64_t SpritePainterEntry::getSortKey(const Vector<Sprite>& cachedSprites, const Vector<TextRenderer>& cachedText) const
+{
+	if (type == SpritePainterEntryType::SpriteCached || type == SpritePainterEntryType::SpriteRef) {
+		const auto& sprite = getSprites(cachedSprites)[0];
+		return sprite.hasMaterial() ? sprite.getMaterial().getSortKey() : 0;
+	} else if (type == SpritePainterEntryType::TextCached || type == SpritePainterEntryType::TextRef) {
+		return getTexts(cachedText)[0].getSortKey();
+	} else {
+		return 0;
+	}
+}
+
+bool SpritePainterEntry::isCompatibleWith(const SpritePainterEntry& other, uint64_t sortKey, uint64_t otherSortKey, const Vector<Sprite>& cachedSprites, const Vector<TextRenderer>& cachedText) const
 {
-	if (type != other.type || clip != other.clip) {
+	if (type != other.type || clip != other.clip || type == SpritePainterEntryType::Callback) {
 		return false;
 	}
 
-	if (type == SpritePainterEntryType::SpriteCached || type == SpritePainterEntryType::SpriteRef) {
-		const auto& s0 = getSprites(cachedSprites)[0];
-		const auto& s1 = other.getSprites(cachedSprites)[0];
+	// Treat no material as compatible, since it'll be ignored by the renderer a little after this anyway
+	if (sortKey == 0 || otherSortKey == 0) {
+		return true;
+	}
 
-		// Treat no material as compatible, since it'll be ignored by the renderer a little after this anyway
-		if (!s0.hasMaterial() || !s1.hasMaterial()) {
-			return true;
-		}
+	// Keys only hold truncated hashes, so they can rule a pair out cheaply, but not confirm it
+	if ((sortKey >> 16) != (otherSortKey >> 16)) {
+		return false;
+	}
 
-		return s0.getMaterial().isCompatibleWith(s1.getMaterial());
-	} else if (type == SpritePainterEntryType::TextCached || type == SpritePainterEntryType::TextRef) {
-		return getTexts(cachedText)[0].isCompatibleWith(other.getTexts(cachedText)[0]);
+	if (type == SpritePainterEntryType::SpriteCached || type == SpritePainterEntryType::SpriteRef) {
+		return getSprites(cachedSprites)[0].getMaterial().isCompatibleWith(other.getSprites(cachedSprites)[0].getMaterial());
 	} else {
-		return false;
+		return getTexts(cachedText)[0].isCompatibleWith(other.getTexts(cachedText)[0]);
 	}
 }
 
@@ -244,11 +265,15 @@ SpritePainter::SpritePainter()
 void SpritePainter::update(Time t, Resources& resources)
 {
 	paramUpdater.update(t);
+	textureStreamer = resources.getTextureStreamer();
 }
 
 void SpritePainter::copyPrevious(const IPainter& prev)
 {
-	paramUpdater.copyPrevious(dynamic_cast<const SpritePainter&>(prev).paramUpdater);
+	const auto& prevPainter = dynamic_cast<const SpritePainter&>(prev);
+	paramUpdater.copyPrevious(prevPainter.paramUpdater);
+	unorderedLayers = prevPainter.unorderedLayers;
+	textureStreamer = prevPainter.textureStreamer;
 }
 
 void SpritePainter::startFrame(bool multithreaded)
@@ -351,6 +376,33 @@ void SpritePainter::addCopy(const TextRenderer& text, int mask, int layer, float
 	dirty = true;
 }
 
+void SpritePainter::add(gsl::span<const TextRenderer> texts, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip)
+{
+	if (!texts.empty()) {
+		if (forceCopy) {
+			addCopy(texts, mask, layer, tieBreaker, clip);
+		} else {
+			Expects(mask >= 0);
+			sprites.push_back(SpritePainterEntry(texts, mask, layer, tieBreaker, sprites.size(), std::move(clip)));
+			dirty = true;
+		}
+	}
+}
+
+void SpritePainter::addCopy(gsl::span<const TextRenderer> texts, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip)
+{
+	Expects(mask >= 0);
+	if (!texts.empty()) {
+		sprites.push_back(SpritePainterEntry(SpritePainterEntryType::TextCached, cachedText.size(), texts.size(), mask, layer, tieBreaker, sprites.size(), std::move(clip)));
+		cachedText.reserve(cachedText.size() + texts.size());
+		for (auto& text: texts) {
+			text.generateSprites();
+			cachedText.push_back(text);
+		}
+		dirty = true;
+	}
+}
+
 void SpritePainter::add(SpritePainterEntry::Callback callback, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip)
 {
 	Expects(mask >= 0);
@@ -359,35 +411,76 @@ void SpritePainter::add(SpritePainterEntry::Callback callback, int mask, int lay
 	dirty = true;
 }
 
+void SpritePainter::add(const Particles& particles, int mask, int layer, float tieBreaker, std::optional<Rect4f> clip)
+{
+	if (!particles.isDirectDraw()) {
+		add(particles.getSprites(), mask, layer, tieBreaker, std::move(clip));
+		return;
+	}
+
+	if (const auto aabb = particles.getAABB()) {
+		add([&particles] (Painter& painter)
+		{
+			particles.draw(painter);
+		}, mask, layer, tieBreaker, std::move(clip));
+		add(*aabb);
+	}
+}
+
 void SpritePainter::add(Rect4f bounds)
 {
 	extraBounds.push_back(bounds);
 }
 
+void SpritePainter::setLayerUnordered(int layer, bool unordered)
+{
+	if (unordered != isLayerUnordered(layer)) {
+		if (unordered) {
+			unorderedLayers.push_back(layer);
+		} else {
+			std_ex::erase(unorderedLayers, layer);
+		}
+	}
+}
+
+bool SpritePainter::isLayerUnordered(int layer) const
+{
+	return std_ex::contains(unorderedLayers, layer);
+}
+
 void SpritePainter::draw(SpriteMaskBase mask, Painter& painter)
 {
+	// View
+	const Rect4f view = painter.getCurrentCamera().getClippingRectangle();
+	MipUsage mipUsage;
+
+	std::unique_lock<std::mutex> lock(drawMutex);
 	if (dirty) {
 		std::sort(sprites.begin(), sprites.end());
+		sortUnorderedLayers();
 		dirty = false;
 	}
-
-	// View
-	const Rect4f view = painter.getCurrentCamera().getClippingRectangle();
+	const auto drawOrder = getSpriteDrawOrder(mask, view, true);
+	lock.unlock();
 
 	// Draw!
-	for (auto spriteIdx: getSpriteDrawOrder(mask, view, true)) {
+	for (auto spriteIdx: drawOrder) {
 		auto& s = sprites[spriteIdx];
 		const auto type = s.getType();
 		
 		if (type == SpritePainterEntryType::SpriteRef || type == SpritePainterEntryType::SpriteCached) {
-			draw(s.getSprites(cachedSprites), painter, view, s.getClip());
+			draw(s.getSprites(cachedSprites), painter, view, s.getClip(), textureStreamer ? &mipUsage : nullptr);
 		} else if (type == SpritePainterEntryType::TextRef || type == SpritePainterEntryType::TextCached) {
+			// Text renderers regenerate their glyph sprites as they draw
+			std::unique_lock<std::mutex> textLock(drawMutex);
 			draw(s.getTexts(cachedText), painter, view, s.getClip());
 		} else if (type == SpritePainterEntryType::Callback) {
 			draw(callbacks.at(s.getIndex()), painter, s.getClip());
 		}
 	}
 	painter.flush();
+
+	reportMipUsage(mipUsage);
 }
 
 Vector<uint32_t> SpritePainter::getSpriteDrawOrder(int mask, Rect4f view, bool reorder) const
@@ -408,15 +501,54 @@ Vector<uint32_t> SpritePainter::getSpriteDrawOrder(int mask, Rect4f view, bool r
 	return result;
 }
 
+void SpritePainter::sortUnorderedLayers()
+{
+	if (unorderedLayers.empty()) {
+		return;
+	}
+
+	// Sort each run between callbacks, keeping the tie breaker order for equal keys
+	auto keys = VectorTemp<std::pair<uint64_t, SpritePainterEntry>>(memoryPool);
+	const auto sortRun = [&] (size_t start, size_t end)
+	{
+		if (end - start < 2) {
+			return;
+		}
+		keys.clear();
+		for (size_t i = start; i < end; ++i) {
+			keys.emplace_back(sprites[i].getSortKey(cachedSprites, cachedText), sprites[i]);
+		}
+		std::stable_sort(keys.begin(), keys.end(), [] (const auto& a, const auto& b) { return a.first < b.first; });
+		for (size_t i = start; i < end; ++i) {
+			sprites[i] = keys[i - start].second;
+		}
+	};
+
+	size_t runStart = 0;
+	for (size_t i = 0; i <= sprites.size(); ++i) {
+		const bool endRun = i == sprites.size()
+			|| sprites[i].getType() == SpritePainterEntryType::Callback
+			|| sprites[i].getLayer() != sprites[runStart].getLayer();
+		if (endRun) {
+			if (runStart < i && isLayerUnordered(sprites[runStart].getLayer())) {
+				sortRun(runStart, i);
+			}
+			runStart = i < sprites.size() && sprites[i].getType() == SpritePainterEntryType::Callback ? i + 1 : i;
+		}
+	}
+}
+
 Vector<uint32_t> SpritePainter::getSpriteDrawOrderReordered(int mask, Rect4f view) const
 {
 	struct Entry {
 		uint32_t idx = 0;
 		bool assigned = false;
+		uint64_t sortKey = 0;
 		Rect4f bounds;
 
-		Entry(uint32_t idx = 0, Rect4f bounds = {})
+		Entry(uint32_t idx = 0, uint64_t sortKey = 0, Rect4f bounds = {})
 			: idx(idx)
+			, sortKey(sortKey)
 			, bounds(bounds)
 		{}
 	};
@@ -427,12 +559,18 @@ Vector<uint32_t> SpritePainter::getSpriteDrawOrderReordered(int mask, Rect4f vie
 	constexpr int maxSkipsInARow = 16;
 
 	// Generate filtered sprite draw order, and sprite bounds
+	// Sprites out of view would be skipped when drawing anyway, so they're culled here, before they can get in the way of reordering
 	const auto nTotal = static_cast<uint32_t>(sprites.size());
 	for (uint32_t i = 0; i < nTotal; ++i) {
 		auto& s = sprites[i];
 
 		if ((s.getMask() & mask) != 0) {
-			entries.emplace_back(i, s.getBounds(view, cachedSprites, cachedText));
+			const auto bounds = s.getBounds(view, cachedSprites, cachedText);
+			const auto type = s.getType();
+			if ((type == SpritePainterEntryType::SpriteRef || type == SpritePainterEntryType::SpriteCached) && !bounds.overlaps(view)) {
+				continue;
+			}
+			entries.emplace_back(i, s.getSortKey(cachedSprites, cachedText), bounds);
 		}
 	}
 	const auto n = static_cast<uint32_t>(entries.size());
@@ -483,7 +621,7 @@ Vector<uint32_t> SpritePainter::getSpriteDrawOrderReordered(int mask, Rect4f vie
 				break;
 			}
 
-			if (sprites[entry.idx].isCompatibleWith(sprites[other.idx], cachedSprites, cachedText) && !overlapsAny(other.bounds, combinedSkipped, skipped)) {
+			if (sprites[entry.idx].isCompatibleWith(sprites[other.idx], entry.sortKey, other.sortKey, cachedSprites, cachedText) && !overlapsAny(other.bounds, combinedSkipped, skipped)) {
 				result.push_back(other.idx);
 				other.assigned = true;
 				skipsInARow = 0;
@@ -546,13 +684,33 @@ SpritePainterMaterialParamUpdater& SpritePainter::getParamUpdater()
 	return paramUpdater;
 }
 
-void SpritePainter::draw(gsl::span<const Sprite> sprites, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const
+void SpritePainter::draw(gsl::span<const Sprite> sprites, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip, MipUsage* mipUsage) const
 {
+	const float zoom = painter.getCurrentCamera().getZoom();
+
+	// Sprites in a span mostly share a texture, so the map is only touched when it changes
+	const Texture* curTexture = nullptr;
+	int curLevel = 0;
+
 	for (const auto& sprite: sprites) {
 		if (sprite.isInView(view)) {
 			// The logic is a bit confusing here - if we're waiting, just go ahead, as the code will eventually wait
 			// If we're not waiting, skip this sprite if it's not loaded
 			if (waitForSpriteLoad || sprite.isLoaded()) {
+				if (mipUsage && sprite.hasMaterial() && sprite.getMaterial().getNumTextureUnits() > 0) {
+					const auto& texture = sprite.getMaterial().getTexture(0);
+					const auto texels = sprite.getTexRect0().getSize() * Vector2f(texture->getSize());
+					const auto level = TextureStreamer::getRequiredMipLevel(texels, sprite.getScaledSize() * zoom);
+					if (texture.get() == curTexture) {
+						curLevel = std::min(curLevel, level);
+					} else {
+						if (curTexture) {
+							recordMipUsage(*mipUsage, curTexture, curLevel);
+						}
+						curTexture = texture.get();
+						curLevel = level;
+					}
+				}
 				if (paramUpdater.needsToPreProcessessMaterial(sprite)) {
 					auto s2 = sprite;
 					paramUpdater.preProcessMaterial(s2);
@@ -563,6 +721,30 @@ void SpritePainter::draw(gsl::span<const Sprite> sprites, Painter& painter, Rect
 			}
 		}
 	}
+
+	if (curTexture) {
+		recordMipUsage(*mipUsage, curTexture, curLevel);
+	}
+}
+
+void SpritePainter::recordMipUsage(MipUsage& mipUsage, const Texture* texture, int level)
+{
+	const auto iter = mipUsage.find(texture);
+	if (iter == mipUsage.end()) {
+		mipUsage[texture] = level;
+	} else {
+		iter->second = std::min(iter->second, level);
+	}
+}
+
+void SpritePainter::reportMipUsage(const MipUsage& mipUsage) const
+{
+	// The streamer takes its own lock, so draws on different threads can report at once
+	if (textureStreamer) {
+		for (const auto& [texture, level]: mipUsage) {
+			textureStreamer->reportUsage(*texture, level);
+		}
+	}
 }
 
 void SpritePainter::draw(gsl::span<const TextRenderer> texts, Painter& painter, Rect4f view, const std::optional<Rect4f>& clip) const
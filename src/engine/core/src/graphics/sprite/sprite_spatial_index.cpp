@@ -0,0 +1,170 @@
+#include "halley/graphics/sprite/sprite_spatial_index.h"
+#include "halley/graphics/sprite/sprite_painter.h"
+#include "halley/utils/algorithm.h"
+
+using namespace Halley;
+
+SpriteSpatialIndex::SpriteSpatialIndex(float cellSize)
+	: cellSize(cellSize)
+{
+	Expects(cellSize > 0);
+}
+
+SpriteSpatialIndex::Handle SpriteSpatialIndex::add(Sprite sprite, int mask, int layer, float tieBreaker)
+{
+	Handle handle;
+	if (freeHandles.empty()) {
+		handle = static_cast<Handle>(entries.size());
+		entries.emplace_back();
+	} else {
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+	}
+
+	auto& entry = entries[handle];
+	entry.sprite = std::move(sprite);
+	entry.bounds = entry.sprite.getAABB();
+	entry.mask = mask;
+	entry.layer = layer;
+	entry.tieBreaker = tieBreaker;
+	entry.alive = true;
+	insertIntoCells(handle);
+
+	return handle;
+}
+
+void SpriteSpatialIndex::remove(Handle handle)
+{
+	auto& entry = entries.at(handle);
+	Expects(entry.alive);
+
+	removeFromCells(handle);
+	entry.sprite = Sprite();
+	entry.alive = false;
+	freeHandles.push_back(handle);
+}
+
+void SpriteSpatialIndex::clear()
+{
+	entries.clear();
+	freeHandles.clear();
+	grid = {};
+	usedCells.reset();
+}
+
+void SpriteSpatialIndex::update(Handle handle, Sprite sprite)
+{
+	auto& entry = entries.at(handle);
+	Expects(entry.alive);
+
+	entry.sprite = std::move(sprite);
+	entry.bounds = entry.sprite.getAABB();
+
+	if (getCell(entry.bounds.getTopLeft()) != entry.cellMin || getCell(entry.bounds.getBottomRight()) != entry.cellMax) {
+		removeFromCells(handle);
+		insertIntoCells(handle);
+	}
+}
+
+const Sprite& SpriteSpatialIndex::getSprite(Handle handle) const
+{
+	return entries.at(handle).sprite;
+}
+
+size_t SpriteSpatialIndex::size() const
+{
+	return entries.size() - freeHandles.size();
+}
+
+void SpriteSpatialIndex::query(Rect4f area, Vector<Handle>& result)
+{
+	result.clear();
+	if (!usedCells) {
+		return;
+	}
+
+	// Only look at cells that were ever used, so querying far away doesn't grow the grid
+	const auto cellMin = Vector2i::max(getCell(area.getTopLeft()), usedCells->first);
+	const auto cellMax = Vector2i::min(getCell(area.getBottomRight()), usedCells->second);
+
+	// Sprites spanning several cells are only checked once
+	++curQuery;
+	for (int y = cellMin.y; y <= cellMax.y; ++y) {
+		for (int x = cellMin.x; x <= cellMax.x; ++x) {
+			for (const auto handle: grid.get(x, y)) {
+				auto& entry = entries[handle];
+				if (entry.lastQuery != curQuery) {
+					entry.lastQuery = curQuery;
+					if (entry.bounds.overlaps(area)) {
+						result.push_back(handle);
+					}
+				}
+			}
+		}
+	}
+
+	// Keeps the order sprites are submitted in stable, regardless of where they are
+	std::sort(result.begin(), result.end());
+}
+
+void SpriteSpatialIndex::submit(SpritePainter& painter, Rect4f view)
+{
+	query(view, queryResults);
+
+	for (const auto handle: queryResults) {
+		const auto& entry = entries[handle];
+		painter.add(entry.sprite, entry.mask, entry.layer, entry.tieBreaker);
+	}
+
+	stats.submitted += queryResults.size();
+	stats.culled += size() - queryResults.size();
+}
+
+const SpriteSpatialIndex::Stats& SpriteSpatialIndex::getStats() const
+{
+	return stats;
+}
+
+void SpriteSpatialIndex::resetStats()
+{
+	stats = {};
+}
+
+Vector2i SpriteSpatialIndex::getCell(Vector2f pos) const
+{
+	return Vector2i((pos / cellSize).floor());
+}
+
+void SpriteSpatialIndex::insertIntoCells(Handle handle)
+{
+	auto& entry = entries[handle];
+	entry.cellMin = getCell(entry.bounds.getTopLeft());
+	entry.cellMax = getCell(entry.bounds.getBottomRight());
+
+	for (int y = entry.cellMin.y; y <= entry.cellMax.y; ++y) {
+		for (int x = entry.cellMin.x; x <= entry.cellMax.x; ++x) {
+			grid.get(x, y).push_back(handle);
+		}
+	}
+
+	if (usedCells) {
+		usedCells = std::pair(Vector2i::min(usedCells->first, entry.cellMin), Vector2i::max(usedCells->second, entry.cellMax));
+	} else {
+		usedCells = std::pair(entry.cellMin, entry.cellMax);
+	}
+}
+
+void SpriteSpatialIndex::removeFromCells(Handle handle)
+{
+	const auto& entry = entries[handle];
+	for (int y = entry.cellMin.y; y <= entry.cellMax.y; ++y) {
+		for (int x = entry.cellMin.x; x <= entry.cellMax.x; ++x) {
+			auto& cell = grid.get(x, y);
+			const auto iter = std::find(cell.begin(), cell.end(), handle);
+			if (iter != cell.end()) {
+				*iter = cell.back();
+				cell.pop_back();
+			}
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#include "halley/graphics/streaming_buffer.h"
+#include "halley/utils/utils.h"
+
+using namespace Halley;
+
+StreamingBuffer::StreamingBuffer(gsl::span<char> memory, size_t numRegions)
+	: memory(memory)
+	, regionSize(alignDown(memory.size() / std::max(numRegions, size_t(1)), alignment))
+	, numRegions(std::max(numRegions, size_t(1)))
+	, curRegion(this->numRegions - 1)
+{
+	Expects(reinterpret_cast<size_t>(memory.data()) % alignment == 0);
+}
+
+size_t StreamingBuffer::startFrame()
+{
+	curRegion = (curRegion + 1) % numRegions;
+	pos = curRegion * regionSize;
+	end = pos + regionSize;
+	return curRegion;
+}
+
+size_t StreamingBuffer::getCurrentRegion() const
+{
+	return curRegion;
+}
+
+gsl::span<char> StreamingBuffer::getFreeSpace() const
+{
+	return memory.subspan(pos, end - pos);
+}
+
+void StreamingBuffer::commit(size_t bytes)
+{
+	Expects(pos + bytes <= end);
+	pos = std::min(alignUp(pos + bytes, alignment), end);
+}
+
+bool StreamingBuffer::contains(const void* data) const
+{
+	const auto* p = static_cast<const char*>(data);
+	return p >= memory.data() && p < memory.data() + memory.size();
+}
+
+size_t StreamingBuffer::getOffset(const void* data) const
+{
+	Expects(contains(data));
+	return static_cast<size_t>(static_cast<const char*>(data) - memory.data());
+}
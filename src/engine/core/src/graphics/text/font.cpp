@@ -10,26 +10,34 @@
 
 using namespace Halley;
 
+namespace {
+	// Biased so that keys sort the same way as the signed charcodes
+	uint64_t getKerningKey(int32_t left, int32_t right)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(left) ^ 0x80000000u) << 32) | (static_cast<uint32_t>(right) ^ 0x80000000u);
+	}
+
+	int32_t getKerningLeft(uint64_t key)
+	{
+		return static_cast<int32_t>(static_cast<uint32_t>(key >> 32) ^ 0x80000000u);
+	}
+
+	int32_t getKerningRight(uint64_t key)
+	{
+		return static_cast<int32_t>(static_cast<uint32_t>(key) ^ 0x80000000u);
+	}
+}
+
 Font::Glyph::Glyph() {}
 
-Font::Glyph::Glyph(int charcode, Rect4f area, Vector2f size, Vector2f horizontalBearing, Vector2f verticalBearing, Vector2f advance, HashMap<int32_t, Vector2f> kerning)
+Font::Glyph::Glyph(int charcode, Rect4f area, Vector2f size, Vector2f horizontalBearing, Vector2f verticalBearing, Vector2f advance)
 	: charcode(charcode)
 	, area(area)
 	, size(size)
 	, horizontalBearing(horizontalBearing)
 	, verticalBearing(verticalBearing)
 	, advance(advance)
-	, kerning(std::move(kerning))
-{
-}
-
-Vector2f Font::Glyph::getKerning(int32_t charcode) const
 {
-	const auto iter = kerning.find(charcode);
-	if (iter != kerning.end()) {
-		return iter->second;
-	}
-	return Vector2f();
 }
 
 void Font::Glyph::serialize(Serializer& s) const
@@ -39,7 +47,6 @@ void Font::Glyph::serialize(Serializer& s) const
 	s << horizontalBearing;
 	s << verticalBearing;
 	s << advance;
-	s << kerning;
 }
 
 void Font::Glyph::deserialize(Deserializer& s)
@@ -49,7 +56,11 @@ void Font::Glyph::deserialize(Deserializer& s)
 	s >> horizontalBearing;
 	s >> verticalBearing;
 	s >> advance;
-	s >> kerning;
+}
+
+Font::Font()
+{
+	updateIndices();
 }
 
 Font::Font(String name, String imageName, float ascender, float height, float sizePt, float renderScale, Vector2i imageSize)
@@ -64,6 +75,7 @@ Font::Font(String name, String imageName, float ascender, float height, float si
 	, distanceField(false)
 	, floorGlyphPosition(false)
 {
+	updateIndices();
 }
 
 Font::Font(String name, String imageName, float ascender, float height, float sizePt, float renderScale, Vector2i imageSize, float distanceFieldSmoothRadius, Vector<String> fallback, bool floorGlyphPosition)
@@ -79,6 +91,7 @@ Font::Font(String name, String imageName, float ascender, float height, float si
 	, fallback(std::move(fallback))
 	, floorGlyphPosition(floorGlyphPosition)
 {
+	updateIndices();
 }
 
 std::unique_ptr<Font> Font::loadResource(ResourceLoader& loader)
@@ -114,34 +127,62 @@ void Font::onLoaded(Resources& resources)
 
 std::pair<const Font::Glyph&, const Font&> Font::getGlyph(int code) const
 {
-	const auto& font = getFontForGlyph(code);
-	return { font.getGlyphHere(code), font };
+	if (const auto* glyph = tryGetGlyphHere(code)) {
+		return { *glyph, *this };
+	}
+	for (const auto& font: fallbackFont) {
+		if (const auto* glyph = font->tryGetGlyphHere(code)) {
+			return { *glyph, *font };
+		}
+	}
+	return { getGlyphHere(code), *this };
 }
 
 const Font::Glyph& Font::getGlyphHere(int code) const
 {
-	auto iter = glyphs.find(code);
-	if (iter == glyphs.end()) {
-		iter = glyphs.find(0);
-		if (iter == glyphs.end()) {
-			throw Exception("Unable to load fallback character, needed for character " + toString(code), HalleyExceptions::Graphics);
-		}
-		return iter->second;
+	if (const auto* glyph = tryGetGlyphHere(code)) {
+		return *glyph;
+	}
+	if (const auto* glyph = tryGetGlyphHere(0)) {
+		return *glyph;
+	}
+	throw Exception("Unable to load fallback character, needed for character " + toString(code), HalleyExceptions::Graphics);
+}
+
+const Font::Glyph* Font::tryGetGlyphHere(int code) const
+{
+	assert(indicesValid);
+	if (code >= 0 && code < static_cast<int>(latin1Size)) {
+		const auto idx = latin1Glyphs[code];
+		return idx != noGlyph ? &glyphs[idx] : nullptr;
 	}
-	return iter->second;
+
+	const auto iter = std::lower_bound(glyphs.begin(), glyphs.end(), code, [] (const Glyph& g, int c) { return g.charcode < c; });
+	return iter != glyphs.end() && iter->charcode == code ? &*iter : nullptr;
 }
 
 const Font& Font::getFontForGlyph(int code) const
 {
-	const auto iter = glyphs.find(code);
-	if (iter == glyphs.end()) {
-		for (const auto& font: fallbackFont) {
-			if (font->glyphs.find(code) != font->glyphs.end()) {
-				return *font;
-			}
-		}
+	return getGlyph(code).second;
+}
+
+Vector2f Font::getKerning(int32_t left, int32_t right) const
+{
+	const auto* glyph = tryGetGlyphHere(left);
+	return glyph ? getKerning(*glyph, right) : Vector2f();
+}
+
+Vector2f Font::getKerning(const Glyph& left, int32_t right) const
+{
+	if (left.kerningCount == 0) {
+		return Vector2f();
 	}
-	return *this;
+
+	const auto key = getKerningKey(left.charcode, right);
+	const auto begin = kerningPairs.begin() + left.kerningStart;
+	const auto end = begin + left.kerningCount;
+	const auto iter = std::lower_bound(begin, end, key, [] (const KerningPair& p, uint64_t k) { return p.key < k; });
+	return iter != end && iter->key == key ? iter->kerning : Vector2f();
 }
 
 float Font::getLineHeightAtSize(float size) const
@@ -194,9 +235,58 @@ bool Font::shouldFloorGlyphPosition() const
 	return floorGlyphPosition;	
 }
 
-void Font::addGlyph(const Glyph& glyph)
+void Font::addGlyph(const Glyph& glyph, const HashMap<int32_t, Vector2f>& kerning)
+{
+	const auto iter = std::lower_bound(glyphs.begin(), glyphs.end(), glyph.charcode, [] (const Glyph& g, int c) { return g.charcode < c; });
+	if (iter != glyphs.end() && iter->charcode == glyph.charcode) {
+		*iter = glyph;
+	} else {
+		glyphs.insert(iter, glyph);
+	}
+
+	const auto first = getKerningKey(glyph.charcode, std::numeric_limits<int32_t>::min());
+	const auto start = std::lower_bound(kerningPairs.begin(), kerningPairs.end(), first, [] (const KerningPair& p, uint64_t k) { return p.key < k; });
+	const auto end = std::find_if(start, kerningPairs.end(), [&] (const KerningPair& p) { return getKerningLeft(p.key) != glyph.charcode; });
+	const auto pos = kerningPairs.erase(start, end) - kerningPairs.begin();
+
+	Vector<KerningPair> pairs;
+	pairs.reserve(kerning.size());
+	for (const auto& [right, value]: kerning) {
+		pairs.push_back(KerningPair{ getKerningKey(glyph.charcode, right), value });
+	}
+	std::sort(pairs.begin(), pairs.end(), [] (const KerningPair& a, const KerningPair& b) { return a.key < b.key; });
+	kerningPairs.insert(kerningPairs.begin() + pos, pairs.begin(), pairs.end());
+
+	// Rebuilding them is a pass over every glyph, so it's left for finishAddingGlyphs
+	indicesValid = false;
+}
+
+void Font::finishAddingGlyphs()
+{
+	updateIndices();
+}
+
+void Font::updateIndices()
 {
-	glyphs[glyph.charcode] = glyph;
+	indicesValid = true;
+	latin1Glyphs.fill(noGlyph);
+
+	size_t kerningIdx = 0;
+	for (size_t i = 0; i < glyphs.size(); ++i) {
+		auto& glyph = glyphs[i];
+		if (glyph.charcode >= 0 && glyph.charcode < static_cast<int32_t>(latin1Size)) {
+			latin1Glyphs[glyph.charcode] = static_cast<uint32_t>(i);
+		}
+
+		while (kerningIdx < kerningPairs.size() && getKerningLeft(kerningPairs[kerningIdx].key) < glyph.charcode) {
+			++kerningIdx;
+		}
+		glyph.kerningStart = static_cast<uint32_t>(kerningIdx);
+		while (kerningIdx < kerningPairs.size() && getKerningLeft(kerningPairs[kerningIdx].key) == glyph.charcode) {
+			++kerningIdx;
+		}
+		glyph.kerningCount = static_cast<uint32_t>(kerningIdx - glyph.kerningStart);
+	}
 }
 
 std::shared_ptr<Material> Font::getMaterial() const
@@ -204,6 +294,11 @@ std::shared_ptr<Material> Font::getMaterial() const
 	return material;
 }
 
+void Font::setMaterial(std::shared_ptr<Material> material)
+{
+	this->material = std::move(material);
+}
+
 void Font::serialize(Serializer& s) const
 {
 	s << name;
@@ -215,7 +310,21 @@ void Font::serialize(Serializer& s) const
 	s << smoothRadius;
 	s << imageSize;
 	s << replacementScale;
-	s << glyphs;
+
+	// Same layout as a HashMap of glyphs, each followed by its own HashMap of kerning, so existing assets still load
+	Expects(indicesValid);
+	s << static_cast<uint32_t>(glyphs.size());
+	for (const auto& glyph: glyphs) {
+		s << glyph.charcode;
+		s << glyph;
+		s << glyph.kerningCount;
+		for (uint32_t i = 0; i < glyph.kerningCount; ++i) {
+			const auto& pair = kerningPairs[glyph.kerningStart + i];
+			s << getKerningRight(pair.key);
+			s << pair.kerning;
+		}
+	}
+
 	s << fallback;
 	s << floorGlyphPosition;
 }
@@ -231,14 +340,36 @@ void Font::deserialize(Deserializer& s)
 	s >> smoothRadius;
 	s >> imageSize;
 	s >> replacementScale;
-	s >> glyphs;
-	s >> fallback;
-	s >> floorGlyphPosition;
 
-	for (auto& g: glyphs) {
-		g.second.charcode = g.first;
+	uint32_t nGlyphs;
+	s >> nGlyphs;
+	glyphs.clear();
+	glyphs.reserve(nGlyphs);
+	kerningPairs.clear();
+	for (uint32_t i = 0; i < nGlyphs; ++i) {
+		auto& glyph = glyphs.emplace_back();
+		s >> glyph.charcode;
+		s >> glyph;
+
+		uint32_t nKerning;
+		s >> nKerning;
+		for (uint32_t j = 0; j < nKerning; ++j) {
+			int32_t right;
+			Vector2f kerning;
+			s >> right;
+			s >> kerning;
+			kerningPairs.push_back(KerningPair{ getKerningKey(glyph.charcode, right), kerning });
+		}
 	}
 
+	// HashMap serialization already writes keys in order, but don't depend on it
+	std::sort(glyphs.begin(), glyphs.end(), [] (const Glyph& a, const Glyph& b) { return a.charcode < b.charcode; });
+	std::sort(kerningPairs.begin(), kerningPairs.end(), [] (const KerningPair& a, const KerningPair& b) { return a.key < b.key; });
+	updateIndices();
+
+	s >> fallback;
+	s >> floorGlyphPosition;
+
 	//printGlyphs();
 }
 
@@ -247,7 +378,7 @@ void Font::printGlyphs() const
 	std::optional<Range<int>> curRange;
 	Vector<Range<int>> ranges;
 	for (auto& g: glyphs) {
-		int c = g.first;
+		int c = g.charcode;
 		if (curRange && curRange->end == c - 1) {
 			curRange->end = c;
 		} else {
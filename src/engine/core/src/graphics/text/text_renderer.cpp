@@ -338,6 +338,13 @@ void TextRenderer::generateLayout(const StringUTF32& text, Vector<GlyphLayout>*
 	auto curFont = TextOverrideCursor(font, fontOverrides);
 	auto curFontSize = TextOverrideCursor(size, fontSizeOverrides);
 
+	// Only changes with the font or size, which is rarely per character
+	const Font* metricsFont = nullptr;
+	float metricsSize = 0;
+	float curScale = 1;
+	float glyphLineHeight = 0;
+	float glyphAscender = 0;
+
 	float minX = std::numeric_limits<float>::infinity();
 	float maxX = -std::numeric_limits<float>::infinity();
 	float height = 0;
@@ -351,9 +358,15 @@ void TextRenderer::generateLayout(const StringUTF32& text, Vector<GlyphLayout>*
 		curFontSize.setPos(i);
 		
 		const auto& [glyph, fontForGlyph] = curFont->getGlyph(c);
-		const float curScale = getScale(fontForGlyph, *curFontSize);
+		if (&fontForGlyph != metricsFont || *curFontSize != metricsSize) {
+			metricsFont = &fontForGlyph;
+			metricsSize = *curFontSize;
+			curScale = getScale(fontForGlyph, metricsSize);
+			glyphLineHeight = getLineHeight(fontForGlyph, metricsSize);
+			glyphAscender = fontForGlyph.getAscenderDistance() * curScale;
+		}
 
-		const Vector2f kerning = lastGlyph && lastFont == &fontForGlyph ? lastGlyph->getKerning(c) : Vector2f();
+		const Vector2f kerning = lastGlyph && lastFont == &fontForGlyph ? fontForGlyph.getKerning(*lastGlyph, c) : Vector2f();
 		const Vector2f cursorPos = lineStartPos + curLineOffset + pixelOffset;
 		const Vector2f glyphPos = cursorPos + (kerning + glyph.horizontalBearing.flipVertical()) * curScale;
 		const float advance = (glyph.advance.x + kerning.x) * curScale;
@@ -367,8 +380,8 @@ void TextRenderer::generateLayout(const StringUTF32& text, Vector<GlyphLayout>*
 		}
 
 		curLineOffset.x += advance;
-		curLineHeight = std::max(curLineHeight, getLineHeight(fontForGlyph, *curFontSize));
-		curAscender = std::max(curAscender, fontForGlyph.getAscenderDistance() * curScale);
+		curLineHeight = std::max(curLineHeight, glyphLineHeight);
+		curAscender = std::max(curAscender, glyphAscender);
 
 		if (c != ' ' && c != '\n') {
 			minX = std::min(minX, glyphPos.x);
@@ -615,7 +628,7 @@ StringUTF32 TextRenderer::split(const StringUTF32& str, float maxWidth, std::fun
 
 			const auto& [glyph, f] = curFont->getGlyph(c);
 			const float scale = getScale(f, *curFontSize);
-			const auto kerning = lastFont == &f && lastGlyph ? lastGlyph->getKerning(c) : Vector2f();
+			const auto kerning = lastFont == &f && lastGlyph ? f.getKerning(*lastGlyph, c) : Vector2f();
 			const float w = accepted ? (glyph.advance.x + kerning.x) * scale : 0.0f;
 			curWidth += w;
 
@@ -730,6 +743,11 @@ bool TextRenderer::isCompatibleWith(const TextRenderer& other) const
 	return getMaterial(*font)->isCompatibleWith(*other.getMaterial(*other.font));
 }
 
+uint64_t TextRenderer::getSortKey() const
+{
+	return font ? getMaterial(*font)->getSortKey() : 0;
+}
+
 float TextRenderer::getScale(const Font& font) const
 {
 	return getScale(font, size);
@@ -1,6 +1,7 @@
 #include "halley/graphics/texture.h"
 #include "halley/api/halley_api.h"
 #include "halley/graphics/texture_descriptor.h"
+#include "halley/graphics/texture_streamer.h"
 #include <halley/file_formats/image.h>
 #include <halley/resources/metadata.h>
 #include "halley/concurrency/concurrent.h"
@@ -37,6 +38,21 @@ void Texture::load(TextureDescriptor desc)
 	}
 }
 
+void Texture::updateRegion(const Image& image, Rect4i area)
+{
+	if (image.getSize() != getSize() || image.getFormat() != Image::Format::RGBA || descriptor.format != TextureFormat::RGBA) {
+		throw Exception("Texture region can only be updated from an RGBA image of the same size.", HalleyExceptions::Graphics);
+	}
+	if (!descriptor.canBeUpdated) {
+		throw Exception("Texture \"" + getAssetId() + "\" wasn't loaded with canBeUpdated set.", HalleyExceptions::Graphics);
+	}
+
+	area = area.intersection(Rect4i(Vector2i(), getSize()));
+	if (area.getWidth() > 0 && area.getHeight() > 0) {
+		doUpdateRegion(image, area);
+	}
+}
+
 void Texture::copyToTexture(Painter& painter, Texture& other) const
 {
 	if (getSize() != other.getSize()) {
@@ -85,6 +101,21 @@ void Texture::doLoad(TextureDescriptor& descriptor)
 {
 }
 
+void Texture::doUpdateRegion(const Image& image, Rect4i area)
+{
+	// No partial uploads, so the whole image goes in again
+	TextureDescriptor desc(getSize(), descriptor.format);
+	desc.addressMode = descriptor.addressMode;
+	desc.useMipMap = descriptor.useMipMap;
+	desc.useFiltering = descriptor.useFiltering;
+	desc.canBeUpdated = true;
+	auto copy = std::make_unique<Image>(Image::Format::RGBA, image.getSize(), false);
+	copy->blitFrom(Vector2i(), image);
+	desc.pixelData = std::move(copy);
+	startLoading();
+	load(std::move(desc));
+}
+
 void Texture::doCopyToTexture(Painter& painter, Texture& other) const
 {
 	Logger::logWarning("Copying to texture not implemented.");
@@ -121,6 +152,7 @@ std::shared_ptr<Texture> Texture::loadResource(ResourceLoader& loader)
 	texture->setAssetId(loader.getName());
 	texture->setMeta(meta);
 	bool retain = loader.getResources().getOptions().retainPixelData;
+	auto* streamer = loader.getResources().getTextureStreamer();
 
 	loader.getAsync(true)
 	.then([texture](std::unique_ptr<ResourceDataStatic> data) -> std::pair<TextureDescriptorImageData, ImageMask>
@@ -148,7 +180,7 @@ std::shared_ptr<Texture> Texture::loadResource(ResourceLoader& loader)
 			return { TextureDescriptorImageData(imageData), std::move(alphaMask) };
 		}
 	})
-	.then(Executors::getVideoAux(), [texture, retain](std::pair<TextureDescriptorImageData, ImageMask> imgPair)
+	.then(Executors::getVideoAux(), [texture, retain, streamer](std::pair<TextureDescriptorImageData, ImageMask> imgPair)
 	{
 		auto& img = imgPair.first;
 		auto& alphaMask = imgPair.second;
@@ -176,16 +208,26 @@ std::shared_ptr<Texture> Texture::loadResource(ResourceLoader& loader)
 
 		const auto& compression = meta.getString("compression");
 		Vector2i size(meta.getInt("width"), meta.getInt("height"));
+
+		// Block compressed data is uploaded as is, with its mips already in it
+		if (compression == "block") {
+			format = fromString<TextureFormat>(meta.getString("textureFormat"));
+		}
 		
 		TextureDescriptor descriptor(size);
 		descriptor.useFiltering = meta.getBool("filtering", false);
 		descriptor.useMipMap = meta.getBool("mipmap", false);
+		descriptor.mipLevels = meta.getInt("mipLevels", 1);
 		descriptor.addressMode = fromString<TextureAddressMode>(meta.getString("addressMode", "clamp"));
 		descriptor.format = format;
 		descriptor.pixelData = std::move(img);
 		descriptor.pixelFormat = compression == "png" || compression == "qoi" || compression == "hlif" ? PixelDataFormat::Image : PixelDataFormat::Precompiled;
 		descriptor.retainPixelData = retain;
-		texture->load(std::move(descriptor));
+		if (streamer && TextureStreamer::canStream(descriptor)) {
+			streamer->add(texture, std::move(descriptor));
+		} else {
+			texture->load(std::move(descriptor));
+		}
 		texture->setAlphaMask(std::move(alphaMask));
 	});
 
@@ -197,6 +239,13 @@ void Texture::setAlphaMask(ImageMask mask)
 	this->mask = std::move(mask);
 }
 
+void Texture::replaceWith(Texture&& other)
+{
+	auto alphaMask = std::move(mask);
+	reload(std::move(other));
+	mask = std::move(alphaMask);
+}
+
 bool Texture::hasOpaquePixels(Rect4i pixelBounds) const
 {
 	if (mask.getSize() != Vector2i()) {
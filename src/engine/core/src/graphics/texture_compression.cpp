@@ -0,0 +1,408 @@
+#include "halley/graphics/texture_compression.h"
+#include "halley/file_formats/image.h"
+#include "halley/support/exception.h"
+
+using namespace Halley;
+
+namespace {
+	using BlockPixels = std::array<std::array<int, 4>, 16>;
+
+	BlockPixels readBlock(const Image& image, int bx, int by)
+	{
+		// Blocks hanging off the edge repeat the last row/column
+		const auto size = image.getSize();
+		const auto src = image.getPixels4BPP();
+		BlockPixels result;
+		for (int i = 0; i < 16; ++i) {
+			const int x = std::min(bx * 4 + (i % 4), size.x - 1);
+			const int y = std::min(by * 4 + (i / 4), size.y - 1);
+			unsigned int r, g, b, a;
+			Image::convertIntToRGBA(src[y * size.x + x], r, g, b, a);
+			result[i] = { int(r), int(g), int(b), int(a) };
+		}
+		return result;
+	}
+
+	uint16_t packRGB565(const std::array<int, 4>& c)
+	{
+		const int r = (c[0] * 31 + 127) / 255;
+		const int g = (c[1] * 63 + 127) / 255;
+		const int b = (c[2] * 31 + 127) / 255;
+		return uint16_t((r << 11) | (g << 5) | b);
+	}
+
+	std::array<int, 4> unpackRGB565(uint16_t c)
+	{
+		const int r = (c >> 11) & 31;
+		const int g = (c >> 5) & 63;
+		const int b = c & 31;
+		return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255 };
+	}
+
+	std::array<std::array<int, 4>, 4> makeColourPalette(uint16_t c0, uint16_t c1, bool fourColours)
+	{
+		const auto a = unpackRGB565(c0);
+		const auto b = unpackRGB565(c1);
+		std::array<std::array<int, 4>, 4> result;
+		result[0] = a;
+		result[1] = b;
+		for (int ch = 0; ch < 3; ++ch) {
+			if (fourColours) {
+				result[2][ch] = (2 * a[ch] + b[ch]) / 3;
+				result[3][ch] = (a[ch] + 2 * b[ch]) / 3;
+			} else {
+				result[2][ch] = (a[ch] + b[ch]) / 2;
+				result[3][ch] = 0;
+			}
+		}
+		result[2][3] = 255;
+		result[3][3] = fourColours ? 255 : 0;
+		return result;
+	}
+
+	int colourDistance(const std::array<int, 4>& a, const std::array<int, 4>& b)
+	{
+		const int dr = a[0] - b[0];
+		const int dg = a[1] - b[1];
+		const int db = a[2] - b[2];
+		return dr * dr + dg * dg + db * db;
+	}
+
+	void findEndpoints(const BlockPixels& px, const std::array<bool, 16>& used, std::array<int, 4>& minCol, std::array<int, 4>& maxCol)
+	{
+		// Principal axis of the colours, through the mean
+		float mean[3] = { 0, 0, 0 };
+		int n = 0;
+		for (int i = 0; i < 16; ++i) {
+			if (used[i]) {
+				for (int ch = 0; ch < 3; ++ch) {
+					mean[ch] += float(px[i][ch]);
+				}
+				++n;
+			}
+		}
+		for (auto& m: mean) {
+			m /= float(n);
+		}
+
+		float cov[6] = { 0, 0, 0, 0, 0, 0 };
+		for (int i = 0; i < 16; ++i) {
+			if (used[i]) {
+				const float r = float(px[i][0]) - mean[0];
+				const float g = float(px[i][1]) - mean[1];
+				const float b = float(px[i][2]) - mean[2];
+				cov[0] += r * r;
+				cov[1] += r * g;
+				cov[2] += r * b;
+				cov[3] += g * g;
+				cov[4] += g * b;
+				cov[5] += b * b;
+			}
+		}
+
+		float axis[3] = { 1, 1, 1 };
+		for (int iter = 0; iter < 8; ++iter) {
+			const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+			const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+			const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+			const float len = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+			if (len < 0.0001f) {
+				break;
+			}
+			axis[0] = x / len;
+			axis[1] = y / len;
+			axis[2] = z / len;
+		}
+
+		float minProj = std::numeric_limits<float>::max();
+		float maxProj = std::numeric_limits<float>::lowest();
+		for (int i = 0; i < 16; ++i) {
+			if (used[i]) {
+				const float proj = float(px[i][0]) * axis[0] + float(px[i][1]) * axis[1] + float(px[i][2]) * axis[2];
+				if (proj < minProj) {
+					minProj = proj;
+					minCol = px[i];
+				}
+				if (proj > maxProj) {
+					maxProj = proj;
+					maxCol = px[i];
+				}
+			}
+		}
+	}
+
+	void encodeColourBlock(const BlockPixels& px, bool allowTransparency, gsl::span<gsl::byte> dst)
+	{
+		std::array<bool, 16> used;
+		bool anyTransparent = false;
+		bool anyOpaque = false;
+		for (int i = 0; i < 16; ++i) {
+			used[i] = !allowTransparency || px[i][3] >= 128;
+			anyTransparent = anyTransparent || !used[i];
+			anyOpaque = anyOpaque || used[i];
+		}
+
+		uint16_t c0 = 0;
+		uint16_t c1 = 0;
+		uint32_t indices = 0;
+
+		if (!anyOpaque) {
+			indices = 0xFFFFFFFF;
+		} else {
+			std::array<int, 4> minCol;
+			std::array<int, 4> maxCol;
+			findEndpoints(px, used, minCol, maxCol);
+			c0 = packRGB565(maxCol);
+			c1 = packRGB565(minCol);
+
+			// c0 > c1 selects four colours, c0 <= c1 three colours plus transparent
+			const bool fourColours = !anyTransparent;
+			if (fourColours ? c0 < c1 : c0 > c1) {
+				std::swap(c0, c1);
+			}
+
+			if (c0 != c1 || anyTransparent) {
+				const auto palette = makeColourPalette(c0, c1, fourColours);
+				for (int i = 0; i < 16; ++i) {
+					uint32_t best = 3;
+					if (used[i]) {
+						int bestDist = std::numeric_limits<int>::max();
+						for (uint32_t j = 0; j < (fourColours ? 4u : 3u); ++j) {
+							const int dist = colourDistance(px[i], palette[j]);
+							if (dist < bestDist) {
+								bestDist = dist;
+								best = j;
+							}
+						}
+					}
+					indices |= best << (2 * i);
+				}
+			}
+		}
+
+		auto* out = reinterpret_cast<uint8_t*>(dst.data());
+		out[0] = uint8_t(c0 & 0xFF);
+		out[1] = uint8_t(c0 >> 8);
+		out[2] = uint8_t(c1 & 0xFF);
+		out[3] = uint8_t(c1 >> 8);
+		for (int i = 0; i < 4; ++i) {
+			out[4 + i] = uint8_t((indices >> (8 * i)) & 0xFF);
+		}
+	}
+
+	void encodeAlphaBlock(const BlockPixels& px, gsl::span<gsl::byte> dst)
+	{
+		int a0 = 0;
+		int a1 = 255;
+		for (const auto& p: px) {
+			a0 = std::max(a0, p[3]);
+			a1 = std::min(a1, p[3]);
+		}
+
+		uint64_t indices = 0;
+		if (a0 != a1) {
+			// a0 > a1 selects eight interpolated values
+			std::array<int, 8> palette = { a0, a1 };
+			for (int j = 1; j < 7; ++j) {
+				palette[j + 1] = ((7 - j) * a0 + j * a1) / 7;
+			}
+			for (int i = 0; i < 16; ++i) {
+				uint64_t best = 0;
+				int bestDist = std::numeric_limits<int>::max();
+				for (uint64_t j = 0; j < 8; ++j) {
+					const int dist = std::abs(px[i][3] - palette[j]);
+					if (dist < bestDist) {
+						bestDist = dist;
+						best = j;
+					}
+				}
+				indices |= best << (3 * i);
+			}
+		}
+
+		auto* out = reinterpret_cast<uint8_t*>(dst.data());
+		out[0] = uint8_t(a0);
+		out[1] = uint8_t(a1);
+		for (int i = 0; i < 6; ++i) {
+			out[2 + i] = uint8_t((indices >> (8 * i)) & 0xFF);
+		}
+	}
+
+	void compressLevel(const Image& image, TextureFormat format, gsl::span<gsl::byte> dst)
+	{
+		const auto size = image.getSize();
+		const int blocksX = (size.x + 3) / 4;
+		const int blocksY = (size.y + 3) / 4;
+		const auto blockSize = TextureDescriptor::getBlockByteSize(format);
+
+		for (int by = 0; by < blocksY; ++by) {
+			for (int bx = 0; bx < blocksX; ++bx) {
+				const auto px = readBlock(image, bx, by);
+				auto block = dst.subspan((by * blocksX + bx) * blockSize, blockSize);
+				if (format == TextureFormat::BC1) {
+					encodeColourBlock(px, true, block);
+				} else {
+					encodeAlphaBlock(px, block.subspan(0, 8));
+					encodeColourBlock(px, false, block.subspan(8, 8));
+				}
+			}
+		}
+	}
+
+	void decompressBlock(gsl::span<const gsl::byte> src, TextureFormat format, std::array<std::array<int, 4>, 16>& px)
+	{
+		const auto* in = reinterpret_cast<const uint8_t*>(src.data());
+
+		const auto* colour = format == TextureFormat::BC1 ? in : in + 8;
+		const uint16_t c0 = uint16_t(colour[0] | (colour[1] << 8));
+		const uint16_t c1 = uint16_t(colour[2] | (colour[3] << 8));
+		const uint32_t indices = uint32_t(colour[4]) | (uint32_t(colour[5]) << 8) | (uint32_t(colour[6]) << 16) | (uint32_t(colour[7]) << 24);
+		const auto palette = makeColourPalette(c0, c1, format != TextureFormat::BC1 || c0 > c1);
+		for (int i = 0; i < 16; ++i) {
+			px[i] = palette[(indices >> (2 * i)) & 3];
+		}
+
+		if (format == TextureFormat::BC3) {
+			const int a0 = in[0];
+			const int a1 = in[1];
+			std::array<int, 8> alphas = { a0, a1 };
+			if (a0 > a1) {
+				for (int j = 1; j < 7; ++j) {
+					alphas[j + 1] = ((7 - j) * a0 + j * a1) / 7;
+				}
+			} else {
+				for (int j = 1; j < 5; ++j) {
+					alphas[j + 1] = ((5 - j) * a0 + j * a1) / 5;
+				}
+				alphas[6] = 0;
+				alphas[7] = 255;
+			}
+
+			uint64_t alphaIndices = 0;
+			for (int i = 0; i < 6; ++i) {
+				alphaIndices |= uint64_t(in[2 + i]) << (8 * i);
+			}
+			for (int i = 0; i < 16; ++i) {
+				px[i][3] = alphas[(alphaIndices >> (3 * i)) & 7];
+			}
+		}
+	}
+}
+
+Bytes TextureCompression::compress(const Image& image, TextureFormat format, int mipLevels)
+{
+	if (image.getFormat() != Image::Format::RGBA && image.getFormat() != Image::Format::RGBAPremultiplied) {
+		throw Exception("Only RGBA images can be block compressed.", HalleyExceptions::Graphics);
+	}
+	if (!TextureDescriptor::isBlockCompressed(format)) {
+		throw Exception("Not a block compressed format: " + toString(format), HalleyExceptions::Graphics);
+	}
+	mipLevels = clamp(mipLevels, 1, getMaxMipLevels(image.getSize()));
+
+	Bytes result(getMipChainByteSize(format, image.getSize(), mipLevels));
+	auto dst = gsl::as_writable_bytes(gsl::span<Byte>(result));
+
+	const Image* level = &image;
+	std::unique_ptr<Image> downsampled;
+	for (int i = 0; i < mipLevels; ++i) {
+		if (i > 0) {
+			downsampled = downsample(*level);
+			level = downsampled.get();
+		}
+		const auto levelBytes = TextureDescriptor::getByteSize(format, level->getSize());
+		compressLevel(*level, format, dst.subspan(0, levelBytes));
+		dst = dst.subspan(levelBytes);
+	}
+
+	return result;
+}
+
+std::unique_ptr<Image> TextureCompression::decompress(gsl::span<const gsl::byte> data, TextureFormat format, Vector2i size)
+{
+	if (!TextureDescriptor::isBlockCompressed(format)) {
+		throw Exception("Not a block compressed format: " + toString(format), HalleyExceptions::Graphics);
+	}
+	if (data.size_bytes() < TextureDescriptor::getByteSize(format, size)) {
+		throw Exception("Not enough data to decompress " + toString(size.x) + "x" + toString(size.y) + " " + toString(format) + " texture.", HalleyExceptions::Graphics);
+	}
+
+	auto result = std::make_unique<Image>(Image::Format::RGBA, size, false);
+	auto dst = result->getPixels4BPP();
+	const int blocksX = (size.x + 3) / 4;
+	const int blocksY = (size.y + 3) / 4;
+	const auto blockSize = TextureDescriptor::getBlockByteSize(format);
+
+	std::array<std::array<int, 4>, 16> px;
+	for (int by = 0; by < blocksY; ++by) {
+		for (int bx = 0; bx < blocksX; ++bx) {
+			decompressBlock(data.subspan((by * blocksX + bx) * blockSize, blockSize), format, px);
+			for (int i = 0; i < 16; ++i) {
+				const int x = bx * 4 + (i % 4);
+				const int y = by * 4 + (i / 4);
+				if (x < size.x && y < size.y) {
+					dst[y * size.x + x] = int(Image::convertRGBAToInt(px[i][0], px[i][1], px[i][2], px[i][3]));
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+int TextureCompression::getMaxMipLevels(Vector2i size)
+{
+	int levels = 1;
+	for (int maxSide = std::max(size.x, size.y); maxSide > 1; maxSide /= 2) {
+		++levels;
+	}
+	return levels;
+}
+
+Vector2i TextureCompression::getMipSize(Vector2i size, int level)
+{
+	return Vector2i(std::max(size.x >> level, 1), std::max(size.y >> level, 1));
+}
+
+size_t TextureCompression::getMipChainByteSize(TextureFormat format, Vector2i size, int mipLevels)
+{
+	size_t total = 0;
+	for (int i = 0; i < mipLevels; ++i) {
+		total += TextureDescriptor::getByteSize(format, getMipSize(size, i));
+	}
+	return total;
+}
+
+std::unique_ptr<Image> TextureCompression::downsample(const Image& image)
+{
+	const auto srcSize = image.getSize();
+	const auto dstSize = getMipSize(srcSize, 1);
+	auto result = std::make_unique<Image>(image.getFormat(), dstSize, false);
+
+	const auto src = image.getPixels4BPP();
+	auto dst = result->getPixels4BPP();
+	for (int y = 0; y < dstSize.y; ++y) {
+		for (int x = 0; x < dstSize.x; ++x) {
+			// Colour is weighted by alpha, so fully transparent pixels don't bleed into the edges
+			int sum[4] = { 0, 0, 0, 0 };
+			for (int i = 0; i < 4; ++i) {
+				const int sx = std::min(x * 2 + (i % 2), srcSize.x - 1);
+				const int sy = std::min(y * 2 + (i / 2), srcSize.y - 1);
+				unsigned int r, g, b, a;
+				Image::convertIntToRGBA(src[sy * srcSize.x + sx], r, g, b, a);
+				sum[0] += int(r * a);
+				sum[1] += int(g * a);
+				sum[2] += int(b * a);
+				sum[3] += int(a);
+			}
+
+			if (sum[3] == 0) {
+				dst[y * dstSize.x + x] = 0;
+			} else {
+				const auto half = sum[3] / 2;
+				dst[y * dstSize.x + x] = int(Image::convertRGBAToInt((sum[0] + half) / sum[3], (sum[1] + half) / sum[3], (sum[2] + half) / sum[3], (sum[3] + 2) / 4));
+			}
+		}
+	}
+
+	return result;
+}
@@ -138,6 +138,8 @@ TextureDescriptor& TextureDescriptor::operator=(TextureDescriptor&& other) noexc
 	format = other.format;
 	pixelFormat = other.pixelFormat;
 	pixelData = std::move(other.pixelData);
+	mipLevels = other.mipLevels;
+	firstMipLevel = other.firstMipLevel;
 	useMipMap = other.useMipMap;
 	useFiltering = other.useFiltering;
 	addressMode = other.addressMode;
@@ -156,6 +158,8 @@ int TextureDescriptor::getBytesPerPixel(TextureFormat format)
 	case TextureFormat::BGRX:
 	case TextureFormat::SRGBA:
 	case TextureFormat::Depth:
+	case TextureFormat::BC1:
+	case TextureFormat::BC3:
 		return 4;
 	case TextureFormat::RGB:
 		return 3;
@@ -171,6 +175,42 @@ int TextureDescriptor::getBytesPerPixel(TextureFormat format)
 	throw Exception("Unknown image format: " + toString(format), HalleyExceptions::Graphics);
 }
 
+bool TextureDescriptor::isBlockCompressed(TextureFormat format)
+{
+	return format == TextureFormat::BC1 || format == TextureFormat::BC3;
+}
+
+size_t TextureDescriptor::getBlockByteSize(TextureFormat format)
+{
+	switch (format) {
+	case TextureFormat::BC1:
+		return 8;
+	case TextureFormat::BC3:
+		return 16;
+	default:
+		throw Exception("Not a block compressed format: " + toString(format), HalleyExceptions::Graphics);
+	}
+}
+
+size_t TextureDescriptor::getByteSize(TextureFormat format, Vector2i size)
+{
+	if (isBlockCompressed(format)) {
+		return getRowPitch(format, size.x) * ((size.y + 3) / 4);
+	} else {
+		return getRowPitch(format, size.x) * size.y;
+	}
+}
+
+size_t TextureDescriptor::getRowPitch(TextureFormat format, int width)
+{
+	if (isBlockCompressed(format)) {
+		// One row of 4x4 blocks
+		return getBlockByteSize(format) * ((width + 3) / 4);
+	} else {
+		return size_t(getBytesPerPixel(format)) * width;
+	}
+}
+
 size_t TextureDescriptor::getMemoryUsage() const
 {
 	return pixelData.getMemoryUsage();
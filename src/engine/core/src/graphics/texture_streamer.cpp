@@ -0,0 +1,253 @@
+#include "halley/graphics/texture_streamer.h"
+#include "halley/api/video_api.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/graphics/texture.h"
+#include "halley/graphics/texture_compression.h"
+
+using namespace Halley;
+
+TextureStreamer::TextureStreamer(VideoAPI& video, size_t vramBudget, ExecutionQueue& uploadQueue, int baseSize)
+	: video(video)
+	, uploadQueue(uploadQueue)
+	, budget(vramBudget)
+	, baseSize(baseSize)
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	// Pending textures can't be destroyed mid load
+	for (auto& [k, e]: entries) {
+		if (e->pending.isValid()) {
+			e->pending.wait();
+		}
+	}
+}
+
+bool TextureStreamer::canStream(const TextureDescriptor& descriptor)
+{
+	return TextureDescriptor::isBlockCompressed(descriptor.format) && descriptor.mipLevels > 1 && descriptor.firstMipLevel == 0 && !descriptor.pixelData.empty();
+}
+
+void TextureStreamer::add(std::shared_ptr<Texture> texture, TextureDescriptor descriptor)
+{
+	Expects(texture != nullptr);
+	Expects(canStream(descriptor));
+
+	auto entry = std::make_unique<Entry>();
+	entry->texture = texture;
+	entry->data = descriptor.pixelData.moveBytes();
+	entry->size = descriptor.size;
+	entry->format = descriptor.format;
+	entry->mipLevels = descriptor.mipLevels;
+	entry->useFiltering = descriptor.useFiltering;
+	entry->addressMode = descriptor.addressMode;
+
+	int level = 0;
+	while (level < entry->mipLevels - 1) {
+		const auto mipSize = TextureCompression::getMipSize(entry->size, level);
+		if (std::max(mipSize.x, mipSize.y) <= baseSize) {
+			break;
+		}
+
+		// Any level up to the base one can become the texture's top level, which D3D11 needs to be made of whole blocks
+		const auto nextSize = TextureCompression::getMipSize(entry->size, level + 1);
+		if (nextSize.x % 4 != 0 || nextSize.y % 4 != 0) {
+			break;
+		}
+		++level;
+	}
+	entry->baseLevel = level;
+	entry->residentLevel = level;
+	entry->targetLevel = level;
+
+	texture->load(makeDescriptor(*entry, level));
+
+	std::unique_lock<std::mutex> lock(mutex);
+	entries[texture.get()] = std::move(entry);
+}
+
+void TextureStreamer::reportUsage(const Texture& texture, int mipLevel)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (entries.find(&texture) != entries.end()) {
+		const auto iter = reported.find(&texture);
+		if (iter == reported.end()) {
+			reported[&texture] = mipLevel;
+		} else {
+			iter->second = std::min(iter->second, mipLevel);
+		}
+	}
+}
+
+void TextureStreamer::update()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	for (auto iter = entries.begin(); iter != entries.end();) {
+		if (iter->second->texture.expired()) {
+			iter = entries.erase(iter);
+		} else {
+			applyFinished(*iter->second);
+			++iter;
+		}
+	}
+
+	for (const auto& [texture, level]: reported) {
+		if (const auto iter = entries.find(texture); iter != entries.end()) {
+			auto& entry = *iter->second;
+			entry.targetLevel = clamp(level, 0, entry.baseLevel);
+			entry.lastUsed = curFrame;
+		}
+	}
+	reported.clear();
+
+	// Count what's on its way too, so nothing gets requested twice over budget
+	size_t used = 0;
+	Vector<Entry*> wanted;
+	for (auto& [k, e]: entries) {
+		const auto level = e->pending.isValid() ? e->pendingLevel : e->residentLevel;
+		used += getLevelBytes(*e, level);
+		if (!e->pending.isValid() && e->lastUsed == curFrame && e->targetLevel < e->residentLevel) {
+			wanted.push_back(e.get());
+		}
+	}
+
+	// Smallest requests first, so as many textures as possible get what they asked for
+	std::sort(wanted.begin(), wanted.end(), [&] (const Entry* a, const Entry* b)
+	{
+		return getLevelBytes(*a, a->targetLevel) - getLevelBytes(*a, a->residentLevel) < getLevelBytes(*b, b->targetLevel) - getLevelBytes(*b, b->residentLevel);
+	});
+
+	for (auto* entry: wanted) {
+		const auto extra = getLevelBytes(*entry, entry->targetLevel) - getLevelBytes(*entry, entry->residentLevel);
+
+		while (used + extra > budget) {
+			// Evict whatever was used the longest ago, as long as it's not being drawn right now
+			Entry* lru = nullptr;
+			for (auto& [k, e]: entries) {
+				if (!e->pending.isValid() && e->residentLevel < e->baseLevel && e->lastUsed < curFrame && (!lru || e->lastUsed < lru->lastUsed)) {
+					lru = e.get();
+				}
+			}
+			if (!lru) {
+				break;
+			}
+			used -= getLevelBytes(*lru, lru->residentLevel) - getLevelBytes(*lru, lru->baseLevel);
+			requestLevel(*lru, lru->baseLevel);
+		}
+
+		if (used + extra <= budget) {
+			used += extra;
+			requestLevel(*entry, entry->targetLevel);
+		}
+	}
+
+	++curFrame;
+}
+
+void TextureStreamer::setBudget(size_t bytes)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	budget = bytes;
+}
+
+size_t TextureStreamer::getBudget() const
+{
+	return budget;
+}
+
+ResourceMemoryUsage TextureStreamer::getMemoryUsage() const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	ResourceMemoryUsage result;
+	for (const auto& [k, e]: entries) {
+		result.ramUsage += e->data.size();
+		result.vramUsage += getLevelBytes(*e, e->residentLevel);
+	}
+	return result;
+}
+
+std::optional<int> TextureStreamer::getResidentMipLevel(const Texture& texture) const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	const auto iter = entries.find(&texture);
+	if (iter == entries.end()) {
+		return std::nullopt;
+	}
+	return iter->second->residentLevel;
+}
+
+size_t TextureStreamer::getNumStreamedIn() const
+{
+	return nStreamedIn;
+}
+
+size_t TextureStreamer::getNumEvicted() const
+{
+	return nEvicted;
+}
+
+int TextureStreamer::getRequiredMipLevel(Vector2f texels, Vector2f pixels)
+{
+	const float ratio = std::min(std::abs(texels.x) / std::max(std::abs(pixels.x), 0.0001f), std::abs(texels.y) / std::max(std::abs(pixels.y), 0.0001f));
+	return ratio <= 1.0f ? 0 : int(std::floor(std::log2(ratio)));
+}
+
+void TextureStreamer::applyFinished(Entry& entry)
+{
+	if (!entry.pending.isValid() || !entry.pending.hasValue()) {
+		return;
+	}
+
+	if (auto texture = entry.texture.lock()) {
+		texture->replaceWith(std::move(*entry.pendingTexture));
+		if (entry.pendingLevel < entry.residentLevel) {
+			++nStreamedIn;
+		} else {
+			++nEvicted;
+		}
+		entry.residentLevel = entry.pendingLevel;
+	}
+
+	entry.pending = {};
+	entry.pendingTexture.reset();
+}
+
+void TextureStreamer::requestLevel(Entry& entry, int level)
+{
+	const auto texture = entry.texture.lock();
+	if (!texture) {
+		return;
+	}
+
+	// Loaded into a separate texture, and only swapped in by update, so anything drawing meanwhile is unaffected
+	entry.pendingTexture = std::shared_ptr<Texture>(video.createTexture(entry.size));
+	entry.pendingTexture->setAssetId(texture->getAssetId());
+	entry.pendingTexture->startLoading();
+	entry.pendingLevel = level;
+	auto descriptor = std::make_shared<TextureDescriptor>(makeDescriptor(entry, level));
+	entry.pending = Concurrent::execute(uploadQueue, [texture = entry.pendingTexture, descriptor] ()
+	{
+		texture->load(std::move(*descriptor));
+	});
+}
+
+size_t TextureStreamer::getLevelBytes(const Entry& entry, int level) const
+{
+	return TextureCompression::getMipChainByteSize(entry.format, entry.size, entry.mipLevels) - TextureCompression::getMipChainByteSize(entry.format, entry.size, level);
+}
+
+TextureDescriptor TextureStreamer::makeDescriptor(const Entry& entry, int level) const
+{
+	TextureDescriptor descriptor(entry.size, entry.format);
+	descriptor.mipLevels = entry.mipLevels;
+	descriptor.firstMipLevel = level;
+	descriptor.useMipMap = true;
+	descriptor.useFiltering = entry.useFiltering;
+	descriptor.addressMode = entry.addressMode;
+
+	const auto offset = TextureCompression::getMipChainByteSize(entry.format, entry.size, level);
+	descriptor.pixelData = TextureDescriptorImageData(gsl::as_bytes(gsl::span<const Byte>(entry.data)).subspan(offset));
+	return descriptor;
+}
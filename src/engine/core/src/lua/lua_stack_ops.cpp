@@ -1,6 +1,7 @@
 #include "lua/src/lua.hpp"
 #include "halley/lua/lua_stack_ops.h"
 #include "halley/lua/lua_state.h"
+#include "halley/scripting/script_data_value.h"
 
 using namespace Halley;
 
@@ -74,6 +75,26 @@ void LuaStackOps::push(const ConfigNode& node)
 	}
 }
 
+void LuaStackOps::push(const ScriptDataValue& value)
+{
+	switch (value.getType()) {
+	case ScriptDataValue::Type::Undefined:
+		push(nullptr);
+		break;
+	case ScriptDataValue::Type::Bool:
+		push(value.asBool());
+		break;
+	case ScriptDataValue::Type::Int:
+		push(value.getInt());
+		break;
+	case ScriptDataValue::Type::Float:
+		push(static_cast<double>(value.getFloat()));
+		break;
+	default:
+		push(value.toConfigNode());
+	}
+}
+
 void LuaStackOps::pushTable(int nArrayIndices, int nRecords)
 {
 	lua_createtable(state.getRawState(), nArrayIndices, nRecords);
@@ -228,6 +249,24 @@ ConfigNode LuaStackOps::popConfigNode()
 	return ConfigNode();
 }
 
+void LuaStackOps::popScriptDataValue(ScriptDataValue& value)
+{
+	switch (lua_type(state.getRawState(), -1)) {
+	case LUA_TNIL:
+		pop();
+		value.setUndefined();
+		break;
+	case LUA_TNUMBER:
+		value.setFloat(static_cast<float>(popDouble()));
+		break;
+	case LUA_TBOOLEAN:
+		value.setBool(popBool());
+		break;
+	default:
+		value.set(popConfigNode());
+	}
+}
+
 ConfigNode LuaStackOps::popTable()
 {
 	auto L = state.getRawState();
@@ -257,6 +296,7 @@ ConfigNode LuaStackOps::popTable()
 			}			
 		}
 	}
+	lua_pop(L, 1);
 
 	return seqResult.empty() ? ConfigNode(std::move(mapResult)) : ConfigNode(std::move(seqResult));
 }
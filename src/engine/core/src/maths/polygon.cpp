@@ -34,6 +34,7 @@
 #include "halley/bytes/byte_serializer.h"
 #include "halley/maths/random.h"
 #include "halley/maths/triangle.h"
+#include "halley/maths/simd.h"
 using namespace Halley;
 
 
@@ -71,6 +72,25 @@ void Polygon::realize()
 
 	aabb = Rect4f::getSpanningRect(vertices);
 	circle = Circle::getSpanningCircle(vertices);
+	updateSIMDVertices();
+}
+
+void Polygon::updateSIMDVertices()
+{
+	simdX.clear();
+	simdY.clear();
+	if (vertices.empty()) {
+		return;
+	}
+
+	const size_t n = vertices.size();
+	const size_t padded = alignUp(n, static_cast<size_t>(4)) + 1;
+	simdX.resize(padded, vertices[0].x);
+	simdY.resize(padded, vertices[0].y);
+	for (size_t i = 0; i < n; ++i) {
+		simdX[i] = vertices[i].x;
+		simdY[i] = vertices[i].y;
+	}
 }
 
 void Polygon::checkConvex()
@@ -292,14 +312,20 @@ bool Polygon::isPointOnEdge(Vector2f point, float epsilon) const
 
 bool Polygon::isPointInsideConvex(Vector2f point) const
 {
-	const float sign = clockwise ? 1.0f : -1.0f;
-	
-	// Do cross product with all the segments
-	const size_t len = vertices.size();
-	for (size_t i = 0; i < len; i++) {
-		const auto a = point - vertices[i];
-		const auto b = vertices[(i+1) % len] - vertices[i];
-		if (a.cross(b) * sign > 0) {
+	const auto sign = SIMDVec4::loadSingleValue(clockwise ? 1.0f : -1.0f);
+	const auto zero = SIMDVec4::loadZero();
+	const auto px = SIMDVec4::loadSingleValue(point.x);
+	const auto py = SIMDVec4::loadSingleValue(point.y);
+
+	// Do cross product with all the segments, four at a time
+	const size_t len = simdX.empty() ? 0 : simdX.size() - 1;
+	for (size_t i = 0; i < len; i += 4) {
+		const auto x0 = SIMDVec4::loadUnaligned(simdX.data() + i);
+		const auto y0 = SIMDVec4::loadUnaligned(simdY.data() + i);
+		const auto bx = SIMDVec4::loadUnaligned(simdX.data() + i + 1) - x0;
+		const auto by = SIMDVec4::loadUnaligned(simdY.data() + i + 1) - y0;
+		const auto cross = (px - x0) * by - (py - y0) * bx;
+		if (zero.lessThan(cross * sign).getMask() != 0) {
 			return false;
 		}
 	}
@@ -308,6 +334,57 @@ bool Polygon::isPointInsideConvex(Vector2f point) const
 	return true;
 }
 
+void Polygon::isPointInside(gsl::span<const Vector2f> points, gsl::span<bool> result) const
+{
+	Expects(points.size() == result.size());
+
+	const size_t nPoints = points.size();
+	size_t i = 0;
+
+	if (convex) {
+		const auto sign = SIMDVec4::loadSingleValue(clockwise ? 1.0f : -1.0f);
+		const auto zero = SIMDVec4::loadZero();
+		const auto centreX = SIMDVec4::loadSingleValue(circle.getCentre().x);
+		const auto centreY = SIMDVec4::loadSingleValue(circle.getCentre().y);
+		const auto radius2 = SIMDVec4::loadSingleValue(circle.getRadius() * circle.getRadius());
+		const auto left = SIMDVec4::loadSingleValue(aabb.getLeft());
+		const auto right = SIMDVec4::loadSingleValue(aabb.getRight());
+		const auto top = SIMDVec4::loadSingleValue(aabb.getTop());
+		const auto bottom = SIMDVec4::loadSingleValue(aabb.getBottom());
+		const size_t nVertices = vertices.size();
+
+		// Test four points at a time against each edge
+		for (; i + 4 <= nPoints; i += 4) {
+			SIMDVec4 px;
+			SIMDVec4 py;
+			SIMDVec4::loadDeinterleaved(&points[i].x, px, py);
+
+			// Same fast fail tests as isPointInside()
+			const auto dx = px - centreX;
+			const auto dy = py - centreY;
+			auto inside = (dx * dx + dy * dy).lessOrEqual(radius2)
+				& left.lessOrEqual(px) & px.lessThan(right)
+				& top.lessOrEqual(py) & py.lessThan(bottom);
+
+			for (size_t j = 0; j < nVertices && inside.getMask() != 0; ++j) {
+				const auto a = vertices[j];
+				const auto b = vertices[(j + 1) % nVertices] - a;
+				const auto cross = (px - SIMDVec4::loadSingleValue(a.x)) * SIMDVec4::loadSingleValue(b.y) - (py - SIMDVec4::loadSingleValue(a.y)) * SIMDVec4::loadSingleValue(b.x);
+				inside = inside & (cross * sign).lessOrEqual(zero);
+			}
+
+			const int mask = inside.getMask();
+			for (size_t k = 0; k < 4; ++k) {
+				result[i + k] = (mask & (1 << k)) != 0;
+			}
+		}
+	}
+
+	for (; i < nPoints; ++i) {
+		result[i] = isPointInside(points[i]);
+	}
+}
+
 bool Polygon::isPointInsideConcave(Vector2f point) const
 {
 	size_t nLeft = 0;
@@ -587,19 +664,146 @@ Polygon::SATClassification Polygon::classify(const LineSegment& line) const
 	return SATClassification::Overlap;
 }
 
-Range<float> Polygon::project(Vector2f axis) const
+void Polygon::collide(gsl::span<const Polygon> others, gsl::span<bool> result) const
 {
-	float min = std::numeric_limits<float>::infinity();
-	float max = -std::numeric_limits<float>::infinity();
+	Expects(others.size() == result.size());
+	if (!convex) {
+		throw Exception("Cannot check collision between non-convex polygons", HalleyExceptions::Utils);
+	}
 
-	const size_t len = vertices.size();
+	// This polygon's axes and its projection on them are the same for every test, so only compute them once
+	const auto ownAxes = getProjectedEdgeAxes();
+	for (size_t i = 0; i < others.size(); ++i) {
+		if (!others[i].convex) {
+			throw Exception("Cannot check collision between non-convex polygons", HalleyExceptions::Utils);
+		}
+		result[i] = collideConvex(others[i], ownAxes);
+	}
+}
+
+bool Polygon::collideConvex(const Polygon& other, gsl::span<const ProjectedAxis> ownAxes) const
+{
+	// Same as collideConvex() above, minus the translation and collision point
+	const float maxDist = circle.getRadius() + other.circle.getRadius();
+	if ((circle.getCentre() - other.circle.getCentre()).squaredLength() >= maxDist * maxDist) {
+		return false;
+	}
+
+	auto separates = [] (Range<float> range1, Range<float> range2)
+	{
+		const float dist = range1.start < range2.start ? range2.start - range1.end : range1.start - range2.end;
+		return dist >= 0;
+	};
+
+	for (const auto& a: ownAxes) {
+		if (separates(a.range, other.project(a.axis))) {
+			return false;
+		}
+	}
+
+	const size_t len = other.vertices.size();
 	for (size_t i = 0; i < len; i++) {
-		const float dot = axis.dot(vertices[i]);
-		min = std::min(min, dot);
-		max = std::max(max, dot);
+		const Vector2f axis = (other.vertices[(i + 1) % len] - other.vertices[i]).orthoLeft().unit();
+		if (separates(project(axis), other.project(axis))) {
+			return false;
+		}
 	}
 
-	return Range<float>(min, max);
+	return true;
+}
+
+void Polygon::classify(gsl::span<const Polygon> others, gsl::span<SATClassification> result, float epsilon) const
+{
+	Expects(convex);
+	Expects(others.size() == result.size());
+
+	const auto ownAxes = getProjectedEdgeAxes();
+	for (size_t i = 0; i < others.size(); ++i) {
+		result[i] = classify(others[i], ownAxes, epsilon);
+	}
+}
+
+Polygon::SATClassification Polygon::classify(const Polygon& other, gsl::span<const ProjectedAxis> ownAxes, float epsilon) const
+{
+	Expects(other.convex);
+
+	// Same as classify() above, but with this polygon's projections on its own axes precomputed
+	const float maxDist = circle.getRadius() + other.circle.getRadius();
+	if ((circle.getCentre() - other.circle.getCentre()).squaredLength() >= maxDist * maxDist) {
+		return SATClassification::Separate;
+	}
+
+	bool contains = true;
+	bool isContainedBy = true;
+
+	auto checkAxis = [&] (Range<float> myRange, Range<float> otherRange) -> bool
+	{
+		if (!myRange.overlaps(otherRange) || myRange.getOverlap(otherRange).getLength() < epsilon) {
+			return false;
+		}
+		if (!myRange.contains(otherRange)) {
+			contains = false;
+		}
+		if (!otherRange.contains(myRange)) {
+			isContainedBy = false;
+		}
+		return true;
+	};
+
+	for (const auto& a: ownAxes) {
+		if (!checkAxis(a.range, other.project(a.axis))) {
+			return SATClassification::Separate;
+		}
+	}
+
+	const size_t n = other.vertices.size();
+	for (size_t i = 0; i < n; i++) {
+		const Vector2f axis = (other.vertices[(i + 1) % n] - other.vertices[i]).orthoLeft().unit();
+		if (!checkAxis(project(axis), other.project(axis))) {
+			return SATClassification::Separate;
+		}
+	}
+
+	if (contains) {
+		return SATClassification::Contains;
+	} else if (isContainedBy) {
+		return SATClassification::IsContainedBy;
+	}
+	return SATClassification::Overlap;
+}
+
+Range<float> Polygon::project(Vector2f axis) const
+{
+	const auto axisX = SIMDVec4::loadSingleValue(axis.x);
+	const auto axisY = SIMDVec4::loadSingleValue(axis.y);
+	auto minDot = SIMDVec4::loadSingleValue(std::numeric_limits<float>::infinity());
+	auto maxDot = SIMDVec4::loadSingleValue(-std::numeric_limits<float>::infinity());
+
+	// Padding vertices are copies of vertices[0], so they don't affect the result
+	const size_t len = simdX.empty() ? 0 : simdX.size() - 1;
+	for (size_t i = 0; i < len; i += 4) {
+		const auto dot = axisX * SIMDVec4::loadUnaligned(simdX.data() + i) + axisY * SIMDVec4::loadUnaligned(simdY.data() + i);
+		minDot = minDot.min(dot);
+		maxDot = maxDot.max(dot);
+	}
+
+	alignas(16) std::array<float, 4> mins;
+	alignas(16) std::array<float, 4> maxs;
+	minDot.storeAligned(mins.data());
+	maxDot.storeAligned(maxs.data());
+	return Range<float>(std::min(std::min(mins[0], mins[1]), std::min(mins[2], mins[3])), std::max(std::max(maxs[0], maxs[1]), std::max(maxs[2], maxs[3])));
+}
+
+Vector<Polygon::ProjectedAxis> Polygon::getProjectedEdgeAxes() const
+{
+	Vector<ProjectedAxis> result;
+	const size_t n = vertices.size();
+	result.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		const Vector2f axis = (vertices[(i + 1) % n] - vertices[i]).orthoLeft().unit();
+		result.push_back(ProjectedAxis{ axis, project(axis) });
+	}
+	return result;
 }
 
 void Polygon::unproject(const Vector2f &axis,const float point,Vector<Vector2f> &ver) const
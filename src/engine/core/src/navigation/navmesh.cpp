@@ -133,52 +133,109 @@ const Polygon& Navmesh::getPolygon(int id) const
 	return polygons[id];
 }
 
-std::optional<Navmesh::NodeId> Navmesh::getNodeAt(Vector2f position) const
-{
-	const auto& polyIndices = getPolygonsAt(position, true);
-	
-	for (auto i: polyIndices) {
-		if (polygons[i].isPointInside(position)) {
-			return i;
+namespace {
+	constexpr float maxDistanceToPolygon = 5.0f;
+
+	// Running best of a getClosestPointTo search, shared by the single and batched versions so both pick the same polygon
+	struct ClosestPolygonSearch {
+		float bestDist;
+		std::optional<Vector2f> bestPoint;
+		StaticBVH::Index bestIdx = 0;
+
+		explicit ClosestPolygonSearch(float maxDist)
+			: bestDist(maxDist)
+		{}
+
+		float visit(const Polygon& poly, StaticBVH::Index idx, Vector2f pos, float anisotropy)
+		{
+			// Coarse test vs circle first
+			const auto distToCircle = poly.getBoundingCircle().getDistanceTo(pos);
+			if (distToCircle <= bestDist) {
+				const auto p = poly.getClosestPoint(pos, anisotropy);
+				const float dist = (p - pos).length();
+				if (dist < bestDist || (bestPoint && dist == bestDist && idx < bestIdx)) { // Ties go to the first polygon, like a linear scan would
+					bestPoint = p;
+					bestDist = dist;
+					bestIdx = idx;
+				}
+			}
+			return bestDist;
 		}
-	}
-
-	const float maxDistanceToPolygon = 5.0f;
+	};
 
-	// Haven't found, look for the closest one in this grid cell...
-	{
+	// Same, for the open edge fallback of getNodeAt
+	struct ClosestOpenEdgeSearch {
 		float bestDist = std::numeric_limits<float>::infinity();
 		int bestNode = -1;
-		for (auto i: polyIndices) {
-			const auto p = polygons[i].getClosestPoint(position);
-			const float distSquared = (p - position).squaredLength();
-			if (distSquared < bestDist && std::sqrt(distSquared) < maxDistanceToPolygon) {
+		StaticBVH::Index bestEdge = 0;
+
+		float visit(const std::pair<uint16_t, LineSegment>& edge, StaticBVH::Index idx, Vector2f position, float maxDist)
+		{
+			const float distSquared = (position - edge.second.getClosestPoint(position)).squaredLength();
+			const bool isBetter = distSquared < bestDist || (bestNode != -1 && distSquared == bestDist && idx < bestEdge); // Ties go to the first edge, like a linear scan would
+			if (isBetter && std::sqrt(distSquared) < maxDistanceToPolygon) {
 				bestDist = distSquared;
-				bestNode = i;
+				bestNode = edge.first;
+				bestEdge = idx;
+				return std::sqrt(bestDist);
 			}
+			return maxDist;
 		}
-		if (bestNode != -1) {
-			return gsl::narrow<NodeId>(bestNode);
+
+		std::optional<Navmesh::NodeId> getResult() const
+		{
+			if (bestNode != -1) {
+				return gsl::narrow<Navmesh::NodeId>(bestNode);
+			}
+			return {};
 		}
+	};
+
+	constexpr size_t packetSize = 4;
+}
+
+std::optional<Navmesh::NodeId> Navmesh::getNodeAt(Vector2f position) const
+{
+	if (const auto node = getNodeInCell(position)) {
+		return node;
 	}
 
 	// If we don't find it even in this cell, then look on the open edges
+	ClosestOpenEdgeSearch search;
+	openEdgeBVH.visitNearest(position, maxDistanceToPolygon, [&] (StaticBVH::Index idx, float maxDist) -> float
 	{
-		float bestDist = std::numeric_limits<float>::infinity();
-		int bestNode = -1;
-		for (const auto& edge: openEdges) {
-			const float distSquared = (position - edge.second.getClosestPoint(position)).squaredLength();
-			if (distSquared < bestDist && std::sqrt(distSquared) < maxDistanceToPolygon) {
-				bestDist = distSquared;
-				bestNode = edge.first;
-			}
+		return search.visit(openEdges[idx], idx, position, maxDist);
+	});
+
+	// If nothing is found, give up
+	return search.getResult();
+}
+
+std::optional<Navmesh::NodeId> Navmesh::getNodeInCell(Vector2f position) const
+{
+	const auto& polyIndices = getPolygonsAt(position, true);
+	
+	for (auto i: polyIndices) {
+		if (polygons[i].isPointInside(position)) {
+			return i;
 		}
-		if (bestNode != -1) {
-			return gsl::narrow<NodeId>(bestNode);
+	}
+
+	// Haven't found, look for the closest one in this grid cell...
+	float bestDist = std::numeric_limits<float>::infinity();
+	int bestNode = -1;
+	for (auto i: polyIndices) {
+		const auto p = polygons[i].getClosestPoint(position);
+		const float distSquared = (p - position).squaredLength();
+		if (distSquared < bestDist && std::sqrt(distSquared) < maxDistanceToPolygon) {
+			bestDist = distSquared;
+			bestNode = i;
 		}
 	}
+	if (bestNode != -1) {
+		return gsl::narrow<NodeId>(bestNode);
+	}
 
-	// Give up
 	return {};
 }
 
@@ -205,23 +262,146 @@ std::optional<Vector2f> Navmesh::getClosestPointTo(Vector2f pos, float anisotrop
 		return pos;
 	}
 
-	float bestDist = maxDist;
-	std::optional<Vector2f> bestPoint;
+	ClosestPolygonSearch search(maxDist);
+	polygonBVH.visitNearest(pos, maxDist, [&] (StaticBVH::Index idx, float) -> float
+	{
+		return search.visit(polygons[idx], idx, pos, anisotropy);
+	});
 
-	for (const auto& poly: polygons) {
-		// Coarse test vs circle first
-		const auto distToCircle = poly.getBoundingCircle().getDistanceTo(pos);
-		if (distToCircle <= bestDist) {
-			const auto p = poly.getClosestPoint(pos, anisotropy);
-			const float dist = (p - pos).length();
-			if (dist < bestDist) {
-				bestPoint = p;
-				bestDist = dist;
+	return search.bestPoint;
+}
+
+void Navmesh::getNodesAt(gsl::span<const Vector2f> positions, gsl::span<std::optional<NodeId>> result) const
+{
+	Expects(positions.size() == result.size());
+
+	// Most queries are resolved by their grid cell, the rest are gathered in packets that walk the open edge tree together
+	std::array<size_t, packetSize> packet;
+	size_t packetLen = 0;
+
+	auto flush = [&] ()
+	{
+		std::array<Vector2f, packetSize> points;
+		std::array<float, packetSize> maxDists;
+		std::array<ClosestOpenEdgeSearch, packetSize> searches;
+		for (size_t i = 0; i < packetLen; ++i) {
+			points[i] = positions[packet[i]];
+			maxDists[i] = maxDistanceToPolygon;
+		}
+
+		openEdgeBVH.visitNearestPacket(gsl::span<const Vector2f>(points.data(), packetLen), gsl::span<float>(maxDists.data(), packetLen), [&] (size_t lane, StaticBVH::Index idx, float maxDist) -> float
+		{
+			return searches[lane].visit(openEdges[idx], idx, points[lane], maxDist);
+		});
+
+		for (size_t i = 0; i < packetLen; ++i) {
+			result[packet[i]] = searches[i].getResult();
+		}
+		packetLen = 0;
+	};
+
+	for (const auto i: getBatchOrder(positions)) {
+		result[i] = getNodeInCell(positions[i]);
+		if (!result[i]) {
+			packet[packetLen++] = i;
+			if (packetLen == packetSize) {
+				flush();
 			}
 		}
 	}
+	if (packetLen > 0) {
+		flush();
+	}
+}
+
+void Navmesh::getClosestPointsTo(gsl::span<const Vector2f> positions, gsl::span<std::optional<Vector2f>> result, float anisotropy, float maxDist) const
+{
+	Expects(positions.size() == result.size());
+
+	// Queries that aren't trivially resolved are gathered in packets of nearby points, which walk the polygon tree together
+	std::array<size_t, packetSize> packet;
+	size_t packetLen = 0;
 
-	return bestPoint;
+	auto flush = [&] ()
+	{
+		std::array<Vector2f, packetSize> points;
+		std::array<float, packetSize> maxDists;
+		std::array<ClosestPolygonSearch, packetSize> searches = { ClosestPolygonSearch(maxDist), ClosestPolygonSearch(maxDist), ClosestPolygonSearch(maxDist), ClosestPolygonSearch(maxDist) };
+		for (size_t i = 0; i < packetLen; ++i) {
+			points[i] = positions[packet[i]];
+			maxDists[i] = maxDist;
+		}
+
+		polygonBVH.visitNearestPacket(gsl::span<const Vector2f>(points.data(), packetLen), gsl::span<float>(maxDists.data(), packetLen), [&] (size_t lane, StaticBVH::Index idx, float) -> float
+		{
+			return searches[lane].visit(polygons[idx], idx, points[lane], anisotropy);
+		});
+
+		for (size_t i = 0; i < packetLen; ++i) {
+			result[packet[i]] = searches[i].bestPoint;
+		}
+		packetLen = 0;
+	};
+
+	for (const auto i: getBatchOrder(positions)) {
+		const auto pos = positions[i];
+		if (boundingCircle.getDistanceTo(pos) > maxDist) {
+			result[i] = {};
+		} else if (containsPoint(pos)) {
+			result[i] = pos;
+		} else {
+			packet[packetLen++] = i;
+			if (packetLen == packetSize) {
+				flush();
+			}
+		}
+	}
+	if (packetLen > 0) {
+		flush();
+	}
+}
+
+void Navmesh::findRayCollisions(gsl::span<const Ray> rays, gsl::span<const float> maxDistances, gsl::span<std::optional<Vector2f>> result) const
+{
+	Expects(rays.size() == maxDistances.size());
+	Expects(rays.size() == result.size());
+
+	// Start nodes are looked up as a batch, the walk along the ray follows polygon adjacency one ray at a time
+	Vector<Vector2f> origins;
+	origins.reserve(rays.size());
+	for (const auto& ray: rays) {
+		origins.push_back(ray.p);
+	}
+	Vector<std::optional<NodeId>> startNodes;
+	startNodes.resize(rays.size());
+	getNodesAt(origins, startNodes);
+
+	for (size_t i = 0; i < rays.size(); ++i) {
+		if (startNodes[i]) {
+			result[i] = findRayCollision(rays[i], maxDistances[i], startNodes[i].value()).first;
+		} else {
+			result[i] = Vector2f(rays[i].p);
+		}
+	}
+}
+
+Vector<size_t> Navmesh::getBatchOrder(gsl::span<const Vector2f> positions) const
+{
+	// Sort queries by grid cell, so consecutive queries touch the same polygons and packets are made of nearby points
+	Vector<std::pair<int, size_t>> keys;
+	keys.reserve(positions.size());
+	for (size_t i = 0; i < positions.size(); ++i) {
+		const auto cell = getGridAt(positions[i], true).value();
+		keys.emplace_back(cell.x + cell.y * gridSize.x, i);
+	}
+	std::sort(keys.begin(), keys.end());
+
+	Vector<size_t> result;
+	result.reserve(keys.size());
+	for (const auto& k: keys) {
+		result.push_back(k.second);
+	}
+	return result;
 }
 
 NavmeshBounds::NavmeshBounds(Vector2f origin, Vector2f side0, Vector2f side1, size_t side0Divisions, size_t side1Divisions, Vector2f scaleFactor)
@@ -634,6 +814,8 @@ void Navmesh::setWorldPosition(Vector2f newOffset, Vector2i gridPos)
 	}
 	origin += delta;
 	computeBoundingCircle();
+	buildPolygonBVH();
+	buildOpenEdgeBVH();
 }
 
 void Navmesh::markPortalConnected(size_t portalId, uint16_t navmeshId)
@@ -651,6 +833,7 @@ void Navmesh::markPortalsDisconnected()
 void Navmesh::processPolygons()
 {
 	addPolygonsToGrid();
+	buildPolygonBVH();
 	computeArea();
 	computeBoundingCircle();
 }
@@ -688,6 +871,31 @@ void Navmesh::addPolygonToGrid(const Polygon& poly, NodeId idx)
 	}
 }
 
+void Navmesh::buildPolygonBVH()
+{
+	// Bounds are padded slightly, so rounding errors never cull a polygon that's exactly at the search distance
+	constexpr float padding = 0.01f;
+
+	Vector<Rect4f> bounds;
+	bounds.reserve(polygons.size());
+	for (const auto& poly: polygons) {
+		bounds.push_back(poly.getAABB().grow(padding));
+	}
+	polygonBVH.build(bounds);
+}
+
+void Navmesh::buildOpenEdgeBVH()
+{
+	constexpr float padding = 0.01f;
+
+	Vector<Rect4f> bounds;
+	bounds.reserve(openEdges.size());
+	for (const auto& edge: openEdges) {
+		bounds.push_back(Rect4f(edge.second.a, edge.second.b).grow(padding));
+	}
+	openEdgeBVH.build(bounds);
+}
+
 std::optional<Vector2i> Navmesh::getGridAt(Vector2f pos, bool allowOutside) const
 {
 	const auto p = Vector2i((normalisedCoordinatesBase.inverseTransform(pos - origin) * Vector2f(gridSize)).floor());
@@ -777,6 +985,7 @@ void Navmesh::generateOpenEdges()
 			}
 		}
 	}
+	buildOpenEdgeBVH();
 }
 
 OptionalLite<uint16_t> Navmesh::getNavmeshFromEdge(NodeAndConn edge) const
@@ -1,6 +1,7 @@
 #include "halley/resources/resources.h"
 #include "halley/resources/resource_locator.h"
 #include "halley/api/halley_api.h"
+#include "halley/graphics/texture_streamer.h"
 #include "halley/support/logger.h"
 
 using namespace Halley;
@@ -10,6 +11,9 @@ Resources::Resources(std::unique_ptr<ResourceLocator> locator, const HalleyAPI&
 	, api(&api)
 	, options(options)
 {
+	if (options.textureStreamingBudget > 0 && api.video && Executors::hasInstance()) {
+		textureStreamer = std::make_unique<TextureStreamer>(*api.video, options.textureStreamingBudget, Executors::getVideoAux());
+	}
 }
 
 void Resources::reloadAssets(const Vector<String>& ids, const Vector<String>& packIds)
@@ -85,6 +89,10 @@ void Resources::generateMemoryReport()
 		}
 	}
 
+	if (textureStreamer) {
+		Logger::logInfo("Streamed textures: " + textureStreamer->getMemoryUsage().toString() + ", budget " + String::prettySize(textureStreamer->getBudget()));
+	}
+
 	locator->generateMemoryReport();
 }
 
@@ -19,6 +19,7 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/flow_gate.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::State; }
+		bool requiresMainThread() const override { return false; }
 
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 		String getPinDescription(const BaseGraphNode& node, PinType elementType, GraphPinId elementIdx) const override;
@@ -43,6 +44,7 @@ namespace Halley {
 		String getName() const override { return "Switch Gate"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/switch.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::State; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -61,6 +63,7 @@ namespace Halley {
 		String getName() const override { return "Switch"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/switch.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::FlowControl; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -87,6 +90,7 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/flow_once.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::FlowControl; }
+		bool requiresMainThread() const override { return false; }
 
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 		String getPinDescription(const BaseGraphNode& node, PinType elementType, GraphPinId elementIdx) const override;
@@ -112,6 +116,7 @@ namespace Halley {
 		String getName() const override { return "Latch"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/latch.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
 
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -142,6 +147,7 @@ namespace Halley {
 		String getName() const override { return "Cache"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/cache.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -168,6 +174,7 @@ namespace Halley {
 		String getName() const override { return "Fence"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/fence.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::FlowControl; }
+		bool requiresMainThread() const override { return false; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
@@ -194,6 +201,7 @@ namespace Halley {
 		String getName() const override { return "Breaker"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/breaker.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::State; }
+		bool requiresMainThread() const override { return false; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
@@ -211,6 +219,7 @@ namespace Halley {
 		String getName() const override { return "Signal"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/signal.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool requiresMainThread() const override { return false; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
@@ -236,6 +245,7 @@ namespace Halley {
 		String getName() const override { return "Line Reset"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/line_reset.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::State; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -255,6 +265,7 @@ namespace Halley {
 		String getName() const override { return "Detach Flow"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/detach_flow.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::FlowControl; }
+		bool requiresMainThread() const override { return false; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
@@ -35,6 +35,17 @@ ConfigNode ScriptLogicGateAnd::doGetData(ScriptEnvironment& environment, const S
 	return ConfigNode(value);
 }
 
+bool ScriptLogicGateAnd::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	const auto a = compiler.compileInput(node, 0);
+	compiler.emit(ScriptDataOpCode::ToBool, dst, a);
+	const auto jumpToEnd = compiler.emitJump(ScriptDataOpCode::JumpIfFalse, dst);
+	const auto b = compiler.compileInput(node, 1);
+	compiler.emit(ScriptDataOpCode::ToBool, dst, b);
+	compiler.patchJump(jumpToEnd);
+	return true;
+}
+
 
 String ScriptLogicGateOr::getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const
 {
@@ -69,6 +80,17 @@ ConfigNode ScriptLogicGateOr::doGetData(ScriptEnvironment& environment, const Sc
 	return ConfigNode(value);
 }
 
+bool ScriptLogicGateOr::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	const auto a = compiler.compileInput(node, 0);
+	compiler.emit(ScriptDataOpCode::ToBool, dst, a);
+	const auto jumpToEnd = compiler.emitJump(ScriptDataOpCode::JumpIfTrue, dst);
+	const auto b = compiler.compileInput(node, 1);
+	compiler.emit(ScriptDataOpCode::ToBool, dst, b);
+	compiler.patchJump(jumpToEnd);
+	return true;
+}
+
 
 String ScriptLogicGateXor::getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const
 {
@@ -103,6 +125,14 @@ ConfigNode ScriptLogicGateXor::doGetData(ScriptEnvironment& environment, const S
 	return ConfigNode(value);
 }
 
+bool ScriptLogicGateXor::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	const auto a = compiler.compileInput(node, 0);
+	const auto b = compiler.compileInput(node, 1);
+	compiler.emit(ScriptDataOpCode::Xor, dst, a, b);
+	return true;
+}
+
 
 String ScriptLogicGateNot::getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const
 {
@@ -132,3 +162,10 @@ ConfigNode ScriptLogicGateNot::doGetData(ScriptEnvironment& environment, const S
 	const bool value = !readDataPin(environment, node, 0).asBool(false);
 	return ConfigNode(value);
 }
+
+bool ScriptLogicGateNot::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	const auto a = compiler.compileInput(node, 0);
+	compiler.emit(ScriptDataOpCode::Not, dst, a);
+	return true;
+}
@@ -10,9 +10,12 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/logic_gate_and.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 	};
 
 	class ScriptLogicGateOr final : public ScriptNodeTypeBase<void> {
@@ -23,9 +26,12 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/logic_gate_or.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 	};
 
 	class ScriptLogicGateXor final : public ScriptNodeTypeBase<void> {
@@ -36,9 +42,12 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/logic_gate_xor.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 	};
 
 	class ScriptLogicGateNot final : public ScriptNodeTypeBase<void> {
@@ -49,8 +58,11 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/logic_gate_not.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 	};
 }
@@ -1,18 +1,27 @@
 #include "script_lua.h"
 
 #include "halley/lua/lua_reference.h"
+#include "halley/lua/lua_state.h"
+#include "halley/utils/algorithm.h"
 
 using namespace Halley;
 
 ScriptLuaExpressionData::ScriptLuaExpressionData(const ConfigNode& node)
 {
-	results = node["results"].asVector<ConfigNode>({});
+	for (const auto& result: node["results"].asVector<ConfigNode>({})) {
+		results.emplace_back(result);
+	}
 }
 
 ConfigNode ScriptLuaExpressionData::toConfigNode(const EntitySerializationContext& context)
 {
+	ConfigNode::SequenceType resultNodes;
+	for (const auto& result: results) {
+		resultNodes.push_back(result.toConfigNode());
+	}
+
 	ConfigNode::MapType result;
-	result["results"] = results;
+	result["results"] = std::move(resultNodes);
 	return result;
 }
 
@@ -87,15 +96,20 @@ String ScriptLuaExpression::getPinDescription(const BaseGraphNode& node, PinType
 void ScriptLuaExpression::doInitData(ScriptLuaExpressionData& data, const ScriptGraphNode& node, const EntitySerializationContext& context,	const ConfigNode& nodeData) const
 {
 	data.results = {};
+	data.resultsEvaluation = 0;
+	data.nArgs = static_cast<uint8_t>(node.getSettings()["args"].asVector<String>({}).size());
+	data.nOutputs = static_cast<uint8_t>(node.getSettings()["outputs"].asInt(1));
 }
 
 ConfigNode ScriptLuaExpression::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ScriptLuaExpressionData& data) const
 {
-	evaluate(environment, node, data);
+	const auto evaluationId = environment.getEvaluationId();
+	if (evaluationId == 0 || evaluationId != data.resultsEvaluation || data.results.empty()) {
+		evaluate(environment, node, data);
+		data.resultsEvaluation = evaluationId;
+	}
 
-	const auto args = node.getSettings()["args"].asVector<String>({});
-	const size_t argsN = args.size();
-	return ConfigNode(data.results[pinN - argsN]);
+	return data.results[pinN - data.nArgs].toConfigNode();
 }
 
 size_t ScriptLuaExpression::nFlowPins() const
@@ -108,39 +122,51 @@ void ScriptLuaExpression::evaluate(ScriptEnvironment& environment, const ScriptG
 	auto& state = environment.getInterface<ILuaInterface>().getLuaState();
 	auto stackOps = LuaStackOps(state);
 
-	const auto args = node.getSettings()["args"].asVector<String>({});
-	const size_t argsN = args.size();
-	const size_t outputs = node.getSettings()["outputs"].asInt(1);
-
-	if (!data.expr) {
-		auto code = node.getSettings()["code"].asString("");
-		if (!code.startsWith("return") && !code.contains('\n')) {
-			code = "return " + code;
-		}
-		if (argsN > 0) {
-			String exprStr = "local " + String::concatList(args, ", ") + " = ...\n" + code;
-			data.expr = LuaExpression(std::move(exprStr));
-		} else {
-			data.expr = LuaExpression(std::move(code));
-		}
+	if (!data.expr || data.exprState != &state) {
+		data.expr = getExpression(state, node);
+		data.exprState = &state;
 	}
 
-	const int firstInputPin = static_cast<int>(nFlowPins());
+	const auto firstInputPin = static_cast<GraphPinId>(nFlowPins());
 
 	LuaFunctionCaller::startCall(state);
 	data.expr->get(state).pushToLuaStack();
-	for (size_t i = 0; i < argsN; ++i) {
-		stackOps.push(readDataPin(environment, node, i + firstInputPin));
+	for (uint8_t i = 0; i < data.nArgs; ++i) {
+		stackOps.push(environment.readInputDataValue(node, firstInputPin + i));
 	}
-	LuaFunctionCaller::call(state, static_cast<int>(argsN), static_cast<int>(outputs));
+	LuaFunctionCaller::call(state, data.nArgs, data.nOutputs);
 
-	data.results.resize(outputs);
-	for (size_t i = 0; i < outputs; ++i) {
-		data.results[outputs - i - 1] = stackOps.popConfigNode();
+	data.results.resize(data.nOutputs);
+	for (size_t i = 0; i < data.nOutputs; ++i) {
+		stackOps.popScriptDataValue(data.results[data.nOutputs - i - 1]);
 	}
 	LuaFunctionCaller::endCall(state);
 }
 
+std::shared_ptr<const LuaExpression> ScriptLuaExpression::getExpression(LuaState& state, const ScriptGraphNode& node) const
+{
+	const auto args = node.getSettings()["args"].asVector<String>({});
+	auto code = node.getSettings()["code"].asString("");
+	if (!code.startsWith("return") && !code.contains('\n')) {
+		code = "return " + code;
+	}
+	if (!args.empty()) {
+		code = "local " + String::concatList(args, ", ") + " = ...\n" + code;
+	}
+
+	auto key = std::pair<const LuaState*, String>(&state, std::move(code));
+	if (const auto iter = expressions.find(key); iter != expressions.end()) {
+		if (auto expr = iter->second.lock()) {
+			return expr;
+		}
+	}
+
+	std_ex::erase_if_value(expressions, [] (const auto& expr) { return expr.expired(); });
+	auto expr = std::make_shared<LuaExpression>(key.second);
+	expressions[std::move(key)] = expr;
+	return expr;
+}
+
 
 std::pair<String, Vector<ColourOverride>> ScriptLuaStatement::getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const
 {
@@ -152,11 +178,8 @@ std::pair<String, Vector<ColourOverride>> ScriptLuaStatement::getNodeDescription
 
 ConfigNode ScriptLuaStatement::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ScriptLuaExpressionData& data) const
 {
-	const auto args = node.getSettings()["args"].asVector<String>({});
-	const size_t argsN = args.size();
-
-	const auto idx = pinN - argsN;
-	return idx < data.results.size() ? ConfigNode(data.results[idx]) : ConfigNode();
+	const auto idx = pinN - data.nArgs;
+	return idx < data.results.size() ? data.results[idx].toConfigNode() : ConfigNode();
 }
 
 IScriptNodeType::Result ScriptLuaStatement::doUpdate(ScriptEnvironment& environment, Time time, const ScriptGraphNode& node, ScriptLuaExpressionData& data) const
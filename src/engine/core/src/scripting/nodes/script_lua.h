@@ -10,8 +10,12 @@ namespace Halley {
 
 		ConfigNode toConfigNode(const EntitySerializationContext& context) override;
 
-		std::optional<LuaExpression> expr;
-		Vector<ConfigNode> results;
+		std::shared_ptr<const LuaExpression> expr;
+		const LuaState* exprState = nullptr;
+		Vector<ScriptDataValue> results;
+		uint32_t resultsEvaluation = 0; // Evaluation id of results, so multiple outputs only run the expression once per tick
+		uint8_t nArgs = 0;
+		uint8_t nOutputs = 0;
 	};
 
 	class ScriptLuaExpression : public ScriptNodeTypeBase<ScriptLuaExpressionData> {
@@ -20,6 +24,7 @@ namespace Halley {
 		String getName() const override { return "Lua Expression"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/lua.png"; }
+		bool isPureData() const override { return false; } // Lua can read (and change) anything, so results can't be cached
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -33,6 +38,12 @@ namespace Halley {
 	protected:
 		virtual size_t nFlowPins() const;
 		void evaluate(ScriptEnvironment& environment, const ScriptGraphNode& node, ScriptLuaExpressionData& data) const;
+
+	private:
+		// Compiled once for each Lua state and shared by all nodes and script states with the same code
+		mutable std::map<std::pair<const LuaState*, String>, std::weak_ptr<const LuaExpression>> expressions;
+
+		std::shared_ptr<const LuaExpression> getExpression(LuaState& state, const ScriptGraphNode& node) const;
 	};
 
 	class ScriptLuaStatement final : public ScriptLuaExpression {
@@ -41,6 +52,7 @@ namespace Halley {
 		String getName() const override { return "Lua Statement"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/lua.png"; }
+		bool isPureData() const override { return false; }
 
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
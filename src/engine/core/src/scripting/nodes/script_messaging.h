@@ -8,6 +8,7 @@ namespace Halley {
 		String getName() const override { return "Send Message"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/send_message.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -23,6 +24,7 @@ namespace Halley {
 		String getName() const override { return "Send Generic Message"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/send_message.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -38,6 +40,7 @@ namespace Halley {
 		String getName() const override { return "Broadcast Message"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/broadcast_message.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -61,6 +64,7 @@ namespace Halley {
 		String getName() const override { return "Receive Message"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/receive_message.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Terminator; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -100,6 +104,7 @@ namespace Halley {
 		String getName() const override { return "Send System Msg"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/send_system_message.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -121,6 +126,7 @@ namespace Halley {
 		String getName() const override { return "Send Entity Msg"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/send_entity_message.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -8,6 +8,7 @@ namespace Halley {
 		String getName() const override { return "Comment"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/comment.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Comment; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
@@ -49,15 +49,22 @@ std::pair<String, Vector<ColourOverride>> ScriptVariable::getNodeDescription(con
 ConfigNode ScriptVariable::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
 	const auto& vars = environment.getVariables(getScope(node));
-	return ConfigNode(vars.getVariable(node.getSettings()["variable"].asString("")));
+	return vars.getVariable(environment.getCurrentGraph()->getVariableKey(node));
+}
+
+bool ScriptVariable::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	const auto variable = compiler.addVariable(node.getSettings()["variable"].asString(""));
+	compiler.emit(ScriptDataOpCode::LoadVariable, dst, 0, 0, static_cast<uint8_t>(getScope(node)), variable);
+	return true;
 }
 
 EntityId ScriptVariable::doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const
 {
 	const auto& vars = environment.getVariables(getScope(node));
-	const auto& data = vars.getVariable(node.getSettings()["variable"].asString(""));
-	if (data.getType() == ConfigNodeType::EntityId || data.getType() == ConfigNodeType::Int || data.getType() == ConfigNodeType::Float) {
-		return data.asEntityId();
+	const auto* data = vars.tryGetValue(environment.getCurrentGraph()->getVariableKey(node));
+	if (data && (data->getType() == ScriptDataValue::Type::EntityId || data->getType() == ScriptDataValue::Type::Int || data->getType() == ScriptDataValue::Type::Float)) {
+		return data->toConfigNode().asEntityId();
 	} else {
 		return {};
 	}
@@ -66,10 +73,10 @@ EntityId ScriptVariable::doGetEntityId(ScriptEnvironment& environment, const Scr
 void ScriptVariable::doSetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const
 {
 	const auto scope = getScope(node);
-	const auto variable = node.getSettings()["variable"].asString("");
+	const auto& variable = environment.getCurrentGraph()->getVariableKey(node);
 
 	if (scope != ScriptVariableScope::Local && !environment.hasNetworkAuthorityOver(environment.getCurrentEntityId())) {
-		Logger::logError(environment.getCurrentGraph()->getAssetId() + ": Cannot write to Script/Entity Variable \"" + variable + "\", not owned by this client");
+		Logger::logError(environment.getCurrentGraph()->getAssetId() + ": Cannot write to Script/Entity Variable \"" + variable.getName() + "\", not owned by this client");
 		return;
 	}
 
@@ -132,13 +139,13 @@ std::pair<String, Vector<ColourOverride>> ScriptEntityVariable::getNodeDescripti
 ConfigNode ScriptEntityVariable::doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const
 {
 	const auto& vars = environment.getEntityVariables(readEntityId(environment, node, 0));
-	return ConfigNode(vars.getVariable(node.getSettings()["variable"].asString("")));
+	return vars.getVariable(environment.getCurrentGraph()->getVariableKey(node));
 }
 
 EntityId ScriptEntityVariable::doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const
 {
 	const auto& vars = environment.getEntityVariables(readEntityId(environment, node, 0));
-	return vars.getVariable(node.getSettings()["variable"].asString("")).asEntityId({});
+	return vars.getVariable(environment.getCurrentGraph()->getVariableKey(node)).asEntityId({});
 }
 
 ConfigNode ScriptEntityVariable::doGetDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node) const
@@ -224,6 +231,12 @@ ConfigNode ScriptLiteral::doGetData(ScriptEnvironment& environment, const Script
 	return getConfigNode(node);
 }
 
+bool ScriptLiteral::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	compiler.emitConstant(dst, getConfigNode(node));
+	return true;
+}
+
 ConfigNode ScriptLiteral::getConfigNode(const BaseGraphNode& node) const
 {
 	const auto& origValue = node.getSettings()["value"];
@@ -436,6 +449,12 @@ ConfigNode ScriptColourLiteral::doGetData(ScriptEnvironment& environment, const
 	return ConfigNode(node.getSettings()["value"].asString("#FFFFFF"));
 }
 
+bool ScriptColourLiteral::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	compiler.emitConstant(dst, ConfigNode(node.getSettings()["value"].asString("#FFFFFF")));
+	return true;
+}
+
 
 
 String ScriptComparison::getLargeLabel(const BaseGraphNode& node) const
@@ -484,6 +503,15 @@ ConfigNode ScriptComparison::doGetData(ScriptEnvironment& environment, const Scr
 	return ConfigNode(a.compareTo(op, b));
 }
 
+bool ScriptComparison::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	const auto a = compiler.compileInput(node, 0);
+	const auto b = compiler.compileInput(node, 1);
+	const auto op = fromString<MathRelOp>(node.getSettings()["operator"].asString("=="));
+	compiler.emit(ScriptDataOpCode::Compare, dst, a, b, static_cast<uint8_t>(op));
+	return true;
+}
+
 
 
 String ScriptArithmetic::getLargeLabel(const BaseGraphNode& node) const
@@ -535,7 +563,20 @@ ConfigNode ScriptArithmetic::doGetData(ScriptEnvironment& environment, const Scr
 	const auto a = readDataPin(environment, node, 0);
 	const auto b = readDataPin(environment, node, 1);
 	const auto op = fromString<MathOp>(node.getSettings()["operator"].asString("+"));
+	return doArithmetic(op, a, b);
+}
+
+bool ScriptArithmetic::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	const auto a = compiler.compileInput(node, 0);
+	const auto b = compiler.compileInput(node, 1);
+	const auto op = fromString<MathOp>(node.getSettings()["operator"].asString("+"));
+	compiler.emit(ScriptDataOpCode::Arithmetic, dst, a, b, static_cast<uint8_t>(op));
+	return true;
+}
 
+ConfigNode ScriptArithmetic::doArithmetic(MathOp op, const ConfigNode& a, const ConfigNode& b)
+{
 	const auto type = ConfigNode::getPromotedType(std::array<ConfigNodeType, 2>{ a.getType(), b.getType() }, true);
 
 	if (type == ConfigNodeType::String) {
@@ -603,6 +644,15 @@ ConfigNode ScriptValueOr::doGetData(ScriptEnvironment& environment, const Script
 	}
 }
 
+bool ScriptValueOr::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	compiler.compileInput(node, 0, dst);
+	const auto jumpToEnd = compiler.emitJump(ScriptDataOpCode::JumpIfDefined, dst);
+	compiler.compileInput(node, 1, dst);
+	compiler.patchJump(jumpToEnd);
+	return true;
+}
+
 
 
 String ScriptConditionalOperator::getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const
@@ -643,6 +693,18 @@ ConfigNode ScriptConditionalOperator::doGetData(ScriptEnvironment& environment,
 	}
 }
 
+bool ScriptConditionalOperator::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	const auto cond = compiler.compileInput(node, 0);
+	const auto jumpToElse = compiler.emitJump(ScriptDataOpCode::JumpIfFalse, cond);
+	compiler.compileInput(node, 1, dst);
+	const auto jumpToEnd = compiler.emitJump(ScriptDataOpCode::Jump);
+	compiler.patchJump(jumpToElse);
+	compiler.compileInput(node, 2, dst);
+	compiler.patchJump(jumpToEnd);
+	return true;
+}
+
 
 Vector<IScriptNodeType::SettingType> ScriptLerp::getSettingTypes() const
 {
@@ -1115,6 +1177,14 @@ ConfigNode ScriptToVector::doGetData(ScriptEnvironment& environment, const Scrip
 	return ConfigNode(Vector2f(x, y));
 }
 
+bool ScriptToVector::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	const auto x = compiler.compileInput(node, 0);
+	const auto y = compiler.compileInput(node, 1);
+	compiler.emit(ScriptDataOpCode::MakeVector, dst, x, y);
+	return true;
+}
+
 
 
 gsl::span<const IGraphNodeType::PinType> ScriptFromVector::getPinConfiguration(const BaseGraphNode& node) const
@@ -1165,6 +1235,16 @@ ConfigNode ScriptFromVector::doGetData(ScriptEnvironment& environment, const Scr
 	}
 }
 
+bool ScriptFromVector::compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const
+{
+	if (pinN != 1 && pinN != 2) {
+		return false;
+	}
+	const auto value = compiler.compileInput(node, 0);
+	compiler.emit(pinN == 1 ? ScriptDataOpCode::VectorX : ScriptDataOpCode::VectorY, dst, value);
+	return true;
+}
+
 
 
 gsl::span<const IGraphNodeType::PinType> ScriptInsertValueIntoMap::getPinConfiguration(const BaseGraphNode& node) const
@@ -1,4 +1,5 @@
 #pragma once
+#include "halley/maths/ops.h"
 #include "halley/scripting/script_environment.h"
 
 namespace Halley {
@@ -8,6 +9,8 @@ namespace Halley {
 		String getName() const override { return "Variable"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/variable.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		String getLargeLabel(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -16,6 +19,7 @@ namespace Halley {
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 		EntityId doGetEntityId(ScriptEnvironment& environment, const ScriptGraphNode& node, GraphPinId pinN) const override;
 		void doSetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN, ConfigNode data) const override;
 		ConfigNode doGetDevConData(ScriptEnvironment& environment, const ScriptGraphNode& node) const override;
@@ -53,9 +57,12 @@ namespace Halley {
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		Vector<SettingType> getSettingTypes() const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 
 	private:
 		ConfigNode getConfigNode(const BaseGraphNode& node) const;
@@ -68,6 +75,7 @@ namespace Halley {
 		String getName() const override { return "Variable Table"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/variable_table.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		String getLargeLabel(const BaseGraphNode& node) const override;
@@ -106,9 +114,12 @@ namespace Halley {
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		Vector<SettingType> getSettingTypes() const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Variable; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 	};
 
 	class ScriptComparison final : public ScriptNodeTypeBase<void> {
@@ -117,6 +128,8 @@ namespace Halley {
 		String getName() const override { return "Comparison"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/comparison.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 		
 		String getLargeLabel(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -125,6 +138,7 @@ namespace Halley {
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 	};
 	
 	class ScriptArithmetic final : public ScriptNodeTypeBase<void> {
@@ -133,6 +147,8 @@ namespace Halley {
 		String getName() const override { return "Arithmetic"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/arithmetic.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		String getLargeLabel(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -141,6 +157,9 @@ namespace Halley {
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
+
+		static ConfigNode doArithmetic(MathOp op, const ConfigNode& a, const ConfigNode& b);
 	};
 	
 	class ScriptValueOr final : public ScriptNodeTypeBase<void> {
@@ -149,12 +168,15 @@ namespace Halley {
 		String getName() const override { return "Value Or"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/value_or.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 	};
 	
 	class ScriptConditionalOperator final : public ScriptNodeTypeBase<void> {
@@ -163,12 +185,15 @@ namespace Halley {
 		String getName() const override { return "Conditional Operator"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/value_or.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 	};
 	
 	class ScriptLerp final : public ScriptNodeTypeBase<void> {
@@ -177,6 +202,8 @@ namespace Halley {
 		String getName() const override { return "Lerp"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/lerp.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -193,6 +220,7 @@ namespace Halley {
 		String getName() const override { return "Advance Variable To"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/advanceTo.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool requiresMainThread() const override { return false; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		String getPinDescription(const BaseGraphNode& node, PinType elementType, GraphPinId elementIdx) const override;
@@ -209,6 +237,7 @@ namespace Halley {
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/set_variable.png"; }
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool requiresMainThread() const override { return false; }
 		Vector<SettingType> getSettingTypes() const override;
 		std::pair<String, Vector<ColourOverride>> getNodeDescription(const BaseGraphNode& node, const BaseGraph& graph) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -233,6 +262,7 @@ namespace Halley {
 		String getLabel(const BaseGraphNode& node) const override;
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/set_variable.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Action; }
+		bool requiresMainThread() const override { return false; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		bool hasDestructor(const ScriptGraphNode& node) const override { return true; }
@@ -250,6 +280,7 @@ namespace Halley {
 		String getName() const override { return "Conv EntityId->Data"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/convEntityIdToData.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -265,6 +296,7 @@ namespace Halley {
 		String getName() const override { return "Conv Data->EntityId"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/convDataToEntityId.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
 		
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -279,6 +311,8 @@ namespace Halley {
 		String getName() const override { return "To Vector2"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/toVector.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 		
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -286,6 +320,7 @@ namespace Halley {
 		String getPinDescription(const BaseGraphNode& node, PinType elementType, GraphPinId elementIdx) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 	};
 
 	class ScriptFromVector final : public ScriptNodeTypeBase<void> {
@@ -294,6 +329,8 @@ namespace Halley {
 		String getName() const override { return "From Vector2"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/fromVector.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 		
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -301,6 +338,7 @@ namespace Halley {
 		String getPinDescription(const BaseGraphNode& node, PinType elementType, GraphPinId elementIdx) const override;
 
 		ConfigNode doGetData(ScriptEnvironment& environment, const ScriptGraphNode& node, size_t pinN) const override;
+		bool compileData(ScriptDataCompiler& compiler, const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst) const override;
 	};
 
 	class ScriptInsertValueIntoMap final : public ScriptNodeTypeBase<void> {
@@ -309,6 +347,8 @@ namespace Halley {
 		String getName() const override { return "Insert Value->Map"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/convDataToEntityId.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -324,6 +364,8 @@ namespace Halley {
 		String getName() const override { return "Get Value<-Map"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/convEntityIdToData.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -339,6 +381,8 @@ namespace Halley {
 		String getName() const override { return "Pack Map"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/map_pack.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -355,6 +399,8 @@ namespace Halley {
 		String getName() const override { return "Unpack Map"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/map_unpack.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
@@ -371,6 +417,8 @@ namespace Halley {
 		String getName() const override { return "Insert Value->Sequence"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/convDataToEntityId.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -386,6 +434,8 @@ namespace Halley {
 		String getName() const override { return "Has Sequence Value"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/convEntityIdToData.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
@@ -401,6 +451,8 @@ namespace Halley {
 		String getName() const override { return "Size Of"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/size_of.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::Expression; }
+		bool requiresMainThread() const override { return false; }
+		bool isPureData() const override { return true; }
 
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
 		String getShortDescription(const ScriptGraphNode& node, const ScriptGraph& graph, GraphPinId elementIdx) const override;
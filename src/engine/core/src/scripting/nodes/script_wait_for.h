@@ -8,6 +8,7 @@ namespace Halley {
 		String getName() const override { return "Wait (Condition)"; }
 		String getIconName(const BaseGraphNode& node) const override { return "script_icons/wait_for.png"; }
 		ScriptNodeClassification getClassification() const override { return ScriptNodeClassification::FlowControl; }
+		bool requiresMainThread() const override { return false; }
 
 		Vector<SettingType> getSettingTypes() const override;
 		gsl::span<const PinType> getPinConfiguration(const BaseGraphNode& node) const override;
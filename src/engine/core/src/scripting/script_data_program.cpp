@@ -0,0 +1,278 @@
+#include "halley/scripting/script_data_program.h"
+
+#include "halley/maths/ops.h"
+#include "halley/scripting/script_environment.h"
+#include "halley/scripting/script_graph.h"
+#include "halley/scripting/script_node_type.h"
+#include "halley/utils/algorithm.h"
+#include "nodes/script_node_variables.h"
+using namespace Halley;
+
+namespace {
+	bool tryArithmetic(MathOp op, const ScriptDataValue& a, const ScriptDataValue& b, ScriptDataValue& dst)
+	{
+		// Same promotion rules as ScriptArithmetic, for the common cases
+		using Type = ScriptDataValue::Type;
+		const auto aType = a.getType();
+		const auto bType = b.getType();
+		if (aType == Type::Int && bType == Type::Int) {
+			dst.setInt(MathOps::apply(op, a.getInt(), b.getInt()));
+		} else if ((aType == Type::Float || aType == Type::Int) && (bType == Type::Float || bType == Type::Int)) {
+			dst.setFloat(MathOps::apply(op, a.asFloat(), b.asFloat()));
+		} else if (aType == Type::Vector2f && bType == Type::Vector2f) {
+			dst.setVector2f(MathOps::apply(op, a.getVector2f(), b.getVector2f()));
+		} else {
+			return false;
+		}
+		return true;
+	}
+
+	bool tryCompare(MathRelOp op, const ScriptDataValue& a, const ScriptDataValue& b, ScriptDataValue& dst)
+	{
+		// Same rules as ConfigNode::compareTo, for the common cases
+		using Type = ScriptDataValue::Type;
+		const auto aType = a.getType();
+		const auto bType = b.getType();
+		if (aType == Type::Int && bType == Type::Int) {
+			dst.setBool(MathOps::compare(op, a.getInt(), b.getInt()));
+		} else if ((aType == Type::Float || aType == Type::Int) && (bType == Type::Float || bType == Type::Int)) {
+			dst.setBool(MathOps::compare(op, a.asFloat(), b.asFloat()));
+		} else if (aType == Type::Bool && bType == Type::Bool) {
+			dst.setBool(MathOps::compare(op, a.asBool(), b.asBool()));
+		} else {
+			return false;
+		}
+		return true;
+	}
+}
+
+const ScriptDataValue& ScriptDataProgram::run(ScriptEnvironment& environment, const EntryPoint& entryPoint, Vector<ScriptDataValue>& registers, size_t base) const
+{
+	// Note that a Fallback can run other programs and resize registers, so no references to it are kept across instructions
+	const auto& nodes = environment.getCurrentGraph()->getNodes();
+	auto reg = [&] (ScriptDataRegister idx) -> ScriptDataValue& { return registers[base + idx]; };
+
+	for (size_t pc = entryPoint.start; ; ++pc) {
+		const auto& instr = code[pc];
+
+		switch (instr.op) {
+		case ScriptDataOpCode::LoadConstant:
+			reg(instr.dst).set(constants[instr.arg]);
+			break;
+
+		case ScriptDataOpCode::LoadVariable:
+			if (const auto* value = environment.getVariables(static_cast<ScriptVariableScope>(instr.param)).tryGetValue(variables[instr.arg])) {
+				reg(instr.dst).set(*value);
+			} else {
+				reg(instr.dst).setUndefined();
+			}
+			break;
+
+		case ScriptDataOpCode::Fallback:
+			{
+				const auto& node = nodes[instr.arg];
+				auto value = node.getNodeType().getData(environment, node, instr.a, environment.getNodeData(node.getId()));
+				reg(instr.dst).set(std::move(value));
+			}
+			break;
+
+		case ScriptDataOpCode::ToBool:
+			reg(instr.dst).setBool(reg(instr.a).asBool());
+			break;
+
+		case ScriptDataOpCode::Not:
+			reg(instr.dst).setBool(!reg(instr.a).asBool());
+			break;
+
+		case ScriptDataOpCode::Xor:
+			reg(instr.dst).setBool(reg(instr.a).asBool() != reg(instr.b).asBool());
+			break;
+
+		case ScriptDataOpCode::Arithmetic:
+			{
+				const auto op = static_cast<MathOp>(instr.param);
+				if (!tryArithmetic(op, reg(instr.a), reg(instr.b), reg(instr.dst))) {
+					auto value = ScriptArithmetic::doArithmetic(op, reg(instr.a).toConfigNode(), reg(instr.b).toConfigNode());
+					reg(instr.dst).set(std::move(value));
+				}
+			}
+			break;
+
+		case ScriptDataOpCode::Compare:
+			{
+				const auto op = static_cast<MathRelOp>(instr.param);
+				if (!tryCompare(op, reg(instr.a), reg(instr.b), reg(instr.dst))) {
+					reg(instr.dst).setBool(reg(instr.a).toConfigNode().compareTo(op, reg(instr.b).toConfigNode()));
+				}
+			}
+			break;
+
+		case ScriptDataOpCode::MakeVector:
+			{
+				const float x = reg(instr.a).asFloat();
+				const float y = reg(instr.b).asFloat();
+				reg(instr.dst).setVector2f(Vector2f(x, y));
+			}
+			break;
+
+		case ScriptDataOpCode::VectorX:
+			reg(instr.dst).setFloat(reg(instr.a).asVector2f().x);
+			break;
+
+		case ScriptDataOpCode::VectorY:
+			reg(instr.dst).setFloat(reg(instr.a).asVector2f().y);
+			break;
+
+		case ScriptDataOpCode::Jump:
+			pc = instr.arg - 1;
+			break;
+
+		case ScriptDataOpCode::JumpIfFalse:
+			if (!reg(instr.a).asBool()) {
+				pc = instr.arg - 1;
+			}
+			break;
+
+		case ScriptDataOpCode::JumpIfTrue:
+			if (reg(instr.a).asBool()) {
+				pc = instr.arg - 1;
+			}
+			break;
+
+		case ScriptDataOpCode::JumpIfDefined:
+			if (reg(instr.a).getType() != ScriptDataValue::Type::Undefined) {
+				pc = instr.arg - 1;
+			}
+			break;
+
+		case ScriptDataOpCode::Return:
+			return reg(instr.a);
+		}
+	}
+}
+
+
+ScriptDataCompiler::ScriptDataCompiler(const ScriptGraph& graph)
+	: graph(graph)
+{
+}
+
+std::shared_ptr<ScriptDataProgram> ScriptDataCompiler::compile()
+{
+	program = std::make_shared<ScriptDataProgram>();
+	program->graphHash = graph.getHash();
+
+	const auto& nodes = graph.getNodes();
+	program->nodePinStart.reserve(nodes.size() + 1);
+	for (const auto& node: nodes) {
+		program->nodePinStart.push_back(static_cast<uint32_t>(program->pinEntryPoint.size()));
+
+		const auto& pins = node.getPins();
+		const auto& pinConfig = node.getNodeType().getPinConfiguration(node);
+		for (size_t i = 0; i < pins.size(); ++i) {
+			int32_t entryIdx = -1;
+
+			const bool isDataInput = i < pinConfig.size() && pinConfig[i].type == GraphElementType(ScriptNodeElementType::ReadDataPin) && pinConfig[i].direction == GraphNodePinDirection::Input;
+			if (isDataInput && !pins[i].connections.empty() && pins[i].connections[0].dstNode) {
+				const auto start = program->code.size();
+				nRegisters = 0;
+				const auto dst = allocateRegister();
+				compileInput(node, static_cast<GraphPinId>(i), dst);
+
+				if (program->code.size() == start + 1 && program->code[start].op == ScriptDataOpCode::Fallback) {
+					// Nothing gained over calling getData() directly
+					program->code.resize(start);
+				} else {
+					emit(ScriptDataOpCode::Return, 0, dst);
+					entryIdx = static_cast<int32_t>(program->entryPoints.size());
+					program->entryPoints.push_back(ScriptDataProgram::EntryPoint{ static_cast<uint32_t>(start), nRegisters });
+				}
+			}
+
+			program->pinEntryPoint.push_back(entryIdx);
+		}
+	}
+	program->nodePinStart.push_back(static_cast<uint32_t>(program->pinEntryPoint.size()));
+
+	return std::move(program);
+}
+
+ScriptDataRegister ScriptDataCompiler::allocateRegister()
+{
+	Expects(nRegisters < std::numeric_limits<ScriptDataRegister>::max());
+	return nRegisters++;
+}
+
+void ScriptDataCompiler::compileInput(const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst)
+{
+	const auto& pins = node.getPins();
+	if (pinN >= pins.size() || pins[pinN].connections.empty() || !pins[pinN].connections[0].dstNode) {
+		emitConstant(dst, ConfigNode());
+		return;
+	}
+
+	const auto& conn = pins[pinN].connections[0];
+	compileOutput(graph.getNodes()[conn.dstNode.value()], conn.dstPin, dst);
+}
+
+ScriptDataRegister ScriptDataCompiler::compileInput(const ScriptGraphNode& node, GraphPinId pinN)
+{
+	const auto dst = allocateRegister();
+	compileInput(node, pinN, dst);
+	return dst;
+}
+
+void ScriptDataCompiler::compileOutput(const ScriptGraphNode& node, GraphPinId pinN, ScriptDataRegister dst)
+{
+	const auto start = program->code.size();
+
+	bool ok = false;
+	if (depth < maxDepth) {
+		++depth;
+		try {
+			ok = node.getNodeType().compileData(*this, node, pinN, dst);
+		} catch (const std::exception&) {
+			// e.g. bad node settings, leave it to getData() to report at runtime, like it does without compilation
+			ok = false;
+		}
+		--depth;
+	}
+
+	if (!ok) {
+		program->code.resize(start);
+		emit(ScriptDataOpCode::Fallback, dst, pinN, 0, 0, node.getId());
+	}
+}
+
+void ScriptDataCompiler::emit(ScriptDataOpCode op, ScriptDataRegister dst, ScriptDataRegister a, ScriptDataRegister b, uint8_t param, uint32_t arg)
+{
+	program->code.push_back(ScriptDataInstruction{ op, param, dst, a, b, arg });
+}
+
+void ScriptDataCompiler::emitConstant(ScriptDataRegister dst, const ConfigNode& value)
+{
+	const auto idx = static_cast<uint32_t>(program->constants.size());
+	program->constants.emplace_back(value);
+	emit(ScriptDataOpCode::LoadConstant, dst, 0, 0, 0, idx);
+}
+
+uint32_t ScriptDataCompiler::addVariable(const String& name)
+{
+	const auto iter = std_ex::find_if(program->variables, [&] (const ScriptVariableKey& key) { return key.getName() == name; });
+	if (iter != program->variables.end()) {
+		return static_cast<uint32_t>(iter - program->variables.begin());
+	}
+	program->variables.push_back(ScriptVariableKey(name));
+	return static_cast<uint32_t>(program->variables.size() - 1);
+}
+
+size_t ScriptDataCompiler::emitJump(ScriptDataOpCode op, ScriptDataRegister cond)
+{
+	emit(op, 0, cond);
+	return program->code.size() - 1;
+}
+
+void ScriptDataCompiler::patchJump(size_t jumpInstruction)
+{
+	program->code[jumpInstruction].arg = static_cast<uint32_t>(program->code.size());
+}
@@ -0,0 +1,136 @@
+#include "halley/scripting/script_data_value.h"
+#include "halley/entity/entity_id.h"
+using namespace Halley;
+
+ScriptDataValue::ScriptDataValue(const ConfigNode& node)
+{
+	set(node);
+}
+
+void ScriptDataValue::set(const ConfigNode& node)
+{
+	switch (node.getType()) {
+	case ConfigNodeType::Undefined:
+		type = Type::Undefined;
+		break;
+	case ConfigNodeType::Bool:
+		setBool(node.asBool());
+		break;
+	case ConfigNodeType::Int:
+		setInt(node.asInt());
+		break;
+	case ConfigNodeType::Float:
+		setFloat(node.asFloat());
+		break;
+	case ConfigNodeType::Float2:
+		setVector2f(node.asVector2f());
+		break;
+	case ConfigNodeType::EntityId:
+		type = Type::EntityId;
+		e = node.asInt64();
+		break;
+	default:
+		type = Type::Boxed;
+		boxed = node;
+	}
+}
+
+void ScriptDataValue::set(const ScriptDataValue& other)
+{
+	// Avoids touching the boxed value unless it's needed
+	type = other.type;
+	if (type == Type::Boxed) {
+		boxed = other.boxed;
+	} else {
+		e = other.e;
+	}
+}
+
+void ScriptDataValue::set(ConfigNode&& node)
+{
+	switch (node.getType()) {
+	case ConfigNodeType::Undefined:
+	case ConfigNodeType::Bool:
+	case ConfigNodeType::Int:
+	case ConfigNodeType::Float:
+	case ConfigNodeType::Float2:
+	case ConfigNodeType::EntityId:
+		set(static_cast<const ConfigNode&>(node));
+		break;
+	default:
+		type = Type::Boxed;
+		boxed = std::move(node);
+	}
+}
+
+bool ScriptDataValue::asBool() const
+{
+	switch (type) {
+	case Type::Undefined:
+		return false;
+	case Type::Bool:
+		return b;
+	case Type::Int:
+		return i != 0;
+	case Type::Float:
+		return f != 0;
+	case Type::Vector2f:
+		return true;
+	case Type::EntityId:
+		return e != -1;
+	default:
+		return boxed.asBool(false);
+	}
+}
+
+float ScriptDataValue::asFloat() const
+{
+	switch (type) {
+	case Type::Undefined:
+		return 0.0f;
+	case Type::Bool:
+		return b ? 1.0f : 0.0f;
+	case Type::Int:
+		return static_cast<float>(i);
+	case Type::Float:
+		return f;
+	default:
+		return toConfigNode().asFloat(0);
+	}
+}
+
+Vector2f ScriptDataValue::asVector2f() const
+{
+	switch (type) {
+	case Type::Undefined:
+		return {};
+	case Type::Int:
+		return Vector2f(static_cast<float>(i), 0);
+	case Type::Float:
+		return Vector2f(f, 0);
+	case Type::Vector2f:
+		return getVector2f();
+	default:
+		return toConfigNode().asVector2f({});
+	}
+}
+
+ConfigNode ScriptDataValue::toConfigNode() const
+{
+	switch (type) {
+	case Type::Undefined:
+		return ConfigNode();
+	case Type::Bool:
+		return ConfigNode(b);
+	case Type::Int:
+		return ConfigNode(i);
+	case Type::Float:
+		return ConfigNode(f);
+	case Type::Vector2f:
+		return ConfigNode(getVector2f());
+	case Type::EntityId:
+		return ConfigNode(EntityId(e));
+	default:
+		return ConfigNode(boxed);
+	}
+}
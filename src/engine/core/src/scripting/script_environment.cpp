@@ -47,8 +47,10 @@ void ScriptEnvironment::update(Time time, ScriptState& graphState, EntityId curE
 
 	currentState = &graphState;
 	currentEntityVariables = &entityVariables;
-	currentGraph->assignTypes(*nodeTypeCollection);
+	assignTypes(*currentGraph);
 	currentEntity = curEntity;
+	graphState.invalidateDataCache();
+	graphState.startEvaluation();
 
 	try {
 		auto& threads = graphState.getThreads();
@@ -208,8 +210,10 @@ void ScriptEnvironment::stopState(ScriptState& graphState, EntityId curEntity, S
 
 	currentState = &graphState;
 	currentEntityVariables = &entityVariables;
-	currentGraph->assignTypes(*nodeTypeCollection);
+	assignTypes(*currentGraph);
 	currentEntity = curEntity;
+	graphState.invalidateDataCache();
+	graphState.startEvaluation();
 
 	if (allThreads) {
 		doTerminateState();
@@ -684,6 +688,11 @@ void ScriptEnvironment::sendEntityMessage(EntityMessageData message)
 
 void ScriptEnvironment::sendSystemMessage(SystemMessageData message)
 {
+	if (worker) {
+		systemOutbox.push_back(std::move(message));
+		return;
+	}
+
 	auto msg = world.deserializeSystemMessage(message.messageName, message.messageData);
 	const auto dst = msg->getMessageDestination();
 	const auto id = msg->getId();
@@ -828,6 +837,106 @@ IScriptStateData* ScriptEnvironment::getNodeData(GraphNodeId nodeId)
 void ScriptEnvironment::assignTypes(const ScriptGraph& graph)
 {
 	graph.assignTypes(*nodeTypeCollection);
+	graph.updateVariableKeys();
+	if (dataPinCompilationEnabled && !graph.getDataProgram()) {
+		graph.setDataProgram(ScriptDataCompiler(graph).compile());
+	}
+	if (dataCacheEnabled) {
+		graph.updatePureDataNodes();
+	}
+}
+
+void ScriptEnvironment::setDataPinCompilationEnabled(bool enabled)
+{
+	dataPinCompilationEnabled = enabled;
+}
+
+bool ScriptEnvironment::isDataPinCompilationEnabled() const
+{
+	return dataPinCompilationEnabled;
+}
+
+void ScriptEnvironment::setDataCacheEnabled(bool enabled)
+{
+	dataCacheEnabled = enabled;
+}
+
+bool ScriptEnvironment::isDataCacheEnabled() const
+{
+	return dataCacheEnabled;
+}
+
+const ScriptEnvironment::DataCacheStats& ScriptEnvironment::getDataCacheStats() const
+{
+	return dataCacheStats;
+}
+
+void ScriptEnvironment::resetDataCacheStats()
+{
+	dataCacheStats = {};
+}
+
+uint32_t ScriptEnvironment::getDataCacheGeneration()
+{
+	if (!dataCacheEnabled || !currentState) {
+		return 0;
+	}
+	return currentState->getDataCacheGeneration(currentEntityVariables);
+}
+
+uint32_t ScriptEnvironment::getEvaluationId() const
+{
+	return currentState ? currentState->getEvaluationId() : 0;
+}
+
+std::unique_ptr<ScriptEnvironment> ScriptEnvironment::makeWorker() const
+{
+	auto result = std::make_unique<ScriptEnvironment>(api, world, resources, nodeTypeCollection, isHost);
+	result->worker = true;
+	return result;
+}
+
+void ScriptEnvironment::prepareWorker(ScriptEnvironment& worker) const
+{
+	Expects(worker.worker);
+
+	worker.isHost = isHost;
+	worker.inputEnabled = inputEnabled;
+	worker.variableTable = variableTable;
+	worker.scriptTargetRetriever = scriptTargetRetriever;
+	worker.dataPinCompilationEnabled = dataPinCompilationEnabled;
+	worker.dataCacheEnabled = dataCacheEnabled;
+}
+
+void ScriptEnvironment::mergeWorker(ScriptEnvironment& worker)
+{
+	Expects(worker.worker);
+
+	for (auto& msg: worker.scriptOutbox) {
+		scriptOutbox.push_back(std::move(msg));
+	}
+	for (auto& msg: worker.entityOutbox) {
+		entityOutbox.push_back(std::move(msg));
+	}
+	for (auto& request: worker.scriptExecutionRequestOutbox) {
+		scriptExecutionRequestOutbox.push_back(std::move(request));
+	}
+	for (auto& msg: worker.systemOutbox) {
+		sendSystemMessage(std::move(msg));
+	}
+	worker.scriptOutbox.clear();
+	worker.entityOutbox.clear();
+	worker.scriptExecutionRequestOutbox.clear();
+	worker.systemOutbox.clear();
+
+	dataCacheStats.evaluations += worker.dataCacheStats.evaluations;
+	dataCacheStats.savedEvaluations += worker.dataCacheStats.savedEvaluations;
+	worker.resetDataCacheStats();
+}
+
+bool ScriptEnvironment::isWorker() const
+{
+	return worker;
 }
 
 ConfigNode ScriptEnvironment::readInputDataPin(const ScriptGraphNode& node, GraphPinId pinN)
@@ -844,9 +953,86 @@ ConfigNode ScriptEnvironment::readInputDataPin(const ScriptGraphNode& node, Grap
 	assert(pin.connections.size() == 1);
 
 	const auto& dst = pin.connections[0];
-	const auto& nodes = currentGraph->getNodes();
-	const auto& dstNode = nodes[dst.dstNode.value()];
-	return dstNode.getNodeType().getData(*this, dstNode, dst.dstPin, getNodeData(dst.dstNode.value()));
+	const auto dstNodeId = dst.dstNode.value();
+	if (dataCacheEnabled && currentGraph->isPureDataNode(dstNodeId)) {
+		const auto generation = getDataCacheGeneration();
+		if (const auto* cached = currentState->getCachedData(dstNodeId, dst.dstPin, generation)) {
+			++dataCacheStats.savedEvaluations;
+			return ConfigNode(*cached);
+		}
+
+		++dataCacheStats.evaluations;
+		auto result = evaluateInputDataPin(node, pinN, dst);
+		currentState->setCachedData(dstNodeId, dst.dstPin, generation, ConfigNode(result));
+		return result;
+	}
+
+	return evaluateInputDataPin(node, pinN, dst);
+}
+
+ConfigNode ScriptEnvironment::evaluateInputDataPin(const ScriptGraphNode& node, GraphPinId pinN, const ScriptGraphNode::PinConnection& connection)
+{
+	if (dataPinCompilationEnabled) {
+		if (const auto* program = currentGraph->getDataProgram()) {
+			if (const auto* entryPoint = program->getEntryPoint(node.getId(), pinN)) {
+				return runDataProgram<ConfigNode>(*program, *entryPoint);
+			}
+		}
+	}
+
+	const auto& dstNode = currentGraph->getNodes()[connection.dstNode.value()];
+	return dstNode.getNodeType().getData(*this, dstNode, connection.dstPin, getNodeData(connection.dstNode.value()));
+}
+
+ScriptDataValue ScriptEnvironment::readInputDataValue(const ScriptGraphNode& node, GraphPinId pinN)
+{
+	const auto& pins = node.getPins();
+	if (pinN >= pins.size()) {
+		return {};
+	}
+
+	const auto& pin = pins[pinN];
+	if (pin.connections.empty() || !pin.connections[0].dstNode) {
+		return {};
+	}
+
+	// Cached values are already boxed
+	const bool cached = dataCacheEnabled && currentGraph->isPureDataNode(pin.connections[0].dstNode.value());
+	if (dataPinCompilationEnabled && !cached) {
+		if (const auto* program = currentGraph->getDataProgram()) {
+			if (const auto* entryPoint = program->getEntryPoint(node.getId(), pinN)) {
+				return runDataProgram<ScriptDataValue>(*program, *entryPoint);
+			}
+		}
+	}
+
+	return ScriptDataValue(readInputDataPin(node, pinN));
+}
+
+template <typename T>
+T ScriptEnvironment::runDataProgram(const ScriptDataProgram& program, const ScriptDataProgram::EntryPoint& entryPoint)
+{
+	// Programs can nest (through Fallback instructions), so registers are allocated as a stack
+	const auto base = dataRegistersUsed;
+	dataRegistersUsed += entryPoint.nRegisters;
+	if (dataRegisters.size() < dataRegistersUsed) {
+		dataRegisters.resize(dataRegistersUsed);
+	}
+
+	try {
+		T result;
+		const auto& value = program.run(*this, entryPoint, dataRegisters, base);
+		if constexpr (std::is_same_v<T, ConfigNode>) {
+			result = value.toConfigNode();
+		} else {
+			result.set(value);
+		}
+		dataRegistersUsed = base;
+		return result;
+	} catch (...) {
+		dataRegistersUsed = base;
+		throw;
+	}
 }
 
 ConfigNode ScriptEnvironment::readOutputDataPin(const ScriptGraphNode& node, GraphPinId pinN)
@@ -960,8 +1146,9 @@ ConfigNode ScriptEnvironment::readNodeElementDevConData(ScriptState& graphState,
 	currentGraph = graphState.getScriptGraphPtr();
 	currentState = &graphState;
 	currentEntityVariables = &entityVariables;
-	currentGraph->assignTypes(*nodeTypeCollection);
+	assignTypes(*currentGraph);
 	currentEntity = curEntity;
+	graphState.startEvaluation();
 
 	ConfigNode result = [&] () -> ConfigNode {
 		const auto& node = graphState.getScriptGraphPtr()->getNodes().at(nodeId);
@@ -6,6 +6,7 @@
 #include "halley/utils/algorithm.h"
 #include "halley/utils/hash.h"
 #include "nodes/script_messaging.h"
+#include "halley/scripting/script_data_program.h"
 #include "halley/scripting/script_node_type.h"
 using namespace Halley;
 
@@ -506,6 +507,121 @@ const ScriptGraph* ScriptGraph::getPreviousVersion(uint64_t hash) const
 	return previousVersion.get();
 }
 
+const ScriptDataProgram* ScriptGraph::getDataProgram() const
+{
+	if (!dataProgram || dataProgram->getGraphHash() != hash) {
+		return nullptr;
+	}
+	return dataProgram.get();
+}
+
+void ScriptGraph::setDataProgram(std::shared_ptr<const ScriptDataProgram> program) const
+{
+	dataProgram = std::move(program);
+}
+
+namespace {
+	enum class PureDataState : uint8_t {
+		Unknown,
+		Visiting,
+		Pure,
+		Impure
+	};
+}
+
+bool ScriptGraph::isPureDataNode(GraphNodeId nodeId) const
+{
+	return pureDataNodesHash == hash && nodeId < pureDataNodes.size() && pureDataNodes[nodeId] == static_cast<uint8_t>(PureDataState::Pure);
+}
+
+void ScriptGraph::updatePureDataNodes() const
+{
+	if (pureDataNodesHash == hash && pureDataNodes.size() == nodes.size()) {
+		return;
+	}
+
+	pureDataNodes.clear();
+	pureDataNodes.resize(nodes.size(), static_cast<uint8_t>(PureDataState::Unknown));
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		computePureDataNode(static_cast<GraphNodeId>(i));
+	}
+	pureDataNodesHash = hash;
+}
+
+const ScriptVariableKey& ScriptGraph::getVariableKey(const ScriptGraphNode& node) const
+{
+	if (variableKeysHash != hash || variableKeys.size() != nodes.size()) {
+		// Not resolved yet, this is only expected outside of ScriptEnvironment (e.g. in tools)
+		static thread_local ScriptVariableKey key;
+		key = ScriptVariableKey(node.getSettings()["variable"].asString(""));
+		return key;
+	}
+	return variableKeys[node.getId()];
+}
+
+void ScriptGraph::updateVariableKeys() const
+{
+	if (variableKeysHash == hash && variableKeys.size() == nodes.size()) {
+		return;
+	}
+
+	variableKeys.clear();
+	variableKeys.reserve(nodes.size());
+	for (const auto& node: nodes) {
+		const auto& settings = node.getSettings();
+		if (settings.getType() == ConfigNodeType::Map && settings.hasKey("variable")) {
+			variableKeys.push_back(ScriptVariableKey(settings["variable"].asString("")));
+		} else {
+			variableKeys.emplace_back();
+		}
+	}
+	variableKeysHash = hash;
+}
+
+bool ScriptGraph::requiresMainThread() const
+{
+	if (!mainThreadRequirement || mainThreadRequirement->first != hash) {
+		const bool required = std::any_of(nodes.begin(), nodes.end(), [] (const ScriptGraphNode& node) { return node.getNodeType().requiresMainThread(); });
+		mainThreadRequirement = std::pair<uint64_t, bool>(hash, required);
+	}
+	return mainThreadRequirement->second;
+}
+
+bool ScriptGraph::computePureDataNode(GraphNodeId nodeId) const
+{
+	auto& state = pureDataNodes[nodeId];
+	if (state != static_cast<uint8_t>(PureDataState::Unknown)) {
+		// Cycles are treated as impure
+		return state == static_cast<uint8_t>(PureDataState::Pure);
+	}
+
+	const auto& node = nodes[nodeId];
+	if (!node.getNodeType().isPureData()) {
+		state = static_cast<uint8_t>(PureDataState::Impure);
+		return false;
+	}
+
+	state = static_cast<uint8_t>(PureDataState::Visiting);
+	bool pure = true;
+	const auto& pinConfig = node.getNodeType().getPinConfiguration(node);
+	const auto& pins = node.getPins();
+	for (size_t i = 0; i < pins.size() && pure; ++i) {
+		const bool isInput = i < pinConfig.size() && pinConfig[i].direction == GraphNodePinDirection::Input;
+		const auto type = i < pinConfig.size() ? ScriptNodeElementType(pinConfig[i].type) : ScriptNodeElementType::Undefined;
+		if (isInput && (type == ScriptNodeElementType::ReadDataPin || type == ScriptNodeElementType::TargetPin)) {
+			for (const auto& conn: pins[i].connections) {
+				if (conn.dstNode && !computePureDataNode(conn.dstNode.value())) {
+					pure = false;
+					break;
+				}
+			}
+		}
+	}
+
+	pureDataNodes[nodeId] = static_cast<uint8_t>(pure ? PureDataState::Pure : PureDataState::Impure);
+	return pure;
+}
+
 ConfigNode& ScriptGraph::getProperties()
 {
 	return properties;
@@ -0,0 +1,92 @@
+#include "halley/scripting/script_parallel_updater.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/scripting/script_environment.h"
+#include "halley/scripting/script_state.h"
+#include "halley/scripting/script_state_set.h"
+
+using namespace Halley;
+
+bool ScriptParallelUpdater::canUpdateInParallel(ScriptEnvironment& env, const ScriptStateSet& states)
+{
+	bool hasPending = false;
+	for (auto& state: states) {
+		if (!state->getFrameFlag()) {
+			const auto& graph = *state->getScriptGraphPtr();
+
+			// Types are assigned here, as graphs are shared between entities
+			env.assignTypes(graph);
+			if (graph.requiresMainThread()) {
+				return false;
+			}
+
+			// Reloaded scripts need to terminate the previous version, which might need the main thread
+			if (state->hasStarted() && state->getGraphHash() != graph.getHash()) {
+				return false;
+			}
+
+			hasPending = true;
+		}
+	}
+	return hasPending;
+}
+
+void ScriptParallelUpdater::update(ScriptEnvironment& env, gsl::span<const Entity> entities, Time t, size_t minEntitiesPerChunk)
+{
+	const size_t nThreads = Executors::hasInstance() ? Executors::getCPU().threadCount() : 0;
+	if (nThreads == 0) {
+		return;
+	}
+
+	const size_t nChunks = std::min(nThreads + 1, entities.size() / std::max(minEntitiesPerChunk, size_t(1)));
+	if (nChunks <= 1) {
+		return;
+	}
+
+	while (workers.size() < nChunks) {
+		workers.push_back(env.makeWorker());
+	}
+
+	const size_t chunkSize = (entities.size() + nChunks - 1) / nChunks;
+	auto getChunk = [&] (size_t i)
+	{
+		const size_t start = std::min(i * chunkSize, entities.size());
+		const size_t end = std::min(start + chunkSize, entities.size());
+		return entities.subspan(start, end - start);
+	};
+
+	for (size_t i = 0; i < nChunks; ++i) {
+		env.prepareWorker(*workers[i]);
+	}
+
+	Vector<Future<void>> tasks;
+	tasks.reserve(nChunks - 1);
+	for (size_t i = 1; i < nChunks; ++i) {
+		tasks.push_back(Concurrent::execute(Executors::getCPU(), [t, &worker = *workers[i], chunk = getChunk(i)] ()
+		{
+			updateChunk(worker, chunk, t);
+		}));
+	}
+	updateChunk(*workers[0], getChunk(0), t);
+	Concurrent::whenAll(tasks.begin(), tasks.end()).wait();
+
+	// Merge in chunk order, so the results are the same as a serial update
+	for (size_t i = 0; i < nChunks; ++i) {
+		env.mergeWorker(*workers[i]);
+	}
+}
+
+void ScriptParallelUpdater::updateChunk(ScriptEnvironment& env, gsl::span<const Entity> entities, Time t)
+{
+	for (const auto& e: entities) {
+		for (auto& state: *e.states) {
+			if (!state->getFrameFlag()) {
+				env.update(t, *state, e.entityId, *e.variables);
+				state->setFrameFlag(true);
+			}
+
+			if (env.hasStopRequests()) {
+				break;
+			}
+		}
+	}
+}
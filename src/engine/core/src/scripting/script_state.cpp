@@ -1,3 +1,4 @@
+#include <atomic>
 #include <utility>
 
 #include "halley/scripting/script_state.h"
@@ -158,7 +159,8 @@ std::optional<uint8_t> ScriptStateThread::getNetworkOwnerId() const
 
 void ScriptStateThread::generateId()
 {
-	static uint32_t nextId = 0;
+	// Script states can be updated from several threads, see ScriptEnvironment::makeWorker
+	static std::atomic<uint32_t> nextId { 0 };
 	uniqueId = nextId++;
 }
 
@@ -499,6 +501,8 @@ void ScriptState::start(uint64_t hash)
 	localVars.clear();
 	sharedVars.clear();
 	nodeState.clear();
+	dataCache.clear();
+	invalidateDataCache();
 	started = true;
 }
 
@@ -650,6 +654,8 @@ void ScriptState::offsetToNodeRange(Range<GraphNodeId> nodeRange)
 	}
 	nodeState.erase(nodeState.begin(), nodeState.begin() + nodeRange.start);
 	nodeState.resize(nodeRange.getLength());
+	dataCache.clear();
+	invalidateDataCache();
 }
 
 void ScriptState::setFutureNodeValue(GraphNodeId id, std::optional<Future<ConfigNode>> future)
@@ -665,6 +671,54 @@ std::optional<Future<ConfigNode>> ScriptState::getFutureNodeValue(GraphNodeId id
 	return std::nullopt;
 }
 
+uint32_t ScriptState::getDataCacheGeneration(const ScriptVariables* entityVariables)
+{
+	const std::array<uint32_t, 3> versions = { localVars.getVersion(), sharedVars.getVersion(), entityVariables ? entityVariables->getVersion() : 0 };
+	if (versions != dataCacheVariableVersions || entityVariables != dataCacheEntityVariables) {
+		dataCacheVariableVersions = versions;
+		dataCacheEntityVariables = entityVariables;
+		invalidateDataCache();
+	}
+	return dataCacheGeneration;
+}
+
+void ScriptState::invalidateDataCache()
+{
+	// Generation 0 is never valid, see CachedData
+	if (++dataCacheGeneration == 0) {
+		dataCache.clear();
+		dataCacheGeneration = 1;
+	}
+}
+
+const ConfigNode* ScriptState::getCachedData(GraphNodeId nodeId, GraphPinId pinId, uint32_t generation) const
+{
+	const auto iter = dataCache.find((static_cast<uint32_t>(nodeId) << 8) | pinId);
+	if (iter != dataCache.end() && iter->second.generation == generation) {
+		return &iter->second.value;
+	}
+	return nullptr;
+}
+
+void ScriptState::setCachedData(GraphNodeId nodeId, GraphPinId pinId, uint32_t generation, ConfigNode value)
+{
+	auto& entry = dataCache[(static_cast<uint32_t>(nodeId) << 8) | pinId];
+	entry.generation = generation;
+	entry.value = std::move(value);
+}
+
+uint32_t ScriptState::getEvaluationId() const
+{
+	return evaluationId;
+}
+
+void ScriptState::startEvaluation()
+{
+	if (++evaluationId == 0) {
+		evaluationId = 1;
+	}
+}
+
 ScriptState::NodeState& ScriptState::getNodeState(GraphNodeId nodeId)
 {
 	return nodeState.at(nodeId);
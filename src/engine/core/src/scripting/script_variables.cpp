@@ -1,9 +1,22 @@
 #include "halley/scripting/script_variables.h"
 #include "halley/bytes/config_node_serializer.h"
 #include "halley/entity/entity_id.h"
+#include "halley/utils/hash.h"
 
 using namespace Halley;
 
+ScriptVariableKey::ScriptVariableKey(String name)
+	: name(std::move(name))
+{
+	hash = Hash::hash(gsl::as_bytes(gsl::span<const char>(this->name.c_str(), this->name.length())));
+}
+
+ScriptVariableKey::ScriptVariableKey(String name, uint64_t hash)
+	: name(std::move(name))
+	, hash(hash)
+{
+}
+
 ScriptVariables::ScriptVariables(const ConfigNode& node, const EntitySerializationContext& context)
 {
 	load(node, context);
@@ -11,34 +24,42 @@ ScriptVariables::ScriptVariables(const ConfigNode& node, const EntitySerializati
 
 void ScriptVariables::load(const ConfigNode& node, const EntitySerializationContext& context)
 {
+	++version;
 	if (node.getType() == ConfigNodeType::Map) {
-		variables.clear();
+		slots.clear();
 		for (const auto& [k, v]: node.asMap()) {
 			if (k.startsWith("entity!")) {
 				context.debugCurrentContext = "ScriptVariables:" + k;
 				const auto entityId = ConfigNodeSerializer<EntityId>().deserialize(context, v);
 				context.debugCurrentContext = {};
-				variables[k.mid(7)] = entityId;
+				const auto key = ScriptVariableKey(k.mid(7));
+				getOrCreateSlot(key).value.set(ConfigNode(entityId));
 			} else {
-				variables[k] = v;
+				const auto key = ScriptVariableKey(k);
+				getOrCreateSlot(key).value.set(v);
 			}
 		}
 	} else if (node.getType() != ConfigNodeType::Undefined) {
 		for (const auto& [k, v]: node.asMap()) {
 			if (k.startsWith("entity!")) {
+				const auto key = ScriptVariableKey(k.mid(7));
 				if (v.getType() == ConfigNodeType::Del) {
-					variables.erase(k.mid(7));
+					eraseSlot(key);
 				} else {
 					context.debugCurrentContext = "ScriptVariables:" + k;
 					const auto entityId = ConfigNodeSerializer<EntityId>().deserialize(context, v);
 					context.debugCurrentContext = {};
-					variables[k.mid(7)] = entityId;
+					getOrCreateSlot(key).value.set(ConfigNode(entityId));
 				}
 			} else {
+				const auto key = ScriptVariableKey(k);
 				if (v.getType() == ConfigNodeType::Del) {
-					variables.erase(k);
+					eraseSlot(key);
 				} else {
-					variables[k].applyDelta(v);
+					auto& value = getOrCreateSlot(key).value;
+					auto data = value.toConfigNode();
+					data.applyDelta(v);
+					value.set(std::move(data));
 				}
 			}
 		}
@@ -48,43 +69,108 @@ void ScriptVariables::load(const ConfigNode& node, const EntitySerializationCont
 ConfigNode ScriptVariables::toConfigNode(const EntitySerializationContext& context) const
 {
 	ConfigNode::MapType result;
-	for (const auto& [k, v]: variables) {
-		if (v.getType() == ConfigNodeType::EntityId) {
-			result["entity!" + k] = ConfigNodeSerializer<EntityId>().serialize(v.asEntityId(), context);
+	for (const auto& slot: slots) {
+		if (slot.value.getType() == ScriptDataValue::Type::EntityId) {
+			result["entity!" + slot.name] = ConfigNodeSerializer<EntityId>().serialize(slot.value.toConfigNode().asEntityId(), context);
 		} else {
-			result[k] = v;
+			result[slot.name] = slot.value.toConfigNode();
 		}
 	}
 	return result;
 }
 
-const ConfigNode& ScriptVariables::getVariable(const String& name) const
+ConfigNode ScriptVariables::getVariable(const String& name) const
 {
-	const auto iter = variables.find(name);
-	if (iter != variables.end()) {
-		return iter->second;
+	return getVariable(ScriptVariableKey(name));
+}
+
+ConfigNode ScriptVariables::getVariable(const ScriptVariableKey& key) const
+{
+	if (const auto* slot = tryGetSlot(key)) {
+		return slot->value.toConfigNode();
 	}
-	return dummy;
+	return {};
 }
 
 void ScriptVariables::setVariable(const String& name, ConfigNode value)
 {
-	variables[name] = std::move(value);
+	setVariable(ScriptVariableKey(name), std::move(value));
+}
+
+void ScriptVariables::setVariable(const ScriptVariableKey& key, ConfigNode value)
+{
+	getOrCreateSlot(key).value.set(std::move(value));
+	++version;
 }
 
 bool ScriptVariables::hasVariable(const String& name) const
 {
-	return variables.find(name) != variables.end();
+	return hasVariable(ScriptVariableKey(name));
+}
+
+bool ScriptVariables::hasVariable(const ScriptVariableKey& key) const
+{
+	return tryGetSlot(key) != nullptr;
+}
+
+const ScriptDataValue* ScriptVariables::tryGetValue(const ScriptVariableKey& key) const
+{
+	const auto* slot = tryGetSlot(key);
+	return slot ? &slot->value : nullptr;
+}
+
+void ScriptVariables::setValue(const ScriptVariableKey& key, const ScriptDataValue& value)
+{
+	getOrCreateSlot(key).value.set(value);
+	++version;
 }
 
 bool ScriptVariables::empty() const
 {
-	return variables.empty();
+	return slots.empty();
 }
 
 void ScriptVariables::clear()
 {
-	variables.clear();
+	slots.clear();
+	++version;
+}
+
+std::pair<bool, size_t> ScriptVariables::findSlot(const ScriptVariableKey& key) const
+{
+	const auto hash = key.getHash();
+	auto iter = std::lower_bound(slots.begin(), slots.end(), hash, [] (const Slot& slot, uint64_t hash) { return slot.hash < hash; });
+
+	// Hashes can collide, so check every slot with this one
+	for (; iter != slots.end() && iter->hash == hash; ++iter) {
+		if (iter->name == key.getName()) {
+			return { true, static_cast<size_t>(iter - slots.begin()) };
+		}
+	}
+	return { false, static_cast<size_t>(iter - slots.begin()) };
+}
+
+const ScriptVariables::Slot* ScriptVariables::tryGetSlot(const ScriptVariableKey& key) const
+{
+	const auto [found, idx] = findSlot(key);
+	return found ? &slots[idx] : nullptr;
+}
+
+ScriptVariables::Slot& ScriptVariables::getOrCreateSlot(const ScriptVariableKey& key)
+{
+	const auto [found, idx] = findSlot(key);
+	if (found) {
+		return slots[idx];
+	}
+	return *slots.insert(slots.begin() + idx, Slot{ key.getHash(), key.getName(), ScriptDataValue() });
+}
+
+void ScriptVariables::eraseSlot(const ScriptVariableKey& key)
+{
+	const auto [found, idx] = findSlot(key);
+	if (found) {
+		slots.erase(slots.begin() + idx);
+	}
 }
 
 ConfigNode ConfigNodeSerializer<ScriptVariables>::serialize(const ScriptVariables& variables, const EntitySerializationContext& context)
@@ -39,15 +39,18 @@ void UIEventHandler::queue(UIEvent event, UIEventDirection direction)
 	eventQueue.emplace_back(std::move(event));
 }
 
-void UIEventHandler::pump()
+bool UIEventHandler::pump()
 {
+	bool handled = false;
 	while (!eventQueue.empty()) {
 		decltype(eventQueue) events = std::move(eventQueue);
 		eventQueue.clear();
 		for (auto& event: events) {
 			handle(event);
 		}
+		handled = true;
 	}
+	return handled;
 }
 
 void UIEventHandler::setWidget(UIWidget* uiWidget)
@@ -1,4 +1,5 @@
 #include "halley/ui/ui_painter.h"
+#include "halley/ui/ui_render_cache.h"
 #include "halley/graphics/sprite/sprite_painter.h"
 #include "halley/graphics/sprite/sprite.h"
 #include "halley/graphics/text/text_renderer.h"
@@ -18,6 +19,7 @@ UIPainter UIPainter::clone() const
 	result.clip = clip;
 	result.currentPriority = currentPriority;
 	result.colourMultiplier = colourMultiplier;
+	result.recording = recording;
 	return result;
 }
 
@@ -46,6 +48,20 @@ UIPainter UIPainter::withNoClip() const
 	return result;
 }
 
+UIPainter UIPainter::withRecording(UIRenderCache& cache) const
+{
+	cache.clear();
+	cache.mask = mask;
+	cache.layer = layer;
+	cache.clip = clip;
+	cache.colourMultiplier = colourMultiplier;
+	cache.valid = true;
+
+	auto result = clone();
+	result.recording = &cache;
+	return result;
+}
+
 UIPainter UIPainter::withAlpha(float alpha) const
 {
 	auto result = clone();
@@ -79,6 +95,11 @@ int UIPainter::getMask() const
 	return mask;
 }
 
+bool UIPainter::isRecording() const
+{
+	return recording != nullptr;
+}
+
 float UIPainter::getCurrentPriorityAndIncrement() const
 {
 	if (rootPainter) {
@@ -90,7 +111,10 @@ float UIPainter::getCurrentPriorityAndIncrement() const
 
 void UIPainter::draw(const Sprite& sprite, bool forceCopy)
 {
-	if (colourMultiplier) {
+	if (recording) {
+		recording->addEntry(UIRenderCache::EntryType::Sprites, recording->sprites.size(), mask, layer, clip);
+		recording->sprites.push_back(applyColour(sprite));
+	} else if (colourMultiplier) {
 		painter->add(applyColour(sprite), mask, layer, getCurrentPriorityAndIncrement(), clip);
 	} else if (forceCopy) {
 		painter->addCopy(sprite, mask, layer, getCurrentPriorityAndIncrement(), clip);
@@ -102,7 +126,10 @@ void UIPainter::draw(const Sprite& sprite, bool forceCopy)
 void UIPainter::draw(const TextRenderer& text, bool forceCopy)
 {
 	text.generateSprites();
-	if (colourMultiplier) {
+	if (recording) {
+		recording->addEntry(UIRenderCache::EntryType::Texts, recording->texts.size(), mask, layer, clip);
+		recording->texts.push_back(applyColour(text));
+	} else if (colourMultiplier) {
 		painter->add(applyColour(text), mask, layer, getCurrentPriorityAndIncrement(), clip);
 	} else if (forceCopy) {
 		painter->addCopy(text, mask, layer, getCurrentPriorityAndIncrement(), clip);
@@ -113,28 +140,74 @@ void UIPainter::draw(const TextRenderer& text, bool forceCopy)
 
 void UIPainter::draw(Sprite&& sprite)
 {
-	painter->add(applyColour(std::move(sprite)), mask, layer, getCurrentPriorityAndIncrement(), clip);
+	if (recording) {
+		recording->addEntry(UIRenderCache::EntryType::Sprites, recording->sprites.size(), mask, layer, clip);
+		recording->sprites.push_back(applyColour(std::move(sprite)));
+	} else {
+		painter->add(applyColour(std::move(sprite)), mask, layer, getCurrentPriorityAndIncrement(), clip);
+	}
 }
 
 void UIPainter::draw(TextRenderer&& text)
 {
-	painter->add(applyColour(std::move(text)), mask, layer, getCurrentPriorityAndIncrement(), clip);
+	if (recording) {
+		text.generateSprites();
+		recording->addEntry(UIRenderCache::EntryType::Texts, recording->texts.size(), mask, layer, clip);
+		recording->texts.push_back(applyColour(std::move(text)));
+	} else {
+		painter->add(applyColour(std::move(text)), mask, layer, getCurrentPriorityAndIncrement(), clip);
+	}
 }
 
 void UIPainter::draw(std::function<void(Painter&)> f)
 {
-	painter->add(std::move(f), mask, layer, getCurrentPriorityAndIncrement(), clip);
+	if (recording) {
+		recording->addEntry(UIRenderCache::EntryType::Callback, recording->callbacks.size(), mask, layer, clip);
+		recording->callbacks.push_back(std::move(f));
+	} else {
+		painter->add(std::move(f), mask, layer, getCurrentPriorityAndIncrement(), clip);
+	}
 }
 
 void UIPainter::addBounds(Rect4f bounds)
 {
-	if (clip && clip->overlaps(bounds)) {
-		painter->add(clip->intersection(bounds));
+	const auto rect = clip && clip->overlaps(bounds) ? clip->intersection(bounds) : bounds;
+	if (recording) {
+		recording->bounds.push_back(rect);
 	} else {
+		painter->add(rect);
+	}
+}
+
+void UIPainter::draw(const UIRenderCache& cache)
+{
+	Expects(!recording);
+
+	for (const auto& entry: cache.entries) {
+		const auto priority = getCurrentPriorityAndIncrement();
+		switch (entry.type) {
+		case UIRenderCache::EntryType::Sprites:
+			painter->add(gsl::span<const Sprite>(cache.sprites).subspan(entry.start, entry.count), entry.mask, entry.layer, priority, entry.clip);
+			break;
+		case UIRenderCache::EntryType::Texts:
+			painter->add(gsl::span<const TextRenderer>(cache.texts).subspan(entry.start, entry.count), entry.mask, entry.layer, priority, entry.clip);
+			break;
+		case UIRenderCache::EntryType::Callback:
+			painter->add(cache.callbacks[entry.start], entry.mask, entry.layer, priority, entry.clip);
+			break;
+		}
+	}
+
+	for (const auto& bounds: cache.bounds) {
 		painter->add(bounds);
 	}
 }
 
+bool UIPainter::canDraw(const UIRenderCache& cache) const
+{
+	return cache.valid && cache.mask == mask && cache.layer == layer && cache.clip == clip && cache.colourMultiplier == colourMultiplier;
+}
+
 TextRenderer UIPainter::applyColour(TextRenderer text) const
 {
 	if (colourMultiplier) {
@@ -0,0 +1,39 @@
+#include "halley/ui/ui_render_cache.h"
+using namespace Halley;
+
+bool UIRenderCache::isValid() const
+{
+	return valid;
+}
+
+void UIRenderCache::invalidate()
+{
+	valid = false;
+}
+
+void UIRenderCache::clear()
+{
+	entries.clear();
+	sprites.clear();
+	texts.clear();
+	callbacks.clear();
+	bounds.clear();
+	valid = false;
+}
+
+size_t UIRenderCache::getNumberOfEntries() const
+{
+	return entries.size();
+}
+
+void UIRenderCache::addEntry(EntryType type, size_t index, int mask, int layer, const std::optional<Rect4f>& clip)
+{
+	if (type != EntryType::Callback && !entries.empty()) {
+		auto& last = entries.back();
+		if (last.type == type && last.mask == mask && last.layer == layer && last.clip == clip && last.start + last.count == index) {
+			++last.count;
+			return;
+		}
+	}
+	entries.push_back(Entry{ type, mask, layer, clip, index, 1 });
+}
@@ -75,11 +75,23 @@ void UIRoot::updateWidgets(UIWidgetUpdateType type, Time t, UIInputType activeIn
 	widgetsCache.clear();
 	for (auto& c: getChildren()) {
 		assert(c->getRoot() == this);
-		widgetsCache.push_back(c);
+		widgetsCache.push_back(c.get());
 	}
 
+	// Removing a widget bumps the generation, after which queued widgets need checking that they're still in the tree
+	updatingWidgets = true;
+	const auto generation = widgetsGeneration;
+	auto isDetached = [&] (const UIWidget& w)
+	{
+		return widgetsGeneration != generation && w.getRoot() != this;
+	};
+
 	for (size_t i = 0; i < widgetsCache.size(); ++i) {
-		auto& w = widgetsCache[i];
+		auto* w = widgetsCache[i];
+		if (isDetached(*w)) {
+			continue;
+		}
+
 		if (w->getParent() && w->getParent()->isGuardedUpdate()) {
 			bool crashed = false;
 			try {
@@ -101,12 +113,17 @@ void UIRoot::updateWidgets(UIWidgetUpdateType type, Time t, UIInputType activeIn
 	}
 
 	for (int i = static_cast<int>(widgetsCache.size()); --i >= 0; ) {
-		auto& w = widgetsCache[i];
+		auto* w = widgetsCache[i];
+		if (isDetached(*w)) {
+			continue;
+		}
 		assert(w->getRoot() == this);
 		w->doPostUpdate();
 	}
 
+	updatingWidgets = false;
 	widgetsCache.clear();
+	widgetsRemovedDuringUpdate.clear();
 }
 
 void UIRoot::update(Time t, UIInputType activeInputType, spInputDevice mouse, spInputDevice manual)
@@ -703,6 +720,13 @@ void UIRoot::focusNext(bool reverse)
 
 void UIRoot::onWidgetRemoved(const UIWidget& widget)
 {
+	if (updatingWidgets) {
+		++widgetsGeneration;
+		if (auto w = widget.weak_from_this().lock()) {
+			widgetsRemovedDuringUpdate.push_back(std::move(w));
+		}
+	}
+
 	auto focus = currentFocus.lock();
 	if (focus && focus.get() == &widget) {
 		currentFocus.reset();
@@ -154,6 +154,9 @@ UISizer& UISizer::operator=(UISizer&& other) noexcept
 
 	curParent = other.curParent;
 
+	minimumSize.reset();
+	minimumSizeWithoutProportional.reset();
+
 	return *this;
 }
 
@@ -164,14 +167,18 @@ Vector2f UISizer::getLayoutMinimumSize(bool force) const
 
 Vector2f UISizer::computeMinimumSize(bool includeProportional) const
 {
-	updateEnabled();
-	if (type == UISizerType::Horizontal || type == UISizerType::Vertical) {
-		return computeMinimumSizeBox(includeProportional);
-	} else if (type == UISizerType::Free) {
-		return computeMinimumSizeBoxFree();
-	} else {
-		return computeMinimumSizeGrid();
+	auto& cached = includeProportional ? minimumSize : minimumSizeWithoutProportional;
+	if (!cached) {
+		updateEnabled();
+		if (type == UISizerType::Horizontal || type == UISizerType::Vertical) {
+			cached = computeMinimumSizeBox(includeProportional);
+		} else if (type == UISizerType::Free) {
+			cached = computeMinimumSizeBoxFree();
+		} else {
+			cached = computeMinimumSizeGrid();
+		}
 	}
+	return *cached;
 }
 
 void UISizer::setRect(Rect4f rect, IUIElementListener* listener)
@@ -189,6 +196,7 @@ void UISizer::add(std::shared_ptr<IUIElement> element, float proportion, Vector4
 {
 	entries.emplace(entries.begin() + std::min(entries.size(), insertPos), UISizerEntry(element, proportion, border, fillFlags));
 	reparentEntry(entries.back());
+	onEntriesChanged();
 }
 
 void UISizer::addSpacer(float size)
@@ -205,6 +213,7 @@ void UISizer::addStretchSpacer(float proportion)
 void UISizer::remove(IUIElement& element)
 {
 	entries.erase(std::remove_if(entries.begin(), entries.end(), [&] (const UISizerEntry& e) { return e.getPointer().get() == &element; }), entries.end());
+	onEntriesChanged();
 }
 
 void UISizer::reparent(UIParent& parent)
@@ -220,6 +229,7 @@ void UISizer::reparent(UIParent& parent)
 		for (auto& e: entries) {
 			reparentEntry(e);
 		}
+		onEntriesChanged();
 	}
 }
 
@@ -312,9 +322,36 @@ void UISizer::updateEnabled() const
 	}
 }
 
+void UISizer::invalidateLayout() const
+{
+	minimumSize.reset();
+	minimumSizeWithoutProportional.reset();
+
+	// Nested sizers first, as their entries determine whether they're active
+	for (auto& e: entries) {
+		if (const auto* sizer = dynamic_cast<const UISizer*>(e.getPointer().get())) {
+			sizer->invalidateLayout();
+		}
+	}
+	updateEnabled();
+}
+
+void UISizer::onEntriesChanged()
+{
+	if (curParent) {
+		// Invalidates the whole sizer tree of the owning widget, including this one
+		minimumSize.reset();
+		minimumSizeWithoutProportional.reset();
+		curParent->markAsNeedingLayout();
+	} else {
+		invalidateLayout();
+	}
+}
+
 void UISizer::swapItems(int idxA, int idxB)
 {
 	std::swap(entries[idxA], entries[idxB]);
+	onEntriesChanged();
 }
 
 void UISizer::clear()
@@ -331,6 +368,7 @@ void UISizer::clear()
 		}
 	}
 	entries.clear();
+	onEntriesChanged();
 }
 
 bool UISizer::isActive() const
@@ -348,6 +386,7 @@ void UISizer::setColumnProportions(const Vector<float>& values)
 	if (gridProportions) {
 		gridProportions->columnProportions = values;
 		gridProportions->columnProportions.resize(gridProportions->nColumns, 0);
+		onEntriesChanged();
 	}
 }
 
@@ -358,6 +397,7 @@ void UISizer::setEvenColumns()
 		for (auto& c: gridProportions->columnProportions) {
 			c = 1.0f;
 		}
+		onEntriesChanged();
 	}
 }
 
@@ -366,6 +406,7 @@ void UISizer::setRowProportions(const Vector<float>& values)
 {
 	if (gridProportions) {
 		gridProportions->rowProportions = values;
+		onEntriesChanged();
 	}
 }
 
@@ -437,7 +478,7 @@ void UISizer::setRectBox(Rect4f rect, IUIElementListener* listener)
 	const int mainAxis = type == UISizerType::Horizontal ? 0 : 1;
 	const int otherAxis = 1 - mainAxis;
 
-	const Vector2f sizerMinSize = computeMinimumSizeBox(false);
+	const Vector2f sizerMinSize = computeMinimumSize(false);
 	float spare = std::max(0.0f, (rect.getSize() - sizerMinSize)[mainAxis]);
 	
 	bool first = true;
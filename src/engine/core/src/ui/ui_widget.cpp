@@ -7,7 +7,9 @@
 #include "halley/ui/ui_anchor.h"
 #include "halley/ui/ui_behaviour.h"
 #include "halley/ui/ui_event_handler.h"
+#include "halley/ui/ui_render_cache.h"
 #include "halley/input/input_keyboard.h"
+#include "halley/utils/scoped_guard.h"
 
 using namespace Halley;
 
@@ -44,6 +46,19 @@ void UIWidget::doDraw(UIPainter& painter) const
 		}
 	}
 
+	if (renderCache && !painter.isRecording()) {
+		if (!painter.canDraw(*renderCache)) {
+			auto recorder = painter.withRecording(*renderCache);
+			doDrawContents(recorder);
+		}
+		painter.draw(*renderCache);
+	} else {
+		doDrawContents(painter);
+	}
+}
+
+void UIWidget::doDrawContents(UIPainter& painter) const
+{
 	draw(painter);
 
 	if (childLayerAdjustment == 0) {
@@ -59,7 +74,7 @@ void UIWidget::doDraw(UIPainter& painter) const
 	drawAfterChildren(painter);
 }
 
-void UIWidget::doUpdate(UIWidgetUpdateType updateType, Time t, UIInputType inputType, JoystickType joystickType, Vector<std::shared_ptr<UIWidget>>& dst)
+void UIWidget::doUpdate(UIWidgetUpdateType updateType, Time t, UIInputType inputType, JoystickType joystickType, Vector<UIWidget*>& dst)
 {
 	if (updateType == UIWidgetUpdateType::Full || updateType == UIWidgetUpdateType::First) {
 		setInputType(inputType);
@@ -71,8 +86,8 @@ void UIWidget::doUpdate(UIWidgetUpdateType updateType, Time t, UIInputType input
 
 		checkActive();
 
-		if (eventHandler) {
-			eventHandler->pump();
+		if (eventHandler && eventHandler->pump()) {
+			invalidateRenderCache();
 		}
 	}
 
@@ -112,11 +127,11 @@ void UIWidget::removeSizerDeadChildren()
 	}
 }
 
-void UIWidget::collectWidgetsForUpdating(Vector<std::shared_ptr<UIWidget>>& dst)
+void UIWidget::collectWidgetsForUpdating(Vector<UIWidget*>& dst)
 {
 	for (auto& c: getChildren()) {
 		assert(c->getRoot() == getRoot());
-		dst.push_back(c);
+		dst.push_back(c.get());
 	}
 }
 
@@ -155,16 +170,33 @@ Vector2f UIWidget::getLayoutMinimumSize(bool force) const
 
 void UIWidget::setRect(Rect4f rect, IUIElementListener* listener)
 {
+	const bool wasInLayout = std::exchange(inLayout, true);
+	auto guard = ScopedGuard([&] ()
+	{
+		inLayout = wasInLayout;
+	});
+
 	setWidgetRect(rect);
 	if (sizer) {
 		const auto border = getInnerBorder();
 		const auto p0 = getLayoutOriginPosition();
 		const auto size = getLayoutSize(rect.getSize());
+		const auto sizerRect = Rect4f(p0 + Vector2f(border.x, border.y), p0 + size - Vector2f(border.z, border.w));
+
+		// Nothing in this subtree changed since it was last placed in the same rect, so it's already laid out
+		// Listeners (e.g. the UI editor) expect to be told about every element, so they always get a full pass
+		if (!layoutDirty && !listener && sizerRect == layoutRect) {
+			return;
+		}
+		layoutDirty = false;
+		layoutRect = sizerRect;
+
 		if (listener) {
 			onPreNotifySetRect(*listener);
 		}
-		sizer->setRect(Rect4f(p0 + Vector2f(border.x, border.y), p0 + size - Vector2f(border.z, border.w)), listener);
+		sizer->setRect(sizerRect, listener);
 	} else {
+		layoutDirty = false;
 		for (auto& c: getChildren()) {
 			c->layout();
 		}
@@ -179,6 +211,12 @@ void UIWidget::layout(IUIElementListener* listener)
 {
 	checkActive();
 	if (isActive()) {
+		const bool wasInLayout = std::exchange(inLayout, true);
+		auto guard = ScopedGuard([&] ()
+		{
+			inLayout = wasInLayout;
+		});
+
 		Vector2f minimumSize = getLayoutMinimumSize(false).ceil();
 		Vector2f targetSize = Vector2f::max(shrinkOnLayout ? Vector2f() : size, minimumSize);
 		setRect(Rect4f(getPosition(), getPosition() + targetSize), listener);
@@ -246,6 +284,7 @@ void UIWidget::setSizer(std::optional<UISizer> sizer)
 	if (this->sizer) {
 		this->sizer->reparent(*this);
 	}
+	markAsNeedingLayout();
 }
 
 void UIWidget::add(std::shared_ptr<IUIElement> element, float proportion, Vector4f border, int fillFlags, size_t insertPos)
@@ -416,7 +455,12 @@ bool UIWidget::ignoreClip() const
 void UIWidget::setPosition(Vector2f pos)
 {
 	Expects(pos.isValid());
-	
+
+	if (position != pos && parent && !isInLayout()) {
+		// The parent's sizer might have to place this widget again
+		// Moves made while laying out (e.g. anchors, or a parent placing its children) are already part of that layout
+		parent->markAsNeedingLayout();
+	}
 	position = pos;
 	positionUpdated = true;
 }
@@ -680,6 +724,11 @@ void UIWidget::setMouseClip(std::optional<Rect4f> clip, bool force)
 	}
 }
 
+const std::optional<Rect4f>& UIWidget::getMouseClip() const
+{
+	return mouseClip;
+}
+
 void UIWidget::onManualControlCycleValue(int delta)
 {
 }
@@ -1058,11 +1107,38 @@ bool UIWidget::needsLayout() const
 void UIWidget::markAsNeedingLayout()
 {
 	layoutNeeded = 1;
+	layoutDirty = true;
+	if (renderCache) {
+		renderCache->invalidate();
+	}
 	if (parent) {
 		parent->markAsNeedingLayout();
 	}
 	if (sizer) {
-		sizer->updateEnabled();
+		sizer->invalidateLayout();
+	}
+}
+
+void UIWidget::setRenderCached(bool enabled)
+{
+	if (enabled && !renderCache) {
+		renderCache = std::make_unique<UIRenderCache>();
+	} else if (!enabled) {
+		renderCache.reset();
+	}
+}
+
+bool UIWidget::isRenderCached() const
+{
+	return !!renderCache;
+}
+
+void UIWidget::invalidateRenderCache()
+{
+	for (auto* widget = this; widget; widget = dynamic_cast<UIWidget*>(widget->parent)) {
+		if (widget->renderCache) {
+			widget->renderCache->invalidate();
+		}
 	}
 }
 
@@ -1142,6 +1218,19 @@ void UIWidget::setWidgetRect(Rect4f rect)
 		size = rect.getSize();
 		positionUpdated = true;
 	}
+	if (positionUpdated) {
+		invalidateRenderCache();
+	}
+}
+
+bool UIWidget::isInLayout() const
+{
+	for (const auto* widget = this; widget; widget = dynamic_cast<const UIWidget*>(widget->parent)) {
+		if (widget->inLayout) {
+			return true;
+		}
+	}
+	return false;
 }
 
 void UIWidget::resetInputResults()
@@ -1303,7 +1392,10 @@ UIGamepadInput::Priority UIWidget::getInputPriority() const
 
 void UIWidget::setChildLayerAdjustment(int delta)
 {
-	childLayerAdjustment = delta;
+	if (childLayerAdjustment != delta) {
+		childLayerAdjustment = delta;
+		invalidateRenderCache();
+	}
 }
 
 int UIWidget::getChildLayerAdjustment() const
@@ -1313,7 +1405,10 @@ int UIWidget::getChildLayerAdjustment() const
 
 void UIWidget::setNoClipChildren(bool noClip)
 {
-	dontClipChildren = noClip;
+	if (dontClipChildren != noClip) {
+		dontClipChildren = noClip;
+		invalidateRenderCache();
+	}
 }
 
 bool UIWidget::getNoClipChildren() const
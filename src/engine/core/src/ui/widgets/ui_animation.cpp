@@ -65,6 +65,7 @@ void UIAnimation::update(Time t, bool moved)
 		animation.update(t);
 		animation.updateSprite(sprite);
 		sprite.setPos(getPosition() + offset).setColour(colour);
+		invalidateRenderCache();
 	}
 }
 
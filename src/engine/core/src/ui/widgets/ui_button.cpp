@@ -203,6 +203,7 @@ void UIButton::doSetState(State state)
 			sendEventDown(UIEvent(UIEventType::SetHovered, getId(), true, false));
 		}
 	}
+	invalidateRenderCache();
 }
 
 void UIButton::onStateChanged(State prev, State next)
@@ -11,6 +11,13 @@ UICustomPaint::UICustomPaint(String id, std::optional<UISizer> sizer, DrawCallba
 void UICustomPaint::setCallback(DrawCallback callback)
 {
 	this->callback = std::move(callback);
+	invalidateRenderCache();
+}
+
+void UICustomPaint::update(Time t, bool moved)
+{
+	// The callback can draw anything, so there's no telling whether it changed
+	invalidateRenderCache();
 }
 
 void UICustomPaint::draw(UIPainter& painter) const
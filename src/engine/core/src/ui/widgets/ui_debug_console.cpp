@@ -434,6 +434,7 @@ void UIDebugConsole::addLine(const String& line, Colour colour)
 void UIDebugConsole::setForcePaintMask(int mask)
 {
 	forceMask = mask;
+	invalidateRenderCache();
 }
 
 const std::shared_ptr<UIDebugConsoleController>& UIDebugConsole::getController() const
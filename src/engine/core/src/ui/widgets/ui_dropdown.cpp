@@ -97,6 +97,7 @@ void UIDropdown::updateTopLabel()
 		label.setText(options[curOption].label);
 		icon = options[curOption].icon;
 	}
+	invalidateRenderCache();
 }
 
 void UIDropdown::updateOptionLabels()
@@ -234,17 +235,23 @@ void UIDropdown::update(Time t, bool moved)
 	}
 
 	const auto& style = styles.at(0);
+	const char* spriteName;
 	if (isEnabled()) {
 		if (openState == OpenState::OpenDown) {
-			sprite = style.getSprite("open");
+			spriteName = "open";
 		} else if (openState == OpenState::OpenUp) {
-			sprite = style.getSprite("openUp");
+			spriteName = "openUp";
 		} else {
-			sprite = isMouseOver() ? style.getSprite("hover") : style.getSprite("normal");
+			spriteName = isMouseOver() ? "hover" : "normal";
 		}
 	} else {
-		sprite = style.getSprite("disabled");
+		spriteName = "disabled";
 	}
+	if (spriteName != curSpriteName) {
+		curSpriteName = spriteName;
+		invalidateRenderCache();
+	}
+	sprite = style.getSprite(spriteName);
 
 	sprite.setPos(getPosition()).scaleTo(getSize());
 
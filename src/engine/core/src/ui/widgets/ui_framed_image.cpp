@@ -50,17 +50,24 @@ void UIFramedImage::draw(UIPainter& painter) const
 void UIFramedImage::update(Time t, bool moved)
 {
 	const auto bgSize = framedSprite.getSize();
-	scrollPos = (scrollPos + float(t) * scrollSpeed).modulo(bgSize);
+	const auto newScrollPos = (scrollPos + float(t) * scrollSpeed).modulo(bgSize);
+	if (newScrollPos != scrollPos) {
+		scrollPos = newScrollPos;
+		invalidateRenderCache();
+	}
 	UIImage::update(t, moved);
 }
 
 void UIFramedImage::setFramedSprite(const Sprite& sprite)
 {
 	framedSprite = sprite;
+	invalidateRenderCache();
 }
 
 Sprite& UIFramedImage::getFramedSprite()
 {
+	// The caller might change it
+	invalidateRenderCache();
 	return framedSprite;
 }
 
@@ -73,6 +80,7 @@ void UIFramedImage::setScrolling(Vector2f ss, std::optional<Vector2f> startPos)
 {
 	if (startPos) {
 		scrollPos = startPos.value();
+		invalidateRenderCache();
 	}
 	scrollSpeed = ss;
 }
@@ -48,6 +48,7 @@ void UIImage::update(Time t, bool moved)
 			.setPos(basePos)
 			.setScale(getSize() / imgBaseSize);
 		dirty = false;
+		invalidateRenderCache();
 	}
 	if (drawing > 0) {
 		--drawing;
@@ -76,6 +77,8 @@ void UIImage::setSprite(Sprite s)
 
 Sprite& UIImage::getSprite()
 {
+	// The caller might change it
+	invalidateRenderCache();
 	return sprite;
 }
 
@@ -91,19 +94,24 @@ void UIImage::setUseClipForPos(bool useClip)
 
 void UIImage::setLayerAdjustment(int adjustment)
 {
-	layerAdjustment = adjustment;
+	if (layerAdjustment != adjustment) {
+		layerAdjustment = adjustment;
+		invalidateRenderCache();
+	}
 }
 
 void UIImage::setWorldClip(std::optional<Rect4f> wc)
 {
 	clip = wc;
 	isLocalClip = false;
+	invalidateRenderCache();
 }
 
 void UIImage::setLocalClip(std::optional<Rect4f> c)
 {
 	clip = c;
 	isLocalClip = true;
+	invalidateRenderCache();
 }
 
 void UIImage::setSelectable(Colour4f normalColour, Colour4f selColour)
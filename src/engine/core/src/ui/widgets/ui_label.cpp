@@ -57,6 +57,7 @@ void UILabel::update(Time t, bool moved)
 	}
 	if (moved || marqueeSpeed) {
 		renderer.setPosition(getPosition() + Vector2f(renderer.getAlignment() * textExtents.x - marqueePos, 0.0f));
+		invalidateRenderCache();
 	}
 }
 
@@ -112,6 +113,8 @@ void UILabel::updateMinSize()
 	}
 	if (textMinSize != oldTextMinSize) {
 		markAsNeedingLayout();
+	} else {
+		invalidateRenderCache();
 	}
 }
 
@@ -289,6 +292,7 @@ void UILabel::setTextRenderer(TextRenderer r)
 void UILabel::setColour(Colour4f colour)
 {
 	renderer.setColour(colour);
+	invalidateRenderCache();
 }
 
 void UILabel::setSelectable(TextRenderer normalRenderer, TextRenderer selectedRenderer, bool preserveAlpha)
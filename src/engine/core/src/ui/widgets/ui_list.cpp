@@ -1150,6 +1150,7 @@ void UIListItem::update(Time t, bool moved)
 
 	if (dirty) {
 		updateSpritePosition();
+		invalidateRenderCache();
 	}
 
 	UIClickable::update(t, moved);
@@ -1260,6 +1261,7 @@ void UIListItem::doSetState(State state)
 	}
 
 	updateSpritePosition();
+	invalidateRenderCache();
 
 	parent.setItemUnderCursor(index, isMouseOver());
 }
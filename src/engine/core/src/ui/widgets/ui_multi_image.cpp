@@ -13,6 +13,8 @@ UIMultiImage::UIMultiImage(const String& id, Vector2f size, Vector<Sprite> sprit
 
 Sprite& UIMultiImage::getSprite(size_t index)
 {
+	// The caller might change it
+	invalidateRenderCache();
 	return sprites.at(index);
 }
 
@@ -75,6 +77,7 @@ void UIMultiImage::update(Time t, bool moved)
 			sprites[i].setPos(basePos + offsets[i]);
 		}
 		dirty = false;
+		invalidateRenderCache();
 	}
 }
 
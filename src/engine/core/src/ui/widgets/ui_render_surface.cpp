@@ -212,7 +212,10 @@ std::optional<Vector2f> UIRenderSurface::transformToChildSpace(Vector2f pos) con
 
 void UIRenderSurface::setBypass(bool bypass)
 {
-	this->bypass = bypass;
+	if (this->bypass != bypass) {
+		this->bypass = bypass;
+		markAsNeedingLayout();
+	}
 }
 
 void UIRenderSurface::setAutoBypass(bool autoBypass)
@@ -248,7 +251,7 @@ void UIRenderSurface::update(Time t, bool moved)
 	}
 
 	if (autoBypass) {
-		bypass = Colour4c(colour) == Colour4c(255, 255, 255, 255) && std::abs(scale.x - 1.0f) < 0.00001f && std::abs(scale.y - 1.0f) < 0.00001f;
+		setBypass(Colour4c(colour) == Colour4c(255, 255, 255, 255) && std::abs(scale.x - 1.0f) < 0.00001f && std::abs(scale.y - 1.0f) < 0.00001f);
 	}
 }
 
@@ -133,6 +133,7 @@ void UIResizeDivider::pressMouse(Vector2f mousePos, int button, KeyMods keyMods)
 	if (button == 0) {
 		held = true;
 		startPos = mousePos;
+		invalidateRenderCache();
 
 		if (target) {
 			startSize = target->getSize()[isHorizontal() ? 0 : 1];
@@ -144,6 +145,7 @@ void UIResizeDivider::releaseMouse(Vector2f mousePos, int button)
 {
 	if (button == 0) {
 		held = false;
+		invalidateRenderCache();
 	}
 }
 
@@ -152,12 +154,18 @@ void UIResizeDivider::onMouseOver(Vector2f mousePos)
 	if (held && target) {
 		setTargetSize(startSize + (mousePos - startPos)[isHorizontal() ? 0 : 1] * (isTargetBeforeMe() ? 1.0f : -1.0f), true);
 	}
-	hover = true;
+	if (!hover) {
+		hover = true;
+		invalidateRenderCache();
+	}
 }
 
 void UIResizeDivider::onMouseLeft(Vector2f mousePos)
 {
-	hover = false;
+	if (hover) {
+		hover = false;
+		invalidateRenderCache();
+	}
 }
 
 void UIResizeDivider::setTargetSize(float size, bool store)
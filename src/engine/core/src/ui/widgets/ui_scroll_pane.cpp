@@ -58,7 +58,10 @@ Vector2f UIScrollPane::getRelativeScrollEndPosition() const
 
 void UIScrollPane::setClipSize(Vector2f clipSize)
 {
-	this->clipSize = clipSize;
+	if (this->clipSize != clipSize) {
+		this->clipSize = clipSize;
+		markAsNeedingLayout();
+	}
 }
 
 void UIScrollPane::scrollTo(Vector2f position)
@@ -75,6 +78,8 @@ void UIScrollPane::scrollTo(Vector2f position)
 	}
 
 	if (scrollPos != old) {
+		// Children are placed relative to the scroll position
+		markAsNeedingLayout();
 		sendEventDown(UIEvent(UIEventType::ScrollPositionChanged, getId(), Vector2f(scrollPos)));
 	}
 }
@@ -169,6 +174,7 @@ bool UIScrollPane::isScrollWheelEnabled() const
 
 void UIScrollPane::refresh(bool force)
 {
+	const auto oldScrollPos = scrollPos;
 	if (!scrollHorizontal) {
 		clipSize.x = getSize().x;
 		scrollPos.x = 0;
@@ -177,6 +183,9 @@ void UIScrollPane::refresh(bool force)
 		clipSize.y = getSize().y;
 		scrollPos.y = 0;
 	}
+	if (scrollPos != oldScrollPos) {
+		markAsNeedingLayout();
+	}
 	contentsSize = UIWidget::getLayoutMinimumSize(false);
 
 	setMouseClip(getRect(), force);
@@ -304,6 +304,13 @@ void UISliderBar::draw(UIPainter& painter) const
 
 void UISliderBar::update(Time t, bool moved)
 {
+	// The bar is filled up to the value, which can change without anything else in the UI changing
+	const auto value = parent.getRelativeValue(true);
+	if (value != drawnValue || getThumbPosition() != thumb.getPosition()) {
+		drawnValue = value;
+		invalidateRenderCache();
+	}
+
 	left.setPos(getPosition() + Vector2f(-left.getUncroppedSize().x, 0));
 	thumb.setPos(getThumbPosition());
 	right.setPos(getPosition() + Vector2f(getSize().x, 0));
@@ -337,4 +344,5 @@ void UISliderBar::updateThumbState()
 	}
 
 	dirtyThumb = false;
+	invalidateRenderCache();
 }
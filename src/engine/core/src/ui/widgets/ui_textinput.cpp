@@ -69,12 +69,14 @@ String UITextInput::getText() const
 UITextInput& UITextInput::setGhostText(LocalisedString t)
 {
 	ghostText = std::move(t);
+	invalidateRenderCache();
 	return *this;
 }
 
 UITextInput& UITextInput::setAppendText(LocalisedString text)
 {
 	appendText = std::move(text);
+	invalidateRenderCache();
 	return *this;
 }
 
@@ -90,6 +92,8 @@ void UITextInput::setShowGhostWhenFocused(bool show)
 
 TextRenderer& UITextInput::getTextLabel()
 {
+	// The caller might change it
+	invalidateRenderCache();
 	return label;
 }
 
@@ -238,6 +242,7 @@ void UITextInput::onTextModified()
 		text.setText(getValidator()->onTextChanged(text.getText()));
 	}
 	updateCaret();
+	invalidateRenderCache();
 
 	const auto str = String(text.getText());
 	sendEvent(UIEvent(UIEventType::TextChanged, getId(), str));
@@ -322,7 +327,12 @@ void UITextInput::update(Time t, bool moved)
 	const bool showAutoComplete = autoCompleteCurOption.has_value();
 	const bool showGhost = text.getText().empty() && (!isFocused() || showGhostWhenFocused || isReadOnly());
 	const bool showAppend = !showGhost && !appendText.getString().isEmpty();
-	ghostText.checkForUpdates();
+	// Caret, selection and text all change while focused
+	const bool focused = isFocused();
+	if (ghostText.checkForUpdates() || focused || wasFocused) {
+		invalidateRenderCache();
+	}
+	wasFocused = focused;
 	ghostLabel.setText(showAutoComplete ? getAutoCompleteCaption() : (showGhost ? ghostText.getString().getUTF32() : (showAppend ? appendText.getString().getUTF32() : StringUTF32())));
 
 	// Update text
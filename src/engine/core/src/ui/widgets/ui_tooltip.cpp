@@ -55,6 +55,7 @@ void UIToolTip::update(Time t, bool moved)
 			pos = Vector2f::min(pos, screenRect.getBottomRight() - getSize());
 			
 			setPosition(pos);
+			invalidateRenderCache();
 		}
 	}
 	text.setPosition(getPosition() + border.xy());
@@ -178,6 +178,7 @@ void UITreeList::onItemDragging(UIListItem& item, int index, Vector2f pos)
 		
 		insertCursor = styles.at(0).getSubStyle("cursor").getSprite(resData.type == UITreeListItem::PositionType::OnTop ? "over" : "beforeAfter");
 		insertCursor.setPos(rect.getTopLeft()).scaleTo(rect.getSize());
+		invalidateRenderCache();
 	}
 
 	sendEvent(UIEvent(UIEventType::MakeAreaVisibleContinuous, getId(), Rect4f(pos, pos + item.getSize()) - getPosition()));
@@ -208,6 +209,7 @@ void UITreeList::onItemDoneDragging(UIListItem& item, int index, Vector2f pos)
 		reparentItems(getSelectedOptionIds(), newParentId, static_cast<int>(newChildIndex));
 	}
 	insertCursor = Sprite();
+	invalidateRenderCache();
 }
 
 bool UITreeList::canParentItemTo(const String& itemId, const String& parentId) const
@@ -0,0 +1,748 @@
+#include "halley/ui/widgets/ui_virtual_list.h"
+#include "halley/ui/ui_style.h"
+#include "halley/ui/ui_root.h"
+#include "halley/input/input_keyboard.h"
+
+using namespace Halley;
+
+std::optional<size_t> IUIVirtualListSource::getItemIndex(const String& id) const
+{
+	const auto n = getNumberOfItems();
+	for (size_t i = 0; i < n; ++i) {
+		if (getItemId(i) == id) {
+			return i;
+		}
+	}
+	return {};
+}
+
+UIVirtualList::UIVirtualList(String id, std::optional<UIStyle> style, float rowHeight)
+	: UIWidget(std::move(id), {}, UISizer(UISizerType::Vertical, style ? style->getFloat("gap") : 0.0f), style ? style->getBorder("innerBorder") : Vector4f())
+	, rowHeight(rowHeight)
+{
+	if (style) {
+		styles.emplace_back(*style);
+		sprite = style->getSprite("background");
+		gap = style->getFloat("gap");
+
+		const auto itemStyle = style->getSubStyle("item");
+		if (this->rowHeight <= 0) {
+			this->rowHeight = itemStyle.getVector2f("minSize", Vector2f()).y;
+		}
+		if (itemStyle.hasSprite("selected")) {
+			selectedSprite = itemStyle.getSprite("selected");
+		}
+		if (itemStyle.hasSprite("hover")) {
+			hoverSprite = itemStyle.getSprite("hover");
+		}
+	}
+	this->rowHeight = std::max(this->rowHeight, 1.0f);
+
+	setInteractWithMouse(true);
+}
+
+void UIVirtualList::setSource(std::shared_ptr<IUIVirtualListSource> s)
+{
+	source = std::move(s);
+
+	// Widgets made by the previous source can't be bound by this one
+	for (auto& row: rows) {
+		UIWidget::remove(*row.widget);
+	}
+	for (auto& widget: pool) {
+		UIWidget::remove(*widget);
+	}
+	rows.clear();
+	pool.clear();
+	firstRow = 0;
+	minWidth = 0;
+	selection.clear();
+	curOption = -1;
+	curHover = -1;
+
+	refresh();
+}
+
+const std::shared_ptr<IUIVirtualListSource>& UIVirtualList::getSource() const
+{
+	return source;
+}
+
+void UIVirtualList::refresh()
+{
+	nItems = source ? source->getNumberOfItems() : 0;
+
+	selection.erase(std::remove_if(selection.begin(), selection.end(), [&] (size_t idx) { return idx >= nItems; }), selection.end());
+	if (curHover >= int(nItems)) {
+		curHover = -1;
+	}
+	minWidth = 0;
+	rebindRows();
+	markAsNeedingLayout();
+
+	if (curOption >= int(nItems)) {
+		curOption = -1;
+		setSelectedOption(int(nItems) - 1);
+	} else if (curOption < 0 && requiresSelection && nItems > 0) {
+		setSelectedOption(0);
+	}
+}
+
+void UIVirtualList::refreshItem(size_t idx)
+{
+	if (auto widget = tryGetItemWidget(idx)) {
+		source->bindItemWidget(*this, *widget, idx);
+	}
+}
+
+size_t UIVirtualList::getCount() const
+{
+	return nItems;
+}
+
+float UIVirtualList::getRowHeight() const
+{
+	return rowHeight;
+}
+
+void UIVirtualList::setOverscan(size_t rows)
+{
+	overscan = rows;
+}
+
+bool UIVirtualList::setSelectedOption(int option, SelectionMode mode)
+{
+	if (!multiSelect) {
+		mode = SelectionMode::Normal;
+	}
+
+	if (nItems == 0) {
+		return false;
+	}
+
+	if (!requiresSelection && option < 0) {
+		selection.clear();
+		curOption = -1;
+		updateRowStates();
+		return false;
+	}
+
+	return changeSelection(clamp(option, 0, int(nItems) - 1), mode);
+}
+
+bool UIVirtualList::setSelectedOptionId(const String& id, SelectionMode mode)
+{
+	if (source) {
+		if (const auto idx = source->getItemIndex(id)) {
+			return setSelectedOption(int(*idx), mode);
+		}
+	}
+	return false;
+}
+
+int UIVirtualList::getSelectedOption() const
+{
+	return curOption;
+}
+
+String UIVirtualList::getSelectedOptionId() const
+{
+	if (source && curOption >= 0 && curOption < int(nItems)) {
+		return source->getItemId(curOption);
+	}
+	return "";
+}
+
+Vector<int> UIVirtualList::getSelectedOptions() const
+{
+	Vector<int> result;
+	result.reserve(selection.size());
+	for (const auto idx: selection) {
+		result.push_back(int(idx));
+	}
+	return result;
+}
+
+Vector<String> UIVirtualList::getSelectedOptionIds() const
+{
+	Vector<String> result;
+	result.reserve(selection.size());
+	for (const auto idx: selection) {
+		result.push_back(source->getItemId(idx));
+	}
+	return result;
+}
+
+bool UIVirtualList::isSelected(size_t idx) const
+{
+	return std::binary_search(selection.begin(), selection.end(), idx);
+}
+
+std::optional<int> UIVirtualList::getHoveredOption() const
+{
+	if (curHover >= 0) {
+		return curHover;
+	}
+	return {};
+}
+
+Rect4f UIVirtualList::getOptionRect(int option) const
+{
+	if (nItems == 0) {
+		return Rect4f();
+	}
+
+	const auto border = getInnerBorder();
+	const auto top = border.y + float(clamp(option, 0, int(nItems) - 1)) * getRowStride();
+	const auto rect = Rect4f(Vector2f(border.x, top), Vector2f(getSize().x - border.z, top + rowHeight));
+	return styles.empty() ? rect : rect.grow(styles[0].getBorder("scrollBorder", Vector4f()));
+}
+
+std::optional<size_t> UIVirtualList::getItemAt(Vector2f pos) const
+{
+	const auto y = pos.y - getPosition().y - getInnerBorder().y;
+	if (y < 0) {
+		return {};
+	}
+
+	const auto stride = getRowStride();
+	const auto idx = size_t(y / stride);
+	if (idx >= nItems || y - float(idx) * stride > rowHeight) {
+		return {};
+	}
+	return idx;
+}
+
+void UIVirtualList::showCurSelection(bool centre)
+{
+	sendEvent(UIEvent(centre ? UIEventType::MakeAreaVisibleCentered : UIEventType::MakeAreaVisible, getId(), getOptionRect(curOption)));
+}
+
+std::pair<size_t, size_t> UIVirtualList::getMaterializedRange() const
+{
+	return { firstRow, firstRow + rows.size() };
+}
+
+std::shared_ptr<UIWidget> UIVirtualList::tryGetItemWidget(size_t idx) const
+{
+	if (idx >= firstRow && idx < firstRow + rows.size()) {
+		return rows[idx - firstRow].widget;
+	}
+	return {};
+}
+
+bool UIVirtualList::isMultiSelect() const
+{
+	return multiSelect;
+}
+
+void UIVirtualList::setMultiSelect(bool enabled)
+{
+	multiSelect = enabled;
+}
+
+void UIVirtualList::setRequiresSelection(bool requireSelection)
+{
+	requiresSelection = requireSelection;
+}
+
+bool UIVirtualList::isSingleClickAccept() const
+{
+	return singleClickAccept;
+}
+
+void UIVirtualList::setSingleClickAccept(bool enabled)
+{
+	singleClickAccept = enabled;
+}
+
+void UIVirtualList::setScrollToSelection(bool value)
+{
+	scrollToSelection = value;
+}
+
+bool UIVirtualList::isAcceptKeyboardInput() const
+{
+	return acceptKeyboardInput;
+}
+
+void UIVirtualList::setAcceptKeyboardInput(bool value)
+{
+	acceptKeyboardInput = value;
+}
+
+void UIVirtualList::setFocusable(bool f)
+{
+	focusable = f;
+}
+
+bool UIVirtualList::canReceiveFocus() const
+{
+	return focusable;
+}
+
+Vector2f UIVirtualList::getLayoutMinimumSize(bool force) const
+{
+	if (!isActive() && !force) {
+		return {};
+	}
+
+	// Width only grows as wider rows scroll into view, so the list doesn't jitter as it's scrolled
+	minWidth = std::max(minWidth, UIWidget::getLayoutMinimumSize(force).x);
+
+	const auto border = getInnerBorder();
+	const auto height = nItems > 0 ? float(nItems) * rowHeight + float(nItems - 1) * gap + border.y + border.w : 0.0f;
+	return Vector2f::max(getMinimumSize(), Vector2f(minWidth, height));
+}
+
+Vector2f UIVirtualList::getLayoutOriginPosition() const
+{
+	return getPosition() + Vector2f(0, float(firstRow) * getRowStride());
+}
+
+void UIVirtualList::pressMouse(Vector2f mousePos, int button, KeyMods keyMods)
+{
+	const auto idx = getItemAt(mousePos);
+	if (!idx) {
+		if (button == 0) {
+			sendEvent(UIEvent(UIEventType::ListBackgroundLeftClicked, getId()));
+		} else if (button == 1) {
+			sendEvent(UIEvent(UIEventType::ListBackgroundMiddleClicked, getId()));
+		} else if (button == 2) {
+			sendEvent(UIEvent(UIEventType::ListBackgroundRightClicked, getId()));
+		}
+		return;
+	}
+
+	const auto option = int(*idx);
+	pressedOption = option;
+	pressedMods = keyMods;
+
+	if (button == 0 || !singleClickAccept) {
+		const auto mode = getMode(keyMods, button);
+
+		// If you click an item that's already selected, that doesn't cause any changes until release
+		if (mode != SelectionMode::Normal || !isSelected(*idx)) {
+			setSelectedOption(option, mode);
+		}
+	}
+
+	const auto itemId = source->getItemId(*idx);
+	if (button == 0) {
+		const bool doubleClick = lastClickedOption == option && timeSinceClick < 0.5;
+		lastClickedOption = option;
+		timeSinceClick = 0;
+
+		sendEvent(UIEvent(UIEventType::ListItemLeftClicked, getId(), itemId, curOption));
+		if (singleClickAccept || (doubleClick && keyMods == KeyMods::None)) {
+			onAccept();
+		}
+	} else if (button == 1) {
+		sendEvent(UIEvent(UIEventType::ListItemMiddleClicked, getId(), itemId, curOption));
+	} else if (button == 2) {
+		sendEvent(UIEvent(UIEventType::ListItemRightClicked, getId(), itemId, curOption));
+	}
+	focus();
+}
+
+void UIVirtualList::releaseMouse(Vector2f mousePos, int button)
+{
+	if (button == 0 && pressedOption >= 0) {
+		const auto mode = getMode(pressedMods, button);
+		if (mode == SelectionMode::Normal && pressedOption < int(nItems) && isSelected(pressedOption)) {
+			setSelectedOption(pressedOption, mode);
+		}
+		pressedOption = -1;
+	}
+}
+
+void UIVirtualList::onMouseOver(Vector2f mousePos)
+{
+	const auto idx = getItemAt(mousePos);
+	setHover(idx ? int(*idx) : -1);
+}
+
+void UIVirtualList::onMouseLeft(Vector2f mousePos)
+{
+	setHover(-1);
+}
+
+void UIVirtualList::readFromDataBind()
+{
+	auto data = getDataBind();
+	if (data->getFormat() == UIDataBind::Format::String) {
+		setSelectedOptionId(data->getStringData());
+	} else {
+		setSelectedOption(data->getIntData());
+	}
+}
+
+void UIVirtualList::updateVisibleRows()
+{
+	auto view = getRect();
+	if (const auto& clip = getMouseClip()) {
+		view = view.intersection(*clip);
+	} else if (const auto* root = getRoot()) {
+		view = view.intersection(root->getRect());
+	}
+	updateVisibleRows(view);
+}
+
+void UIVirtualList::updateVisibleRows(Rect4f view)
+{
+	if (!source || nItems == 0) {
+		materializeRows(0, 0);
+		return;
+	}
+
+	const auto stride = getRowStride();
+	const auto origin = getPosition().y + getInnerBorder().y;
+	const auto top = std::floor((view.getTop() - origin) / stride);
+	const auto bottom = std::ceil((view.getBottom() - origin) / stride);
+	rowsPerPage = size_t(std::max(1.0f, std::floor(view.getHeight() / stride)));
+
+	const auto first = size_t(clamp(top - float(overscan), 0.0f, float(nItems)));
+	const auto last = size_t(clamp(bottom + float(overscan), 0.0f, float(nItems)));
+	materializeRows(first, std::max(first, last));
+}
+
+void UIVirtualList::draw(UIPainter& painter) const
+{
+	if (sprite.hasMaterial()) {
+		painter.draw(sprite);
+	}
+
+	for (const auto& row: rows) {
+		const auto& highlight = row.selected ? selectedSprite : hoverSprite;
+		if ((row.selected || row.hovered) && highlight.hasMaterial()) {
+			auto s = highlight;
+			s.scaleTo(row.widget->getSize()).setPos(row.widget->getPosition());
+			painter.draw(std::move(s));
+		}
+	}
+}
+
+void UIVirtualList::update(Time t, bool moved)
+{
+	if (moved) {
+		if (sprite.hasMaterial()) {
+			sprite.scaleTo(getSize()).setPos(getPosition());
+		}
+	}
+
+	timeSinceClick += t;
+	updateVisibleRows();
+}
+
+void UIVirtualList::onGamepadInput(const UIInputResults& input, Time time)
+{
+	if (nItems == 0) {
+		return;
+	}
+
+	if (input.isButtonPressed(UIGamepadInput::Button::Next)) {
+		setSelectedOption(modulo(curOption + 1, int(nItems)));
+	}
+	if (input.isButtonPressed(UIGamepadInput::Button::Prev)) {
+		setSelectedOption(modulo(curOption - 1, int(nItems)));
+	}
+	moveSelection(input.getAxisRepeat(UIGamepadInput::Axis::Y), true);
+
+	if (input.isButtonPressed(UIGamepadInput::Button::Accept)) {
+		onAccept();
+	}
+
+	if (input.isButtonPressed(UIGamepadInput::Button::Cancel)) {
+		onCancel();
+	}
+}
+
+bool UIVirtualList::onKeyPress(KeyboardKeyPress key)
+{
+	if (!acceptKeyboardInput) {
+		return false;
+	}
+
+	if (key.is(KeyCode::Up)) {
+		moveSelection(-1, true);
+		return true;
+	}
+
+	if (key.is(KeyCode::Down)) {
+		moveSelection(1, true);
+		return true;
+	}
+
+	if (key.is(KeyCode::PageUp)) {
+		moveSelection(-int(rowsPerPage), false);
+		return true;
+	}
+
+	if (key.is(KeyCode::PageDown)) {
+		moveSelection(int(rowsPerPage), false);
+		return true;
+	}
+
+	if (key.is(KeyCode::Home)) {
+		setSelectedOption(0);
+		return true;
+	}
+
+	if (key.is(KeyCode::End)) {
+		setSelectedOption(int(nItems) - 1);
+		return true;
+	}
+
+	if (key.is(KeyCode::Enter)) {
+		onAccept();
+		return true;
+	}
+
+	return false;
+}
+
+void UIVirtualList::moveSelection(int delta, bool wrap)
+{
+	if (delta == 0 || nItems == 0) {
+		return;
+	}
+
+	const auto option = curOption + delta;
+	setSelectedOption(wrap ? modulo(option, int(nItems)) : clamp(option, 0, int(nItems) - 1));
+}
+
+void UIVirtualList::onAccept()
+{
+	playStyleSound("acceptSound");
+	sendEvent(UIEvent(UIEventType::ListAccept, getId(), getSelectedOptionId(), curOption));
+}
+
+void UIVirtualList::onCancel()
+{
+	playStyleSound("cancelSound");
+	sendEvent(UIEvent(UIEventType::ListCancel, getId(), getSelectedOptionId(), curOption));
+}
+
+void UIVirtualList::setSelection(Vector<size_t> indices, int option)
+{
+	std::sort(indices.begin(), indices.end());
+	indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+	selection = std::move(indices);
+	curOption = option;
+	updateRowStates();
+}
+
+float UIVirtualList::getRowStride() const
+{
+	return rowHeight + gap;
+}
+
+void UIVirtualList::materializeRows(size_t first, size_t last)
+{
+	if (first == firstRow && last == firstRow + rows.size()) {
+		return;
+	}
+
+	// Rows that scrolled out go back to the pool
+	for (auto& row: rows) {
+		if (row.idx < first || row.idx >= last) {
+			row.widget->setActive(false);
+			pool.push_back(std::move(row.widget));
+		}
+	}
+
+	Vector<Row> newRows;
+	newRows.reserve(last - first);
+	for (size_t i = first; i < last; ++i) {
+		if (i >= firstRow && i < firstRow + rows.size()) {
+			// Still visible, no need to rebind
+			newRows.push_back(std::move(rows[i - firstRow]));
+			continue;
+		}
+
+		std::shared_ptr<UIWidget> widget;
+		if (pool.empty()) {
+			widget = source->makeItemWidget(*this);
+			widget->setMinSize(Vector2f(widget->getMinimumSize().x, rowHeight));
+			add(widget, 0, {}, UISizerFillFlags::Fill);
+		} else {
+			widget = std::move(pool.back());
+			pool.pop_back();
+			widget->setActive(true);
+		}
+
+		source->bindItemWidget(*this, *widget, i);
+		newRows.push_back(Row{ i, std::move(widget) });
+		sendRowState(newRows.back(), true);
+	}
+
+	rows = std::move(newRows);
+	firstRow = first;
+
+	// Keep the sizer in row order, with the pooled widgets at the end
+	HashMap<const IUIElement*, size_t> order;
+	for (size_t i = 0; i < rows.size(); ++i) {
+		order[rows[i].widget.get()] = i;
+	}
+	const auto getOrder = [&] (const UISizerEntry& entry)
+	{
+		const auto iter = order.find(entry.getPointer().get());
+		return iter != order.end() ? iter->second : std::numeric_limits<size_t>::max();
+	};
+	getSizer().sortItems([&] (const UISizerEntry& a, const UISizerEntry& b)
+	{
+		return getOrder(a) < getOrder(b);
+	});
+}
+
+void UIVirtualList::rebindRows()
+{
+	if (firstRow + rows.size() > nItems) {
+		const auto first = std::min(firstRow, nItems);
+		materializeRows(first, nItems);
+	}
+
+	for (auto& row: rows) {
+		source->bindItemWidget(*this, *row.widget, row.idx);
+		sendRowState(row, true);
+	}
+}
+
+void UIVirtualList::updateRowStates()
+{
+	for (auto& row: rows) {
+		sendRowState(row, false);
+	}
+}
+
+void UIVirtualList::sendRowState(Row& row, bool force)
+{
+	const bool selected = isSelected(row.idx);
+	const bool hovered = int(row.idx) == curHover;
+	if (force || selected != row.selected || hovered != row.hovered) {
+		// Highlights are drawn by the list itself
+		invalidateRenderCache();
+	}
+	if (force || selected != row.selected) {
+		row.selected = selected;
+		row.widget->sendEventDown(UIEvent(UIEventType::SetSelected, row.widget->getId(), selected));
+	}
+	if (force || hovered != row.hovered) {
+		row.hovered = hovered;
+		row.widget->sendEventDown(UIEvent(UIEventType::SetHovered, row.widget->getId(), hovered));
+	}
+}
+
+void UIVirtualList::setHover(int option)
+{
+	if (option == curHover) {
+		return;
+	}
+
+	curHover = option;
+	updateRowStates();
+	if (curHover >= 0) {
+		sendEvent(UIEvent(UIEventType::ListHoveredChanged, getId(), source->getItemId(curHover), curHover));
+		playStyleSound("hoverSound");
+	} else {
+		sendEvent(UIEvent(UIEventType::ListHoveredChanged, getId(), String(), -1));
+	}
+}
+
+bool UIVirtualList::changeSelection(int newItem, SelectionMode mode)
+{
+	std::optional<int> newItemToFocus;
+	bool changed = false;
+	const int oldItem = curOption;
+
+	if (mode == SelectionMode::Normal) {
+		if (selection.size() != 1 || selection[0] != size_t(newItem)) {
+			selection = { size_t(newItem) };
+			changed = true;
+		}
+		if (oldItem != newItem) {
+			newItemToFocus = newItem;
+		}
+	} else if (mode == SelectionMode::AddToSelect) {
+		if (!isSelected(newItem)) {
+			select(newItem, true);
+			changed = true;
+		}
+		if (oldItem != newItem) {
+			newItemToFocus = newItem;
+		}
+	} else if (mode == SelectionMode::CtrlSelect) {
+		const bool wasSelected = isSelected(newItem);
+		select(newItem, !wasSelected);
+		if (wasSelected) {
+			const int fallback = selection.empty() ? newItem : int(selection.front());
+			if (selection.empty()) {
+				select(fallback, true);
+			}
+			if (curOption != fallback) {
+				newItemToFocus = fallback;
+			}
+		} else {
+			newItemToFocus = newItem;
+		}
+		changed = true;
+	} else if (mode == SelectionMode::ShiftSelect) {
+		const int a = oldItem >= 0 ? std::min(oldItem, newItem) : newItem;
+		const int b = std::max(oldItem, newItem);
+		selection.clear();
+		for (int i = a; i <= b; ++i) {
+			selection.push_back(size_t(i));
+		}
+		changed = true;
+	}
+
+	if (newItemToFocus) {
+		curOption = *newItemToFocus;
+		changed = true;
+	}
+
+	if (changed) {
+		updateRowStates();
+		notifyNewItemSelected();
+	}
+
+	return changed;
+}
+
+void UIVirtualList::select(size_t idx, bool selected)
+{
+	const auto iter = std::lower_bound(selection.begin(), selection.end(), idx);
+	const bool present = iter != selection.end() && *iter == idx;
+	if (selected && !present) {
+		selection.insert(iter, idx);
+	} else if (!selected && present) {
+		selection.erase(iter);
+	}
+}
+
+void UIVirtualList::notifyNewItemSelected()
+{
+	if (notifyItemSelectionEnabled) {
+		const auto& itemId = getSelectedOptionId();
+		playStyleSound("selectionChangedSound");
+
+		sendEvent(UIEvent(UIEventType::ListSelectionChanged, getId(), itemId, curOption));
+		if (scrollToSelection) {
+			sendEvent(UIEvent(UIEventType::MakeAreaVisible, getId(), getOptionRect(curOption)));
+		}
+
+		if (getDataBindFormat() == UIDataBind::Format::String) {
+			notifyDataBind(itemId);
+		} else {
+			notifyDataBind(curOption);
+		}
+	}
+}
+
+UIVirtualList::SelectionMode UIVirtualList::getMode(KeyMods keyMods, int button) const
+{
+	const bool shiftHeld = (static_cast<int>(keyMods) & static_cast<int>(KeyMods::Shift)) != 0;
+	const bool ctrlHeld = (static_cast<int>(keyMods) & static_cast<int>(KeyMods::Ctrl)) != 0;
+	return button == 0 ? (shiftHeld ? SelectionMode::ShiftSelect : (ctrlHeld ? SelectionMode::CtrlSelect : SelectionMode::Normal)) : SelectionMode::Normal;
+}
@@ -0,0 +1,331 @@
+#include "halley/ui/widgets/ui_virtual_tree_list.h"
+#include "halley/ui/widgets/ui_tree_list.h"
+#include "halley/ui/widgets/ui_image.h"
+#include "halley/ui/widgets/ui_label.h"
+#include "halley/ui/ui_style.h"
+#include "halley/input/input_keyboard.h"
+#include "halley/support/exception.h"
+
+using namespace Halley;
+
+class UIVirtualTreeList::Source final : public IUIVirtualListSource {
+public:
+	explicit Source(UIVirtualTreeList& tree)
+		: tree(tree)
+	{}
+
+	size_t getNumberOfItems() const override
+	{
+		return tree.flatNodes.size();
+	}
+
+	String getItemId(size_t idx) const override
+	{
+		return tree.flatNodes[idx]->id;
+	}
+
+	std::optional<size_t> getItemIndex(const String& id) const override
+	{
+		const auto* node = tree.tryGetNode(id);
+		return node ? node->row : std::nullopt;
+	}
+
+	std::shared_ptr<UIWidget> makeItemWidget(UIVirtualList& list) override
+	{
+		return tree.makeRowWidget();
+	}
+
+	void bindItemWidget(UIVirtualList& list, UIWidget& widget, size_t idx) override
+	{
+		tree.bindRowWidget(widget, idx);
+	}
+
+private:
+	UIVirtualTreeList& tree;
+};
+
+class UIVirtualTreeList::Row final : public UIWidget {
+public:
+	explicit Row(const UIStyle& style)
+		: UIWidget("row", Vector2f(), UISizer(UISizerType::Horizontal))
+	{
+		controls = std::make_shared<UITreeListControls>("", style.getSubStyle("controls"));
+		add(controls, 0, {}, UISizerFillFlags::Fill);
+
+		const auto content = std::make_shared<UIWidget>("root", Vector2f(), UISizer());
+		icon = std::make_shared<UIImage>(Sprite());
+		content->add(icon, 0, {}, UISizerAlignFlags::Centre);
+
+		const auto& labelStyle = style.getSubStyle("label");
+		label = std::make_shared<UILabel>("label", labelStyle, labelStyle.getTextRenderer("normal"), LocalisedString());
+		if (labelStyle.hasTextRenderer("selected")) {
+			label->setSelectable(labelStyle.getTextRenderer("normal"), labelStyle.getTextRenderer("selected"), true);
+		}
+		content->add(label, 0, style.getBorder("labelBorder"), UISizerFillFlags::Fill);
+
+		add(content, 1);
+	}
+
+	std::shared_ptr<UITreeListControls> controls;
+	std::shared_ptr<UIImage> icon;
+	std::shared_ptr<UILabel> label;
+};
+
+UIVirtualTreeList::UIVirtualTreeList(String id, UIStyle style)
+	: UIVirtualList(std::move(id), std::move(style))
+{
+	setSource(std::make_shared<Source>(*this));
+
+	setHandle(UIEventType::TreeCollapseHandle, [=] (const UIEvent& event)
+	{
+		onExpandedChanged(event.getStringData(), false);
+	});
+
+	setHandle(UIEventType::TreeExpandHandle, [=] (const UIEvent& event)
+	{
+		onExpandedChanged(event.getStringData(), true);
+	});
+}
+
+void UIVirtualTreeList::addTreeItem(const String& id, const String& parentId, size_t childIndex, const LocalisedString& label, Sprite icon, bool expanded)
+{
+	if (nodes.contains(id)) {
+		throw Exception("Tree item \"" + id + "\" already exists in \"" + getId() + "\"", HalleyExceptions::UI);
+	}
+
+	auto& parent = getNodeOrRoot(parentId);
+	auto node = std::make_unique<Node>();
+	node->id = id;
+	node->label = label;
+	node->icon = std::move(icon);
+	node->parent = &parent;
+	node->expanded = expanded;
+
+	parent.children.insert(parent.children.begin() + std::min(childIndex, parent.children.size()), node.get());
+	nodes[id] = std::move(node);
+	needsUpdate = true;
+}
+
+void UIVirtualTreeList::removeItem(const String& id)
+{
+	if (auto* node = tryGetNode(id)) {
+		auto& siblings = node->parent->children;
+		siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+
+		// Rows can't keep pointing at removed nodes, so this is applied immediately. The nodes are kept alive until then, as the selection is read from the old rows.
+		Vector<std::unique_ptr<Node>> removed;
+		removeNode(*node, removed);
+		needsUpdate = true;
+		updateTree();
+	}
+}
+
+void UIVirtualTreeList::clearTree()
+{
+	auto removed = std::move(nodes);
+	nodes.clear();
+	root.children.clear();
+	needsUpdate = true;
+	updateTree();
+}
+
+void UIVirtualTreeList::setLabel(const String& id, const LocalisedString& label, Sprite icon)
+{
+	if (auto* node = tryGetNode(id)) {
+		node->label = label;
+		node->icon = std::move(icon);
+		if (node->row && !needsUpdate) {
+			refreshItem(*node->row);
+		}
+	}
+}
+
+void UIVirtualTreeList::setExpanded(const String& id, bool expanded)
+{
+	auto* node = tryGetNode(id);
+	if (node && node->expanded != expanded) {
+		node->expanded = expanded;
+		needsUpdate = true;
+	}
+}
+
+bool UIVirtualTreeList::isExpanded(const String& id) const
+{
+	const auto* node = tryGetNode(id);
+	return node && node->expanded;
+}
+
+void UIVirtualTreeList::expandParentsOfId(const String& id)
+{
+	if (auto* node = tryGetNode(id)) {
+		for (auto* p = node->parent; p != &root; p = p->parent) {
+			if (!p->expanded) {
+				p->expanded = true;
+				needsUpdate = true;
+			}
+		}
+	}
+}
+
+bool UIVirtualTreeList::hasTreeItem(const String& id) const
+{
+	return nodes.contains(id);
+}
+
+size_t UIVirtualTreeList::getNumberOfTreeItems() const
+{
+	return nodes.size();
+}
+
+String UIVirtualTreeList::getParentId(const String& id) const
+{
+	const auto* node = tryGetNode(id);
+	return node ? node->parent->id : "";
+}
+
+void UIVirtualTreeList::updateTree()
+{
+	if (!needsUpdate) {
+		return;
+	}
+	needsUpdate = false;
+
+	// Selection is kept by id, so grab it before the rows are rebuilt
+	const auto selectedIds = getSelectedOptionIds();
+	const auto curId = getSelectedOptionId();
+
+	for (auto& [id, node]: nodes) {
+		node->row.reset();
+	}
+	flatNodes.clear();
+	flatten(root);
+
+	Vector<size_t> selected;
+	for (const auto& id: selectedIds) {
+		if (const auto* node = tryGetNode(id); node && node->row) {
+			selected.push_back(*node->row);
+		}
+	}
+
+	// If the current item got hidden, fall back to its closest visible ancestor
+	int curOption = -1;
+	for (const auto* node = tryGetNode(curId); node && node != &root; node = node->parent) {
+		if (node->row) {
+			curOption = int(*node->row);
+			if (node->id != curId) {
+				selected = { *node->row };
+			}
+			break;
+		}
+	}
+
+	setSelection(std::move(selected), curOption);
+	refresh();
+}
+
+void UIVirtualTreeList::update(Time t, bool moved)
+{
+	updateTree();
+	UIVirtualList::update(t, moved);
+}
+
+bool UIVirtualTreeList::onKeyPress(KeyboardKeyPress key)
+{
+	if (isAcceptKeyboardInput() && (key.is(KeyCode::Left) || key.is(KeyCode::Right))) {
+		const auto* node = tryGetNode(getSelectedOptionId());
+		if (!node) {
+			return false;
+		}
+
+		const bool hasChildren = !node->children.empty();
+		if (key.is(KeyCode::Left)) {
+			if (hasChildren && node->expanded) {
+				onExpandedChanged(node->id, false);
+			} else if (node->parent != &root) {
+				setSelectedOptionId(node->parent->id);
+			}
+		} else {
+			if (hasChildren && !node->expanded) {
+				onExpandedChanged(node->id, true);
+			} else if (hasChildren) {
+				setSelectedOptionId(node->children.front()->id);
+			}
+		}
+		return true;
+	}
+
+	return UIVirtualList::onKeyPress(key);
+}
+
+UIVirtualTreeList::Node* UIVirtualTreeList::tryGetNode(const String& id)
+{
+	const auto iter = nodes.find(id);
+	return iter != nodes.end() ? iter->second.get() : nullptr;
+}
+
+const UIVirtualTreeList::Node* UIVirtualTreeList::tryGetNode(const String& id) const
+{
+	const auto iter = nodes.find(id);
+	return iter != nodes.end() ? iter->second.get() : nullptr;
+}
+
+UIVirtualTreeList::Node& UIVirtualTreeList::getNodeOrRoot(const String& id)
+{
+	auto* node = tryGetNode(id);
+	return node ? *node : root;
+}
+
+void UIVirtualTreeList::removeNode(Node& node, Vector<std::unique_ptr<Node>>& removed)
+{
+	for (auto* child: node.children) {
+		removeNode(*child, removed);
+	}
+	const auto iter = nodes.find(node.id);
+	removed.push_back(std::move(iter->second));
+	nodes.erase(iter);
+}
+
+void UIVirtualTreeList::flatten(Node& node)
+{
+	for (size_t i = 0; i < node.children.size(); ++i) {
+		auto& child = *node.children[i];
+		child.childIndex = i;
+		child.row = flatNodes.size();
+		flatNodes.push_back(&child);
+		if (child.expanded) {
+			flatten(child);
+		}
+	}
+}
+
+void UIVirtualTreeList::onExpandedChanged(const String& id, bool expanded)
+{
+	setExpanded(id, expanded);
+	updateTree();
+	sendEvent(UIEvent(UIEventType::TreeItemExpanded, getId(), id, expanded));
+}
+
+std::shared_ptr<UIWidget> UIVirtualTreeList::makeRowWidget()
+{
+	return std::make_shared<Row>(styles.at(0));
+}
+
+void UIVirtualTreeList::bindRowWidget(UIWidget& widget, size_t idx)
+{
+	auto& row = static_cast<Row&>(widget);
+	const auto& node = *flatNodes[idx];
+
+	// Same layout as UITreeListItem::doUpdateTree: the number of siblings left at each depth, from the top
+	Vector<int> itemsLeftPerDepth;
+	for (const auto* n = &node; n->parent; n = n->parent) {
+		itemsLeftPerDepth.push_back(int(n->parent->children.size() - n->childIndex));
+	}
+	std::reverse(itemsLeftPerDepth.begin(), itemsLeftPerDepth.end());
+
+	row.controls->setId(node.id);
+	row.controls->updateGuides(itemsLeftPerDepth, !node.children.empty(), node.expanded);
+	row.controls->setExpanded(node.expanded);
+	row.icon->setSprite(node.icon);
+	row.icon->setActive(node.icon.hasMaterial());
+	row.label->setText(node.label);
+}
@@ -215,6 +215,8 @@ public:
 
 private:
 	Vector<std::pair<EntityId, ScriptMessage>> pendingMessages;
+	ScriptParallelUpdater parallelUpdater;
+	Vector<ScriptParallelUpdater::Entity> parallelEntities;
 
 	void initializeEnvironment()
 	{
@@ -279,6 +281,11 @@ private:
 	void updateScripts(Time t)
 	{
 		auto& env = getScriptingService().getEnvironment();
+		if (getScriptingService().isParallelUpdate()) {
+			updateScriptsParallel(t);
+		}
+
+		// Anything left behind by the parallel update (i.e. scripts that require the main thread) is updated here
 		for (auto& e : scriptableFamily) {
 			e.scriptable.activeStates.terminateMarkedDead(env, e.entityId, e.scriptable.variables);
 
@@ -297,6 +304,21 @@ private:
 		}
 	}
 
+	void updateScriptsParallel(Time t)
+	{
+		auto& env = getScriptingService().getEnvironment();
+
+		parallelEntities.clear();
+		for (auto& e : scriptableFamily) {
+			e.scriptable.activeStates.terminateMarkedDead(env, e.entityId, e.scriptable.variables);
+			if (ScriptParallelUpdater::canUpdateInParallel(env, e.scriptable.activeStates)) {
+				parallelEntities.push_back({ e.entityId, &e.scriptable.activeStates, &e.scriptable.variables });
+			}
+		}
+
+		parallelUpdater.update(env, parallelEntities, t);
+	}
+
 	void eraseDeadScripts(ScriptableFamily& e)
 	{
 		e.scriptable.activeStates.removeDeadLocalStates(getWorld(), e.entityId);
@@ -1,6 +1,8 @@
 #include "dx11_texture.h"
 #include "dx11_video.h"
 #include "halley/graphics/texture_descriptor.h"
+#include "halley/graphics/texture_compression.h"
+#include "halley/file_formats/image.h"
 using namespace Halley;
 
 DX11Texture::DX11Texture(DX11Video& video, Vector2i size)
@@ -40,6 +42,7 @@ DX11Texture& DX11Texture::operator=(DX11Texture&& other) noexcept
 {
 	other.waitForLoad(true);
 
+	clear();
 	moveFrom(other);
 
 	texture = other.texture;
@@ -77,12 +80,20 @@ void DX11Texture::doLoad(TextureDescriptor& descriptor)
 {
 	clear();
 
-	int bpp = TextureDescriptor::getBytesPerPixel(descriptor.format);
+	// Block compressed textures come with their mips, and can't generate them
+	const bool blockCompressed = TextureDescriptor::isBlockCompressed(descriptor.format);
+	const bool generateMips = descriptor.useMipMap && !blockCompressed;
+
+	// Mips above firstMipLevel aren't resident, so it's allocated at a smaller size
+	const auto allocSize = blockCompressed ? TextureCompression::getMipSize(size, descriptor.firstMipLevel) : size;
+	if (blockCompressed && (allocSize.x % 4 != 0 || allocSize.y % 4 != 0)) {
+		throw Exception("Block compressed texture \"" + getAssetId() + "\" must be a multiple of 4 in size.", HalleyExceptions::VideoPlugin);
+	}
 
 	CD3D11_TEXTURE2D_DESC desc;
-	desc.Width = size.x;
-	desc.Height = size.y;
-	desc.MipLevels = descriptor.useMipMap ? 0 : 1;
+	desc.Width = allocSize.x;
+	desc.Height = allocSize.y;
+	desc.MipLevels = blockCompressed ? descriptor.mipLevels - descriptor.firstMipLevel : (generateMips ? 0 : 1);
 	desc.ArraySize = 1;
 
 	switch (descriptor.format) {
@@ -114,11 +125,17 @@ void DX11Texture::doLoad(TextureDescriptor& descriptor)
 	case TextureFormat::RGBAFloat16:
 		desc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
 		break;
+	case TextureFormat::BC1:
+		desc.Format = DXGI_FORMAT_BC1_UNORM;
+		break;
+	case TextureFormat::BC3:
+		desc.Format = DXGI_FORMAT_BC3_UNORM;
+		break;
 	default:
 		throw Exception("Unknown texture format", HalleyExceptions::VideoPlugin);
 	}
 
-	vramUsage = bpp * size.x * size.y;
+	vramUsage = blockCompressed ? TextureCompression::getMipChainByteSize(descriptor.format, allocSize, desc.MipLevels) : TextureDescriptor::getByteSize(descriptor.format, size);
 
 	desc.BindFlags = 0;
 	if (descriptor.isDepthStencil) {
@@ -130,29 +147,37 @@ void DX11Texture::doLoad(TextureDescriptor& descriptor)
 			desc.BindFlags |= D3D11_BIND_RENDER_TARGET;
 		}
 	}
-	if (descriptor.useMipMap) {
+	if (generateMips) {
 		desc.BindFlags |= D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
 	}
 
 	desc.SampleDesc.Count = 1;
 	desc.SampleDesc.Quality = 0;
-	desc.MiscFlags = descriptor.useMipMap ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0;
+	desc.MiscFlags = generateMips ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0;
 	format = desc.Format;
 
 	bool hasPixelData = false;
-	D3D11_SUBRESOURCE_DATA subResData;
+	Vector<D3D11_SUBRESOURCE_DATA> subResData(desc.MipLevels == 0 ? 1 : desc.MipLevels);
 			
 	if (descriptor.pixelData.empty()) {
 		desc.Usage = D3D11_USAGE_DEFAULT;
 	} else {
-		if (descriptor.canBeUpdated || descriptor.useMipMap) {
+		if (descriptor.canBeUpdated || generateMips) {
 			desc.Usage = D3D11_USAGE_DEFAULT;
 		} else {
 			desc.Usage = D3D11_USAGE_IMMUTABLE;
 		}
-		subResData.pSysMem = descriptor.pixelData.getSpan().data();
-		subResData.SysMemPitch = descriptor.pixelData.getStrideOr(bpp * size.x);
-		subResData.SysMemSlicePitch = 0;
+
+		auto data = descriptor.pixelData.getSpan();
+		for (size_t i = 0; i < subResData.size(); ++i) {
+			const auto mipSize = TextureCompression::getMipSize(allocSize, int(i));
+			subResData[i].pSysMem = data.data();
+			subResData[i].SysMemPitch = i == 0 ? descriptor.pixelData.getStrideOr(int(TextureDescriptor::getRowPitch(descriptor.format, mipSize.x))) : UINT(TextureDescriptor::getRowPitch(descriptor.format, mipSize.x));
+			subResData[i].SysMemSlicePitch = 0;
+			if (i + 1 < subResData.size()) {
+				data = data.subspan(TextureDescriptor::getByteSize(descriptor.format, mipSize));
+			}
+		}
 		hasPixelData = true;
 	}
 
@@ -162,7 +187,7 @@ void DX11Texture::doLoad(TextureDescriptor& descriptor)
 		desc.Usage = D3D11_USAGE_STAGING;
 	}
 
-	HRESULT result = video.getDevice().CreateTexture2D(&desc, hasPixelData && !descriptor.useMipMap ? &subResData : nullptr, &texture);
+	HRESULT result = video.getDevice().CreateTexture2D(&desc, hasPixelData && !generateMips ? subResData.data() : nullptr, &texture);
 	if (result != S_OK) {
 		throw Exception("Error loading texture.", HalleyExceptions::VideoPlugin);
 	}
@@ -171,7 +196,7 @@ void DX11Texture::doLoad(TextureDescriptor& descriptor)
 		CD3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
 		srvDesc.Format = desc.Format;
 		srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-		srvDesc.Texture2D.MipLevels = descriptor.useMipMap ? -1 : 1;
+		srvDesc.Texture2D.MipLevels = descriptor.useMipMap || blockCompressed ? -1 : 1;
 		srvDesc.Texture2D.MostDetailedMip = 0;
 
 		if (descriptor.format == TextureFormat::Depth) {
@@ -193,9 +218,9 @@ void DX11Texture::doLoad(TextureDescriptor& descriptor)
 			}
 		}
 		
-		if (descriptor.useMipMap) {
+		if (generateMips) {
 			if (hasPixelData) {
-				video.getDeviceContext().UpdateSubresource(texture, 0, nullptr, subResData.pSysMem, subResData.SysMemPitch, 0);
+				video.getDeviceContext().UpdateSubresource(texture, 0, nullptr, subResData[0].pSysMem, subResData[0].SysMemPitch, 0);
 			}
 			generateMipMaps();
 		}
@@ -237,9 +262,28 @@ void DX11Texture::bind(DX11Video& video, int textureUnit, TextureSamplerType sam
 	video.getDeviceContext().PSSetSamplers(textureUnit, 1, samplers);
 }
 
+void DX11Texture::doUpdateRegion(const Image& image, Rect4i area)
+{
+	D3D11_BOX box;
+	box.left = UINT(area.getLeft());
+	box.right = UINT(area.getRight());
+	box.top = UINT(area.getTop());
+	box.bottom = UINT(area.getBottom());
+	box.front = 0;
+	box.back = 1;
+
+	const auto pitch = UINT(image.getSize().x * 4);
+	const auto* src = image.getPixelBytes().data() + size_t(area.getTop()) * pitch + size_t(area.getLeft()) * 4;
+	video.getDeviceContext().UpdateSubresource(texture, 0, &box, src, pitch, 0);
+
+	if (descriptor.useMipMap) {
+		generateMipMaps();
+	}
+}
+
 void DX11Texture::generateMipMaps()
 {
-	if (descriptor.useMipMap && srv) {
+	if (descriptor.useMipMap && srv && !TextureDescriptor::isBlockCompressed(descriptor.format)) {
 		video.getDeviceContext().GenerateMips(srv);
 	}
 }
@@ -18,6 +18,7 @@ namespace Halley
 		DX11Texture& operator=(DX11Texture&& other) noexcept;
 
 		void doLoad(TextureDescriptor& descriptor) override;
+		void doUpdateRegion(const Image& image, Rect4i area) override;
 		void reload(Resource&& resource) override;
 		void bind(DX11Video& video, int textureUnit, TextureSamplerType samplerType) const;
 		void generateMipMaps() override;
@@ -15,6 +15,7 @@ namespace Halley {
 	public:
 		explicit MetalTexture(MetalVideo& video, Vector2i size);
 		void doLoad(TextureDescriptor& descriptor) override;
+		void doUpdateRegion(const Image& image, Rect4i area) override;
 		void bind(id<MTLRenderCommandEncoder> encoder, int bindIndex) const;
 
 	private:
@@ -1,5 +1,6 @@
 #include "metal_texture.h"
 #include "metal_video.h"
+#include <halley/file_formats/image.h>
 
 using namespace Halley;
 
@@ -81,6 +82,22 @@ void MetalTexture::doLoad(TextureDescriptor& descriptor)
 	doneLoading();
 }
 
+void MetalTexture::doUpdateRegion(const Image& image, Rect4i area)
+{
+	const NSUInteger bytesPerRow = 4 * image.getSize().x;
+	MTLRegion region = {
+		{ static_cast<NSUInteger>(area.getLeft()), static_cast<NSUInteger>(area.getTop()), 0 },
+		{ static_cast<NSUInteger>(area.getWidth()), static_cast<NSUInteger>(area.getHeight()), 1 }
+	};
+	const auto* src = image.getPixelBytes().data() + size_t(area.getTop()) * bytesPerRow + size_t(area.getLeft()) * 4;
+
+	[metalTexture replaceRegion:region
+		mipmapLevel:0
+		withBytes:src
+		bytesPerRow:bytesPerRow
+	];
+}
+
 void MetalTexture::bind(id<MTLRenderCommandEncoder> encoder, int bindIndex) const
 {
 	waitForLoad();
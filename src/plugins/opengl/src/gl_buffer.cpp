@@ -34,6 +34,47 @@ void GLBuffer::setData(gsl::span<const gsl::byte> data)
 	glCheckError();
 }
 
+void GLBuffer::reserve(size_t newCapacity)
+{
+	bind();
+	if (capacity < newCapacity) {
+		capacity = newCapacity;
+		glBufferData(target, static_cast<GLsizeiptr>(capacity), nullptr, usage);
+	}
+
+	glCheckError();
+}
+
+void GLBuffer::setSubData(size_t offset, gsl::span<const gsl::byte> data)
+{
+	Expects(offset + data.size_bytes() <= capacity);
+
+	bind();
+	glBufferSubData(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(data.size_bytes()), data.data());
+
+	glCheckError();
+}
+
+void GLBuffer::setSubDataUnsynchronized(size_t offset, gsl::span<const gsl::byte> data)
+{
+	Expects(offset + data.size_bytes() <= capacity);
+
+	bind();
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+	// Skips the implicit wait glBufferSubData does if the buffer is still in use
+	void* dst = glMapBufferRange(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(data.size_bytes()), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	glCheckError();
+	if (dst) {
+		memcpy(dst, data.data(), data.size_bytes());
+		glUnmapBuffer(target);
+	}
+#else
+	glBufferSubData(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(data.size_bytes()), data.data());
+#endif
+
+	glCheckError();
+}
+
 size_t GLBuffer::getSize() const
 {
 	return size;
@@ -15,6 +15,9 @@ namespace Halley
 		void bindToTarget(GLuint index);
 		void init(GLenum target, GLenum usage = GL_DYNAMIC_DRAW);
 		void setData(gsl::span<const gsl::byte> data);
+		void reserve(size_t capacity);
+		void setSubData(size_t offset, gsl::span<const gsl::byte> data);
+		void setSubDataUnsynchronized(size_t offset, gsl::span<const gsl::byte> data); // Caller must make sure the GPU isn't using this range
 		size_t getSize() const;
 
 	private:
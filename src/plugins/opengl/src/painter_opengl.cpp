@@ -16,6 +16,15 @@ PainterOpenGL::PainterOpenGL(VideoAPI& video, Resources& resources)
 
 PainterOpenGL::~PainterOpenGL()
 {
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+	for (auto& fence: streamFences) {
+		if (fence) {
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+#endif
+
 	if (vao != 0) {
 		glBindVertexArray(0);
 		glDeleteVertexArrays(1, &vao);
@@ -37,6 +46,7 @@ void PainterOpenGL::doStartRender()
 	vertexBuffer.init(GL_ARRAY_BUFFER);
 	elementBuffer.init(GL_ELEMENT_ARRAY_BUFFER);
 	stdQuadElementBuffer.init(GL_ELEMENT_ARRAY_BUFFER, GL_STATIC_DRAW);
+	quadCornerBuffer.init(GL_ARRAY_BUFFER, GL_STATIC_DRAW);
 
 	if (vao == 0) {
 		glGenVertexArrays(1, &vao);
@@ -199,27 +209,156 @@ void PainterOpenGL::setVertices(const MaterialDefinition& material, size_t numVe
 
 	// Load indices into VBO
 	if (standardQuadsOnly) {
-		if (stdQuadElementBuffer.getSize() < numIndices * sizeof(IndexType)) {
-			size_t indicesToAllocate = nextPowerOf2(numIndices);
-			Vector<IndexType> tmp(indicesToAllocate);
-			generateQuadIndices(0, indicesToAllocate / 6, tmp.data());
-			stdQuadElementBuffer.setData(gsl::as_bytes(gsl::span<IndexType>(tmp)));
-		} else {
-			stdQuadElementBuffer.bind();
-		}
+		bindStandardQuadIndices(numIndices);
 	} else {
 		elementBuffer.setData(gsl::as_bytes(gsl::span<const IndexType>(indices, numIndices)));
 	}
+	indexDrawOffset = 0;
 
 	// Load vertices into VBO
 	size_t bytesSize = numVertices * material.getVertexStride();
 	vertexBuffer.setData(gsl::as_bytes(gsl::span<const char>(static_cast<const char*>(vertexData), bytesSize)));
 
 	// Set attributes
-	setupVertexAttributes(material);
+	setupVertexAttributes(material, vertexBuffer, 0, false);
+}
+
+gsl::span<char> PainterOpenGL::getVertexStreamMemory()
+{
+	// No persistent mapping before GL 4.4, so Painter writes here and each range is copied as it's drawn, into the same offset of a GL buffer
+	// The copy maps the range unsynchronized, which is safe because the region fences guarantee the GPU is done with it
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+	if (vertexStreamMemory.empty()) {
+		vertexStreamMemory.resize(16 * 1024 * 1024);
+		vertexStreamBuffer.init(GL_ARRAY_BUFFER);
+		vertexStreamBuffer.reserve(vertexStreamMemory.size());
+	}
+	return vertexStreamMemory;
+#else
+	// No fences or unsynchronized mapping on GLES2, so draw data is uploaded the regular way
+	return {};
+#endif
+}
+
+gsl::span<char> PainterOpenGL::getIndexStreamMemory()
+{
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+	if (indexStreamMemory.empty()) {
+		indexStreamMemory.resize(2 * 1024 * 1024);
+		indexStreamBuffer.init(GL_ELEMENT_ARRAY_BUFFER);
+		indexStreamBuffer.reserve(indexStreamMemory.size());
+	}
+	return indexStreamMemory;
+#else
+	return {};
+#endif
+}
+
+void PainterOpenGL::setStreamedVertices(const MaterialDefinition& material, size_t numVertices, size_t vertexOffset, size_t numIndices, size_t indexOffset, bool standardQuadsOnly)
+{
+	Expects(numVertices > 0);
+	Expects(numIndices >= numVertices);
+
+	if (standardQuadsOnly) {
+		bindStandardQuadIndices(numIndices);
+		indexDrawOffset = 0;
+	} else {
+		indexStreamBuffer.setSubDataUnsynchronized(indexOffset, gsl::as_bytes(gsl::span<const char>(indexStreamMemory).subspan(indexOffset, numIndices * sizeof(IndexType))));
+		indexDrawOffset = indexOffset;
+	}
+
+	const size_t bytesSize = numVertices * material.getVertexStride();
+	vertexStreamBuffer.setSubDataUnsynchronized(vertexOffset, gsl::as_bytes(gsl::span<const char>(vertexStreamMemory).subspan(vertexOffset, bytesSize)));
+
+	setupVertexAttributes(material, vertexStreamBuffer, vertexOffset, false);
+}
+
+void PainterOpenGL::setStreamedInstances(const MaterialDefinition& material, size_t numInstances, size_t offset)
+{
+	Expects(numInstances > 0);
+
+	bindQuadCorners();
+	bindStandardQuadIndices(6);
+	indexDrawOffset = 0;
+
+	const size_t bytesSize = numInstances * material.getVertexStride();
+	vertexStreamBuffer.setSubDataUnsynchronized(offset, gsl::as_bytes(gsl::span<const char>(vertexStreamMemory).subspan(offset, bytesSize)));
+
+	setupVertexAttributes(material, vertexStreamBuffer, offset, true);
+}
+
+void PainterOpenGL::waitForStreamRegion(size_t region)
+{
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+	auto& fence = streamFences[region];
+	if (fence) {
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+		glDeleteSync(fence);
+		fence = nullptr;
+		glCheckError();
+	}
+#endif
+}
+
+void PainterOpenGL::fenceStreamRegion(size_t region)
+{
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+	auto& fence = streamFences[region];
+	if (fence) {
+		glDeleteSync(fence);
+	}
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glCheckError();
+#endif
+}
+
+bool PainterOpenGL::supportsInstancing() const
+{
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+	return true;
+#else
+	// GLES2 only has instancing through extensions
+	return false;
+#endif
+}
+
+void PainterOpenGL::setInstances(const MaterialDefinition& material, size_t numInstances, const void* instanceData)
+{
+	Expects(numInstances > 0);
+	Expects(instanceData);
+
+	bindQuadCorners();
+	bindStandardQuadIndices(6);
+	indexDrawOffset = 0;
+
+	size_t bytesSize = numInstances * material.getVertexStride();
+	vertexBuffer.setData(gsl::as_bytes(gsl::span<const char>(static_cast<const char*>(instanceData), bytesSize)));
+
+	setupVertexAttributes(material, vertexBuffer, 0, true);
+}
+
+void PainterOpenGL::bindQuadCorners()
+{
+	if (quadCornerBuffer.getSize() == 0) {
+		// Same layout drawSprites writes into vertPos: position and texture coordinates, both in 0-1 space
+		const Vector4f corners[] = { Vector4f(0, 0, 0, 0), Vector4f(1, 0, 1, 0), Vector4f(1, 1, 1, 1), Vector4f(0, 1, 0, 1) };
+		quadCornerBuffer.setData(gsl::as_bytes(gsl::span<const Vector4f>(corners)));
+	}
+}
+
+void PainterOpenGL::bindStandardQuadIndices(size_t numIndices)
+{
+	if (stdQuadElementBuffer.getSize() < numIndices * sizeof(IndexType)) {
+		size_t indicesToAllocate = nextPowerOf2(numIndices);
+		Vector<IndexType> tmp(indicesToAllocate);
+		generateQuadIndices(0, indicesToAllocate / 6, tmp.data());
+		stdQuadElementBuffer.setData(gsl::as_bytes(gsl::span<IndexType>(tmp)));
+	} else {
+		stdQuadElementBuffer.bind();
+	}
 }
 
-void PainterOpenGL::setupVertexAttributes(const MaterialDefinition& material)
+void PainterOpenGL::setupVertexAttributes(const MaterialDefinition& material, GLBuffer& buffer, size_t baseOffset, bool instanced)
 {
     uint32_t unusedLocations = 0xffff;
 
@@ -265,12 +404,28 @@ void PainterOpenGL::setupVertexAttributes(const MaterialDefinition& material)
 			break;
 		}
 		glEnableVertexAttribArray(attribute.location);
-		size_t offset = attribute.offset;
-		glVertexAttribPointer(attribute.location, count, type, GL_FALSE, GLsizei(vertexStride), reinterpret_cast<GLvoid*>(offset));
-		glCheckError();
-
         Ensures(attribute.location < 16);
         uint32_t mask = 1u << attribute.location;
+
+		const bool perInstance = instanced && !attribute.isVertexPos;
+		if (instanced && attribute.isVertexPos) {
+			quadCornerBuffer.bind();
+			glVertexAttribPointer(attribute.location, count, type, GL_FALSE, GLsizei(sizeof(Vector4f)), nullptr);
+			buffer.bind();
+		} else {
+			size_t offset = baseOffset + attribute.offset;
+			glVertexAttribPointer(attribute.location, count, type, GL_FALSE, GLsizei(vertexStride), reinterpret_cast<GLvoid*>(offset));
+		}
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+		if (perInstance != ((instancedLocations & mask) != 0)) {
+			glVertexAttribDivisor(attribute.location, perInstance ? 1 : 0);
+			instancedLocations ^= mask;
+		}
+#else
+		Expects(!perInstance);
+#endif
+		glCheckError();
+
         Ensures((unusedLocations & mask) != 0);
         unusedLocations &= ~mask;
 	}
@@ -292,6 +447,18 @@ void PainterOpenGL::drawTriangles(size_t numIndices)
 	Expects(numIndices > 0);
 	Expects(numIndices % 3 == 0);
 
-	glDrawElements(GL_TRIANGLES, int(numIndices), GL_UNSIGNED_SHORT, nullptr);
+	glDrawElements(GL_TRIANGLES, int(numIndices), GL_UNSIGNED_SHORT, reinterpret_cast<const GLvoid*>(indexDrawOffset));
+	glCheckError();
+}
+
+void PainterOpenGL::drawInstancedQuads(size_t numInstances)
+{
+	Expects(numInstances > 0);
+
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+	glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, reinterpret_cast<const GLvoid*>(indexDrawOffset), GLsizei(numInstances));
 	glCheckError();
+#else
+	throw Exception("Instanced drawing is not supported on this OpenGL version.", HalleyExceptions::VideoPlugin);
+#endif
 }
@@ -27,6 +27,15 @@ namespace Halley
 	protected:
 		void setVertices(const MaterialDefinition& material, size_t numVertices, const void* vertexData, size_t numIndices, const IndexType* indices, bool standardQuadsOnly) override;
 		void drawTriangles(size_t numIndices) override;
+		bool supportsInstancing() const override;
+		void setInstances(const MaterialDefinition& material, size_t numInstances, const void* instanceData) override;
+		void drawInstancedQuads(size_t numInstances) override;
+		gsl::span<char> getVertexStreamMemory() override;
+		gsl::span<char> getIndexStreamMemory() override;
+		void setStreamedVertices(const MaterialDefinition& material, size_t numVertices, size_t vertexOffset, size_t numIndices, size_t indexOffset, bool standardQuadsOnly) override;
+		void setStreamedInstances(const MaterialDefinition& material, size_t numInstances, size_t offset) override;
+		void waitForStreamRegion(size_t region) override;
+		void fenceStreamRegion(size_t region) override;
 		void setViewPort(Rect4i rect) override;
 		void onUpdateProjection(Material& material, bool hashChanged) override;
 
@@ -35,9 +44,21 @@ namespace Halley
 		GLBuffer vertexBuffer;
 		GLBuffer elementBuffer;
 		GLBuffer stdQuadElementBuffer;
+		GLBuffer quadCornerBuffer;
+		GLBuffer vertexStreamBuffer;
+		GLBuffer indexStreamBuffer;
+		Vector<char> vertexStreamMemory;
+		Vector<char> indexStreamMemory;
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+		std::array<GLsync, streamRegions> streamFences = {};
+#endif
+		size_t indexDrawOffset = 0;
+		uint32_t instancedLocations = 0;
 		std::unique_ptr<GLUtils> glUtils;
 		std::optional<Rect4i> clipping;
 
-		void setupVertexAttributes(const MaterialDefinition& material);
+		void bindStandardQuadIndices(size_t numIndices);
+		void bindQuadCorners();
+		void setupVertexAttributes(const MaterialDefinition& material, GLBuffer& buffer, size_t baseOffset, bool instanced);
 	};
 }
@@ -3,6 +3,8 @@
 #include "halley_gl.h"
 #include "texture_opengl.h"
 #include "halley/graphics/texture_descriptor.h"
+#include "halley/graphics/texture_compression.h"
+#include "halley/file_formats/image.h"
 #include <gsl/assert>
 #include "video_opengl.h"
 #include "halley/game/game_platform.h"
@@ -11,6 +13,13 @@
 
 using namespace Halley;
 
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 TextureOpenGL::TextureOpenGL(VideoOpenGL& parent, Vector2i size)
 	: Texture(size)
 	, parent(parent)
@@ -35,10 +44,9 @@ TextureOpenGL& TextureOpenGL::operator=(TextureOpenGL&& other) noexcept
 
 	moveFrom(other);
 
-	textureId = other.textureId;
+	// Swapped rather than overwritten, so other deletes the texture being replaced
+	std::swap(textureId, other.textureId);
 	texSize = other.texSize;
-
-	other.textureId = 0;
 	other.texSize = {};
 
 	doneLoading();
@@ -52,7 +60,9 @@ void TextureOpenGL::doLoad(TextureDescriptor& d)
     glUtils.setTextureUnit(0);
 	glUtils.bindTexture(textureId);
 	
-	if (texSize != d.size) {
+	if (TextureDescriptor::isBlockCompressed(d.format)) {
+		createCompressed(d.size, d.format, d.firstMipLevel, d.mipLevels, d.useFiltering, d.addressMode, d.pixelData);
+	} else if (texSize != d.size) {
 		create(d.size, d.format, d.useMipMap, d.useFiltering, d.addressMode, d.pixelData);
 	} else if (!d.pixelData.empty()) {
 		updateImage(d.pixelData, d.format, d.useMipMap);
@@ -60,6 +70,35 @@ void TextureOpenGL::doLoad(TextureDescriptor& d)
 	finishLoading();
 }
 
+void TextureOpenGL::doUpdateRegion(const Image& image, Rect4i area)
+{
+	waitForOpenGLLoad();
+
+	GLUtils glUtils;
+	glUtils.setTextureUnit(0);
+	glUtils.bindTexture(textureId);
+
+	const int width = image.getSize().x;
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+#if defined(WITH_OPENGL) || defined(WITH_OPENGL_ES3)
+	// Rows are read with the stride of the whole image, starting from the area's first pixel
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+	const auto* src = image.getPixelBytes().data() + (size_t(area.getTop()) * width + area.getLeft()) * 4;
+	glTexSubImage2D(GL_TEXTURE_2D, 0, area.getLeft(), area.getTop(), area.getWidth(), area.getHeight(), GL_RGBA, GL_UNSIGNED_BYTE, src);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+#else
+	// No GL_UNPACK_ROW_LENGTH on GLES2, so the area's rows go in whole
+	const auto* src = image.getPixelBytes().data() + size_t(area.getTop()) * width * 4;
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.getTop(), width, area.getHeight(), GL_RGBA, GL_UNSIGNED_BYTE, src);
+#endif
+	glCheckError();
+
+	if (descriptor.useMipMap) {
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glCheckError();
+	}
+}
+
 void TextureOpenGL::reload(Resource&& resource)
 {
 	*this = std::move(dynamic_cast<TextureOpenGL&>(resource));
@@ -67,7 +106,7 @@ void TextureOpenGL::reload(Resource&& resource)
 
 void TextureOpenGL::generateMipMaps()
 {
-	if (descriptor.useMipMap) {
+	if (descriptor.useMipMap && !TextureDescriptor::isBlockCompressed(descriptor.format)) {
 		GLUtils glUtils;
 	    glUtils.setTextureUnit(0);
 		glUtils.bindTexture(textureId);
@@ -133,24 +172,7 @@ void TextureOpenGL::create(Vector2i size, TextureFormat format, bool useMipMap,
 	//Expects(size.y <= 4096);
 	glCheckError();
 
-#if defined (WITH_OPENGL)
-	if (useMipMap) {
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, -1);
-	}
-#endif
-
-	const auto wrap = getGLAddressMode(addressMode);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
-
-	const int filtering = useFiltering ? GL_LINEAR : GL_NEAREST;
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, useMipMap ? GL_LINEAR_MIPMAP_LINEAR : filtering);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filtering);
-
-	if (format == TextureFormat::Depth) {
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
-	}
+	setSamplerParameters(format, useMipMap, useFiltering, addressMode);
 
 	const auto internalFormat = getGLInternalFormat(format);
 	const auto pixelFormat = getGLPixelFormat(format);
@@ -177,6 +199,69 @@ void TextureOpenGL::create(Vector2i size, TextureFormat format, bool useMipMap,
 	texSize = size;
 }
 
+void TextureOpenGL::createCompressed(Vector2i fullSize, TextureFormat format, int firstMipLevel, int mipLevels, bool useFiltering, TextureAddressMode addressMode, TextureDescriptorImageData& pixelData)
+{
+	Expects(fullSize.x > 0);
+	Expects(fullSize.y > 0);
+	Expects(firstMipLevel >= 0 && firstMipLevel < mipLevels);
+	glCheckError();
+
+	// Mips above firstMipLevel aren't resident, so it's allocated at a smaller size
+	const auto size = TextureCompression::getMipSize(fullSize, firstMipLevel);
+	const int levels = mipLevels - firstMipLevel;
+
+#if defined (WITH_OPENGL)
+	const auto internalFormat = format == TextureFormat::BC1 ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	if (pixelData.getSpan().size_bytes() < TextureCompression::getMipChainByteSize(format, size, levels)) {
+		throw Exception("Not enough data for compressed texture \"" + getAssetId() + "\"", HalleyExceptions::VideoPlugin);
+	}
+
+	setSamplerParameters(format, levels > 1, useFiltering, addressMode);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+	auto data = pixelData.getSpan();
+	for (int i = 0; i < levels; ++i) {
+		const auto mipSize = TextureCompression::getMipSize(size, i);
+		const auto mipBytes = TextureDescriptor::getByteSize(format, mipSize);
+		glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, mipSize.x, mipSize.y, 0, static_cast<GLsizei>(mipBytes), data.data());
+		glCheckError();
+		data = data.subspan(mipBytes);
+	}
+#else
+	// S3TC isn't guaranteed on GLES, so decode the top level on the CPU
+	TextureDescriptorImageData decoded(TextureCompression::decompress(pixelData.getSpan(), format, size));
+	create(size, TextureFormat::RGBA, false, useFiltering, addressMode, decoded);
+#endif
+
+#ifdef WITH_OPENGL
+	glObjectLabel(GL_TEXTURE, textureId, -1, getAssetId().c_str());
+#endif
+
+	texSize = fullSize;
+}
+
+void TextureOpenGL::setSamplerParameters(TextureFormat format, bool useMipMap, bool useFiltering, TextureAddressMode addressMode)
+{
+#if defined (WITH_OPENGL)
+	if (useMipMap) {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, -1);
+	}
+#endif
+
+	const auto wrap = getGLAddressMode(addressMode);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+
+	const int filtering = useFiltering ? GL_LINEAR : GL_NEAREST;
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, useMipMap ? GL_LINEAR_MIPMAP_LINEAR : filtering);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filtering);
+
+	if (format == TextureFormat::Depth) {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	}
+}
+
 void TextureOpenGL::updateImage(TextureDescriptorImageData& pixelData, TextureFormat format, bool useMipMap)
 {
 	int stride = pixelData.getStrideOr(size.x);
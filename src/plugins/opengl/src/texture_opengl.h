@@ -21,6 +21,7 @@ namespace Halley
 		unsigned int getNativeId() const;
 
 		void doLoad(TextureDescriptor& descriptor) override;
+		void doUpdateRegion(const Image& image, Rect4i area) override;
 		void reload(Resource&& resource) override;
 
 		void generateMipMaps() override;
@@ -28,6 +29,8 @@ namespace Halley
 	private:
 		void updateImage(TextureDescriptorImageData& pixelData, TextureFormat format, bool useMipMap);
 		void create(Vector2i size, TextureFormat format, bool useMipMap, bool useFiltering, TextureAddressMode addressMode, TextureDescriptorImageData& imgData);
+		void createCompressed(Vector2i fullSize, TextureFormat format, int firstMipLevel, int mipLevels, bool useFiltering, TextureAddressMode addressMode, TextureDescriptorImageData& imgData);
+		void setSamplerParameters(TextureFormat format, bool useMipMap, bool useFiltering, TextureAddressMode addressMode);
 
 		static int getGLInternalFormat(TextureFormat format);
 		static unsigned int getGLPixelFormat(TextureFormat format);
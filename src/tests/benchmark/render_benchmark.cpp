@@ -0,0 +1,267 @@
+#include <halley.hpp>
+#include <iostream>
+using namespace Halley;
+
+// Measures the CPU side of rendering a synthetic scene through SpritePainter and Painter on the dummy video backend
+// Usage: halley-render-benchmark [--sprites N] [--texts N] [--particles N] [--materials N] [--frames N] [--warmup N] [--no-instancing] [--unordered]
+// Prints the per frame averages as JSON
+
+namespace {
+	struct BenchmarkOptions {
+		int sprites = 20000;
+		int texts = 200;
+		int particles = 50;
+		int materials = 8;
+		int frames = 300;
+		int warmup = 30;
+		bool instancing = true;
+		bool unordered = false;
+	};
+
+	bool parseOptions(int argc, char** argv, BenchmarkOptions& options)
+	{
+		const HashMap<String, int*> intOptions = {
+			{ "--sprites", &options.sprites },
+			{ "--texts", &options.texts },
+			{ "--particles", &options.particles },
+			{ "--materials", &options.materials },
+			{ "--frames", &options.frames },
+			{ "--warmup", &options.warmup }
+		};
+
+		for (int i = 1; i < argc; ++i) {
+			const auto arg = String(argv[i]);
+			if (arg == "--no-instancing") {
+				options.instancing = false;
+			} else if (arg == "--unordered") {
+				options.unordered = true;
+			} else if (const auto iter = intOptions.find(arg); iter != intOptions.end() && i + 1 < argc && String(argv[i + 1]).isInteger()) {
+				*iter->second = std::max(String(argv[++i]).toInteger(), 0);
+			} else {
+				std::cerr << "Unknown argument: " << arg << std::endl;
+				return false;
+			}
+		}
+		options.materials = std::max(options.materials, 1);
+		options.frames = std::max(options.frames, 1);
+		return true;
+	}
+
+	std::shared_ptr<Font> makeFont(Resources& resources)
+	{
+		// Distance field, like the fonts the importer generates
+		auto font = std::make_shared<Font>("benchmark", "benchmark_font", 14.0f, 18.0f, 16.0f, 1.0f, Vector2i(256, 128), 4.0f, Vector<String>(), false);
+		for (int c = 32; c < 127; ++c) {
+			const int idx = c - 32;
+			const auto area = Rect4f(float(idx % 16) / 16.0f, float(idx / 16) / 8.0f, 1.0f / 16.0f, 1.0f / 8.0f);
+			font->addGlyph(Font::Glyph(c, area, Vector2f(10, 16), Vector2f(0, 14), Vector2f(), Vector2f(float(8 + c % 3), 0)));
+		}
+		font->finishAddingGlyphs();
+
+		auto material = std::make_shared<Material>(resources.get<MaterialDefinition>("Halley/Text"));
+		material->set(0, resources.get<Texture>("benchmark_font"));
+		font->setMaterial(std::move(material));
+		return font;
+	}
+
+	class BenchmarkScene {
+	public:
+		BenchmarkScene(const BenchmarkOptions& options, Resources& resources, Rect4f area)
+			: rng(uint32_t(1234))
+		{
+			for (int i = 0; i < options.materials; ++i) {
+				auto material = std::make_shared<Material>(resources.get<MaterialDefinition>(MaterialDefinition::defaultMaterial));
+				material->set(0, resources.get<Texture>("benchmark_" + toString(i)));
+				materials.push_back(std::move(material));
+			}
+
+			auto makeSprite = [&] (Vector2f pos, float size)
+			{
+				Sprite sprite;
+				sprite
+					.setMaterial(rng.getRandomElement(materials))
+					.setTexRect(Rect4f(0, 0, 1, 1))
+					.setSize(Vector2f(size, size))
+					.setPivot(Vector2f(0.5f, 0.5f))
+					.setPosition(pos);
+				return sprite;
+			};
+			auto randomPos = [&] ()
+			{
+				return Vector2f(rng.getFloat(area.getLeft(), area.getRight()), rng.getFloat(area.getTop(), area.getBottom()));
+			};
+
+			for (int i = 0; i < options.sprites; ++i) {
+				sprites.push_back(makeSprite(randomPos(), rng.getFloat(8.0f, 64.0f)));
+				spriteLayers.push_back(rng.getInt(0, 3));
+			}
+
+			const auto font = makeFont(resources);
+			for (int i = 0; i < options.texts; ++i) {
+				auto& text = texts.emplace_back(font, "Label number " + toString(i), 16);
+				text.setPosition(randomPos());
+			}
+
+			ConfigNode::MapType emitterConfig;
+			emitterConfig["spawnRate"] = 100.0f;
+			emitterConfig["spawnArea"] = Vector2f(32, 32);
+			emitterConfig["ttl"] = Range<float>(1.0f, 2.0f);
+			emitterConfig["speed"] = Range<float>(20.0f, 60.0f);
+			emitterConfig["azimuth"] = Range<float>(0.0f, 360.0f);
+			emitterConfig["fadeOutTime"] = 0.5f;
+			const auto emitterNode = ConfigNode(std::move(emitterConfig));
+
+			EntitySerializationContext context;
+			context.resources = &resources;
+			for (int i = 0; i < options.particles; ++i) {
+				auto& emitter = particles.emplace_back(emitterNode, resources, context);
+				emitter.setSprites({ makeSprite(Vector2f(), 8) });
+				emitter.setPosition(randomPos());
+			}
+		}
+
+		void update(int frame)
+		{
+			constexpr Time dt = 1.0 / 60.0;
+			for (auto& emitter: particles) {
+				emitter.update(dt);
+				emitter.updateSprites(dt);
+			}
+
+			// A quarter of the texts change every frame, like counters and timers do
+			for (size_t i = size_t(frame % 4); i < texts.size(); i += 4) {
+				texts[i].setText("Label number " + toString(i) + ": " + toString(frame));
+			}
+		}
+
+		void collect(SpritePainter& spritePainter) const
+		{
+			for (size_t i = 0; i < sprites.size(); ++i) {
+				spritePainter.add(sprites[i], 1, spriteLayers[i], sprites[i].getPosition().y);
+			}
+			for (const auto& emitter: particles) {
+				const auto emitterSprites = emitter.getSprites();
+				if (!emitterSprites.empty()) {
+					spritePainter.add(emitterSprites, 1, 2, emitterSprites[0].getPosition().y);
+				}
+			}
+			for (const auto& text: texts) {
+				spritePainter.add(text, 1, 4, text.getPosition().y);
+			}
+		}
+
+		size_t getNumParticles() const
+		{
+			size_t n = 0;
+			for (const auto& emitter: particles) {
+				n += emitter.getSprites().size();
+			}
+			return n;
+		}
+
+	private:
+		Random rng;
+		Vector<std::shared_ptr<Material>> materials;
+		Vector<Sprite> sprites;
+		Vector<int> spriteLayers;
+		Vector<TextRenderer> texts;
+		std::list<Particles> particles;
+	};
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		return 1;
+	}
+
+	const auto screenSize = Vector2i(1920, 1080);
+	HeadlessRenderer renderer(screenSize);
+	renderer.getPainter().setInstancingEnabled(options.instancing);
+
+	// Scene spreads a bit past the screen, so some of it gets culled
+	const auto view = Rect4f(Vector2f(), Vector2f(screenSize));
+	BenchmarkScene scene(options, renderer.getResources(), view.grow(256));
+	SpritePainter spritePainter;
+	if (options.unordered) {
+		// Sprite layers, as if they didn't overlap or were additive
+		for (int layer = 0; layer < 4; ++layer) {
+			spritePainter.setLayerUnordered(layer);
+		}
+	}
+
+	Stopwatch updateTime(false);
+	Stopwatch collectTime(false);
+	Stopwatch drawTime(false);
+	Stopwatch totalTime(false);
+	size_t drawCalls = 0;
+	size_t vertices = 0;
+	size_t triangles = 0;
+	size_t bytesUploaded = 0;
+	size_t bytesStreamed = 0;
+	size_t bindsAvoided = 0;
+	size_t particles = 0;
+
+	for (int frame = 0; frame < options.warmup + options.frames; ++frame) {
+		if (frame == options.warmup) {
+			for (auto* stopwatch: { &updateTime, &collectTime, &drawTime, &totalTime }) {
+				stopwatch->reset();
+			}
+		}
+
+		totalTime.start();
+
+		updateTime.start();
+		scene.update(frame);
+		updateTime.pause();
+
+		renderer.render([&] (RenderContext& rc)
+		{
+			collectTime.start();
+			spritePainter.startFrame();
+			scene.collect(spritePainter);
+			collectTime.pause();
+
+			rc.bind([&] (Painter& painter)
+			{
+				drawTime.start();
+				spritePainter.draw(1, painter);
+				drawTime.pause();
+			});
+		});
+
+		totalTime.pause();
+
+		if (frame >= options.warmup) {
+			const auto& painter = renderer.getPainter();
+			drawCalls += painter.getNumDrawCalls();
+			vertices += painter.getNumVertices();
+			triangles += painter.getNumTriangles();
+			bytesUploaded += painter.getNumBytesUploaded();
+			bytesStreamed += painter.getNumBytesStreamed();
+			bindsAvoided += painter.getNumBindsAvoided();
+			particles += scene.getNumParticles();
+		}
+	}
+
+	const auto nFrames = double(options.frames);
+	auto perFrameUs = [&] (const Stopwatch& stopwatch) { return double(stopwatch.elapsedNanoseconds()) / nFrames / 1000.0; };
+	const auto total = perFrameUs(totalTime);
+	const auto update = perFrameUs(updateTime);
+	const auto collect = perFrameUs(collectTime);
+	const auto draw = perFrameUs(drawTime);
+
+	std::cout << "{\n";
+	std::cout << "  \"scene\": { \"sprites\": " << options.sprites << ", \"texts\": " << options.texts << ", \"particleEmitters\": " << options.particles
+		<< ", \"materials\": " << options.materials << ", \"frames\": " << options.frames << ", \"instancing\": " << (options.instancing ? "true" : "false") << ", \"unordered\": " << (options.unordered ? "true" : "false") << " },\n";
+	std::cout << "  \"timingsUs\": { \"update\": " << update << ", \"collect\": " << collect << ", \"draw\": " << draw
+		<< ", \"submit\": " << (total - update - collect - draw) << ", \"total\": " << total << " },\n";
+	std::cout << "  \"perFrame\": { \"drawCalls\": " << double(drawCalls) / nFrames << ", \"vertices\": " << double(vertices) / nFrames
+		<< ", \"triangles\": " << double(triangles) / nFrames << ", \"vertexBytes\": " << double(bytesUploaded) / nFrames
+		<< ", \"streamedBytes\": " << double(bytesStreamed) / nFrames << ", \"bindsAvoided\": " << double(bindsAvoided) / nFrames
+		<< ", \"particles\": " << double(particles) / nFrames << " }\n";
+	std::cout << "}" << std::endl;
+
+	return 0;
+}
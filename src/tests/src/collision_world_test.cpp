@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	Rect4f makeRandomRect(Random& rng, float worldSize, float maxSize)
+	{
+		const auto pos = Vector2f(rng.getFloat(0.0f, worldSize), rng.getFloat(0.0f, worldSize));
+		return Rect4f(pos, rng.getFloat(1.0f, maxSize), rng.getFloat(1.0f, maxSize));
+	}
+
+	Vector<DynamicAABBTree::Pair> getPairsBruteForce(const DynamicAABBTree& tree, gsl::span<const DynamicAABBTree::Handle> handles)
+	{
+		Vector<DynamicAABBTree::Pair> result;
+		for (size_t i = 0; i < handles.size(); ++i) {
+			for (size_t j = i + 1; j < handles.size(); ++j) {
+				if (tree.getFatBounds(handles[i]).overlaps(tree.getFatBounds(handles[j]))) {
+					result.emplace_back(std::min(handles[i], handles[j]), std::max(handles[i], handles[j]));
+				}
+			}
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+}
+
+TEST(HalleyCollisionWorld, TreeInsertMoveRemove)
+{
+	Random rng(uint32_t(1));
+	DynamicAABBTree tree;
+	Vector<DynamicAABBTree::Handle> handles;
+
+	for (int i = 0; i < 500; ++i) {
+		handles.push_back(tree.insert(makeRandomRect(rng, 1000.0f, 30.0f)));
+	}
+	for (int i = 0; i < 1000; ++i) {
+		const auto idx = rng.getSizeT(0, handles.size() - 1);
+		tree.move(handles[idx], makeRandomRect(rng, 1000.0f, 30.0f), Vector2f(rng.getFloat(-5.0f, 5.0f), rng.getFloat(-5.0f, 5.0f)));
+	}
+	for (int i = 0; i < 200; ++i) {
+		const auto idx = rng.getSizeT(0, handles.size() - 1);
+		tree.remove(handles[idx]);
+		handles.erase(handles.begin() + idx);
+	}
+
+	EXPECT_EQ(tree.size(), handles.size());
+	EXPECT_LT(tree.getHeight(), 30);
+
+	Vector<DynamicAABBTree::Pair> pairs;
+	tree.getOverlappingPairs(pairs);
+	std::sort(pairs.begin(), pairs.end());
+	EXPECT_EQ(pairs, getPairsBruteForce(tree, handles));
+
+	// Queries
+	for (int i = 0; i < 100; ++i) {
+		const auto rect = makeRandomRect(rng, 1000.0f, 100.0f);
+		Vector<DynamicAABBTree::Handle> found;
+		tree.query(rect, [&] (DynamicAABBTree::Handle h) { found.push_back(h); return true; });
+		std::sort(found.begin(), found.end());
+
+		Vector<DynamicAABBTree::Handle> expected;
+		for (auto h: handles) {
+			if (tree.getFatBounds(h).overlaps(rect)) {
+				expected.push_back(h);
+			}
+		}
+		std::sort(expected.begin(), expected.end());
+		EXPECT_EQ(found, expected);
+	}
+}
+
+TEST(HalleyCollisionWorld, NewOverlappingPairs)
+{
+	Random rng(uint32_t(2));
+	DynamicAABBTree tree;
+	Vector<DynamicAABBTree::Handle> handles;
+	for (int i = 0; i < 300; ++i) {
+		handles.push_back(tree.insert(makeRandomRect(rng, 500.0f, 30.0f)));
+	}
+
+	// Everything is new, so it should find all pairs
+	Vector<DynamicAABBTree::Pair> pairs;
+	tree.getNewOverlappingPairs(pairs);
+	EXPECT_EQ(pairs, getPairsBruteForce(tree, handles));
+
+	// Move a few elements far away, new pairs must all involve them
+	Vector<DynamicAABBTree::Handle> movedHandles;
+	for (int i = 0; i < 10; ++i) {
+		const auto h = handles[i * 7];
+		if (tree.move(h, makeRandomRect(rng, 500.0f, 30.0f))) {
+			movedHandles.push_back(h);
+		}
+	}
+	pairs.clear();
+	tree.getNewOverlappingPairs(pairs);
+	for (const auto& p: pairs) {
+		EXPECT_TRUE(std_ex::contains(movedHandles, p.first) || std_ex::contains(movedHandles, p.second));
+	}
+	const auto all = getPairsBruteForce(tree, handles);
+	for (const auto& p: all) {
+		if (std_ex::contains(movedHandles, p.first) || std_ex::contains(movedHandles, p.second)) {
+			EXPECT_TRUE(std_ex::contains(pairs, p));
+		}
+	}
+
+	pairs.clear();
+	tree.getNewOverlappingPairs(pairs);
+	EXPECT_TRUE(pairs.empty());
+}
+
+TEST(HalleyCollisionWorld, NarrowphaseAndRayCast)
+{
+	CollisionWorld world;
+	const auto circleA = world.add(Circle(Vector2f(0, 0), 10), 1);
+	const auto circleB = world.add(Circle(Vector2f(15, 0), 10), 2);
+	const auto square = world.add(Polygon(Rect4f(100, 0, 20, 20)), 3);
+	const auto farCircle = world.add(Circle(Vector2f(125, 10), 4), 4); // Close to square's bounds, but not touching it
+
+	Vector<CollisionWorld::Pair> collisions;
+	world.getCollisions(collisions);
+	ASSERT_EQ(collisions.size(), 1);
+	EXPECT_EQ(collisions[0], CollisionWorld::Pair(std::min(circleA, circleB), std::max(circleA, circleB)));
+
+	// Move the circle into the square
+	world.setShape(farCircle, Circle(Vector2f(118, 10), 4), Vector2f(-7, 0));
+	collisions.clear();
+	world.getCollisions(collisions);
+	EXPECT_EQ(collisions.size(), 2);
+	EXPECT_EQ(world.getUserData(farCircle), 4);
+
+	const auto hit = world.rayCast(Ray(Vector2f(50, 10), Vector2f(1, 0)), 1000.0f);
+	ASSERT_TRUE(hit.has_value());
+	EXPECT_EQ(hit->handle, square);
+	EXPECT_NEAR(hit->result.distance, 50.0f, 0.001f);
+
+	EXPECT_FALSE(world.rayCast(Ray(Vector2f(50, 10), Vector2f(1, 0)), 40.0f).has_value());
+
+	world.remove(square);
+	const auto hit2 = world.rayCast(Ray(Vector2f(50, 10), Vector2f(1, 0)), 1000.0f);
+	ASSERT_TRUE(hit2.has_value());
+	EXPECT_EQ(hit2->handle, farCircle);
+}
+
+TEST(HalleyCollisionWorld, DISABLED_Benchmark50kMovingObjects)
+{
+	// Run with --gtest_also_run_disabled_tests
+	constexpr size_t nObjects = 50000;
+	constexpr size_t nFrames = 60;
+	constexpr float worldSize = 10000.0f;
+
+	Random rng(uint32_t(42));
+	CollisionWorld world;
+
+	Vector<Vector2f> positions;
+	Vector<Vector2f> velocities;
+	Vector<CollisionWorld::Handle> handles;
+	for (size_t i = 0; i < nObjects; ++i) {
+		positions.push_back(Vector2f(rng.getFloat(0, worldSize), rng.getFloat(0, worldSize)));
+		velocities.push_back(Vector2f(rng.getFloat(-2.0f, 2.0f), rng.getFloat(-2.0f, 2.0f)));
+		handles.push_back(world.add(Circle(positions.back(), rng.getFloat(2.0f, 10.0f))));
+	}
+
+	Stopwatch updateTimer(false);
+	Stopwatch pairsTimer(false);
+	Vector<CollisionWorld::Pair> collisions;
+	size_t totalCollisions = 0;
+
+	for (size_t frame = 0; frame < nFrames; ++frame) {
+		updateTimer.start();
+		for (size_t i = 0; i < nObjects; ++i) {
+			positions[i] += velocities[i];
+			const auto radius = world.getShape(handles[i]).getCircle().getRadius();
+			world.setShape(handles[i], Circle(positions[i], radius), velocities[i]);
+		}
+		updateTimer.pause();
+
+		pairsTimer.start();
+		collisions.clear();
+		world.getCollisions(collisions);
+		totalCollisions += collisions.size();
+		pairsTimer.pause();
+	}
+
+	std::cout << nObjects << " objects, " << nFrames << " frames: update " << (updateTimer.elapsedMicroseconds() / nFrames) << " us/frame, pairs "
+		<< (pairsTimer.elapsedMicroseconds() / nFrames) << " us/frame, " << (totalCollisions / nFrames) << " collisions/frame" << std::endl;
+}
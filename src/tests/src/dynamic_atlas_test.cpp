@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	std::unique_ptr<DynamicAtlas> makeAtlas(HeadlessRenderer& renderer, Vector2i pageSize, size_t maxPages)
+	{
+		auto matDef = renderer.getResources().get<MaterialDefinition>(MaterialDefinition::defaultMaterial);
+		return std::make_unique<DynamicAtlas>(*renderer.getAPI().video, matDef, pageSize, maxPages);
+	}
+
+	Image makeImage(Vector2i size)
+	{
+		Image image(Image::Format::RGBA, size);
+		image.clear(Image::convertRGBAToInt(255, 255, 255));
+		return image;
+	}
+}
+
+TEST(HalleyDynamicAtlas, SpritesShareOnePage)
+{
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	auto atlas = makeAtlas(renderer, Vector2i(256, 256), 4);
+
+	for (int i = 0; i < 20; ++i) {
+		atlas->add("icon" + toString(i), makeImage(Vector2i(16 + i, 24)));
+	}
+
+	Vector<Sprite> sprites(20);
+	for (int i = 0; i < 20; ++i) {
+		EXPECT_TRUE(atlas->setSprite(sprites[i], "icon" + toString(i)));
+		sprites[i].setPosition(Vector2f(float(i * 40), 100));
+	}
+	atlas->update();
+
+	EXPECT_EQ(atlas->getNumPages(), 1);
+	EXPECT_EQ(atlas->getNumImages(), 20);
+	EXPECT_EQ(sprites[5].getSize(), Vector2f(21, 24));
+	EXPECT_EQ(sprites[0].getMaterial().getTexture(0), sprites[19].getMaterial().getTexture(0));
+
+	renderer.render([&] (RenderContext& rc)
+	{
+		rc.bind([&] (Painter& p)
+		{
+			for (auto& sprite: sprites) {
+				sprite.draw(p);
+			}
+		});
+	});
+	EXPECT_EQ(painter.getNumDrawCalls(), 1);
+}
+
+TEST(HalleyDynamicAtlas, EvictsLeastRecentlyUsed)
+{
+	HeadlessRenderer renderer;
+	auto atlas = makeAtlas(renderer, Vector2i(64, 64), 1);
+	Sprite sprite;
+
+	// Four 30x30 (32x32 padded) fill the only page
+	for (int i = 0; i < 4; ++i) {
+		atlas->add("a" + toString(i), makeImage(Vector2i(30, 30)));
+		atlas->update();
+	}
+	EXPECT_EQ(atlas->getNumImages(), 4);
+
+	// a0 is used this frame, so a1 is the oldest that can go
+	atlas->setSprite(sprite, "a0");
+	atlas->add("b", makeImage(Vector2i(30, 30)));
+	EXPECT_TRUE(atlas->setSprite(sprite, "b"));
+	EXPECT_TRUE(atlas->contains("a0"));
+	EXPECT_FALSE(atlas->contains("a1"));
+	EXPECT_EQ(atlas->getNumEvicted(), 1);
+
+	// Too big for any page
+	atlas->add("huge", makeImage(Vector2i(100, 10)));
+	EXPECT_FALSE(atlas->setSprite(sprite, "huge"));
+	EXPECT_EQ(atlas->getNumImages(), 4);
+}
+
+TEST(HalleyDynamicAtlas, AddingImagesKeepsPagesInPlace)
+{
+	HeadlessRenderer renderer;
+	auto atlas = makeAtlas(renderer, Vector2i(128, 128), 1);
+
+	atlas->add("first", makeImage(Vector2i(20, 20)));
+	Sprite first;
+	ASSERT_TRUE(atlas->setSprite(first, "first"));
+	atlas->update();
+	const auto material = first.getMaterialPtr();
+	const auto texture = first.getMaterial().getTexture(0);
+	const auto texRect = first.getTexRect0();
+
+	// Later images go into free space, without moving anything or replacing the page
+	Sprite sprite;
+	for (int i = 0; i < 12; ++i) {
+		atlas->add("icon" + toString(i), makeImage(Vector2i(10 + i, 18)));
+		ASSERT_TRUE(atlas->setSprite(sprite, "icon" + toString(i)));
+		atlas->update();
+
+		ASSERT_TRUE(atlas->setSprite(first, "first"));
+		EXPECT_EQ(first.getMaterialPtr(), material);
+		EXPECT_EQ(sprite.getMaterialPtr(), material);
+		EXPECT_EQ(first.getMaterial().getTexture(0), texture);
+		EXPECT_EQ(first.getTexRect0(), texRect);
+	}
+
+	// Removed areas are reused straight away
+	atlas->remove("first");
+	atlas->add("second", makeImage(Vector2i(20, 20)));
+	ASSERT_TRUE(atlas->setSprite(sprite, "second"));
+	EXPECT_EQ(sprite.getTexRect0(), texRect);
+	EXPECT_EQ(sprite.getMaterialPtr(), material);
+	EXPECT_EQ(atlas->getNumEvicted(), 0);
+}
+
+TEST(HalleyDynamicAtlas, RepacksFragmentedPages)
+{
+	HeadlessRenderer renderer;
+	auto atlas = makeAtlas(renderer, Vector2i(64, 64), 1);
+	Sprite sprite;
+
+	// Four 14x30 strips (16x32 padded), with two of them then removed, leaving free space only in 16x32 pieces
+	for (int i = 0; i < 4; ++i) {
+		atlas->add("strip" + toString(i), makeImage(Vector2i(14, 30)));
+	}
+	atlas->update();
+	for (int i = 0; i < 4; ++i) {
+		ASSERT_TRUE(atlas->setSprite(sprite, "strip" + toString(i)));
+	}
+	atlas->update();
+	atlas->remove("strip0");
+	atlas->remove("strip2");
+
+	// A 62x30 and a 30x30 only fit once the remaining strips are moved together
+	atlas->add("wide", makeImage(Vector2i(62, 30)));
+	atlas->add("square", makeImage(Vector2i(30, 30)));
+	EXPECT_TRUE(atlas->setSprite(sprite, "wide"));
+	EXPECT_TRUE(atlas->setSprite(sprite, "square"));
+	EXPECT_TRUE(atlas->setSprite(sprite, "strip1"));
+	EXPECT_TRUE(atlas->setSprite(sprite, "strip3"));
+	EXPECT_EQ(atlas->getNumEvicted(), 0);
+	EXPECT_EQ(atlas->getNumImages(), 4);
+}
+
+TEST(HalleyDynamicAtlas, DoesntMoveImagesInUseThisFrame)
+{
+	HeadlessRenderer renderer;
+	auto atlas = makeAtlas(renderer, Vector2i(64, 64), 1);
+	Sprite sprite;
+
+	// Same fragmented page as above
+	for (int i = 0; i < 4; ++i) {
+		atlas->add("strip" + toString(i), makeImage(Vector2i(14, 30)));
+	}
+	atlas->update();
+	atlas->remove("strip0");
+	atlas->remove("strip2");
+
+	// Both strips were handed out this frame, so the page can't be repacked until update
+	Sprite strip1;
+	ASSERT_TRUE(atlas->setSprite(strip1, "strip1"));
+	ASSERT_TRUE(atlas->setSprite(sprite, "strip3"));
+	const auto texRect = strip1.getTexRect0();
+
+	atlas->add("wide", makeImage(Vector2i(62, 30)));
+	atlas->add("square", makeImage(Vector2i(30, 30)));
+	const bool bothPlaced = atlas->setSprite(sprite, "wide") && atlas->setSprite(sprite, "square");
+	EXPECT_FALSE(bothPlaced);
+	EXPECT_TRUE(atlas->contains("wide"));
+	EXPECT_TRUE(atlas->contains("square"));
+	ASSERT_TRUE(atlas->setSprite(strip1, "strip1"));
+	EXPECT_EQ(strip1.getTexRect0(), texRect);
+
+	atlas->update();
+	EXPECT_TRUE(atlas->setSprite(sprite, "wide"));
+	EXPECT_TRUE(atlas->setSprite(sprite, "square"));
+	EXPECT_TRUE(atlas->setSprite(sprite, "strip1"));
+	EXPECT_TRUE(atlas->setSprite(sprite, "strip3"));
+	EXPECT_EQ(atlas->getNumEvicted(), 0);
+}
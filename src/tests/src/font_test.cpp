@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	// How fonts were written while each glyph kept its own kerning map, which imported assets still use
+	struct LegacyGlyph {
+		Rect4f area;
+		Vector2f size;
+		Vector2f horizontalBearing;
+		Vector2f verticalBearing;
+		Vector2f advance;
+		HashMap<int32_t, Vector2f> kerning;
+
+		void serialize(Serializer& s) const
+		{
+			s << area;
+			s << size;
+			s << horizontalBearing;
+			s << verticalBearing;
+			s << advance;
+			s << kerning;
+		}
+	};
+
+	struct LegacyFont {
+		HashMap<int, LegacyGlyph> glyphs;
+
+		void serialize(Serializer& s) const
+		{
+			s << String("test") << String("test.png") << 10.0f << 14.0f << 12.0f << false << 0.0f << Vector2i(512, 512) << 1.0f;
+			s << glyphs;
+			s << Vector<String>() << false;
+		}
+	};
+
+	Bytes makeLegacyFont(int nExtraGlyphs)
+	{
+		LegacyFont font;
+		auto& glyphs = font.glyphs;
+		auto addGlyph = [&] (int c)
+		{
+			auto& g = glyphs[c];
+			g.area = Rect4f(float(c % 64), float(c / 64), 1, 1);
+			g.size = Vector2f(10, 12);
+			g.advance = Vector2f(float(8 + c % 5), 0);
+		};
+
+		addGlyph(0);
+		for (int c = 32; c < 127; ++c) {
+			addGlyph(c);
+		}
+		for (int c = 0xC0; c < 0x100; ++c) {
+			addGlyph(c);
+		}
+		for (int i = 0; i < nExtraGlyphs; ++i) {
+			addGlyph(0x4E00 + i);
+		}
+
+		for (int l = 'A'; l <= 'Z'; ++l) {
+			for (int r = 'a'; r <= 'z'; ++r) {
+				if ((l + r) % 3 == 0) {
+					glyphs[l].kerning[r] = Vector2f(-float((l + r) % 4), 0);
+				}
+			}
+		}
+		glyphs['A'].kerning['V'] = Vector2f(-3, 0);
+		glyphs[0x4E01].kerning[0x4E02] = Vector2f(-1, 0);
+
+		return Serializer::toBytes(font);
+	}
+
+	std::shared_ptr<Font> loadFont(const Bytes& bytes)
+	{
+		auto font = std::make_shared<Font>();
+		Deserializer ds(bytes);
+		font->deserialize(ds);
+		return font;
+	}
+}
+
+TEST(HalleyFont, LoadsExistingData)
+{
+	const auto bytes = makeLegacyFont(100);
+	const auto font = loadFont(bytes);
+
+	EXPECT_EQ(font->getGlyph('A').first.charcode, 'A');
+	EXPECT_EQ(font->getGlyph('A').first.advance, Vector2f(8 + 'A' % 5, 0));
+	EXPECT_EQ(font->getGlyph(0xE9).first.charcode, 0xE9);
+	EXPECT_EQ(font->getGlyph(0x4E10).first.charcode, 0x4E10);
+	EXPECT_EQ(font->getGlyph(0x4E10).first.area, Rect4f(float(0x4E10 % 64), float(0x4E10 / 64), 1, 1));
+	EXPECT_EQ(&font->getGlyph(0x4E10).second, font.get());
+
+	// Missing glyphs fall back to 0
+	EXPECT_EQ(font->tryGetGlyphHere(0x1F), nullptr);
+	EXPECT_EQ(font->tryGetGlyphHere(0x3000), nullptr);
+	EXPECT_EQ(font->getGlyph(0x1F).first.charcode, 0);
+	EXPECT_EQ(font->getGlyph(0x3000).first.charcode, 0);
+
+	EXPECT_EQ(font->getKerning('A', 'V'), Vector2f(-3, 0));
+	EXPECT_EQ(font->getKerning('A', 'a'), Vector2f(-2, 0));
+	EXPECT_EQ(font->getKerning('A', 'd'), Vector2f(-1, 0));
+	EXPECT_EQ(font->getKerning('A', 'b'), Vector2f());
+	EXPECT_EQ(font->getKerning('V', 'A'), Vector2f());
+	EXPECT_EQ(font->getKerning(0x4E01, 0x4E02), Vector2f(-1, 0));
+
+	// Writes exactly what it read
+	EXPECT_EQ(Serializer::toBytes(*font), bytes);
+}
+
+TEST(HalleyFont, AddGlyphs)
+{
+	Font font("test", "test.png", 10, 14, 12, 1, Vector2i(512, 512));
+	auto makeGlyph = [] (int c, float advance)
+	{
+		return Font::Glyph(c, Rect4f(), Vector2f(), Vector2f(), Vector2f(), Vector2f(advance, 0));
+	};
+
+	font.addGlyph(makeGlyph(0x4E00, 1));
+	font.addGlyph(makeGlyph('b', 2), { { 'a', Vector2f(-2, 0) } });
+	font.addGlyph(makeGlyph('a', 3), { { 'b', Vector2f(-1, 0) }, { 0x4E00, Vector2f(-4, 0) } });
+	font.addGlyph(makeGlyph(0, 4));
+	font.finishAddingGlyphs();
+
+	EXPECT_EQ(font.getGlyph('a').first.advance.x, 3);
+	EXPECT_EQ(font.getGlyph('b').first.advance.x, 2);
+	EXPECT_EQ(font.getGlyph(0x4E00).first.advance.x, 1);
+	EXPECT_EQ(font.getGlyph('c').first.advance.x, 4);
+	EXPECT_EQ(font.getKerning('a', 'b'), Vector2f(-1, 0));
+	EXPECT_EQ(font.getKerning('b', 'a'), Vector2f(-2, 0));
+	EXPECT_EQ(font.getKerning('a', 0x4E00), Vector2f(-4, 0));
+
+	// Replacing a glyph replaces its kerning
+	font.addGlyph(makeGlyph('a', 5), { { 'a', Vector2f(-5, 0) } });
+	font.finishAddingGlyphs();
+	EXPECT_EQ(font.getGlyph('a').first.advance.x, 5);
+	EXPECT_EQ(font.getKerning('a', 'b'), Vector2f());
+	EXPECT_EQ(font.getKerning('a', 'a'), Vector2f(-5, 0));
+	EXPECT_EQ(font.getKerning('b', 'a'), Vector2f(-2, 0));
+
+	const auto copy = loadFont(Serializer::toBytes(font));
+	EXPECT_EQ(copy->getGlyph('a').first.advance.x, 5);
+	EXPECT_EQ(copy->getKerning('a', 'a'), Vector2f(-5, 0));
+	EXPECT_EQ(copy->getKerning('b', 'a'), Vector2f(-2, 0));
+}
+
+TEST(HalleyFont, AddsLargeFontsInOneGo)
+{
+	// Like the font generator does for a CJK font: everything in charcode order, then the indices are built once
+	Font font("test", "test.png", 10, 14, 12, 1, Vector2i(512, 512));
+	constexpr int nGlyphs = 20000;
+	for (int i = 0; i < nGlyphs; ++i) {
+		const int c = i < 256 ? i : 0x4E00 + i;
+		HashMap<int32_t, Vector2f> kerning;
+		kerning[c + 1] = Vector2f(-float(i % 7), 0);
+		font.addGlyph(Font::Glyph(c, Rect4f(), Vector2f(), Vector2f(), Vector2f(), Vector2f(float(i), 0)), kerning);
+	}
+	font.finishAddingGlyphs();
+
+	EXPECT_EQ(font.getGlyph('a').first.advance.x, float('a'));
+	EXPECT_EQ(font.getGlyph(0x4E00 + 12345).first.advance.x, 12345.0f);
+	EXPECT_EQ(font.getKerning(0x4E00 + 12345, 0x4E00 + 12346), Vector2f(-float(12345 % 7), 0));
+	EXPECT_EQ(font.getKerning('a', 'b'), Vector2f(-float('a' % 7), 0));
+	EXPECT_EQ(font.getKerning('a', 'c'), Vector2f());
+}
+
+TEST(HalleyFont, DISABLED_LayoutBenchmark)
+{
+	// Run with --gtest_also_run_disabled_tests
+	constexpr int nStrings = 200;
+	constexpr int nFrames = 200;
+
+	const auto font = loadFont(makeLegacyFont(3000));
+
+	Vector<StringUTF32> lines;
+	for (int i = 0; i < nStrings; ++i) {
+		auto line = String("Avast, Captain! The Vessel at bay is waiting for your orders, number " + toString(i) + ".").getUTF32();
+		if (i % 4 == 0) {
+			for (int j = 0; j < 20; ++j) {
+				line.push_back(char32_t(0x4E00 + (i * 37 + j * 101) % 3000));
+			}
+		}
+		lines.push_back(std::move(line));
+	}
+
+	TextRenderer renderer(font, "", 20);
+	float total = 0;
+	Stopwatch timer;
+	for (int i = 0; i < nFrames; ++i) {
+		for (const auto& line: lines) {
+			total += renderer.getExtents(line).x;
+		}
+	}
+	timer.pause();
+
+	std::cout << nStrings << " strings laid out in " << (timer.elapsedNanoseconds() / nFrames / 1000.0) << " us per frame (" << total << ")" << std::endl;
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "script_test_context.h"
+using namespace Halley;
+
+namespace {
+	class LuaTestContext {
+	public:
+		LuaTestContext()
+			: api(makeTestAPI(core))
+			, resources(makeResources(api))
+			, state(*resources)
+		{
+		}
+
+		LuaStackOps getStackOps() { return LuaStackOps(state); }
+
+		// Goes through Lua and back, checking that nothing else on the stack was touched
+		ScriptDataValue roundTrip(const ScriptDataValue& value)
+		{
+			auto stackOps = getStackOps();
+			stackOps.push(1234);
+			stackOps.push(value);
+
+			ScriptDataValue result;
+			result.set(ConfigNode("garbage"));
+			stackOps.popScriptDataValue(result);
+			EXPECT_EQ(stackOps.popInt(), 1234);
+			return result;
+		}
+
+		ConfigNode roundTrip(const ConfigNode& node)
+		{
+			auto stackOps = getStackOps();
+			stackOps.push(node);
+			return stackOps.popConfigNode();
+		}
+
+	private:
+		TestCoreAPI core;
+		HalleyAPI api;
+		std::unique_ptr<Resources> resources;
+		LuaState state;
+
+		// LuaState loads the halley module on construction, which isn't needed here
+		static std::unique_ptr<Resources> makeResources(const HalleyAPI& api)
+		{
+			auto resources = std::make_unique<Resources>(std::unique_ptr<ResourceLocator>(), api, ResourceOptions());
+			resources->init<BinaryFile>();
+			resources->of<BinaryFile>().setResourceLoader([] (std::string_view name, ResourceLoadPriority)
+			{
+				const String code = "return {}";
+				return std::make_shared<BinaryFile>(gsl::as_bytes(gsl::span<const char>(code.c_str(), code.length())));
+			});
+			return resources;
+		}
+	};
+
+	ConfigNode makeSequence()
+	{
+		ConfigNode::SequenceType seq;
+		seq.push_back(ConfigNode(1.5f));
+		seq.push_back(ConfigNode("two"));
+		seq.push_back(ConfigNode(true));
+		return ConfigNode(std::move(seq));
+	}
+
+	ConfigNode makeMap()
+	{
+		ConfigNode::MapType map;
+		map["name"] = "halley";
+		map["speed"] = 2.5f;
+		map["enabled"] = false;
+		map["list"] = makeSequence();
+		return ConfigNode(std::move(map));
+	}
+}
+
+TEST(HalleyLuaStackOps, BasicScriptDataValuesRoundTrip)
+{
+	LuaTestContext ctx;
+
+	EXPECT_EQ(ctx.roundTrip(ScriptDataValue()).getType(), ScriptDataValue::Type::Undefined);
+
+	for (const bool b: { true, false }) {
+		ScriptDataValue value;
+		value.setBool(b);
+		const auto result = ctx.roundTrip(value);
+		ASSERT_EQ(result.getType(), ScriptDataValue::Type::Bool);
+		EXPECT_EQ(result.asBool(), b);
+	}
+
+	ScriptDataValue f;
+	f.setFloat(-3.25f);
+	const auto floatResult = ctx.roundTrip(f);
+	ASSERT_EQ(floatResult.getType(), ScriptDataValue::Type::Float);
+	EXPECT_EQ(floatResult.getFloat(), -3.25f);
+
+	// Lua numbers always come back as floats, same as popConfigNode()
+	ScriptDataValue i;
+	i.setInt(42);
+	const auto intResult = ctx.roundTrip(i);
+	ASSERT_EQ(intResult.getType(), ScriptDataValue::Type::Float);
+	EXPECT_EQ(intResult.getFloat(), 42.0f);
+	EXPECT_EQ(ctx.roundTrip(ConfigNode(42)).getType(), ConfigNodeType::Float);
+}
+
+TEST(HalleyLuaStackOps, BoxedScriptDataValuesMatchConfigNodePath)
+{
+	LuaTestContext ctx;
+
+	for (const auto& node: { ConfigNode("hello"), ConfigNode(String()), makeSequence(), makeMap() }) {
+		const auto value = ScriptDataValue(node);
+		ASSERT_EQ(value.getType(), ScriptDataValue::Type::Boxed);
+
+		const auto result = ctx.roundTrip(value);
+		EXPECT_EQ(result.getType(), ScriptDataValue::Type::Boxed);
+		EXPECT_EQ(result.toConfigNode(), ctx.roundTrip(node));
+		EXPECT_EQ(result.toConfigNode(), node);
+	}
+}
+
+TEST(HalleyLuaStackOps, ScriptDataValuesRoundTripThroughConfigNodes)
+{
+	ScriptDataValue values[7];
+	values[1].setBool(true);
+	values[2].setInt(-7);
+	values[3].setFloat(0.5f);
+	values[4].setVector2f(Vector2f(3, -4));
+	values[5].set(ConfigNode(EntityId(0x123456789ll)));
+	values[6].set(makeMap());
+
+	for (const auto& value: values) {
+		const auto node = value.toConfigNode();
+		const auto result = ScriptDataValue(node);
+		EXPECT_EQ(result.getType(), value.getType());
+		EXPECT_EQ(result.toConfigNode(), node);
+	}
+}
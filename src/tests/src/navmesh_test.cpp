@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	constexpr float cellSize = 10.0f;
+
+	// A grid of quads over a jittered lattice, with random holes punched in it
+	Navmesh makeRandomNavmesh(Random& rng, int w, int h)
+	{
+		Vector<Vector2f> lattice;
+		for (int y = 0; y <= h; ++y) {
+			for (int x = 0; x <= w; ++x) {
+				const bool border = x == 0 || y == 0 || x == w || y == h;
+				const auto jitter = border ? Vector2f() : Vector2f(rng.getFloat(-0.2f, 0.2f), rng.getFloat(-0.2f, 0.2f));
+				lattice.push_back((Vector2f(float(x), float(y)) + jitter) * cellSize);
+			}
+		}
+		auto vertex = [&] (int x, int y) { return lattice[x + y * (w + 1)]; };
+
+		Vector<int> cellToNode(w * h, -1);
+		int nNodes = 0;
+		for (auto& c: cellToNode) {
+			if (rng.getFloat(0.0f, 1.0f) > 0.2f) {
+				c = nNodes++;
+			}
+		}
+		auto nodeAt = [&] (int x, int y) { return x < 0 || y < 0 || x >= w || y >= h ? -1 : cellToNode[x + y * w]; };
+
+		Vector<Navmesh::PolygonData> polys;
+		for (int y = 0; y < h; ++y) {
+			for (int x = 0; x < w; ++x) {
+				if (nodeAt(x, y) >= 0) {
+					Polygon poly(VertexList{ vertex(x, y), vertex(x + 1, y), vertex(x + 1, y + 1), vertex(x, y + 1) });
+					Vector<int> connections = { nodeAt(x, y - 1), nodeAt(x + 1, y), nodeAt(x, y + 1), nodeAt(x - 1, y) };
+					polys.push_back(Navmesh::PolygonData{ std::move(poly), std::move(connections), 1.0f });
+				}
+			}
+		}
+
+		const auto size = Vector2f(float(w), float(h)) * cellSize;
+		return Navmesh(std::move(polys), NavmeshBounds(Vector2f(), Vector2f(size.x, 0), Vector2f(0, size.y), w, h, Vector2f(1, 1)), 0);
+	}
+
+	Vector<Vector2f> makeRandomPoints(Random& rng, int w, int h, size_t n)
+	{
+		// Some points fall outside of the navmesh
+		Vector<Vector2f> result;
+		for (size_t i = 0; i < n; ++i) {
+			result.push_back(Vector2f(rng.getFloat(-2.0f, float(w) + 2.0f), rng.getFloat(-2.0f, float(h) + 2.0f)) * cellSize);
+		}
+		return result;
+	}
+}
+
+TEST(HalleyNavmesh, BatchedNodeQueriesMatchSingle)
+{
+	for (uint32_t seed = 1; seed <= 10; ++seed) {
+		Random rng(seed);
+		const auto navmesh = makeRandomNavmesh(rng, 24, 16);
+		const auto points = makeRandomPoints(rng, 24, 16, 503);
+
+		Vector<std::optional<Navmesh::NodeId>> result(points.size());
+		navmesh.getNodesAt(points, result);
+		for (size_t i = 0; i < points.size(); ++i) {
+			EXPECT_EQ(result[i], navmesh.getNodeAt(points[i])) << "seed " << seed << ", point " << points[i];
+		}
+	}
+}
+
+TEST(HalleyNavmesh, BatchedClosestPointsMatchSingle)
+{
+	for (uint32_t seed = 1; seed <= 10; ++seed) {
+		Random rng(seed);
+		const auto navmesh = makeRandomNavmesh(rng, 24, 16);
+		const auto points = makeRandomPoints(rng, 24, 16, 503);
+
+		Vector<std::optional<Vector2f>> result(points.size());
+		for (const auto maxDist: { std::numeric_limits<float>::infinity(), 15.0f, 3.0f }) {
+			for (const auto anisotropy: { 1.0f, 2.0f }) {
+				navmesh.getClosestPointsTo(points, result, anisotropy, maxDist);
+				for (size_t i = 0; i < points.size(); ++i) {
+					EXPECT_EQ(result[i], navmesh.getClosestPointTo(points[i], anisotropy, maxDist)) << "seed " << seed << ", point " << points[i];
+				}
+			}
+		}
+	}
+}
+
+TEST(HalleyNavmesh, BatchedRayCollisionsMatchSingle)
+{
+	for (uint32_t seed = 1; seed <= 10; ++seed) {
+		Random rng(seed);
+		const auto navmesh = makeRandomNavmesh(rng, 24, 16);
+		const auto origins = makeRandomPoints(rng, 24, 16, 251);
+
+		Vector<Ray> rays;
+		Vector<float> maxDistances;
+		for (const auto& origin: origins) {
+			rays.emplace_back(origin, Vector2f(1, 0).rotate(Angle1f::fromDegrees(rng.getFloat(0.0f, 360.0f))));
+			maxDistances.push_back(rng.getFloat(1.0f, 150.0f));
+		}
+
+		Vector<std::optional<Vector2f>> result(rays.size());
+		navmesh.findRayCollisions(rays, maxDistances, result);
+		for (size_t i = 0; i < rays.size(); ++i) {
+			EXPECT_EQ(result[i], navmesh.findRayCollision(rays[i], maxDistances[i])) << "seed " << seed << ", ray " << i;
+		}
+	}
+}
@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include <thread>
+using namespace Halley;
+
+namespace {
+	class TestScene {
+	public:
+		TestScene(Resources& resources, uint32_t seed)
+		{
+			Random rng(seed);
+
+			Vector<std::shared_ptr<Material>> materials;
+			for (int i = 0; i < 3; ++i) {
+				auto material = std::make_shared<Material>(resources.get<MaterialDefinition>(MaterialDefinition::defaultMaterial));
+				material->set(0, resources.get<Texture>("texture" + toString(i)));
+				materials.push_back(std::move(material));
+			}
+
+			for (int i = 0; i < 200; ++i) {
+				auto& sprite = sprites.emplace_back();
+				sprite
+					.setMaterial(rng.getRandomElement(materials))
+					.setTexRect(Rect4f(0, 0, 1, 1))
+					.setSize(Vector2f(16, 16))
+					.setPosition(Vector2f(rng.getFloat(0, 640), rng.getFloat(0, 720)));
+			}
+		}
+
+		void draw(Painter& painter) const
+		{
+			painter.clear(Colour4f(0, 0, 0, 1));
+			Sprite::drawMixedMaterials(sprites.data(), sprites.size(), painter);
+
+			painter.setClip(Rect4i(10, 10, 200, 100));
+			const auto points = std::array<Vector2f, 3>{ Vector2f(0, 0), Vector2f(100, 50), Vector2f(30, 90) };
+			painter.drawLine(points, 2.0f, Colour4f(1, 1, 1, 1), true);
+			painter.setClip();
+
+			painter.drawRect(Rect4f(50, 50, 100, 100), 1.0f, Colour4f(1, 0, 0, 1));
+		}
+
+	private:
+		Vector<Sprite> sprites;
+	};
+
+	struct CommandSummary {
+		RenderSnapshot::CommandType type;
+		RenderSnapshot::Reason reason;
+		size_t numTriangles;
+		uint64_t materialHash;
+
+		bool operator==(const CommandSummary& other) const
+		{
+			return type == other.type && reason == other.reason && numTriangles == other.numTriangles && materialHash == other.materialHash;
+		}
+	};
+
+	Vector<CommandSummary> summarise(const RenderSnapshot& snapshot)
+	{
+		Vector<CommandSummary> result;
+		for (size_t i = 0; i < snapshot.getNumCommands(); ++i) {
+			const auto info = snapshot.getCommandInfo(i);
+			result.push_back({ info.type, info.reason, info.numTriangles, info.materialHash });
+		}
+		return result;
+	}
+}
+
+TEST(HalleyPainterCommandList, ReplaysLikeDrawingDirectly)
+{
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	const TestScene left(renderer.getResources(), 1);
+	const TestScene right(renderer.getResources(), 2);
+
+	Camera leftCamera(Vector2f(320, 360));
+	leftCamera.setViewPort(Rect4i(0, 0, 640, 720));
+	Camera rightCamera(Vector2f(320, 360));
+	rightCamera.setViewPort(Rect4i(640, 0, 640, 720));
+
+	RenderSnapshot direct;
+	renderer.render([&] (RenderContext& rc)
+	{
+		painter.startRecording(&direct);
+		rc.with(leftCamera).bind([&] (Painter& p) { left.draw(p); });
+		rc.with(rightCamera).bind([&] (Painter& p) { right.draw(p); });
+	});
+	const auto directDrawCalls = painter.getNumDrawCalls();
+	const auto directTriangles = painter.getNumTriangles();
+	const auto directBytes = painter.getNumBytesUploaded();
+
+	PainterCommandList leftList(painter);
+	PainterCommandList rightList(painter);
+	RenderSnapshot deferred;
+	renderer.render([&] (RenderContext& rc)
+	{
+		auto record = [&] (PainterCommandList& list, const Camera& camera, const TestScene& scene)
+		{
+			list.record(rc.with(camera), [&] (RenderContext& listContext)
+			{
+				listContext.bind([&] (Painter& p) { scene.draw(p); });
+			});
+		};
+		std::thread leftThread([&] { record(leftList, leftCamera, left); });
+		std::thread rightThread([&] { record(rightList, rightCamera, right); });
+		leftThread.join();
+		rightThread.join();
+
+		// Nothing reaches the painter until the lists are replayed
+		EXPECT_EQ(painter.getNumDrawCalls(), 0);
+		EXPECT_FALSE(leftList.isEmpty());
+
+		painter.startRecording(&deferred);
+		leftList.replay(painter);
+		rightList.replay(painter);
+	});
+
+	EXPECT_EQ(painter.getNumDrawCalls(), directDrawCalls);
+	EXPECT_EQ(painter.getNumTriangles(), directTriangles);
+	EXPECT_EQ(painter.getNumBytesUploaded(), directBytes);
+	EXPECT_GT(directDrawCalls, 3);
+	EXPECT_TRUE(summarise(deferred) == summarise(direct));
+}
+
+TEST(HalleyPainterCommandList, ReplayRestoresBinding)
+{
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	const TestScene scene(renderer.getResources(), 3);
+
+	Camera listCamera(Vector2f(100, 100));
+	PainterCommandList list(painter);
+	RenderSnapshot snapshot;
+	renderer.render([&] (RenderContext& rc)
+	{
+		list.record(rc.with(listCamera), [&] (RenderContext& listContext)
+		{
+			listContext.bind([&] (Painter& p)
+			{
+				scene.draw(p);
+				p.setClip(Rect4i(0, 0, 50, 50));
+				p.drawRect(Rect4f(0, 0, 10, 10), 1.0f, Colour4f(1, 1, 1, 1));
+			});
+		});
+
+		painter.startRecording(&snapshot);
+		rc.bind([&] (Painter& p)
+		{
+			const auto cameraPos = p.getCurrentCamera().getPosition();
+			list.replay(p);
+			EXPECT_EQ(p.getCurrentCamera().getPosition(), cameraPos);
+
+			// The list left a clip set, this needs to reset it
+			p.drawRect(Rect4f(0, 0, 10, 10), 1.0f, Colour4f(1, 1, 1, 1));
+		});
+	});
+
+	const auto last = snapshot.getCommandInfo(snapshot.getNumCommands() - 1);
+	EXPECT_EQ(last.type, RenderSnapshot::CommandType::Draw);
+	EXPECT_TRUE(last.hasBindChange);
+	EXPECT_TRUE(last.hasClipChange);
+}
+
+TEST(HalleyPainterCommandList, RecordsTheSameMaterialFromTwoThreads)
+{
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	auto material = std::make_shared<Material>(renderer.getResources().get<MaterialDefinition>(MaterialDefinition::defaultMaterial));
+	material->set(0, renderer.getResources().get<Texture>("texture"));
+
+	Sprite sprite;
+	sprite.setMaterial(material).setTexRect(Rect4f(0, 0, 1, 1)).setSize(Vector2f(16, 16));
+
+	PainterCommandList listA(painter);
+	PainterCommandList listB(painter);
+	for (int i = 0; i < 50; ++i) {
+		// Every change leaves the hashes to be computed by whichever thread reads them first
+		material->set(0, renderer.getResources().get<Texture>("texture" + toString(i % 3)));
+		const auto expectedHash = Material(*material).getPartialHash();
+
+		renderer.render([&] (RenderContext& rc)
+		{
+			auto record = [&] (PainterCommandList& list)
+			{
+				list.record(rc, [&] (RenderContext& listContext)
+				{
+					listContext.bind([&] (Painter& p)
+					{
+						auto s = sprite;
+						for (int j = 0; j < 10; ++j) {
+							s.setPosition(Vector2f(float(j * 20), 0)).draw(p);
+						}
+					});
+				});
+			};
+			std::thread threadA([&] { record(listA); });
+			std::thread threadB([&] { record(listB); });
+			threadA.join();
+			threadB.join();
+
+			RenderSnapshot snapshot;
+			painter.startRecording(&snapshot);
+			listA.replay(painter);
+			listB.replay(painter);
+			painter.flush();
+			painter.stopRecording();
+
+			ASSERT_GT(snapshot.getNumCommands(), 0);
+			for (size_t j = 0; j < snapshot.getNumCommands(); ++j) {
+				const auto info = snapshot.getCommandInfo(j);
+				if (info.type == RenderSnapshot::CommandType::Draw) {
+					EXPECT_EQ(info.materialHash, expectedHash);
+				}
+			}
+		});
+		EXPECT_EQ(material->getPartialHash(), expectedHash);
+	}
+}
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_executors.h"
+using namespace Halley;
+
+namespace {
+	Particles makeEmitter(HeadlessRenderer& renderer, ConfigNode::MapType config)
+	{
+		EntitySerializationContext context;
+		context.resources = &renderer.getResources();
+		Particles particles(ConfigNode(std::move(config)), renderer.getResources(), context);
+
+		auto material = std::make_shared<Material>(renderer.getResources().get<MaterialDefinition>(MaterialDefinition::defaultMaterial));
+		material->set(0, renderer.getResources().get<Texture>("particle"));
+		Sprite sprite;
+		sprite.setMaterial(material).setTexRect(Rect4f(0, 0, 1, 1)).setSize(Vector2f(8, 8)).setPivot(Vector2f(0.5f, 0.5f));
+		particles.setSprites({ sprite });
+		particles.setPosition(Vector2f(100, 50));
+		return particles;
+	}
+
+	ConfigNode::MapType makeBusyConfig()
+	{
+		// Exercises every part of the update: scatter, stop time, damping, min height and curves
+		ConfigNode::MapType config;
+		config["spawnRate"] = 12000.0f;
+		config["spawnArea"] = Vector2f(64, 32);
+		config["ttl"] = Range<float>(0.5f, 3.0f);
+		config["speed"] = Range<float>(20.0f, 200.0f);
+		config["azimuth"] = Range<float>(0.0f, 360.0f);
+		config["altitude"] = Range<float>(0.0f, 60.0f);
+		config["acceleration"] = Vector3f(0, 30, -100);
+		config["minHeight"] = -20.0f;
+		config["speedDamp"] = 0.5f;
+		config["stopTime"] = 0.3f;
+		config["directionScatter"] = 20.0f;
+		config["rotateTowardsMovement"] = true;
+		config["startScale"] = 1.0f;
+		config["endScale"] = 0.2f;
+		config["fadeInTime"] = 0.1f;
+		config["fadeOutTime"] = 0.3f;
+		return config;
+	}
+
+	Vector<SpriteVertexAttrib> simulate(HeadlessRenderer& renderer, int frames)
+	{
+		Random::getGlobal().setSeed(uint32_t(1234));
+		auto particles = makeEmitter(renderer, makeBusyConfig());
+		for (int i = 0; i < frames; ++i) {
+			particles.setPosition(Vector2f(100.0f + float(i), 50));
+			particles.update(1.0 / 30.0);
+			particles.updateSprites(1.0 / 30.0);
+		}
+
+		Vector<SpriteVertexAttrib> result;
+		for (const auto& sprite: particles.getSprites()) {
+			result.push_back(sprite.getVertexAttributes());
+		}
+		return result;
+	}
+}
+
+TEST(HalleyParticles, IntegratesMovement)
+{
+	HeadlessRenderer renderer;
+	TestExecutors executors(0);
+
+	ConfigNode::MapType config;
+	config["spawnRate"] = 0.0f;
+	config["burst"] = 500;
+	config["ttl"] = Range<float>(10.0f, 10.0f);
+	config["speed"] = Range<float>(100.0f, 100.0f);
+	config["azimuth"] = Range<float>(0.0f, 360.0f);
+	config["acceleration"] = Vector3f(0, 50, 0);
+	config["rotateTowardsMovement"] = true;
+	auto particles = makeEmitter(renderer, config);
+
+	// The burst is spawned at time 0, so it hasn't moved yet
+	particles.update(0.1);
+	particles.updateSprites(0.1);
+	const auto sprites = particles.getSprites();
+	ASSERT_EQ(sprites.size(), 500);
+
+	Vector<Vector2f> startPos;
+	Vector<Vector2f> startVel;
+	for (const auto& sprite: sprites) {
+		EXPECT_EQ(sprite.getPosition(), Vector2f(100, 50));
+		startPos.push_back(sprite.getPosition());
+		startVel.push_back(Vector2f(100, 0).rotate(sprite.getRotation()));
+	}
+
+	constexpr float dt = 0.25f;
+	particles.update(dt);
+	particles.updateSprites(dt);
+	ASSERT_EQ(particles.getSprites().size(), 500);
+	for (size_t i = 0; i < sprites.size(); ++i) {
+		const auto expected = startPos[i] + startVel[i] * dt + Vector2f(0, 50) * (0.5f * dt * dt);
+		EXPECT_NEAR(sprites[i].getPosition().x, expected.x, 0.01f);
+		EXPECT_NEAR(sprites[i].getPosition().y, expected.y, 0.01f);
+	}
+
+	// Everything is past its ttl
+	particles.update(10.0);
+	particles.updateSprites(10.0);
+	EXPECT_TRUE(particles.getSprites().empty());
+	EXPECT_FALSE(particles.getAABB().has_value());
+}
+
+TEST(HalleyParticles, WorkerThreadsDontChangeResults)
+{
+	HeadlessRenderer renderer;
+
+	Vector<SpriteVertexAttrib> serial;
+	{
+		TestExecutors executors(0);
+		serial = simulate(renderer, 60);
+	}
+	ASSERT_GT(serial.size(), 10000); // Large enough to be split into several ranges
+
+	Vector<SpriteVertexAttrib> parallel;
+	{
+		TestExecutors executors(3);
+		parallel = simulate(renderer, 60);
+	}
+
+	ASSERT_EQ(serial.size(), parallel.size());
+	for (size_t i = 0; i < serial.size(); ++i) {
+		// Padding isn't initialised, so this can't just be a memcmp
+		const auto& a = serial[i];
+		const auto& b = parallel[i];
+		ASSERT_TRUE(a.pos == b.pos && a.rotation == b.rotation && a.scale == b.scale && a.colour == b.colour && a.custom1 == b.custom1) << "particle " << i;
+	}
+}
+
+TEST(HalleyParticles, UpdatesFromAWorkerThread)
+{
+	HeadlessRenderer renderer;
+	TestExecutors executors(1);
+
+	// The only worker is the one running the update, so it has to go through every range itself
+	Concurrent::execute(Executors::getCPU(), [&] ()
+	{
+		const auto sprites = simulate(renderer, 60);
+		EXPECT_GT(sprites.size(), 10000);
+	}).wait();
+}
+
+TEST(HalleyParticles, TurningDirectDrawOffKeepsParticlesVisible)
+{
+	HeadlessRenderer renderer;
+	TestExecutors executors(0);
+
+	Random::getGlobal().setSeed(uint32_t(1234));
+	auto config = makeBusyConfig();
+	config["directDraw"] = true;
+	auto particles = makeEmitter(renderer, config);
+	ASSERT_TRUE(particles.isDirectDraw());
+
+	for (int i = 0; i < 30; ++i) {
+		particles.update(1.0 / 30.0);
+		particles.updateSprites(1.0 / 30.0);
+	}
+	EXPECT_TRUE(particles.getSprites().empty());
+	const auto aabb = particles.getAABB();
+	ASSERT_TRUE(aabb.has_value());
+
+	// Particles that were already alive get their sprites back straight away
+	particles.setDirectDraw(false);
+	EXPECT_FALSE(particles.isDirectDraw());
+	particles.updateSprites(0);
+	const auto sprites = particles.getSprites();
+	ASSERT_GT(sprites.size(), 1000);
+	for (const auto& sprite: sprites) {
+		ASSERT_TRUE(sprite.hasMaterial());
+		EXPECT_EQ(sprite.getSize(), Vector2f(8, 8));
+		EXPECT_TRUE(aabb->grow(0.01f).contains(sprite.getPosition()));
+	}
+}
+
+TEST(HalleyParticles, DirectDrawMatchesSpritePath)
+{
+	HeadlessRenderer renderer;
+	TestExecutors executors(0);
+	auto& painter = renderer.getPainter();
+
+	Random::getGlobal().setSeed(uint32_t(1234));
+	auto config = makeBusyConfig();
+	config["directDraw"] = true;
+	auto particles = makeEmitter(renderer, config);
+	for (int i = 0; i < 30; ++i) {
+		particles.update(1.0 / 30.0);
+		particles.updateSprites(1.0 / 30.0);
+	}
+
+	auto drawParticles = [&] ()
+	{
+		renderer.render([&] (RenderContext& rc)
+		{
+			rc.bind([&] (Painter& p) { particles.draw(p); });
+		});
+		return std::pair(painter.getNumTriangles(), painter.getNumBytesUploaded());
+	};
+
+	// The whole emitter goes in as one entry
+	SpritePainter spritePainter;
+	spritePainter.startFrame();
+	spritePainter.add(particles, 1, 0, 0.0f);
+	ASSERT_TRUE(spritePainter.getBounds().has_value());
+	EXPECT_EQ(spritePainter.getBounds(), particles.getAABB());
+
+	ASSERT_TRUE(particles.isDirectDraw());
+	const auto direct = drawParticles();
+	const auto directDrawCalls = painter.getNumDrawCalls();
+
+	// Same particles, now through their sprites
+	particles.setDirectDraw(false);
+	particles.updateSprites(0);
+	const auto viaSprites = drawParticles();
+
+	EXPECT_GT(direct.first, 2000);
+	EXPECT_EQ(direct, viaSprites);
+	EXPECT_EQ(directDrawCalls, 1);
+}
@@ -18,3 +18,171 @@ TEST(HalleyPolygon, Subtraction)
 		EXPECT_TRUE(result.value()[i].isConvex());
 	}
 }
+
+namespace {
+	Polygon makeRegularPolygon(Vector2f centre, float radius, size_t sides, bool clockwise)
+	{
+		VertexList vs;
+		for (size_t i = 0; i < sides; ++i) {
+			const float angle = 2.0f * pif() * static_cast<float>(i) / static_cast<float>(sides);
+			vs.push_back(centre + Vector2f(std::cos(angle), std::sin(angle)) * radius);
+		}
+		if (clockwise) {
+			std::reverse(vs.begin(), vs.end());
+		}
+		return Polygon(std::move(vs));
+	}
+
+	Vector<Polygon> makeRandomPolygons(Random& rng, size_t n)
+	{
+		Vector<Polygon> result;
+		for (size_t i = 0; i < n; ++i) {
+			const auto centre = Vector2f(rng.getFloat(-100.0f, 100.0f), rng.getFloat(-100.0f, 100.0f));
+			result.push_back(makeRegularPolygon(centre, rng.getFloat(5.0f, 60.0f), 3 + i % 8, i % 3 == 0));
+		}
+		return result;
+	}
+
+	Vector<Vector2f> makeRandomPoints(Random& rng, size_t n)
+	{
+		Vector<Vector2f> result;
+		for (size_t i = 0; i < n; ++i) {
+			result.push_back(Vector2f(rng.getFloat(-150.0f, 150.0f), rng.getFloat(-150.0f, 150.0f)));
+		}
+		return result;
+	}
+
+	bool isPointInsideConvexScalar(const Polygon& poly, Vector2f point)
+	{
+		const auto& circle = poly.getBoundingCircle();
+		if ((point - circle.getCentre()).squaredLength() > circle.getRadius() * circle.getRadius() || !poly.getAABB().contains(point)) {
+			return false;
+		}
+
+		const auto& vs = poly.getVertices();
+		const float sign = poly.isClockwise() ? 1.0f : -1.0f;
+		for (size_t i = 0; i < vs.size(); ++i) {
+			if ((point - vs[i]).cross(vs[(i + 1) % vs.size()] - vs[i]) * sign > 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+TEST(HalleyPolygon, PointInsideBatch)
+{
+	Random rng(uint32_t(1234));
+	const auto polygons = makeRandomPolygons(rng, 50);
+	auto points = makeRandomPoints(rng, 103);
+
+	for (const auto& poly: polygons) {
+		// Points exactly on vertices and edges must agree too
+		points.push_back(poly.getVertices()[0]);
+		points.push_back(0.5f * (poly.getVertices()[0] + poly.getVertices()[1]));
+
+		Vector<bool> result(points.size());
+		poly.isPointInside(points, result);
+
+		for (size_t i = 0; i < points.size(); ++i) {
+			EXPECT_EQ(result[i], poly.isPointInside(points[i]));
+			EXPECT_EQ(result[i], isPointInsideConvexScalar(poly, points[i]));
+		}
+	}
+
+	// Concave polygons take the scalar path
+	const auto concave = Polygon({ { 0, 0 }, { 100, 0 }, { 100, 100 }, { 50, 20 }, { 0, 100 } });
+	EXPECT_FALSE(concave.isConvex());
+	Vector<bool> result(points.size());
+	concave.isPointInside(points, result);
+	for (size_t i = 0; i < points.size(); ++i) {
+		EXPECT_EQ(result[i], concave.isPointInside(points[i]));
+	}
+}
+
+TEST(HalleyPolygon, CollideAndClassifyBatch)
+{
+	Random rng(uint32_t(5678));
+	const auto polygons = makeRandomPolygons(rng, 200);
+
+	Vector<bool> collisions(polygons.size());
+	Vector<Polygon::SATClassification> classifications(polygons.size());
+	size_t nCollisions = 0;
+
+	for (size_t i = 0; i < 20; ++i) {
+		const auto& poly = polygons[i];
+		poly.collide(polygons, collisions);
+		poly.classify(polygons, classifications);
+
+		for (size_t j = 0; j < polygons.size(); ++j) {
+			EXPECT_EQ(collisions[j], poly.collide(polygons[j]));
+			EXPECT_EQ(classifications[j], poly.classify(polygons[j]));
+			nCollisions += collisions[j] ? 1 : 0;
+		}
+		EXPECT_TRUE(collisions[i]);
+		EXPECT_EQ(classifications[i], Polygon::SATClassification::Contains);
+	}
+
+	EXPECT_GT(nCollisions, 20);
+}
+
+TEST(HalleyPolygon, DISABLED_BenchmarkPointInside)
+{
+	// Run with --gtest_also_run_disabled_tests
+	Random rng(uint32_t(42));
+	const auto polygons = makeRandomPolygons(rng, 1000);
+	const auto points = makeRandomPoints(rng, 1000);
+
+	size_t scalarCount = 0;
+	Stopwatch scalarTimer;
+	for (const auto& poly: polygons) {
+		for (const auto& p: points) {
+			scalarCount += isPointInsideConvexScalar(poly, p) ? 1 : 0;
+		}
+	}
+	scalarTimer.pause();
+
+	size_t batchCount = 0;
+	Vector<bool> result(points.size());
+	Stopwatch batchTimer;
+	for (const auto& poly: polygons) {
+		poly.isPointInside(points, result);
+		for (const auto r: result) {
+			batchCount += r ? 1 : 0;
+		}
+	}
+	batchTimer.pause();
+
+	EXPECT_EQ(scalarCount, batchCount);
+	std::cout << "Point inside, scalar: " << scalarTimer.elapsedMicroseconds() << " us, batch: " << batchTimer.elapsedMicroseconds() << " us" << std::endl;
+}
+
+TEST(HalleyPolygon, DISABLED_BenchmarkCollide)
+{
+	// Run with --gtest_also_run_disabled_tests
+	Random rng(uint32_t(42));
+	const auto polygons = makeRandomPolygons(rng, 2000);
+
+	size_t singleCount = 0;
+	Stopwatch singleTimer;
+	for (const auto& a: polygons) {
+		for (const auto& b: polygons) {
+			singleCount += a.collide(b) ? 1 : 0;
+		}
+	}
+	singleTimer.pause();
+
+	size_t batchCount = 0;
+	Vector<bool> result(polygons.size());
+	Stopwatch batchTimer;
+	for (const auto& a: polygons) {
+		a.collide(polygons, result);
+		for (const auto r: result) {
+			batchCount += r ? 1 : 0;
+		}
+	}
+	batchTimer.pause();
+
+	EXPECT_EQ(singleCount, batchCount);
+	std::cout << "Collide, single: " << singleTimer.elapsedMicroseconds() << " us, batch: " << batchTimer.elapsedMicroseconds() << " us" << std::endl;
+}
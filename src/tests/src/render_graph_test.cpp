@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_executors.h"
+using namespace Halley;
+
+namespace {
+	// Pin indices, as in RenderGraphNodeTypes
+	constexpr GraphPinId paintColourOut = 3;
+	constexpr GraphPinId overlayColourIn = 0;
+	constexpr GraphPinId overlayColourOut = 2;
+	constexpr GraphPinId overlayTextureIn = 4;
+	constexpr GraphPinId outputColourIn = 0;
+
+	GraphNodeId addPaint(RenderGraphDefinition& def, const String& name)
+	{
+		ConfigNode::MapType settings;
+		settings["name"] = name;
+		settings["cameraId"] = "main";
+		settings["paintMasks"] = ConfigNode::SequenceType{ ConfigNode(1) };
+		settings["colourClear"] = "#000000";
+		return def.addNode("paint", {}, ConfigNode(std::move(settings)));
+	}
+
+	GraphNodeId addOverlay(RenderGraphDefinition& def, const String& name)
+	{
+		ConfigNode::MapType settings;
+		settings["name"] = name;
+		settings["material"] = "Test/Overlay";
+		settings["colourClear"] = "#000000";
+		return def.addNode("overlay", {}, ConfigNode(std::move(settings)));
+	}
+
+	GraphNodeId addOutput(RenderGraphDefinition& def)
+	{
+		ConfigNode::MapType settings;
+		settings["name"] = "output";
+		return def.addNode("output", {}, ConfigNode(std::move(settings)));
+	}
+
+	void renderGraph(HeadlessRenderer& renderer, RenderGraph& graph)
+	{
+		renderer.render([&] (RenderContext& rc)
+		{
+			graph.render(rc, *renderer.getAPI().video);
+		});
+	}
+}
+
+TEST(HalleyRenderGraph, CullsAndAliasesTargets)
+{
+	HeadlessRenderer renderer;
+
+	// scene -> blur -> tonemap -> output, plus a node that doesn't reach the output
+	auto def = std::make_shared<RenderGraphDefinition>();
+	const auto scene = addPaint(*def, "scene");
+	const auto blur = addOverlay(*def, "blur");
+	const auto tonemap = addOverlay(*def, "tonemap");
+	const auto output = addOutput(*def);
+	addPaint(*def, "unused");
+	def->loadMaterials(renderer.getResources());
+	def->connectPins(scene, paintColourOut, blur, overlayTextureIn);
+	def->connectPins(blur, overlayColourOut, tonemap, overlayTextureIn);
+	def->connectPins(tonemap, overlayColourOut, output, outputColourIn);
+
+	RenderGraph graph(def);
+	graph.setCamera("main", Camera());
+
+	renderGraph(renderer, graph);
+	const auto& stats = graph.getRenderStats();
+	EXPECT_EQ(stats.nodes, 5);
+	EXPECT_EQ(stats.culledNodes, 1);
+	EXPECT_EQ(stats.passes, 4);
+	EXPECT_EQ(stats.waves, 4);
+
+	// Scene's target is done with once blur has sampled it, so tonemap gets to reuse it
+	EXPECT_EQ(stats.transientTargets, 3);
+	EXPECT_EQ(stats.transientTextures, 2);
+	EXPECT_EQ(stats.transientBytes, 2 * 1280 * 720 * 4);
+
+	// Nothing new is needed after the first frame
+	renderGraph(renderer, graph);
+	EXPECT_EQ(graph.getRenderStats().targetsCreated, 0);
+	EXPECT_EQ(graph.getRenderStats().transientTextures, 2);
+
+	graph.setTargetAliasing(false);
+	renderGraph(renderer, graph);
+	EXPECT_EQ(graph.getRenderStats().transientTargets, 0);
+	EXPECT_EQ(graph.getRenderStats().transientTextures, 0);
+	EXPECT_EQ(graph.getRenderStats().targetsCreated, 3);
+}
+
+TEST(HalleyRenderGraph, RecordsIndependentNodesInParallel)
+{
+	HeadlessRenderer renderer;
+	TestExecutors executors(2);
+
+	// world and ui don't depend on each other, and are then composed by the overlay
+	auto def = std::make_shared<RenderGraphDefinition>();
+	const auto world = addPaint(*def, "world");
+	const auto ui = addPaint(*def, "ui");
+	const auto compose = addOverlay(*def, "compose");
+	const auto output = addOutput(*def);
+	def->loadMaterials(renderer.getResources());
+	def->connectPins(world, paintColourOut, compose, overlayColourIn);
+	def->connectPins(ui, paintColourOut, compose, overlayTextureIn);
+	def->connectPins(compose, overlayColourOut, output, outputColourIn);
+
+	RenderGraph graph(def);
+	graph.setCamera("main", Camera());
+	graph.setParallelRecording(true);
+
+	std::atomic<int> draws = 0;
+	auto material = std::make_shared<Material>(renderer.getResources().get<MaterialDefinition>(MaterialDefinition::defaultMaterial));
+	material->set(0, renderer.getResources().get<Texture>("sprite"));
+	Sprite sprite;
+	sprite.setMaterial(material).setTexRect(Rect4f(0, 0, 1, 1)).setSize(Vector2f(32, 32));
+	graph.setDrawCallback([&] (SpriteMaskBase mask, Painter& painter)
+	{
+		sprite.draw(painter);
+		++draws;
+	});
+
+	renderGraph(renderer, graph);
+	EXPECT_EQ(draws, 2);
+	EXPECT_EQ(graph.getRenderStats().passes, 4);
+	EXPECT_EQ(graph.getRenderStats().parallelPasses, 2);
+
+	graph.setParallelRecording(false);
+	renderGraph(renderer, graph);
+	EXPECT_EQ(draws, 4);
+	EXPECT_EQ(graph.getRenderStats().parallelPasses, 0);
+}
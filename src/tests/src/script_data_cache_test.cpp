@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "script_test_context.h"
+using namespace Halley;
+
+namespace {
+	struct CacheTestGraph {
+		GraphNodeId product;
+		GraphNodeId comparison;
+		GraphNodeId sinkA;
+		GraphNodeId sinkB;
+		GraphNodeId sinkC;
+
+		CacheTestGraph(ScriptTestContext& ctx)
+		{
+			// x * 2 > 5, read twice, and x * 2 read once
+			product = ctx.addBinary("arithmetic", "*", ctx.addVariable("x"), ctx.addLiteral(ConfigNode(2)));
+			comparison = ctx.addBinary("comparison", ">", product, ctx.addLiteral(ConfigNode(5)));
+			sinkA = ctx.addSink(comparison);
+			sinkB = ctx.addSink(comparison);
+			sinkC = ctx.addSink(product);
+			ctx.prepare();
+		}
+	};
+}
+
+TEST(HalleyScriptDataCache, EvaluatesOncePerTick)
+{
+	ScriptTestContext ctx;
+	const CacheTestGraph g(ctx);
+	EXPECT_TRUE(ctx.graph.isPureDataNode(g.comparison));
+
+	ctx.state->getLocalVariables().setVariable("x", ConfigNode(3));
+	EXPECT_TRUE(ctx.read(g.sinkA).asBool());
+	EXPECT_TRUE(ctx.read(g.sinkB).asBool());
+	EXPECT_EQ(ctx.read(g.sinkC).asInt(), 6);
+
+	const auto& stats = ctx.environment.getDataCacheStats();
+	EXPECT_EQ(stats.savedEvaluations, 1);
+	const auto evaluations = stats.evaluations;
+
+	// Writing to a variable invalidates the cache
+	ctx.state->getLocalVariables().setVariable("x", ConfigNode(1));
+	EXPECT_FALSE(ctx.read(g.sinkA).asBool());
+	EXPECT_FALSE(ctx.read(g.sinkB).asBool());
+	EXPECT_EQ(ctx.read(g.sinkC).asInt(), 2);
+	EXPECT_EQ(stats.savedEvaluations, 2);
+	EXPECT_GT(stats.evaluations, evaluations);
+
+	// So does a new tick
+	ctx.state->invalidateDataCache();
+	ctx.read(g.sinkA);
+	EXPECT_EQ(stats.savedEvaluations, 2);
+	ctx.read(g.sinkB);
+	EXPECT_EQ(stats.savedEvaluations, 3);
+}
+
+TEST(HalleyScriptDataCache, MatchesUncached)
+{
+	for (const bool compiled: { false, true }) {
+		ScriptTestContext cached;
+		ScriptTestContext uncached;
+		cached.environment.setDataPinCompilationEnabled(compiled);
+		uncached.environment.setDataPinCompilationEnabled(compiled);
+		uncached.environment.setDataCacheEnabled(false);
+		const CacheTestGraph g0(cached);
+		const CacheTestGraph g1(uncached);
+
+		for (int x = 0; x < 5; ++x) {
+			cached.state->getLocalVariables().setVariable("x", ConfigNode(x));
+			uncached.state->getLocalVariables().setVariable("x", ConfigNode(x));
+			for (int i = 0; i < 2; ++i) {
+				EXPECT_EQ(cached.read(g0.sinkA), uncached.read(g1.sinkA));
+				EXPECT_EQ(cached.read(g0.sinkB), uncached.read(g1.sinkB));
+				EXPECT_EQ(cached.read(g0.sinkC), uncached.read(g1.sinkC));
+			}
+		}
+
+		EXPECT_GT(cached.environment.getDataCacheStats().savedEvaluations, 0);
+		EXPECT_EQ(uncached.environment.getDataCacheStats().savedEvaluations, 0);
+		EXPECT_EQ(uncached.environment.getDataCacheStats().evaluations, 0);
+	}
+}
+
+TEST(HalleyScriptDataCache, ImpureInputsAreNotCached)
+{
+	ScriptTestContext ctx;
+	const auto entityData = ctx.add("convEntityIdToData");
+	const auto size = ctx.addGate("sizeOf", { entityData });
+	const auto sum = ctx.addBinary("arithmetic", "+", size, ctx.addLiteral(ConfigNode(1)));
+	const auto literalSum = ctx.addBinary("arithmetic", "+", ctx.addLiteral(ConfigNode(1)), ctx.addLiteral(ConfigNode(2)));
+	ConfigNode::MapType luaSettings;
+	luaSettings["code"] = "1";
+	const auto luaSum = ctx.addBinary("arithmetic", "+", ctx.add("luaExpression", std::move(luaSettings)), ctx.addLiteral(ConfigNode(2)));
+	const auto sink = ctx.addSink(sum);
+	ctx.prepare();
+
+	EXPECT_FALSE(ctx.graph.isPureDataNode(entityData));
+	EXPECT_FALSE(ctx.graph.isPureDataNode(size));
+	EXPECT_FALSE(ctx.graph.isPureDataNode(sum));
+	EXPECT_TRUE(ctx.graph.isPureDataNode(literalSum));
+	EXPECT_FALSE(ctx.graph.isPureDataNode(luaSum));
+
+	ctx.read(sink);
+	ctx.read(sink);
+	EXPECT_EQ(ctx.environment.getDataCacheStats().savedEvaluations, 0);
+}
+
+namespace {
+	class TestLuaInterface final : public ILuaInterface {
+	public:
+		TestLuaInterface(Resources& resources)
+			: state(initResources(resources))
+		{
+		}
+
+		LuaState& getLuaState() override { return state; }
+
+	private:
+		LuaState state;
+
+		// LuaState loads the halley module on construction, which isn't needed here
+		static Resources& initResources(Resources& resources)
+		{
+			resources.init<BinaryFile>();
+			resources.of<BinaryFile>().setResourceLoader([] (std::string_view name, ResourceLoadPriority)
+			{
+				const String code = "return {}";
+				return std::make_shared<BinaryFile>(gsl::as_bytes(gsl::span<const char>(code.c_str(), code.length())));
+			});
+			return resources;
+		}
+	};
+}
+
+TEST(HalleyScriptDataCache, LuaExpressionsRunOncePerEvaluation)
+{
+	ScriptTestContext ctx;
+	TestLuaInterface lua(ctx.resources);
+	ctx.world.setInterface<ILuaInterface>(&lua);
+
+	// Both outputs come from the same call, so they only match if it isn't run again for the second one
+	ConfigNode::MapType luaSettings;
+	luaSettings["code"] = "calls = (calls or 0) + 1\nreturn calls, calls * 10";
+	luaSettings["outputs"] = 2;
+	const auto expr = ctx.add("luaExpression", std::move(luaSettings));
+	const auto sum = ctx.add("arithmetic", ScriptTestContext::setting("operator", ConfigNode("+")));
+	ctx.connect(expr, 0, sum, 0);
+	ctx.connect(expr, 1, sum, 1);
+	const auto sink = ctx.addSink(sum);
+	ctx.prepare();
+
+	// Each read is a new evaluation, so the expression runs again
+	EXPECT_EQ(ctx.read(sink).asInt(), 11);
+	EXPECT_EQ(ctx.read(sink).asInt(), 22);
+}
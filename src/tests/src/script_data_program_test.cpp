@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "script_test_context.h"
+using namespace Halley;
+
+TEST(HalleyScriptDataProgram, CompiledMatchesInterpreted)
+{
+	ScriptTestContext ctx;
+
+	const auto x = ctx.addVariable("x");
+	const auto undefinedVar = ctx.addVariable("undefined");
+	const auto three = ctx.addLiteral(ConfigNode(3));
+	const auto four = ctx.addLiteral(ConfigNode(4.0f));
+	const auto half = ctx.addLiteral(ConfigNode(0.5f));
+	const auto abc = ctx.addLiteral(ConfigNode("abc"));
+	const auto vec = ctx.addLiteral(ConfigNode(Vector2f(1, 2)));
+	const auto yes = ctx.addLiteral(ConfigNode("yes"));
+	const auto no = ctx.addLiteral(ConfigNode("no"));
+
+	const auto sumInt = ctx.addBinary("arithmetic", "+", three, x);
+	const auto mulFloat = ctx.addBinary("arithmetic", "*", half, x);
+	const auto divide = ctx.addBinary("arithmetic", "/", x, three);
+	const auto concat = ctx.addBinary("arithmetic", "+", abc, abc);
+	const auto negate = ctx.add("arithmetic", ScriptTestContext::setting("operator", ConfigNode("-")));
+	ctx.connect(x, negate, 1);
+
+	const auto toVector = ctx.addGate("toVector", { x, mulFloat });
+	const auto vecSum = ctx.addBinary("arithmetic", "+", toVector, vec);
+	const auto fromVector = ctx.addGate("fromVector", { vecSum });
+
+	const auto greater = ctx.addBinary("comparison", ">=", x, four);
+	const auto intCompare = ctx.addBinary("comparison", "==", sumInt, three);
+	const auto stringCompare = ctx.addBinary("comparison", "<", abc, yes);
+	const auto conditional = ctx.addGate("conditionalOperator", { greater, yes, no });
+
+	const auto notGate = ctx.addGate("logicGateNot", { greater });
+	const auto orGate = ctx.addGate("logicGateOr", { notGate, undefinedVar });
+	const auto andGate = ctx.addGate("logicGateAnd", { greater, stringCompare });
+	const auto xorGate = ctx.addGate("logicGateXor", { andGate, x });
+	const auto valueOr = ctx.addGate("valueOr", { undefinedVar, half });
+
+	// sizeOf isn't compiled, so it goes through a fallback, which itself reads a compiled input
+	const auto sizeOf = ctx.addGate("sizeOf", { concat });
+	const auto sizePlusX = ctx.addBinary("arithmetic", "+", sizeOf, x);
+
+	for (const auto node: { sumInt, mulFloat, divide, concat, negate, vecSum, greater, intCompare, stringCompare,
+		conditional, notGate, orGate, andGate, xorGate, valueOr, sizePlusX, x, undefinedVar }) {
+		ctx.addSink(node);
+	}
+	ctx.addSink(fromVector, 1);
+	ctx.addSink(fromVector, 2);
+
+	ctx.environment.setDataCacheEnabled(false);
+	ctx.prepare();
+	ASSERT_NE(ctx.graph.getDataProgram(), nullptr);
+	EXPECT_GE(ctx.graph.getDataProgram()->getNumEntryPoints(), ctx.sinks.size());
+
+	for (const auto& xValue: { ConfigNode(), ConfigNode(0), ConfigNode(4), ConfigNode(-2.5f), ConfigNode(true), ConfigNode(Vector2f(3, 4)), ConfigNode("text") }) {
+		ctx.state->getLocalVariables().setVariable("x", ConfigNode(xValue));
+
+		for (const auto sink: ctx.sinks) {
+			ctx.environment.setDataPinCompilationEnabled(false);
+			std::optional<ConfigNode> expected;
+			try {
+				expected = ctx.read(sink);
+			} catch (...) {}
+
+			ctx.environment.setDataPinCompilationEnabled(true);
+			if (expected) {
+				const auto compiled = ctx.read(sink);
+				EXPECT_EQ(compiled.getType(), expected->getType()) << "sink " << sink << ", x = " << xValue.asString("null");
+				EXPECT_EQ(compiled, *expected) << "sink " << sink << ", x = " << xValue.asString("null");
+			} else {
+				EXPECT_ANY_THROW(ctx.read(sink)) << "sink " << sink << ", x = " << xValue.asString("null");
+			}
+		}
+	}
+}
+
+TEST(HalleyScriptDataProgram, RecompilesWhenGraphChanges)
+{
+	ScriptTestContext ctx;
+	const auto op = ctx.addBinary("arithmetic", "*", ctx.addLiteral(ConfigNode(2)), ctx.addLiteral(ConfigNode(5)));
+	const auto sink = ctx.addSink(op);
+	ctx.environment.setDataCacheEnabled(false);
+	ctx.prepare();
+	EXPECT_EQ(ctx.read(sink).asInt(), 10);
+
+	ctx.graph.getNodes()[op].getSettings()["operator"] = "-";
+	ctx.graph.updateHash();
+	EXPECT_EQ(ctx.graph.getDataProgram(), nullptr);
+	ctx.environment.assignTypes(ctx.graph);
+	EXPECT_EQ(ctx.read(sink).asInt(), -3);
+	EXPECT_NE(ctx.graph.getDataProgram(), nullptr);
+}
+
+TEST(HalleyScriptDataProgram, DISABLED_Benchmark)
+{
+	// Run with --gtest_also_run_disabled_tests
+	constexpr int nIterations = 200000;
+
+	struct Case {
+		const char* name;
+		std::function<GraphNodeId(ScriptTestContext&)> build;
+	};
+
+	const Case cases[] = {
+		{ "arithmetic chain", [] (ScriptTestContext& ctx)
+		{
+			// ((x + 1) * (y - 2) + x) / 3
+			const auto x = ctx.addVariable("x");
+			const auto y = ctx.addVariable("y");
+			const auto a = ctx.addBinary("arithmetic", "+", x, ctx.addLiteral(ConfigNode(1)));
+			const auto b = ctx.addBinary("arithmetic", "-", y, ctx.addLiteral(ConfigNode(2)));
+			const auto c = ctx.addBinary("arithmetic", "*", a, b);
+			const auto d = ctx.addBinary("arithmetic", "+", c, x);
+			return ctx.addSink(ctx.addBinary("arithmetic", "/", d, ctx.addLiteral(ConfigNode(3.0f))));
+		} },
+		{ "branching", [] (ScriptTestContext& ctx)
+		{
+			// x > y && !(x == 3) ? (x, y) : (y, x)
+			const auto x = ctx.addVariable("x");
+			const auto y = ctx.addVariable("y");
+			const auto gt = ctx.addBinary("comparison", ">", x, y);
+			const auto notEq = ctx.addGate("logicGateNot", { ctx.addBinary("comparison", "==", x, ctx.addLiteral(ConfigNode(3))) });
+			const auto cond = ctx.addGate("conditionalOperator", {
+				ctx.addGate("logicGateAnd", { gt, notEq }),
+				ctx.addGate("toVector", { x, y }),
+				ctx.addGate("toVector", { y, x })
+			});
+			return ctx.addSink(cond);
+		} },
+		{ "with fallback", [] (ScriptTestContext& ctx)
+		{
+			// sizeOf("abc" + "def") * x
+			const auto s = ctx.addBinary("arithmetic", "+", ctx.addLiteral(ConfigNode("abc")), ctx.addLiteral(ConfigNode("def")));
+			return ctx.addSink(ctx.addBinary("arithmetic", "*", ctx.addGate("sizeOf", { s }), ctx.addVariable("x")));
+		} }
+	};
+
+	for (const auto& c: cases) {
+		ScriptTestContext ctx;
+		const auto sink = c.build(ctx);
+		ctx.environment.setDataCacheEnabled(false);
+		ctx.prepare();
+		ctx.state->getLocalVariables().setVariable("x", ConfigNode(7));
+		ctx.state->getLocalVariables().setVariable("y", ConfigNode(2.5f));
+
+		int64_t times[2];
+		ConfigNode results[2];
+		for (int compiled = 0; compiled < 2; ++compiled) {
+			ctx.environment.setDataPinCompilationEnabled(compiled != 0);
+			Stopwatch timer;
+			for (int i = 0; i < nIterations; ++i) {
+				results[compiled] = ctx.read(sink);
+			}
+			timer.pause();
+			times[compiled] = timer.elapsedNanoseconds();
+		}
+		EXPECT_EQ(results[0], results[1]);
+
+		std::cout << c.name << ": interpreted " << (times[0] / nIterations) << " ns/read, compiled " << (times[1] / nIterations) << " ns/read" << std::endl;
+	}
+}
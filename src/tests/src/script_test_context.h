@@ -0,0 +1,144 @@
+#pragma once
+
+#include <halley.hpp>
+
+namespace Halley {
+	class TestCoreAPI final : public CoreAPI {
+	public:
+		void quit(int exitCode) override {}
+		void setStage(StageID stage) override {}
+		void setStage(std::unique_ptr<Stage> stage) override {}
+		void initStage(Stage& stage) override {}
+		Stage& getCurrentStage() override { throw Exception("Not available in tests", HalleyExceptions::Core); }
+		HalleyStatics& getStatics() override { throw Exception("Not available in tests", HalleyExceptions::Core); }
+		const Environment& getEnvironment() override { throw Exception("Not available in tests", HalleyExceptions::Core); }
+		void addProfilerCallback(IProfileCallback* callback) override {}
+		void removeProfilerCallback(IProfileCallback* callback) override {}
+		void addStartFrameCallback(IStartFrameCallback* callback) override {}
+		void removeStartFrameCallback(IStartFrameCallback* callback) override {}
+		Future<std::unique_ptr<RenderSnapshot>> requestRenderSnapshot() override { return {}; }
+		bool isDevMode() override { return false; }
+		DevConClient* getDevConClient() const override { return nullptr; }
+	};
+
+	inline HalleyAPI makeTestAPI(CoreAPI& core)
+	{
+		HalleyAPI api{};
+		api.core = &core;
+		return api;
+	}
+
+	// Just enough of the engine to run scripts without a Core
+	class ScriptTestContext {
+	public:
+		ScriptTestContext()
+			: api(makeTestAPI(core))
+			, resources(nullptr, api, ResourceOptions())
+			, world(api, resources, std::make_shared<WorldReflection>())
+			, environment(api, world, resources, std::make_shared<ScriptNodeTypeCollection>())
+		{
+		}
+
+		GraphNodeId add(const String& type, ConfigNode settings = ConfigNode::MapType())
+		{
+			// Pin types are needed to connect nodes, so assign it straight away
+			const auto id = graph.addNode(type, Vector2f(), std::move(settings));
+			graph.getNodes()[id].assignType(environment.getNodeTypeCollection());
+			return id;
+		}
+
+		GraphNodeId addLiteral(ConfigNode value)
+		{
+			return add("literal", setting("value", std::move(value)));
+		}
+
+		GraphNodeId addVariable(const String& name)
+		{
+			auto settings = setting("variable", ConfigNode(name));
+			settings["scope"] = "local";
+			return add("variable", std::move(settings));
+		}
+
+		GraphNodeId addBinary(const String& type, const String& op, GraphNodeId a, GraphNodeId b)
+		{
+			const auto id = add(type, setting("operator", ConfigNode(op)));
+			connect(a, id, 0);
+			connect(b, id, 1);
+			return id;
+		}
+
+		GraphNodeId addGate(const String& type, std::initializer_list<GraphNodeId> inputs)
+		{
+			const auto id = add(type);
+			GraphPinId pin = 0;
+			for (const auto input: inputs) {
+				connect(input, id, pin++);
+			}
+			return id;
+		}
+
+		// Connects the (first) data output of src
+		void connect(GraphNodeId src, GraphNodeId dst, GraphPinId dstPin)
+		{
+			connect(src, getOutputPin(src), dst, dstPin);
+		}
+
+		void connect(GraphNodeId src, GraphPinId srcPin, GraphNodeId dst, GraphPinId dstPin)
+		{
+			graph.connectPins(src, srcPin, dst, dstPin);
+		}
+
+		GraphPinId getOutputPin(GraphNodeId id) const
+		{
+			const auto& type = graph.getNodes()[id].getType();
+			if (type == "literal") {
+				return 0;
+			} else if (type == "variable" || type == "logicGateNot" || type == "sizeOf" || type == "convEntityIdToData") {
+				return 1;
+			} else if (type == "conditionalOperator") {
+				return 3;
+			} else {
+				return 2;
+			}
+		}
+
+		GraphNodeId addSink(GraphNodeId src, std::optional<GraphPinId> srcPin = {})
+		{
+			const auto id = add("valueOr");
+			connect(src, srcPin.value_or(getOutputPin(src)), id, 0);
+			sinks.push_back(id);
+			return id;
+		}
+
+		void prepare()
+		{
+			graph.updateHash();
+			state = std::make_unique<ScriptState>(&graph, false);
+			environment.assignTypes(graph);
+			state->prepareStates(EntitySerializationContext(), 0);
+		}
+
+		ConfigNode read(GraphNodeId sink)
+		{
+			return environment.readNodeElementDevConData(*state, EntityId(), entityVariables, sink, 0);
+		}
+
+		static ConfigNode setting(const String& key, ConfigNode value)
+		{
+			ConfigNode result = ConfigNode::MapType();
+			result[key] = std::move(value);
+			return result;
+		}
+
+		TestCoreAPI core;
+		HalleyAPI api;
+		Resources resources;
+		World world;
+		ScriptEnvironment environment;
+
+		ScriptGraph graph;
+		std::unique_ptr<ScriptState> state;
+		ScriptVariables entityVariables;
+		Vector<GraphNodeId> sinks;
+	};
+}
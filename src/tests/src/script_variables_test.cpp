@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+TEST(HalleyScriptVariables, SetAndGet)
+{
+	ScriptVariables vars;
+	EXPECT_TRUE(vars.empty());
+	EXPECT_FALSE(vars.hasVariable("a"));
+	EXPECT_EQ(vars.getVariable("a").getType(), ConfigNodeType::Undefined);
+
+	const auto version = vars.getVersion();
+	vars.setVariable("a", ConfigNode(3));
+	vars.setVariable("b", ConfigNode(1.5f));
+	vars.setVariable("c", ConfigNode(Vector2f(1, 2)));
+	vars.setVariable("d", ConfigNode("text"));
+	vars.setVariable("e", ConfigNode(true));
+	EXPECT_GT(vars.getVersion(), version);
+
+	EXPECT_EQ(vars.getVariable("a"), ConfigNode(3));
+	EXPECT_EQ(vars.getVariable("b"), ConfigNode(1.5f));
+	EXPECT_EQ(vars.getVariable("c"), ConfigNode(Vector2f(1, 2)));
+	EXPECT_EQ(vars.getVariable("d"), ConfigNode("text"));
+	EXPECT_EQ(vars.getVariable("e"), ConfigNode(true));
+	EXPECT_EQ(vars.getVariable("a").getType(), ConfigNodeType::Int);
+
+	// Overwriting with a different type
+	vars.setVariable("a", ConfigNode("three"));
+	vars.setVariable("d", ConfigNode(4));
+	EXPECT_EQ(vars.getVariable("a"), ConfigNode("three"));
+	EXPECT_EQ(vars.getVariable("d"), ConfigNode(4));
+
+	// Undefined values are still set
+	vars.setVariable("f", ConfigNode());
+	EXPECT_TRUE(vars.hasVariable("f"));
+
+	vars.clear();
+	EXPECT_TRUE(vars.empty());
+	EXPECT_FALSE(vars.hasVariable("a"));
+}
+
+TEST(HalleyScriptVariables, KeysMatchNames)
+{
+	ScriptVariables vars;
+	const auto key = ScriptVariableKey("speed");
+	EXPECT_EQ(key.getName(), "speed");
+	EXPECT_EQ(key.getHash(), ScriptVariableKey("speed").getHash());
+	EXPECT_NE(key.getHash(), ScriptVariableKey("speeds").getHash());
+
+	vars.setVariable(key, ConfigNode(2.0f));
+	EXPECT_EQ(vars.getVariable("speed"), ConfigNode(2.0f));
+	EXPECT_TRUE(vars.hasVariable(key));
+
+	vars.setVariable("speed", ConfigNode(5));
+	ASSERT_NE(vars.tryGetValue(key), nullptr);
+	EXPECT_EQ(vars.tryGetValue(key)->getType(), ScriptDataValue::Type::Int);
+	EXPECT_EQ(vars.tryGetValue(key)->getInt(), 5);
+
+	ScriptDataValue value;
+	value.setVector2f(Vector2f(3, 4));
+	vars.setValue(ScriptVariableKey("position"), value);
+	EXPECT_EQ(vars.getVariable("position"), ConfigNode(Vector2f(3, 4)));
+	EXPECT_EQ(vars.tryGetValue(ScriptVariableKey("missing")), nullptr);
+}
+
+TEST(HalleyScriptVariables, CollidingHashesKeepSeparateSlots)
+{
+	ScriptVariables vars;
+	const auto a = ScriptVariableKey("a", 42);
+	const auto b = ScriptVariableKey("b", 42);
+	const auto c = ScriptVariableKey("c", 42);
+
+	vars.setVariable(a, ConfigNode(1));
+	vars.setVariable(b, ConfigNode(2));
+	EXPECT_FALSE(vars.hasVariable(c));
+	EXPECT_EQ(vars.getVariable(a), ConfigNode(1));
+	EXPECT_EQ(vars.getVariable(b), ConfigNode(2));
+
+	vars.setVariable(a, ConfigNode(3));
+	EXPECT_EQ(vars.getVariable(a), ConfigNode(3));
+	EXPECT_EQ(vars.getVariable(b), ConfigNode(2));
+
+	const auto node = vars.toConfigNode(EntitySerializationContext());
+	EXPECT_EQ(node["a"], ConfigNode(3));
+	EXPECT_EQ(node["b"], ConfigNode(2));
+}
+
+TEST(HalleyScriptVariables, Serialization)
+{
+	const EntitySerializationContext context;
+
+	ScriptVariables vars;
+	vars.setVariable("a", ConfigNode(3));
+	vars.setVariable("b", ConfigNode("text"));
+	ConfigNode::SequenceType sequence;
+	sequence.push_back(ConfigNode(1));
+	sequence.push_back(ConfigNode(2));
+	vars.setVariable("c", ConfigNode(sequence));
+
+	const auto node = ConfigNodeSerializer<ScriptVariables>().serialize(vars, context);
+	ASSERT_EQ(node.getType(), ConfigNodeType::Map);
+	EXPECT_EQ(node["a"], ConfigNode(3));
+	EXPECT_EQ(node["b"], ConfigNode("text"));
+	EXPECT_EQ(node["c"], ConfigNode(sequence));
+
+	const auto loaded = ConfigNodeSerializer<ScriptVariables>().deserialize(context, node);
+	EXPECT_EQ(loaded.getVariable("a"), ConfigNode(3));
+	EXPECT_EQ(loaded.getVariable("b"), ConfigNode("text"));
+	EXPECT_EQ(loaded.getVariable("c"), ConfigNode(sequence));
+
+	// Deltas, as sent over the network
+	ScriptVariables changed = loaded;
+	changed.setVariable("a", ConfigNode(4));
+	changed.setVariable("d", ConfigNode(1.5f));
+	auto changedNode = ConfigNodeSerializer<ScriptVariables>().serialize(changed, context);
+	changedNode.removeKey("b");
+	const auto delta = ConfigNode::createDelta(node, changedNode);
+	EXPECT_EQ(delta.getType(), ConfigNodeType::DeltaMap);
+
+	ScriptVariables target = loaded;
+	ConfigNodeSerializer<ScriptVariables>().deserialize(context, delta, target);
+	EXPECT_EQ(target.getVariable("a"), ConfigNode(4));
+	EXPECT_FALSE(target.hasVariable("b"));
+	EXPECT_EQ(target.getVariable("c"), ConfigNode(sequence));
+	EXPECT_EQ(target.getVariable("d"), ConfigNode(1.5f));
+}
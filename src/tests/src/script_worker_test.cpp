@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "script_test_context.h"
+#include "test_executors.h"
+using namespace Halley;
+
+TEST(HalleyScriptWorker, DetectsMainThreadNodes)
+{
+	ScriptTestContext ctx;
+	const auto op = ctx.addBinary("arithmetic", "+", ctx.addLiteral(ConfigNode(1)), ctx.addVariable("x"));
+	ctx.addSink(op);
+	ctx.prepare();
+	EXPECT_FALSE(ctx.graph.requiresMainThread());
+
+	ctx.add("spawnEntity");
+	ctx.graph.updateHash();
+	ctx.environment.assignTypes(ctx.graph);
+	EXPECT_TRUE(ctx.graph.requiresMainThread());
+}
+
+TEST(HalleyScriptWorker, NodesRequireMainThreadUnlessKnownSafe)
+{
+	ScriptTestContext ctx;
+	Vector<GraphNodeId> ids;
+	for (const auto* type: { "setPosition", "setRotation", "setScale", "setHeight", "setSubworld", "startScript", "spawnEntity", "luaExpression" }) {
+		ids.push_back(ctx.add(type));
+	}
+	ctx.graph.updateHash();
+	ctx.environment.assignTypes(ctx.graph);
+	for (const auto id: ids) {
+		const auto& node = ctx.graph.getNodes()[id];
+		EXPECT_TRUE(node.getNodeType().requiresMainThread()) << node.getType();
+	}
+
+	EXPECT_FALSE(ctx.environment.getNodeTypeCollection().tryGetNodeType("stopScript")->requiresMainThread());
+	EXPECT_FALSE(ctx.environment.getNodeTypeCollection().tryGetNodeType("wait")->requiresMainThread());
+}
+
+namespace {
+	// One entity per state, all running a script that asks to stop another script on its own entity
+	struct ParallelTestEntities {
+		Vector<ScriptStateSet> states;
+		Vector<ScriptVariables> variables;
+		Vector<ScriptParallelUpdater::Entity> entities;
+
+		ParallelTestEntities(ScriptTestContext& ctx, size_t n)
+			: states(n)
+			, variables(n)
+		{
+			for (size_t i = 0; i < n; ++i) {
+				auto state = std::make_shared<ScriptState>(&ctx.graph, false);
+				state->prepareStates(EntitySerializationContext(), 0);
+				states[i].addState(std::move(state));
+				entities.push_back({ EntityId(static_cast<int64_t>(i + 1)), &states[i], &variables[i] });
+			}
+		}
+
+		// The main thread pass in ScriptSystem, which picks up anything the workers didn't update
+		void updateRemaining(ScriptEnvironment& env, Time t)
+		{
+			for (auto& e: entities) {
+				for (auto& state: *e.states) {
+					if (!state->getFrameFlag()) {
+						env.update(t, *state, e.entityId, *e.variables);
+						state->setFrameFlag(true);
+					}
+				}
+			}
+		}
+	};
+
+	ScriptTestContext& makeStopScriptGraph(ScriptTestContext& ctx)
+	{
+		// Graphs are created with a start node
+		const auto start = *ctx.graph.getStartNode();
+		ctx.graph.getNodes()[start].assignType(ctx.environment.getNodeTypeCollection());
+		const auto stop = ctx.add("stopScript", ScriptTestContext::setting("script", ConfigNode("other")));
+		ctx.connect(start, 0, stop, 0);
+		ctx.prepare();
+		return ctx;
+	}
+}
+
+TEST(HalleyScriptWorker, ParallelUpdateMatchesSerial)
+{
+	constexpr size_t n = 100;
+	TestExecutors executors(3);
+
+	ScriptTestContext serialCtx;
+	ParallelTestEntities serial(makeStopScriptGraph(serialCtx), n);
+	serial.updateRemaining(serialCtx.environment, 0.1);
+	const auto serialRequests = serialCtx.environment.getScriptExecutionRequests();
+	ASSERT_EQ(serialRequests.size(), n);
+
+	ScriptTestContext parallelCtx;
+	ParallelTestEntities parallel(makeStopScriptGraph(parallelCtx), n);
+	EXPECT_FALSE(parallelCtx.graph.requiresMainThread());
+	for (auto& e: parallel.entities) {
+		EXPECT_TRUE(ScriptParallelUpdater::canUpdateInParallel(parallelCtx.environment, *e.states));
+	}
+
+	ScriptParallelUpdater updater;
+	updater.update(parallelCtx.environment, parallel.entities, 0.1);
+
+	// Every state was updated by a worker, and nothing reached the environment before merging
+	for (auto& e: parallel.entities) {
+		EXPECT_TRUE((*e.states->begin())->getFrameFlag());
+		EXPECT_FALSE(ScriptParallelUpdater::canUpdateInParallel(parallelCtx.environment, *e.states));
+	}
+	parallel.updateRemaining(parallelCtx.environment, 0.1);
+
+	const auto parallelRequests = parallelCtx.environment.getScriptExecutionRequests();
+	ASSERT_EQ(parallelRequests.size(), serialRequests.size());
+	for (size_t i = 0; i < n; ++i) {
+		EXPECT_EQ(parallelRequests[i].target, serialRequests[i].target);
+		EXPECT_EQ(parallelRequests[i].target, EntityId(static_cast<int64_t>(i + 1)));
+		EXPECT_EQ(parallelRequests[i].type, ScriptEnvironment::ScriptExecutionRequestType::Stop);
+	}
+}
+
+TEST(HalleyScriptWorker, MainThreadScriptsAreLeftForSerialUpdate)
+{
+	TestExecutors executors(3);
+	ScriptTestContext ctx;
+	const auto start = *ctx.graph.getStartNode();
+	ctx.graph.getNodes()[start].assignType(ctx.environment.getNodeTypeCollection());
+	const auto setPosition = ctx.add("setPosition");
+	ctx.connect(start, 0, setPosition, 0);
+	ctx.prepare();
+
+	// Same filtering as ScriptSystem does
+	ParallelTestEntities all(ctx, 100);
+	Vector<ScriptParallelUpdater::Entity> parallel;
+	for (auto& e: all.entities) {
+		if (ScriptParallelUpdater::canUpdateInParallel(ctx.environment, *e.states)) {
+			parallel.push_back(e);
+		}
+	}
+	EXPECT_TRUE(parallel.empty());
+
+	ScriptParallelUpdater updater;
+	updater.update(ctx.environment, parallel, 0.1);
+	for (auto& e: all.entities) {
+		EXPECT_FALSE((*e.states->begin())->getFrameFlag());
+	}
+}
+
+TEST(HalleyScriptWorker, MergesOutboxesInOrder)
+{
+	ScriptTestContext ctx;
+	auto worker0 = ctx.environment.makeWorker();
+	auto worker1 = ctx.environment.makeWorker();
+	ctx.environment.prepareWorker(*worker0);
+	ctx.environment.prepareWorker(*worker1);
+	EXPECT_TRUE(worker0->isWorker());
+	EXPECT_FALSE(ctx.environment.isWorker());
+
+	worker1->startScript(EntityId(), "b", {}, {});
+	worker0->startScript(EntityId(), "a", {}, {});
+	worker1->stopScript(EntityId(), "c");
+	EXPECT_FALSE(worker0->hasStopRequests());
+	EXPECT_TRUE(worker1->hasStopRequests());
+
+	ctx.environment.mergeWorker(*worker0);
+	ctx.environment.mergeWorker(*worker1);
+	EXPECT_TRUE(worker1->getScriptExecutionRequests().empty());
+
+	const auto requests = ctx.environment.getScriptExecutionRequests();
+	ASSERT_EQ(requests.size(), 3);
+	EXPECT_EQ(requests[0].value, "a");
+	EXPECT_EQ(requests[1].value, "b");
+	EXPECT_EQ(requests[2].value, "c");
+	EXPECT_EQ(requests[2].type, ScriptEnvironment::ScriptExecutionRequestType::Stop);
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	std::shared_ptr<Material> makeMaterial(Resources& resources, const String& texture)
+	{
+		auto material = std::make_shared<Material>(resources.get<MaterialDefinition>(MaterialDefinition::defaultMaterial));
+		material->set(0, resources.get<Texture>(texture));
+		return material;
+	}
+
+	Sprite makeSprite(const std::shared_ptr<Material>& material)
+	{
+		Sprite sprite;
+		sprite.setMaterial(material).setTexRect(Rect4f(0, 0, 1, 1)).setSize(Vector2f(32, 32)).setPosition(Vector2f(100, 100));
+		return sprite;
+	}
+}
+
+TEST(HalleySpritePainter, SkipsRedundantBinds)
+{
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	const auto sprite = makeSprite(makeMaterial(renderer.getResources(), "a"));
+
+	renderer.render([&] (RenderContext& rc)
+	{
+		rc.bind([&] (Painter& p)
+		{
+			sprite.draw(p);
+			p.flush();
+			sprite.draw(p);
+		});
+	});
+	EXPECT_EQ(painter.getNumDrawCalls(), 2);
+	EXPECT_EQ(painter.getNumBindsAvoided(), 2); // Pass and uniform data
+
+	renderer.render([&] (RenderContext& rc)
+	{
+		rc.bind([&] (Painter& p)
+		{
+			sprite.draw(p);
+			p.setClip(Rect4i(0, 0, 50, 50));
+			sprite.draw(p);
+		});
+	});
+	EXPECT_EQ(painter.getNumDrawCalls(), 2);
+	EXPECT_EQ(painter.getNumBindsAvoided(), 0);
+}
+
+TEST(HalleySpritePainter, SortsUnorderedLayersByMaterial)
+{
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	const auto materialA = makeMaterial(renderer.getResources(), "a");
+	const auto materialB = makeMaterial(renderer.getResources(), "b");
+	const auto last = makeSprite(makeMaterial(renderer.getResources(), "c"));
+
+	// All on top of each other, so only an unordered layer can batch them
+	Vector<Sprite> sprites;
+	for (int i = 0; i < 20; ++i) {
+		sprites.push_back(makeSprite(i % 2 == 0 ? materialA : materialB));
+	}
+
+	auto drawCalls = [&] (bool unordered)
+	{
+		SpritePainter spritePainter;
+		spritePainter.setLayerUnordered(0, unordered);
+		renderer.render([&] (RenderContext& rc)
+		{
+			spritePainter.startFrame();
+			for (size_t i = 0; i < sprites.size(); ++i) {
+				spritePainter.add(sprites[i], 1, 0, float(i));
+			}
+			spritePainter.add([] (Painter& p) {}, 1, 1, 0.0f);
+			spritePainter.add(last, 1, 2, 0.0f);
+			rc.bind([&] (Painter& p) { spritePainter.draw(1, p); });
+		});
+		return painter.getNumDrawCalls();
+	};
+
+	EXPECT_EQ(drawCalls(false), 21);
+	EXPECT_EQ(drawCalls(true), 3);
+}
+
+TEST(HalleySpritePainter, DrawsFromTwoThreads)
+{
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	const auto materialA = makeMaterial(renderer.getResources(), "a");
+	const auto materialB = makeMaterial(renderer.getResources(), "b");
+
+	Vector<Sprite> sprites;
+	for (int i = 0; i < 200; ++i) {
+		sprites.push_back(makeSprite(i % 2 == 0 ? materialA : materialB));
+	}
+
+	SpritePainter spritePainter;
+	spritePainter.setLayerUnordered(0);
+	PainterCommandList listA(painter);
+	PainterCommandList listB(painter);
+
+	auto drawCalls = [&] (bool parallel)
+	{
+		renderer.render([&] (RenderContext& rc)
+		{
+			// Whichever thread draws first has to sort the painter, while the other one waits on it
+			spritePainter.startFrame();
+			for (size_t i = 0; i < sprites.size(); ++i) {
+				spritePainter.add(sprites[i], 1, 0, float(i));
+			}
+
+			auto record = [&] (PainterCommandList& list)
+			{
+				list.record(rc, [&] (RenderContext& listContext)
+				{
+					listContext.bind([&] (Painter& p) { spritePainter.draw(1, p); });
+				});
+			};
+			if (parallel) {
+				std::thread threadA([&] { record(listA); });
+				std::thread threadB([&] { record(listB); });
+				threadA.join();
+				threadB.join();
+			} else {
+				record(listA);
+				record(listB);
+			}
+
+			rc.bind([&] (Painter& p)
+			{
+				listA.replay(p);
+				listB.replay(p);
+			});
+		});
+		return painter.getNumDrawCalls();
+	};
+
+	const auto serial = drawCalls(false);
+	EXPECT_EQ(serial, 4);
+	for (int i = 0; i < 50; ++i) {
+		ASSERT_EQ(drawCalls(true), serial);
+	}
+}
+
+TEST(HalleySpritePainter, InstancingUploadsAQuarterOfTheVertexData)
+{
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	auto sprite = makeSprite(makeMaterial(renderer.getResources(), "a"));
+	constexpr int nSprites = 1000;
+
+	auto drawSprites = [&] (bool instancing)
+	{
+		painter.setInstancingEnabled(instancing);
+		renderer.render([&] (RenderContext& rc)
+		{
+			rc.bind([&] (Painter& p)
+			{
+				for (int i = 0; i < nSprites; ++i) {
+					sprite.setPosition(Vector2f(float(i % 100), float(i / 100))).draw(p);
+				}
+			});
+		});
+		return std::tuple(painter.getNumDrawCalls(), painter.getNumTriangles(), painter.getNumBytesUploaded());
+	};
+
+	const auto [instancedCalls, instancedTris, instancedBytes] = drawSprites(true);
+	const auto [expandedCalls, expandedTris, expandedBytes] = drawSprites(false);
+
+	// Same draw, but one vertex per sprite instead of four (standard quad indices are cached either way)
+	EXPECT_EQ(instancedCalls, 1);
+	EXPECT_EQ(expandedCalls, 1);
+	EXPECT_EQ(instancedTris, nSprites * 2);
+	EXPECT_EQ(expandedTris, nSprites * 2);
+	const auto stride = sprite.getMaterial().getDefinition().getVertexStride();
+	EXPECT_EQ(instancedBytes, nSprites * stride);
+	EXPECT_EQ(expandedBytes, nSprites * 4 * stride);
+}
+
+TEST(HalleySpritePainter, DISABLED_InstancingBenchmark)
+{
+	// Run with --gtest_also_run_disabled_tests
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	auto sprite = makeSprite(makeMaterial(renderer.getResources(), "a"));
+	constexpr int nSprites = 100000;
+	constexpr int nFrames = 30;
+
+	for (const bool instancing: { true, false }) {
+		painter.setInstancingEnabled(instancing);
+		Stopwatch timer;
+		for (int frame = 0; frame < nFrames; ++frame) {
+			renderer.render([&] (RenderContext& rc)
+			{
+				rc.bind([&] (Painter& p)
+				{
+					for (int i = 0; i < nSprites; ++i) {
+						sprite.setPosition(Vector2f(float(i % 1000), float(i / 1000))).draw(p);
+					}
+				});
+			});
+		}
+		timer.pause();
+		std::cout << (instancing ? "instanced: " : "expanded: ") << (timer.elapsedMicroseconds() / nFrames) << " us/frame, "
+			<< painter.getNumBytesUploaded() << " bytes/frame, " << painter.getNumDrawCalls() << " draw calls" << std::endl;
+	}
+}
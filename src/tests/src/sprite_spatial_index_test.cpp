@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	Sprite makeSprite(Vector2f pos)
+	{
+		Sprite sprite;
+		sprite.setSize(Vector2f(32, 32)).setPosition(pos);
+		return sprite;
+	}
+
+	Vector<SpriteSpatialIndex::Handle> bruteForce(const Vector<Sprite>& sprites, Rect4f area)
+	{
+		Vector<SpriteSpatialIndex::Handle> result;
+		for (size_t i = 0; i < sprites.size(); ++i) {
+			if (sprites[i].getAABB().overlaps(area)) {
+				result.push_back(static_cast<SpriteSpatialIndex::Handle>(i));
+			}
+		}
+		return result;
+	}
+}
+
+TEST(HalleySpriteSpatialIndex, MatchesBruteForce)
+{
+	SpriteSpatialIndex index(128.0f);
+	Vector<Sprite> sprites;
+	for (int y = -25; y < 25; ++y) {
+		for (int x = -25; x < 25; ++x) {
+			sprites.push_back(makeSprite(Vector2f(float(x * 100), float(y * 100))));
+			index.add(sprites.back(), 1, 0);
+		}
+	}
+
+	// One huge sprite, spanning many cells
+	sprites.push_back(makeSprite(Vector2f(-300, -300)).setScale(20.0f));
+	index.add(sprites.back(), 1, 0);
+
+	Vector<SpriteSpatialIndex::Handle> result;
+	for (const auto area: { Rect4f(-10, -10, 1000, 500), Rect4f(-2600, -2600, 5200, 5200), Rect4f(45, 45, 10, 10), Rect4f(123, -456, 789, 321) }) {
+		index.query(area, result);
+		EXPECT_EQ(result, bruteForce(sprites, area));
+	}
+
+	// Far away from anything, and doesn't grow the grid
+	index.query(Rect4f(1000000, 1000000, 500, 500), result);
+	EXPECT_TRUE(result.empty());
+}
+
+TEST(HalleySpriteSpatialIndex, UpdatesAndRemoves)
+{
+	SpriteSpatialIndex index(128.0f);
+	const auto a = index.add(makeSprite(Vector2f(0, 0)), 1, 0);
+	const auto b = index.add(makeSprite(Vector2f(50, 0)), 1, 0);
+
+	Vector<SpriteSpatialIndex::Handle> result;
+	index.query(Rect4f(0, 0, 100, 100), result);
+	EXPECT_EQ(result.size(), 2);
+
+	index.update(a, makeSprite(Vector2f(5000, 5000)));
+	index.query(Rect4f(0, 0, 100, 100), result);
+	EXPECT_EQ(result, Vector<SpriteSpatialIndex::Handle>{ b });
+	index.query(Rect4f(4990, 4990, 100, 100), result);
+	EXPECT_EQ(result, Vector<SpriteSpatialIndex::Handle>{ a });
+
+	index.remove(b);
+	EXPECT_EQ(index.size(), 1);
+	index.query(Rect4f(0, 0, 100, 100), result);
+	EXPECT_TRUE(result.empty());
+
+	// Handles get reused
+	EXPECT_EQ(index.add(makeSprite(Vector2f(10, 10)), 1, 0), b);
+	EXPECT_EQ(index.getSprite(b).getPosition(), Vector2f(10, 10));
+}
+
+TEST(HalleySpriteSpatialIndex, SubmitsOnlyVisibleSprites)
+{
+	SpriteSpatialIndex index;
+	for (int i = 0; i < 100; ++i) {
+		index.add(makeSprite(Vector2f(float(i * 100), 0)), 1, 0);
+	}
+
+	SpritePainter painter;
+	painter.startFrame();
+
+	Camera camera(Vector2f(500, 0));
+	camera.setViewPort(Rect4i(0, 0, 640, 360));
+	const auto view = camera.getClippingRectangle();
+	index.submit(painter, view);
+
+	// 640 wide around x = 500, so only the ones from 200 to 800
+	EXPECT_EQ(index.getStats().submitted, 7);
+	EXPECT_EQ(index.getStats().culled, 93);
+
+	const auto bounds = painter.getBounds();
+	ASSERT_TRUE(bounds.has_value());
+	EXPECT_TRUE(bounds->overlaps(view));
+
+	index.resetStats();
+	EXPECT_EQ(index.getStats().submitted, 0);
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "halley/data_structures/static_bvh.h"
+using namespace Halley;
+
+namespace {
+	// Five elements split into groups of 1, 1, 1 and 2, so the last node has two unused slots
+	Vector<Rect4f> makeBounds()
+	{
+		Vector<Rect4f> result;
+		for (int i = 0; i < 5; ++i) {
+			result.push_back(Rect4f(Vector2f(float(i * 10), 0), 5, 5));
+		}
+		return result;
+	}
+}
+
+TEST(HalleyStaticBVH, UnusedSlotsAreNeverVisited)
+{
+	const auto bounds = makeBounds();
+	const StaticBVH bvh(bounds);
+	constexpr float inf = std::numeric_limits<float>::infinity();
+
+	Vector<int> visits(bounds.size(), 0);
+	bvh.visitNearest(Vector2f(100, 100), inf, [&] (StaticBVH::Index idx, float maxDist)
+	{
+		++visits.at(idx);
+		return maxDist;
+	});
+	EXPECT_EQ(visits, Vector<int>(bounds.size(), 1));
+
+	visits.assign(bounds.size(), 0);
+	bvh.visitOverlapping(Rect4f(Vector2f(-inf, -inf), Vector2f(inf, inf)), [&] (StaticBVH::Index idx)
+	{
+		++visits.at(idx);
+	});
+	EXPECT_EQ(visits, Vector<int>(bounds.size(), 1));
+
+	const std::array<Vector2f, 2> points = { Vector2f(100, 100), Vector2f(-100, 0) };
+	std::array<float, 2> maxDists = { inf, inf };
+	visits.assign(bounds.size() * points.size(), 0);
+	bvh.visitNearestPacket(points, maxDists, [&] (size_t query, StaticBVH::Index idx, float maxDist)
+	{
+		++visits.at(query * bounds.size() + idx);
+		return maxDist;
+	});
+	EXPECT_EQ(visits, Vector<int>(bounds.size() * points.size(), 1));
+}
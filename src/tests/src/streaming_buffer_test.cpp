@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	void drawSprites(Painter& painter, const std::shared_ptr<const Material>& material, int n)
+	{
+		Sprite sprite;
+		sprite.setMaterial(material).setTexRect(Rect4f(0, 0, 1, 1)).setSize(Vector2f(16, 16));
+		for (int i = 0; i < n; ++i) {
+			sprite.setPosition(Vector2f(float(i % 100), float(i / 100))).draw(painter);
+		}
+	}
+}
+
+TEST(HalleyStreamingBuffer, CyclesThroughRegions)
+{
+	alignas(StreamingBuffer::alignment) std::array<char, 300> memory;
+	StreamingBuffer buffer(memory, 3);
+
+	EXPECT_EQ(buffer.startFrame(), 0);
+	const auto first = buffer.getFreeSpace();
+	EXPECT_EQ(first.data(), memory.data());
+	EXPECT_EQ(first.size(), 96);
+
+	buffer.commit(10);
+	EXPECT_EQ(buffer.getOffset(buffer.getFreeSpace().data()), 16);
+	EXPECT_EQ(buffer.getFreeSpace().size(), 80);
+
+	EXPECT_EQ(buffer.startFrame(), 1);
+	EXPECT_EQ(buffer.getOffset(buffer.getFreeSpace().data()), 96);
+	EXPECT_EQ(buffer.startFrame(), 2);
+	EXPECT_EQ(buffer.startFrame(), 0);
+	EXPECT_EQ(buffer.getFreeSpace().size(), 96);
+
+	EXPECT_TRUE(buffer.contains(memory.data() + 299));
+	EXPECT_FALSE(buffer.contains(memory.data() + 300));
+}
+
+TEST(HalleyStreamingBuffer, PainterStreamsDrawData)
+{
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	auto material = std::make_shared<Material>(renderer.getResources().get<MaterialDefinition>(MaterialDefinition::defaultMaterial));
+	material->set(0, renderer.getResources().get<Texture>("texture"));
+
+	for (const bool instancing: { true, false }) {
+		painter.setInstancingEnabled(instancing);
+		renderer.render([&] (RenderContext& rc)
+		{
+			rc.bind([&] (Painter& p)
+			{
+				drawSprites(p, material, 1000);
+				p.drawRect(Rect4f(10, 10, 100, 100), 1.0f, Colour4f(1, 1, 1, 1));
+			});
+		});
+
+		EXPECT_GT(painter.getNumBytesUploaded(), 0);
+		EXPECT_EQ(painter.getNumBytesStreamed(), painter.getNumBytesUploaded());
+	}
+}
+
+TEST(HalleyStreamingBuffer, FallsBackWhenRegionIsFull)
+{
+	HeadlessRenderer renderer;
+	auto& painter = renderer.getPainter();
+	painter.setInstancingEnabled(false);
+	auto material = std::make_shared<Material>(renderer.getResources().get<MaterialDefinition>(MaterialDefinition::defaultMaterial));
+	material->set(0, renderer.getResources().get<Texture>("texture"));
+
+	// Far more than one frame's region holds, which still has to draw everything
+	constexpr int nSprites = 100000;
+	renderer.render([&] (RenderContext& rc)
+	{
+		rc.bind([&] (Painter& p) { drawSprites(p, material, nSprites); });
+	});
+
+	EXPECT_EQ(painter.getNumVertices(), nSprites * 4);
+	EXPECT_GT(painter.getNumBytesStreamed(), 0);
+	EXPECT_LT(painter.getNumBytesStreamed(), painter.getNumBytesUploaded());
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+TEST(HalleyTempMemoryPool, AllocatesAligned)
+{
+	TempMemoryPool pool(1024);
+	auto* a = pool.allocate(3, 1);
+	auto* b = pool.allocate(16, 16);
+	EXPECT_NE(a, b);
+	EXPECT_EQ(reinterpret_cast<size_t>(b) % 16, 0);
+
+	pool.deallocate(a, 3);
+	pool.deallocate(b, 16);
+	pool.reset();
+	EXPECT_EQ(pool.allocate(3, 1), a);
+	pool.deallocate(a, 3);
+}
+
+TEST(HalleyTempMemoryPool, PagesRequestsLargerThanCapacity)
+{
+	TempMemoryPool pool(256);
+	auto* small = pool.allocate(200, 8);
+
+	// Doesn't fit in the first page, nor in a page of the regular size
+	constexpr size_t bigSize = 4096;
+	auto* big = pool.allocate(bigSize, 16);
+	ASSERT_NE(big, nullptr);
+	EXPECT_EQ(reinterpret_cast<size_t>(big) % 16, 0);
+	memset(big, 0xCD, bigSize);
+
+	// Small requests keep going to the page with room
+	auto* more = pool.allocate(32, 8);
+	EXPECT_NE(more, nullptr);
+
+	pool.deallocate(more, 32);
+	pool.deallocate(big, bigSize);
+	pool.deallocate(small, 200);
+	pool.reset();
+
+	// The large page is kept around for the next frame
+	EXPECT_EQ(pool.allocate(200, 8), small);
+	EXPECT_EQ(pool.allocate(bigSize, 16), big);
+	pool.deallocate(big, bigSize);
+	pool.deallocate(small, 200);
+}
+
+TEST(HalleyTempMemoryPool, ThrowsWithoutPaging)
+{
+	TempMemoryPool pool(256, false);
+	EXPECT_THROW(pool.allocate(512, 8), std::bad_alloc);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <halley.hpp>
+
+namespace Halley {
+	// Installs executors with a pool of CPU threads for the duration of a test, then puts back whichever instance was there before
+	class TestExecutors {
+	public:
+		explicit TestExecutors(size_t nCPUThreads = 2)
+			: prev(Executors::hasInstance() ? &Executors::get() : nullptr)
+		{
+			Executors::setInstance(executors);
+			if (nCPUThreads > 0) {
+				pool = std::make_unique<ThreadPool>("CPU", executors.getCPU(), nCPUThreads, [] (String name, std::function<void()> f) { return std::thread(std::move(f)); });
+			}
+		}
+
+		~TestExecutors()
+		{
+			pool.reset();
+			if (prev) {
+				Executors::setInstance(*prev);
+			} else {
+				Executors::clearInstance();
+			}
+		}
+
+		TestExecutors(const TestExecutors& other) = delete;
+		TestExecutors& operator=(const TestExecutors& other) = delete;
+
+		Executors executors;
+
+	private:
+		Executors* prev;
+		std::unique_ptr<ThreadPool> pool;
+	};
+}
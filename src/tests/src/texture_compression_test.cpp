@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	Image makeGradient(Vector2i size, bool withAlpha)
+	{
+		Image image(Image::Format::RGBA, size);
+		auto px = image.getPixels4BPP();
+		for (int y = 0; y < size.y; ++y) {
+			for (int x = 0; x < size.x; ++x) {
+				const auto alpha = withAlpha ? (x * 255) / std::max(size.x - 1, 1) : 255;
+				px[y * size.x + x] = int(Image::convertRGBAToInt(x * 4, 255 - y * 4, 128, alpha));
+			}
+		}
+		return image;
+	}
+
+	int maxChannelError(const Image& a, const Image& b)
+	{
+		int maxError = 0;
+		const auto pa = a.getPixels4BPP();
+		const auto pb = b.getPixels4BPP();
+		for (size_t i = 0; i < pa.size(); ++i) {
+			const auto ca = Image::convertIntToColour(pa[i]);
+			const auto cb = Image::convertIntToColour(pb[i]);
+			maxError = std::max({ maxError, std::abs(ca.r - cb.r), std::abs(ca.g - cb.g), std::abs(ca.b - cb.b), std::abs(ca.a - cb.a) });
+		}
+		return maxError;
+	}
+}
+
+TEST(HalleyTextureCompression, SolidColourIsExact)
+{
+	Image image(Image::Format::RGBA, Vector2i(4, 4));
+	image.clear(int(Image::convertRGBAToInt(255, 0, 0)));
+
+	for (const auto format: { TextureFormat::BC1, TextureFormat::BC3 }) {
+		const auto data = TextureCompression::compress(image, format);
+		EXPECT_EQ(data.size(), TextureDescriptor::getBlockByteSize(format));
+		EXPECT_EQ(TextureDescriptor::getBytesPerPixel(format), 4); // Sampled as RGBA, e.g. by halley.texBPP
+
+		const auto decoded = TextureCompression::decompress(data.byte_span(), format, image.getSize());
+		EXPECT_EQ(maxChannelError(image, *decoded), 0);
+	}
+}
+
+TEST(HalleyTextureCompression, RoundTripsGradients)
+{
+	// Not a multiple of 4, so edge blocks are partially used
+	// Textures are rejected on import at this size, but it's what the small mips of any texture look like
+	const auto size = Vector2i(30, 18);
+
+	const auto opaque = makeGradient(size, false);
+	const auto bc1 = TextureCompression::compress(opaque, TextureFormat::BC1);
+	EXPECT_EQ(bc1.size(), 8 * 8 * 5);
+	EXPECT_LE(maxChannelError(opaque, *TextureCompression::decompress(bc1.byte_span(), TextureFormat::BC1, size)), 12);
+
+	const auto translucent = makeGradient(size, true);
+	const auto bc3 = TextureCompression::compress(translucent, TextureFormat::BC3);
+	EXPECT_EQ(bc3.size(), 16 * 8 * 5);
+	EXPECT_LE(maxChannelError(translucent, *TextureCompression::decompress(bc3.byte_span(), TextureFormat::BC3, size)), 12);
+}
+
+TEST(HalleyTextureCompression, BC1KeepsTransparentPixels)
+{
+	Image image(Image::Format::RGBA, Vector2i(4, 4));
+	image.clear(int(Image::convertRGBAToInt(0, 200, 0)));
+	image.getPixels4BPP()[5] = 0;
+
+	const auto data = TextureCompression::compress(image, TextureFormat::BC1);
+	const auto decoded = TextureCompression::decompress(data.byte_span(), TextureFormat::BC1, image.getSize());
+	EXPECT_EQ(Image::convertIntToColour(decoded->getPixel4BPP(Vector2i(1, 1))).a, 0);
+	EXPECT_EQ(Image::convertIntToColour(decoded->getPixel4BPP(Vector2i(2, 2))).a, 255);
+}
+
+TEST(HalleyTextureCompression, StoresMipChain)
+{
+	const auto size = Vector2i(64, 16);
+	EXPECT_EQ(TextureCompression::getMaxMipLevels(size), 7);
+	EXPECT_EQ(TextureCompression::getMipSize(size, 6), Vector2i(1, 1));
+
+	// 64, 16, 4, 2, 1, 1 and 1 blocks
+	const auto data = TextureCompression::compress(makeGradient(size, false), TextureFormat::BC1, 7);
+	EXPECT_EQ(data.size(), 8 * (64 + 16 + 4 + 2 + 1 + 1 + 1));
+	EXPECT_EQ(data.size(), TextureCompression::getMipChainByteSize(TextureFormat::BC1, size, 7));
+}
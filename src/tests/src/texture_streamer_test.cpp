@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+#include "test_executors.h"
+using namespace Halley;
+
+namespace {
+	constexpr auto textureSize = Vector2i(256, 256);
+
+	TextureDescriptor makeDescriptor(Vector2i size = textureSize)
+	{
+		Image image(Image::Format::RGBA, size);
+		image.clear(int(Image::convertRGBAToInt(40, 80, 160)));
+		const auto mipLevels = TextureCompression::getMaxMipLevels(size);
+
+		TextureDescriptor descriptor(size, TextureFormat::BC1);
+		descriptor.mipLevels = mipLevels;
+		descriptor.pixelData = TextureCompression::compress(image, TextureFormat::BC1, mipLevels);
+		return descriptor;
+	}
+
+	std::shared_ptr<Texture> addTexture(HeadlessRenderer& renderer, TextureStreamer& streamer)
+	{
+		std::shared_ptr<Texture> texture = renderer.getAPI().video->createTexture(textureSize);
+		streamer.add(texture, makeDescriptor());
+		return texture;
+	}
+
+	void runFrame(TextureStreamer& streamer, ExecutionQueue& queue)
+	{
+		streamer.update();
+		Executor(queue).runPending();
+		streamer.update();
+	}
+}
+
+TEST(HalleyTextureStreamer, StreamsInRequestedMips)
+{
+	HeadlessRenderer renderer;
+	TestExecutors executors(0);
+	ExecutionQueue queue;
+	TextureStreamer streamer(*renderer.getAPI().video, 1024 * 1024, queue);
+
+	EXPECT_FALSE(TextureStreamer::canStream(TextureDescriptor(textureSize, TextureFormat::RGBA)));
+	EXPECT_TRUE(TextureStreamer::canStream(makeDescriptor()));
+
+	// Starts with the 64x64 mip and below only
+	auto texture = addTexture(renderer, streamer);
+	EXPECT_EQ(streamer.getResidentMipLevel(*texture), 2);
+	EXPECT_EQ(texture->getSize(), textureSize);
+
+	streamer.reportUsage(*texture, 0);
+	runFrame(streamer, queue);
+	EXPECT_EQ(streamer.getResidentMipLevel(*texture), 0);
+	EXPECT_EQ(streamer.getNumStreamedIn(), 1);
+	EXPECT_EQ(streamer.getMemoryUsage().vramUsage, TextureCompression::getMipChainByteSize(TextureFormat::BC1, textureSize, TextureCompression::getMaxMipLevels(textureSize)));
+
+	texture.reset();
+	streamer.update();
+	EXPECT_EQ(streamer.getMemoryUsage().vramUsage, 0);
+}
+
+TEST(HalleyTextureStreamer, OnlyDropsMipsMadeOfWholeBlocks)
+{
+	HeadlessRenderer renderer;
+	ExecutionQueue queue;
+	TextureStreamer streamer(*renderer.getAPI().video, 1024 * 1024, queue);
+
+	// 144x18 would be next, but that can't be the top level of a block compressed texture
+	const auto size = Vector2i(288, 36);
+	std::shared_ptr<Texture> texture = renderer.getAPI().video->createTexture(size);
+	streamer.add(texture, makeDescriptor(size));
+	EXPECT_EQ(streamer.getResidentMipLevel(*texture), 0);
+}
+
+TEST(HalleyTextureStreamer, EvictsLeastRecentlyUsed)
+{
+	HeadlessRenderer renderer;
+	TestExecutors executors(0);
+	ExecutionQueue queue;
+
+	// Only fits one texture fully streamed in
+	TextureStreamer streamer(*renderer.getAPI().video, 50000, queue);
+	auto a = addTexture(renderer, streamer);
+	auto b = addTexture(renderer, streamer);
+
+	streamer.reportUsage(*a, 0);
+	runFrame(streamer, queue);
+	EXPECT_EQ(streamer.getResidentMipLevel(*a), 0);
+
+	streamer.reportUsage(*b, 0);
+	runFrame(streamer, queue);
+	EXPECT_EQ(streamer.getResidentMipLevel(*a), 2);
+	EXPECT_EQ(streamer.getResidentMipLevel(*b), 0);
+	EXPECT_EQ(streamer.getNumEvicted(), 1);
+	EXPECT_LE(streamer.getMemoryUsage().vramUsage, streamer.getBudget());
+
+	// Both in use, so neither gets evicted for the other
+	streamer.reportUsage(*a, 0);
+	streamer.reportUsage(*b, 0);
+	runFrame(streamer, queue);
+	EXPECT_EQ(streamer.getResidentMipLevel(*a), 2);
+	EXPECT_EQ(streamer.getResidentMipLevel(*b), 0);
+}
+
+TEST(HalleyTextureStreamer, RequiredMipLevel)
+{
+	EXPECT_EQ(TextureStreamer::getRequiredMipLevel(Vector2f(256, 256), Vector2f(512, 512)), 0);
+	EXPECT_EQ(TextureStreamer::getRequiredMipLevel(Vector2f(256, 256), Vector2f(256, 256)), 0);
+	EXPECT_EQ(TextureStreamer::getRequiredMipLevel(Vector2f(256, 256), Vector2f(64, 64)), 2);
+	EXPECT_EQ(TextureStreamer::getRequiredMipLevel(Vector2f(256, 128), Vector2f(100, 64)), 1);
+}
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	class CountingElement final : public IUIElement {
+	public:
+		explicit CountingElement(Vector2f size) : size(size) {}
+
+		Vector2f getLayoutMinimumSize(bool force) const override { return size; }
+		void setRect(Rect4f r, IUIElementListener* listener) override { rect = r; ++placed; }
+		bool isActive() const override { return true; }
+
+		Vector2f size;
+		Rect4f rect;
+		int placed = 0;
+	};
+
+	std::shared_ptr<UIWidget> makeTree(int nGroups, int nItemsPerGroup, Vector<std::shared_ptr<UIWidget>>& groups, Vector<std::shared_ptr<UIWidget>>& items)
+	{
+		auto root = std::make_shared<UIWidget>("root", Vector2f(), UISizer(UISizerType::Vertical));
+		for (int i = 0; i < nGroups; ++i) {
+			auto group = std::make_shared<UIWidget>("group" + toString(i), Vector2f(), UISizer(UISizerType::Grid, 1.0f, 4));
+			for (int j = 0; j < nItemsPerGroup; ++j) {
+				auto item = std::make_shared<UIWidget>("item" + toString(j), Vector2f(10, 10), UISizer(UISizerType::Horizontal));
+				group->add(item);
+				items.push_back(item);
+			}
+			root->add(group);
+			groups.push_back(group);
+		}
+		return root;
+	}
+}
+
+TEST(HalleyUILayout, OnlyDirtySubtreesAreLaidOut)
+{
+	auto root = std::make_shared<UIWidget>("root", Vector2f(50, 0), UISizer(UISizerType::Vertical));
+	Vector<std::shared_ptr<UIWidget>> groups;
+	Vector<std::shared_ptr<CountingElement>> elements;
+	for (int i = 0; i < 3; ++i) {
+		auto group = std::make_shared<UIWidget>("group" + toString(i), Vector2f(), UISizer(UISizerType::Horizontal));
+		auto element = std::make_shared<CountingElement>(Vector2f(20, 10));
+		group->add(element);
+		root->add(group);
+		groups.push_back(group);
+		elements.push_back(element);
+	}
+
+	root->layout();
+	for (auto& e: elements) {
+		EXPECT_EQ(e->placed, 1);
+	}
+	EXPECT_EQ(root->getSize(), Vector2f(50, 32));
+	EXPECT_EQ(groups[2]->getPosition(), Vector2f(0, 22));
+
+	// Nothing changed
+	root->layout();
+	for (auto& e: elements) {
+		EXPECT_EQ(e->placed, 1);
+	}
+
+	// Only the changed group is placed again, as its siblings keep their rects
+	groups[1]->setInnerBorder(Vector4f(1, 0, 0, 0));
+	root->layout();
+	EXPECT_EQ(elements[0]->placed, 1);
+	EXPECT_EQ(elements[1]->placed, 2);
+	EXPECT_EQ(elements[2]->placed, 1);
+	EXPECT_EQ(elements[1]->rect.getTopLeft(), Vector2f(1, 11));
+	EXPECT_EQ(root->getSize(), Vector2f(50, 32));
+
+	// Growing a group moves its siblings
+	groups[0]->setMinSize(Vector2f(0, 15));
+	root->layout();
+	EXPECT_EQ(elements[0]->placed, 2);
+	EXPECT_EQ(elements[1]->placed, 3);
+	EXPECT_EQ(elements[2]->placed, 2);
+	EXPECT_EQ(groups[2]->getPosition(), Vector2f(0, 27));
+
+	// Moving the whole tree places everything again
+	root->setPosition(Vector2f(100, 0));
+	root->layout();
+	EXPECT_EQ(elements[0]->placed, 3);
+	EXPECT_EQ(elements[1]->placed, 4);
+	EXPECT_EQ(elements[2]->placed, 3);
+	EXPECT_EQ(groups[0]->getPosition(), Vector2f(100, 0));
+	EXPECT_EQ(elements[1]->rect.getTopLeft(), Vector2f(101, 16));
+}
+
+TEST(HalleyUILayout, SizerChangesInvalidateLayout)
+{
+	Vector<std::shared_ptr<UIWidget>> groups;
+	Vector<std::shared_ptr<UIWidget>> items;
+	auto root = makeTree(2, 3, groups, items);
+	root->layout();
+	EXPECT_EQ(root->getSize(), Vector2f(33, 21));
+
+	groups[1]->add(std::make_shared<UIWidget>("extra", Vector2f(10, 10)));
+	root->layout();
+	EXPECT_EQ(root->getSize(), Vector2f(43, 21));
+
+	groups[0]->setActive(false);
+	root->layout();
+	EXPECT_EQ(root->getSize(), Vector2f(43, 10));
+
+	groups[1]->getSizer().swapItems(0, 3);
+	root->layout();
+	EXPECT_EQ(items[3]->getPosition().x, 33.0f);
+}
+
+TEST(HalleyUILayout, ScrollingPlacesChildrenAgain)
+{
+	auto root = std::make_shared<UIWidget>("root", Vector2f(), UISizer(UISizerType::Vertical));
+	auto pane = std::make_shared<UIScrollPane>("pane", Vector2f(0, 20), UISizer(UISizerType::Vertical));
+	Vector<std::shared_ptr<UIWidget>> items;
+	for (int i = 0; i < 5; ++i) {
+		items.push_back(std::make_shared<UIWidget>("item" + toString(i), Vector2f(10, 10)));
+		pane->add(items.back());
+	}
+	root->add(pane);
+
+	root->layout();
+	pane->update(0, false);
+	root->layout();
+	EXPECT_EQ(pane->getSize(), Vector2f(10, 20));
+	EXPECT_EQ(items[2]->getPosition(), Vector2f(0, 22));
+
+	pane->scrollTo(Vector2f(0, 15));
+	EXPECT_EQ(pane->getScrollPosition(), Vector2f(0, 15));
+	root->layout();
+	EXPECT_EQ(items[0]->getPosition(), Vector2f(0, -15));
+	EXPECT_EQ(items[2]->getPosition(), Vector2f(0, 7));
+
+	// Clamped to the contents
+	pane->scrollBy(Vector2f(0, 100));
+	root->layout();
+	EXPECT_EQ(items[4]->getPosition(), Vector2f(0, 10));
+}
+
+TEST(HalleyUILayout, MovesDuringLayoutDontDirtyParent)
+{
+	auto root = std::make_shared<UIWidget>("root", Vector2f(), UISizer(UISizerType::Vertical));
+	auto element = std::make_shared<CountingElement>(Vector2f(20, 10));
+	auto panel = std::make_shared<UIWidget>("panel", Vector2f(100, 100));
+	auto anchored = std::make_shared<UIWidget>("anchored", Vector2f(10, 10));
+	anchored->setAnchor(UIAnchor());
+	panel->add(anchored);
+	panel->addNewChildren(UIInputType::Undefined);
+	root->add(element);
+	root->add(panel);
+
+	root->layout();
+	EXPECT_EQ(element->placed, 1);
+	EXPECT_EQ(anchored->getPosition(), Vector2f(45, 56));
+
+	// Anchoring during the last pass didn't leave anything to do
+	root->layout();
+	EXPECT_EQ(element->placed, 1);
+
+	// Moving it from outside does, and the anchor puts it back
+	anchored->setPosition(Vector2f(0, 0));
+	root->layout();
+	EXPECT_EQ(element->placed, 2);
+	EXPECT_EQ(anchored->getPosition(), Vector2f(45, 56));
+}
+
+TEST(HalleyUILayout, DISABLED_Benchmark)
+{
+	// Run with --gtest_also_run_disabled_tests
+	constexpr int nGroups = 100;
+	constexpr int nItemsPerGroup = 100;
+	constexpr int nIterations = 1000;
+
+	Vector<std::shared_ptr<UIWidget>> groups;
+	Vector<std::shared_ptr<UIWidget>> items;
+	auto root = makeTree(nGroups, nItemsPerGroup, groups, items);
+
+	Stopwatch fullTimer;
+	root->layout();
+	fullTimer.pause();
+
+	Stopwatch cleanTimer;
+	for (int i = 0; i < nIterations; ++i) {
+		root->layout();
+	}
+	cleanTimer.pause();
+
+	Stopwatch changedTimer;
+	for (int i = 0; i < nIterations; ++i) {
+		items[(i * 7919) % items.size()]->setMinSize(Vector2f(10.0f + float(i % 2), 10.0f));
+		root->layout();
+	}
+	changedTimer.pause();
+
+	std::cout << (nGroups * nItemsPerGroup) << " widgets: first layout " << fullTimer.elapsedMicroseconds() << " us, unchanged " << (cleanTimer.elapsedNanoseconds() / nIterations / 1000.0)
+		<< " us, one widget changed " << (changedTimer.elapsedNanoseconds() / nIterations / 1000.0) << " us" << std::endl;
+}
@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	class DrawCountingWidget final : public UIWidget {
+	public:
+		DrawCountingWidget(String id, Vector2f size)
+			: UIWidget(std::move(id), size)
+		{
+			sprite.setSize(size);
+		}
+
+		void draw(UIPainter& painter) const override
+		{
+			++draws;
+			painter.draw(sprite);
+		}
+
+		Sprite sprite;
+		mutable int draws = 0;
+	};
+
+	class Host final : public UIWidget {
+	public:
+		using UIWidget::UIWidget;
+
+		void drawAll(UIPainter& painter) const
+		{
+			drawChildren(painter);
+		}
+	};
+
+	class TestButton final : public UIButton {
+	public:
+		using UIButton::UIButton;
+		using UIButton::doSetState;
+	};
+
+	std::shared_ptr<UIStyleSheet> makeStyleSheet(Resources& resources)
+	{
+		// The default style needs a font, but nothing here draws text
+		resources.init<Font>();
+		resources.of<Font>().setResourceLoader([] (std::string_view name, ResourceLoadPriority)
+		{
+			return std::make_shared<Font>(String(name), "", 10.0f, 12.0f, 12.0f, 1.0f, Vector2i(16, 16));
+		});
+		return std::make_shared<UIStyleSheet>(resources);
+	}
+
+	std::shared_ptr<Host> makeHud(int nPanels, int nItemsPerPanel, bool cached, Vector<std::shared_ptr<DrawCountingWidget>>& items)
+	{
+		auto host = std::make_shared<Host>("host", Vector2f(), UISizer(UISizerType::Vertical));
+		for (int i = 0; i < nPanels; ++i) {
+			auto panel = std::make_shared<UIWidget>("panel" + toString(i), Vector2f(), UISizer(UISizerType::Horizontal));
+			panel->setRenderCached(cached);
+			for (int j = 0; j < nItemsPerPanel; ++j) {
+				auto item = std::make_shared<DrawCountingWidget>("item" + toString(j), Vector2f(10, 10));
+				panel->add(item);
+				items.push_back(item);
+			}
+			host->add(panel);
+		}
+		host->forceAddChildren(UIInputType::Undefined, true);
+		host->layout();
+		return host;
+	}
+}
+
+TEST(HalleyUIRenderCache, MergesEntries)
+{
+	SpritePainter spritePainter;
+	spritePainter.startFrame();
+	UIPainter painter(spritePainter, 1, 0);
+
+	Sprite sprite;
+	sprite.setSize(Vector2f(10, 10));
+
+	UIRenderCache cache;
+	EXPECT_FALSE(painter.canDraw(cache));
+	{
+		auto recorder = painter.withRecording(cache);
+		EXPECT_TRUE(recorder.isRecording());
+		recorder.draw(sprite);
+		recorder.draw(sprite);
+		recorder.withAdjustedLayer(1).draw(sprite);
+		recorder.draw(sprite);
+		recorder.withClip(Rect4f(0, 0, 5, 5)).draw(sprite);
+	}
+	EXPECT_FALSE(painter.isRecording());
+	EXPECT_EQ(cache.getNumberOfEntries(), 4);
+
+	EXPECT_TRUE(painter.canDraw(cache));
+	EXPECT_FALSE(painter.withAlpha(0.5f).canDraw(cache));
+	EXPECT_FALSE(painter.withAdjustedLayer(1).canDraw(cache));
+	cache.invalidate();
+	EXPECT_FALSE(painter.canDraw(cache));
+}
+
+TEST(HalleyUIRenderCache, RedrawsOnlyWhenInvalidated)
+{
+	Vector<std::shared_ptr<DrawCountingWidget>> items;
+	auto host = makeHud(1, 5, true, items);
+	const auto panel = host->getChildren().at(0);
+
+	SpritePainter spritePainter;
+	auto drawFrame = [&] (float alpha)
+	{
+		spritePainter.startFrame();
+		UIPainter painter(spritePainter, 1, 0);
+		auto p2 = alpha < 1.0f ? painter.withAlpha(alpha) : painter.clone();
+		host->drawAll(p2);
+	};
+	auto expectDraws = [&] (int n)
+	{
+		for (auto& item: items) {
+			EXPECT_EQ(item->draws, n);
+		}
+	};
+
+	drawFrame(1.0f);
+	expectDraws(1);
+	drawFrame(1.0f);
+	expectDraws(1);
+
+	// Layout changes in the subtree
+	items[2]->setMinSize(Vector2f(10, 20));
+	host->layout();
+	drawFrame(1.0f);
+	expectDraws(2);
+	drawFrame(1.0f);
+	expectDraws(2);
+
+	// Painter state changes
+	drawFrame(0.5f);
+	expectDraws(3);
+	drawFrame(1.0f);
+	expectDraws(4);
+
+	// Explicit invalidation
+	items[0]->invalidateRenderCache();
+	drawFrame(1.0f);
+	expectDraws(5);
+
+	panel->setRenderCached(false);
+	drawFrame(1.0f);
+	drawFrame(1.0f);
+	expectDraws(7);
+}
+
+TEST(HalleyUIRenderCache, WidgetsInvalidateWhenTheirLookChanges)
+{
+	HeadlessRenderer renderer;
+	const auto styleSheet = makeStyleSheet(renderer.getResources());
+
+	Vector<std::shared_ptr<DrawCountingWidget>> items;
+	auto host = makeHud(1, 2, true, items);
+	const auto panel = host->getChildren().at(0);
+
+	auto button = std::make_shared<TestButton>("button", UIStyle("button", styleSheet));
+	auto image = std::make_shared<UIImage>("image", Sprite().setSize(Vector2f(10, 10)));
+	panel->add(button);
+	panel->add(image);
+	panel->forceAddChildren(UIInputType::Undefined, true);
+	host->layout();
+
+	SpritePainter spritePainter;
+	auto drawFrame = [&] ()
+	{
+		spritePainter.startFrame();
+		UIPainter painter(spritePainter, 1, 0);
+		host->drawAll(painter);
+		return items[0]->draws;
+	};
+
+	const int start = drawFrame();
+	EXPECT_EQ(drawFrame(), start);
+
+	// Buttons change sprite on hover, press, etc. without any layout
+	button->doSetState(UIClickable::State::Hover);
+	EXPECT_EQ(drawFrame(), start + 1);
+	EXPECT_EQ(drawFrame(), start + 1);
+
+	// Sprites handed out for changing
+	image->getSprite().setColour(Colour4f(1, 0, 0));
+	EXPECT_EQ(drawFrame(), start + 2);
+	image->setLayerAdjustment(1);
+	EXPECT_EQ(drawFrame(), start + 3);
+	image->setLayerAdjustment(1);
+	EXPECT_EQ(drawFrame(), start + 3);
+}
+
+TEST(HalleyUIRenderCache, DISABLED_Benchmark)
+{
+	// Run with --gtest_also_run_disabled_tests
+	constexpr int nPanels = 50;
+	constexpr int nItemsPerPanel = 40;
+	constexpr int nFrames = 1000;
+
+	auto run = [&] (bool cached)
+	{
+		Vector<std::shared_ptr<DrawCountingWidget>> items;
+		auto host = makeHud(nPanels, nItemsPerPanel, cached, items);
+		SpritePainter spritePainter;
+
+		Stopwatch timer;
+		for (int i = 0; i < nFrames; ++i) {
+			spritePainter.startFrame();
+			UIPainter painter(spritePainter, 1, 0);
+			host->drawAll(painter);
+		}
+		timer.pause();
+		return timer.elapsedNanoseconds() / nFrames / 1000.0;
+	};
+
+	const auto uncachedTime = run(false);
+	const auto cachedTime = run(true);
+	std::cout << (nPanels * nItemsPerPanel) << " static widgets: " << uncachedTime << " us per frame, cached " << cachedTime << " us per frame" << std::endl;
+}
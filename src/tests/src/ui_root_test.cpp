@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	class TestInput final : public InputAPI {
+	public:
+		size_t getNumberOfKeyboards() const override { return 0; }
+		std::shared_ptr<InputKeyboard> getKeyboard(int id) const override { return {}; }
+		size_t getNumberOfJoysticks() const override { return 0; }
+		std::shared_ptr<InputDevice> getJoystick(int id) const override { return {}; }
+		size_t getNumberOfMice() const override { return 0; }
+		std::shared_ptr<InputDevice> getMouse(int id) const override { return {}; }
+		Vector<std::shared_ptr<InputTouch>> getNewTouchEvents() override { return {}; }
+		Vector<std::shared_ptr<InputTouch>> getTouchEvents() override { return {}; }
+		void setMouseRemapping(std::function<Vector2f(Vector2i)> remapFunction) override {}
+	};
+
+	class TestUI {
+	public:
+		TestUI()
+		{
+			api.input = &input;
+			root = std::make_unique<UIRoot>(api, Rect4f(0, 0, 1280, 720));
+			BaseFrameData::setThreadFrameData(&frameData);
+		}
+
+		~TestUI()
+		{
+			root.reset();
+			BaseFrameData::setThreadFrameData(nullptr);
+		}
+
+		void update()
+		{
+			root->update(1.0 / 60.0, UIInputType::Undefined, {}, {});
+		}
+
+		TestInput input;
+		HalleyAPI api{};
+		BaseFrameData frameData;
+		std::unique_ptr<UIRoot> root;
+	};
+
+	class CountingWidget : public UIWidget {
+	public:
+		CountingWidget(String id, std::shared_ptr<int> updates, std::optional<UISizer> sizer = {})
+			: UIWidget(std::move(id), Vector2f(), std::move(sizer))
+			, updates(std::move(updates))
+		{}
+
+	protected:
+		void update(Time t, bool moved) override
+		{
+			++*updates;
+		}
+
+		std::shared_ptr<int> updates;
+	};
+
+	class ClearParentWidget final : public CountingWidget {
+	public:
+		using CountingWidget::CountingWidget;
+
+		bool clearParent = false;
+
+	protected:
+		void update(Time t, bool moved) override
+		{
+			CountingWidget::update(t, moved);
+			if (clearParent) {
+				clearParent = false;
+				dynamic_cast<UIWidget*>(getParent())->clear();
+			}
+		}
+	};
+}
+
+TEST(HalleyUIRoot, WidgetsRemovedDuringUpdateAreSkipped)
+{
+	TestUI ui;
+
+	auto updates = std::make_shared<int>(0);
+	auto siblingUpdates = std::make_shared<int>(0);
+	auto panel = std::make_shared<UIWidget>("panel", Vector2f(), UISizer());
+	auto clearer = std::make_shared<ClearParentWidget>("clearer", updates);
+	panel->add(clearer);
+	for (int i = 0; i < 3; ++i) {
+		auto sibling = std::make_shared<CountingWidget>("sibling" + toString(i), siblingUpdates, UISizer());
+		sibling->add(std::make_shared<CountingWidget>("child", siblingUpdates));
+		panel->add(sibling);
+	}
+	ui.root->addChild(panel);
+
+	ui.update();
+	const int siblingUpdatesPerFrame = *siblingUpdates;
+	EXPECT_EQ(siblingUpdatesPerFrame, 12);
+	ui.update();
+	EXPECT_EQ(*siblingUpdates, 2 * siblingUpdatesPerFrame);
+
+	// The siblings are already queued for updating when they get removed, and nothing else is keeping them alive
+	clearer = {};
+	auto* clearerWidget = dynamic_cast<ClearParentWidget*>(panel->getChildren().at(0).get());
+	ASSERT_NE(clearerWidget, nullptr);
+	clearerWidget->clearParent = true;
+	ui.update();
+	EXPECT_EQ(*siblingUpdates, 2 * siblingUpdatesPerFrame);
+	EXPECT_TRUE(panel->getChildren().empty());
+
+	ui.update();
+	EXPECT_EQ(*siblingUpdates, 2 * siblingUpdatesPerFrame);
+}
+
+TEST(HalleyUIRoot, DISABLED_UpdateBenchmark)
+{
+	// Run with --gtest_also_run_disabled_tests
+	constexpr int nPanels = 100;
+	constexpr int nItemsPerPanel = 100;
+	constexpr int nFrames = 200;
+
+	TestUI ui;
+	auto updates = std::make_shared<int>(0);
+	for (int i = 0; i < nPanels; ++i) {
+		auto panel = std::make_shared<UIWidget>("panel" + toString(i), Vector2f(), UISizer(UISizerType::Vertical));
+		for (int j = 0; j < nItemsPerPanel; ++j) {
+			auto item = std::make_shared<CountingWidget>("item" + toString(j), updates, UISizer());
+			item->add(std::make_shared<CountingWidget>("label", updates));
+			panel->add(item);
+		}
+		ui.root->addChild(panel);
+	}
+	ui.update();
+
+	*updates = 0;
+	Stopwatch timer;
+	for (int i = 0; i < nFrames; ++i) {
+		ui.update();
+	}
+	timer.pause();
+
+	std::cout << (nPanels * (1 + 2 * nItemsPerPanel)) << " widgets: " << (timer.elapsedNanoseconds() / nFrames / 1000.0) << " us per frame, " << (*updates / nFrames) << " widget updates per frame" << std::endl;
+}
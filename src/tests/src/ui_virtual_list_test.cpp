@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <halley.hpp>
+using namespace Halley;
+
+namespace {
+	class TestSource final : public IUIVirtualListSource {
+	public:
+		explicit TestSource(size_t n) : n(n) {}
+
+		size_t getNumberOfItems() const override { return n; }
+		String getItemId(size_t idx) const override { return "item" + toString(idx); }
+
+		std::shared_ptr<UIWidget> makeItemWidget(UIVirtualList& list) override
+		{
+			++made;
+			return std::make_shared<UIWidget>("row", Vector2f(20, 0));
+		}
+
+		void bindItemWidget(UIVirtualList& list, UIWidget& widget, size_t idx) override
+		{
+			++bound;
+			widget.setId(getItemId(idx));
+		}
+
+		size_t n;
+		int made = 0;
+		int bound = 0;
+	};
+
+	class TestList final : public UIVirtualList {
+	public:
+		using UIVirtualList::UIVirtualList;
+		using UIVirtualList::onKeyPress;
+	};
+}
+
+TEST(HalleyUIVirtualList, OnlyVisibleRowsAreMaterialized)
+{
+	auto source = std::make_shared<TestSource>(1000);
+	auto list = std::make_shared<TestList>("list", std::nullopt, 10.0f);
+	list->setOverscan(2);
+	list->setSource(source);
+	list->layout();
+	EXPECT_EQ(list->getSize(), Vector2f(0, 10000));
+
+	list->updateVisibleRows(Rect4f(0, 0, 100, 50));
+	EXPECT_EQ(list->getMaterializedRange(), std::make_pair(size_t(0), size_t(7)));
+	EXPECT_EQ(source->made, 7);
+
+	list->updateVisibleRows(Rect4f(0, 500, 100, 50));
+	EXPECT_EQ(list->getMaterializedRange(), std::make_pair(size_t(48), size_t(57)));
+	EXPECT_EQ(source->made, 9);
+	EXPECT_EQ(list->tryGetItemWidget(10), nullptr);
+	ASSERT_NE(list->tryGetItemWidget(50), nullptr);
+	EXPECT_EQ(list->tryGetItemWidget(50)->getId(), "item50");
+
+	// Only the visible rows are laid out, at their place in the full list
+	list->layout();
+	EXPECT_EQ(list->getSize(), Vector2f(20, 10000));
+	EXPECT_EQ(list->tryGetItemWidget(50)->getPosition(), Vector2f(0, 500));
+	EXPECT_EQ(list->tryGetItemWidget(50)->getSize(), Vector2f(20, 10));
+
+	// Scrolling through everything reuses the same widgets
+	for (int y = 0; y < 10000; y += 30) {
+		list->updateVisibleRows(Rect4f(0, float(y), 100, 50));
+	}
+	EXPECT_EQ(source->made, 9);
+	EXPECT_EQ(list->getMaterializedRange(), std::make_pair(size_t(997), size_t(1000)));
+	EXPECT_EQ(list->tryGetItemWidget(999)->getId(), "item999");
+
+	// Rows that stay in view aren't bound again
+	const auto boundBefore = source->bound;
+	list->updateVisibleRows(Rect4f(0, 9990, 100, 10));
+	EXPECT_EQ(source->bound, boundBefore);
+
+	// Removing items drops the rows past the end
+	source->n = 500;
+	list->refresh();
+	list->updateVisibleRows(Rect4f(0, 4900, 100, 50));
+	EXPECT_EQ(list->getMaterializedRange(), std::make_pair(size_t(488), size_t(497)));
+	list->layout();
+	EXPECT_EQ(list->getSize(), Vector2f(20, 5000));
+}
+
+TEST(HalleyUIVirtualList, SelectionAndKeyboard)
+{
+	auto source = std::make_shared<TestSource>(1000);
+	auto list = std::make_shared<TestList>("list", std::nullopt, 10.0f);
+	list->setSource(source);
+	list->layout();
+	list->updateVisibleRows(Rect4f(0, 0, 100, 50));
+	EXPECT_EQ(list->getSelectedOption(), 0);
+	EXPECT_EQ(list->getSelectedOptionId(), "item0");
+
+	// Selection is tracked by index, so it doesn't need the row to be materialized
+	list->setSelectedOptionId("item600");
+	EXPECT_EQ(list->getSelectedOption(), 600);
+	EXPECT_TRUE(list->isSelected(600));
+	EXPECT_FALSE(list->isSelected(0));
+	EXPECT_EQ(list->getOptionRect(600), Rect4f(0, 6000, 0, 10));
+	EXPECT_EQ(list->getItemAt(Vector2f(5, 6005)), size_t(600));
+
+	list->onKeyPress(KeyboardKeyPress(KeyCode::Down));
+	EXPECT_EQ(list->getSelectedOption(), 601);
+	list->onKeyPress(KeyboardKeyPress(KeyCode::PageDown));
+	EXPECT_EQ(list->getSelectedOption(), 606);
+	list->onKeyPress(KeyboardKeyPress(KeyCode::End));
+	EXPECT_EQ(list->getSelectedOption(), 999);
+	list->onKeyPress(KeyboardKeyPress(KeyCode::Down));
+	EXPECT_EQ(list->getSelectedOption(), 0);
+	list->onKeyPress(KeyboardKeyPress(KeyCode::PageUp));
+	EXPECT_EQ(list->getSelectedOption(), 0);
+	list->onKeyPress(KeyboardKeyPress(KeyCode::Up));
+	EXPECT_EQ(list->getSelectedOption(), 999);
+	EXPECT_EQ(list->getSelectedOptions(), Vector<int>{ 999 });
+
+	list->setMultiSelect(true);
+	list->setSelectedOption(10);
+	list->setSelectedOption(700, UIList::SelectionMode::ShiftSelect);
+	EXPECT_EQ(list->getSelectedOption(), 10);
+	EXPECT_EQ(list->getSelectedOptions().size(), 691);
+	list->setSelectedOption(300, UIList::SelectionMode::CtrlSelect);
+	EXPECT_FALSE(list->isSelected(300));
+	EXPECT_EQ(list->getSelectedOptions().size(), 690);
+
+	source->n = 100;
+	list->refresh();
+	EXPECT_EQ(list->getSelectedOptions().size(), 90);
+	EXPECT_EQ(list->getSelectedOption(), 10);
+}
+
+TEST(HalleyUIVirtualList, DISABLED_Benchmark)
+{
+	// Run with --gtest_also_run_disabled_tests
+	constexpr size_t nItems = 50000;
+	constexpr float rowHeight = 10.0f;
+	constexpr float viewHeight = 600.0f;
+
+	auto source = std::make_shared<TestSource>(nItems);
+	auto list = std::make_shared<TestList>("list", std::nullopt, rowHeight);
+
+	Stopwatch virtualTimer;
+	list->setSource(source);
+	list->updateVisibleRows(Rect4f(0, 0, 100, viewHeight));
+	list->layout();
+	virtualTimer.pause();
+
+	int nFrames = 0;
+	Stopwatch scrollTimer;
+	for (float y = 0; y < float(nItems) * rowHeight; y += 70.0f) {
+		list->updateVisibleRows(Rect4f(0, y, 100, viewHeight));
+		list->layout();
+		++nFrames;
+	}
+	scrollTimer.pause();
+
+	std::cout << nItems << " items: " << virtualTimer.elapsedMicroseconds() << " us to build with " << source->made << " widgets, " << (scrollTimer.elapsedNanoseconds() / nFrames / 1000.0) << " us per scrolled frame" << std::endl;
+}
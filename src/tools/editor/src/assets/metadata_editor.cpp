@@ -93,6 +93,7 @@ void MetadataEditor::makeUI()
 		addBoolField("Mipmap", "mipmap", false);
 		addBoolField("Power of Two", "powerOfTwo", true);
 		addEnumField<TextureFormat>("Format", "format", "rgba");
+		addDropdownField("Compression", "blockCompression", { "none", "bc1", "bc3" }, "none");
 		addEnumField<TextureAddressMode>("Address", "addressMode", "clamp");
 		addInt2Field("Tile Split", "tileWidth", "tileHeight", Vector2i());
 		addBoolField("Trim", "trim", true);
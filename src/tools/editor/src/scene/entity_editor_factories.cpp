@@ -1379,6 +1379,8 @@ public:
 		systemContainer->add(context.makeField("bool", pars.withSubKey("destroyWhenDone", "false"), ComponentEditorLabelCreation::Never));
 		systemContainer->add(context.makeLabel("Relative Position"));
 		systemContainer->add(context.makeField("bool", pars.withSubKey("relativePosition", "false"), ComponentEditorLabelCreation::Never));
+		systemContainer->add(context.makeLabel("Direct Draw"));
+		systemContainer->add(context.makeField("bool", pars.withSubKey("directDraw", "false"), ComponentEditorLabelCreation::Never));
 		multiSystemContainer->add(context.makeLabel("On Spawn"));
 		multiSystemContainer->add(context.makeField("Halley::EntityId", pars.withSubKey("onSpawn", ""), ComponentEditorLabelCreation::Never));
 		multiSystemContainer->add(context.makeLabel("On Death"));
@@ -4,6 +4,8 @@
 #include "halley/tools/assets/import_assets_database.h"
 #include "halley/tools/file/filesystem.h"
 #include "halley/file_formats/image.h"
+#include "halley/graphics/texture.h"
+#include "halley/graphics/texture_compression.h"
 
 using namespace Halley;
 
@@ -22,8 +24,23 @@ void TextureImporter::import(const ImportingAsset& asset, IAssetCollector& colle
 
 	const bool useQOI = false;
 	const bool useHLIF = true;
+	const auto blockCompression = meta.getString("blockCompression", "none");
 
-	if (useHLIF) {
+	if (blockCompression != "none") {
+		// Stored ready for upload, so it stays compressed in VRAM too
+		const auto format = getBlockCompressionFormat(asset.assetId, blockCompression, image);
+		const int mipLevels = meta.getBool("mipmap", false) ? TextureCompression::getMaxMipLevels(image.getSize()) : 1;
+
+		ImageDataAndMask data;
+		data.imageData = TextureCompression::compress(image, format, mipLevels);
+		data.mask = ImageMask::fromAlpha(image);
+
+		meta.set("compression", "block");
+		meta.set("textureFormat", toString(format));
+		meta.set("mipLevels", mipLevels);
+		meta.set("withMask", true);
+		collector.output(asset.assetId, AssetType::Texture, Serializer::toBytes(data, SerializerOptions(SerializerOptions::maxVersion)), meta);
+	} else if (useHLIF) {
 		meta.set("compression", "hlif");
 		collector.output(asset.assetId, AssetType::Texture, image.saveHLIFToBytes(asset.assetId, lz4hc), meta);
 	} else if (useQOI && (image.getFormat() == Image::Format::RGB || image.getFormat() == Image::Format::RGBA || image.getFormat() == Image::Format::RGBAPremultiplied)) {
@@ -34,3 +51,23 @@ void TextureImporter::import(const ImportingAsset& asset, IAssetCollector& colle
 		collector.output(asset.assetId, AssetType::Texture, image.savePNGToBytes(), meta);
 	}
 }
+
+TextureFormat TextureImporter::getBlockCompressionFormat(const String& assetId, const String& blockCompression, const Image& image)
+{
+	if (image.getFormat() != Image::Format::RGBA && image.getFormat() != Image::Format::RGBAPremultiplied) {
+		throw Exception("Block compression on \"" + assetId + "\" requires an RGBA image, found " + toString(image.getFormat()), HalleyExceptions::Tools);
+	}
+
+	// D3D11 won't create block compressed textures whose top level isn't made of whole blocks (smaller mips are fine)
+	const auto size = image.getSize();
+	if (size.x % 4 != 0 || size.y % 4 != 0) {
+		throw Exception("Block compression on \"" + assetId + "\" requires a size that's a multiple of 4, found " + toString(size.x) + "x" + toString(size.y), HalleyExceptions::Tools);
+	}
+
+	if (blockCompression == "bc1") {
+		return TextureFormat::BC1;
+	} else if (blockCompression == "bc3") {
+		return TextureFormat::BC3;
+	}
+	throw Exception("Unsupported block compression \"" + blockCompression + "\" on \"" + assetId + "\", expected none, bc1 or bc3", HalleyExceptions::Tools);
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "halley/plugin/iasset_importer.h"
+#include "halley/graphics/texture_descriptor.h"
 
 namespace Halley
 {
@@ -13,5 +14,7 @@ namespace Halley
 
 	private:
 		bool lz4hc;
+
+		static TextureFormat getBlockCompressionFormat(const String& assetId, const String& blockCompression, const Image& image);
 	};
 }
@@ -241,7 +241,16 @@ std::unique_ptr<Font> FontGenerator::generateFontMapBinary(const Metadata& meta,
 		kerningMap[kerningPair.left][kerningPair.right] = kerningPair.kerning;
 	}
 
+	// Font keeps its glyphs sorted, so add them in that order
+	Vector<const CharcodeEntry*> sortedEntries;
+	sortedEntries.reserve(entries.size());
 	for (auto& c: entries) {
+		sortedEntries.push_back(&c);
+	}
+	std::sort(sortedEntries.begin(), sortedEntries.end(), [] (const CharcodeEntry* a, const CharcodeEntry* b) { return a->charcode < b->charcode; });
+
+	for (const auto* entry: sortedEntries) {
+		const auto& c = *entry;
 		auto metrics = font.getMetrics(c.charcode);
 
 		const int32_t charcode = c.charcode;
@@ -251,8 +260,9 @@ std::unique_ptr<Font> FontGenerator::generateFontMapBinary(const Metadata& meta,
 		const Vector2f verticalBearing = metrics.bearingVertical + Vector2f(-padding, padding);
 		const Vector2f advance = metrics.advance;
 
-		result->addGlyph(Font::Glyph(charcode, area, size, horizontalBearing, verticalBearing, advance, std::move(kerningMap[charcode])));
+		result->addGlyph(Font::Glyph(charcode, area, size, horizontalBearing, verticalBearing, advance), kerningMap[charcode]);
 	}
+	result->finishAddingGlyphs();
 	
 	return result;
 }